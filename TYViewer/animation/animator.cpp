@@ -0,0 +1,209 @@
+#include "animator.h"
+
+#include <cmath>
+#include <algorithm>
+
+#include "util/trace.h"
+
+Animator::Animator(unsigned int threads) :
+	elapsed(0.0f),
+	generation(0),
+	busy(0),
+	stopping(false),
+	phase(Phase::Pose),
+	taskCount(0),
+	nextTask(0)
+{
+	if (threads == 0)
+		threads = std::max(1u, std::thread::hardware_concurrency());
+
+	// The thread calling update() and skin() works too.
+	for (unsigned int i = 1; i < threads; i++)
+	{
+		workers.emplace_back(&Animator::workerLoop, this);
+	}
+}
+
+Animator::~Animator()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+	}
+	wake.notify_all();
+
+	for (auto& thread : workers)
+	{
+		thread.join();
+	}
+}
+
+size_t Animator::addActor(const SkinnedModel& model, const QuantizedClip& clip, float time, float speed)
+{
+	Actor actor;
+	actor.model = &model;
+	actor.clip = &clip;
+	actor.time = time;
+	actor.speed = speed;
+
+	actor.poses.resize(std::max(model.bones.size(), clip.getBoneCount()));
+	actor.palette.resize(model.getPaletteSize());
+
+	actors.push_back(std::move(actor));
+
+	size_t index = actors.size() - 1;
+	for (size_t first = 0; first < model.vertices.size(); first += ANIMATOR_SKIN_BATCH)
+	{
+		batches.push_back({ index, first, std::min<size_t>(ANIMATOR_SKIN_BATCH, model.vertices.size() - first) });
+	}
+
+	return index;
+}
+
+void Animator::clear()
+{
+	actors.clear();
+	batches.clear();
+}
+
+void Animator::update(float seconds)
+{
+	TRACE_ZONE("Animator::update");
+
+	elapsed = seconds;
+	run(Phase::Pose, actors.size());
+}
+
+void Animator::skin()
+{
+	TRACE_ZONE("Animator::skin");
+
+	// Allocated here rather than in addActor, actors skinned on the GPU never need them.
+	for (auto& actor : actors)
+	{
+		actor.vertices.resize(actor.model->vertices.size());
+	}
+
+	run(Phase::Skin, batches.size());
+}
+
+size_t Animator::getActorCount() const
+{
+	return actors.size();
+}
+
+unsigned int Animator::getThreads() const
+{
+	return static_cast<unsigned int>(workers.size()) + 1;
+}
+
+const std::vector<BoneMatrix>& Animator::getPalette(size_t actor) const
+{
+	return actors[actor].palette;
+}
+
+const std::vector<SkinnedVertex>& Animator::getVertices(size_t actor) const
+{
+	return actors[actor].vertices;
+}
+
+size_t Animator::getVertexCount() const
+{
+	size_t count = 0;
+	for (auto& actor : actors)
+	{
+		count += actor.model->vertices.size();
+	}
+	return count;
+}
+
+size_t Animator::getBytes() const
+{
+	size_t bytes = sizeof(Animator) + actors.capacity() * sizeof(Actor) + batches.capacity() * sizeof(Batch);
+	for (auto& actor : actors)
+	{
+		bytes += actor.poses.capacity() * sizeof(BonePose) +
+			actor.palette.capacity() * sizeof(BoneMatrix) +
+			actor.vertices.capacity() * sizeof(SkinnedVertex);
+	}
+	return bytes;
+}
+
+void Animator::run(Phase phase, size_t tasks)
+{
+	this->phase = phase;
+	taskCount = tasks;
+	nextTask = 0;
+
+	// Waking the workers costs more than a single task.
+	if (workers.empty() || tasks <= 1)
+	{
+		runTasks();
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		generation++;
+		busy = static_cast<unsigned int>(workers.size());
+	}
+	wake.notify_all();
+
+	runTasks();
+
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		done.wait(lock, [this]() { return busy == 0; });
+	}
+}
+
+void Animator::runTasks()
+{
+	for (size_t task = nextTask++; task < taskCount; task = nextTask++)
+	{
+		if (phase == Phase::Pose)
+		{
+			Actor& actor = actors[task];
+
+			float duration = actor.clip->getDuration();
+			actor.time = duration > 0.0f ? std::fmod(actor.time + elapsed * actor.speed, duration) : 0.0f;
+			if (actor.time < 0.0f)
+				actor.time += duration;
+
+			actor.clip->sample(actor.time, actor.poses.data());
+			Skinning::buildPalette(*actor.model, actor.poses.data(), actor.palette.data());
+		}
+		else
+		{
+			const Batch& batch = batches[task];
+			Actor& actor = actors[batch.actor];
+
+			Skinning::skin(actor.model->vertices.data() + batch.first, batch.count, actor.palette.data(), actor.vertices.data() + batch.first);
+		}
+	}
+}
+
+void Animator::workerLoop()
+{
+	Trace::setThreadName("Animator");
+
+	unsigned int seen = 0;
+	while (true)
+	{
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			wake.wait(lock, [&]() { return stopping || generation != seen; });
+			if (stopping)
+				return;
+			seen = generation;
+		}
+
+		runTasks();
+
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			if (--busy == 0)
+				done.notify_one();
+		}
+	}
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <condition_variable>
+
+#include "animation/clip.h"
+#include "animation/skinning.h"
+
+// Vertices skinned per task, enough to be worth taking and few enough to balance threads.
+#define ANIMATOR_SKIN_BATCH 2048
+
+// Plays clips on any number of actors at once, posing and skinning them across worker threads.
+// Actors only refer to their model and clip, many actors can share both.
+class Animator
+{
+public:
+	// 'threads' 0 uses every core.
+	Animator(unsigned int threads = 0);
+	~Animator();
+
+	Animator(const Animator&) = delete;
+	Animator& operator=(const Animator&) = delete;
+
+	// 'model' and 'clip' must stay alive until clear(). Bones the clip has no track for stay at rest.
+	size_t addActor(const SkinnedModel& model, const QuantizedClip& clip, float time = 0.0f, float speed = 1.0f);
+	void clear();
+
+	// Moves every actor 'seconds' along its clip, looping, and builds its bone palette.
+	void update(float seconds);
+	// Skins every actor's vertices with the palette of the last update().
+	void skin();
+
+	size_t getActorCount() const;
+	unsigned int getThreads() const;
+
+	const std::vector<BoneMatrix>& getPalette(size_t actor) const;
+	// Empty until the first skin().
+	const std::vector<SkinnedVertex>& getVertices(size_t actor) const;
+
+	// Summed over every actor.
+	size_t getVertexCount() const;
+	size_t getBytes() const;
+
+private:
+	struct Actor
+	{
+		const SkinnedModel* model;
+		const QuantizedClip* clip;
+
+		float time;
+		float speed;
+
+		std::vector<BonePose> poses;
+		std::vector<BoneMatrix> palette;
+		std::vector<SkinnedVertex> vertices;
+	};
+
+	// Part of one actor's vertices.
+	struct Batch
+	{
+		size_t actor;
+		size_t first;
+		size_t count;
+	};
+
+	enum class Phase
+	{
+		Pose,
+		Skin
+	};
+
+	// Runs 'tasks' tasks of 'phase' on every worker and the calling thread, returns once all are done.
+	void run(Phase phase, size_t tasks);
+	void runTasks();
+	void workerLoop();
+
+	std::vector<Actor> actors;
+	std::vector<Batch> batches;
+
+	float elapsed;
+
+	// Workers sleep between calls instead of being created every frame.
+	std::vector<std::thread> workers;
+	std::mutex mutex;
+	std::condition_variable wake;
+	std::condition_variable done;
+	unsigned int generation;
+	unsigned int busy;
+	bool stopping;
+
+	Phase phase;
+	size_t taskCount;
+	std::atomic<size_t> nextTask;
+};
@@ -0,0 +1,319 @@
+#include "clip.h"
+
+#include <cmath>
+#include <algorithm>
+
+#include "util/trace.h"
+
+// Rotation components other than the largest lie within +-1/sqrt(2), stored in 15 bits.
+#define ROTATION_COMPONENT_RANGE 0.70710678f
+#define ROTATION_COMPONENT_STEPS 32767.0f
+
+#define TRANSLATION_STEPS 65535.0f
+
+static glm::vec4 normalizeRotation(const glm::vec4& rotation)
+{
+	float length = std::sqrt(glm::dot(rotation, rotation));
+	return length > 0.0f ? rotation / length : glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+}
+
+// Normalized linear interpolation along the shorter arc, close enough to slerp between keys this near.
+static glm::vec4 interpolateRotation(const glm::vec4& a, const glm::vec4& b, float alpha)
+{
+	glm::vec4 target = glm::dot(a, b) < 0.0f ? b * -1.0f : b;
+	return normalizeRotation(a + (target - a) * alpha);
+}
+
+AnimationClip::AnimationClip() :
+	duration(0.0f)
+{}
+
+void AnimationClip::sample(float time, BonePose* poses) const
+{
+	time = std::max(0.0f, std::min(time, duration));
+
+	for (size_t i = 0; i < tracks.size(); i++)
+	{
+		const BoneTrack& track = tracks[i];
+
+		// One translation and rotation per time.
+		size_t keys = std::min(track.times.size(), std::min(track.translations.size(), track.rotations.size()));
+		if (keys == 0)
+		{
+			poses[i] = BonePose();
+			continue;
+		}
+
+		size_t next = std::upper_bound(track.times.begin(), track.times.begin() + keys, time) - track.times.begin();
+		if (next == 0 || next == keys)
+		{
+			size_t key = next == 0 ? 0 : keys - 1;
+			poses[i].translation = track.translations[key];
+			poses[i].rotation = track.rotations[key];
+			continue;
+		}
+
+		size_t previous = next - 1;
+		float span = track.times[next] - track.times[previous];
+		float alpha = span > 0.0f ? (time - track.times[previous]) / span : 0.0f;
+
+		poses[i].translation = glm::mix(track.translations[previous], track.translations[next], alpha);
+		poses[i].rotation = interpolateRotation(track.rotations[previous], track.rotations[next], alpha);
+	}
+}
+
+size_t AnimationClip::getBytes() const
+{
+	size_t bytes = sizeof(AnimationClip) + tracks.capacity() * sizeof(BoneTrack);
+	for (auto& track : tracks)
+	{
+		bytes += track.times.capacity() * sizeof(float) +
+			track.translations.capacity() * sizeof(glm::vec3) +
+			track.rotations.capacity() * sizeof(glm::vec4);
+	}
+	return bytes;
+}
+
+QuantizedClip::QuantizedClip() :
+	duration(0.0f),
+	framesPerSecond(0.0f),
+	frameCount(0),
+	translationTracks(0),
+	rotationTracks(0)
+{}
+
+void QuantizedClip::build(const AnimationClip& clip, float sampleRate)
+{
+	TRACE_ZONE_DETAIL("QuantizedClip::build", clip.name);
+
+	name = clip.name;
+	duration = std::max(clip.duration, 0.0f);
+
+	// Spread evenly so the last frame lands on the end of the clip.
+	frameCount = duration > 0.0f ? std::max(2u, static_cast<uint32_t>(std::ceil(duration * sampleRate)) + 1) : 1;
+	framesPerSecond = frameCount > 1 ? (frameCount - 1) / duration : 0.0f;
+
+	size_t bones = clip.tracks.size();
+
+	std::vector<BonePose> frames(frameCount * bones);
+	for (uint32_t frame = 0; frame < frameCount; frame++)
+	{
+		clip.sample(frameCount > 1 ? frame / framesPerSecond : 0.0f, &frames[frame * bones]);
+	}
+
+	tracks.assign(bones, Track());
+	constantTranslations.clear();
+	constantRotations.clear();
+	translationMins.clear();
+	translationScales.clear();
+	translationTracks = 0;
+	rotationTracks = 0;
+
+	for (size_t bone = 0; bone < bones; bone++)
+	{
+		glm::vec3 min = frames[bone].translation;
+		glm::vec3 max = min;
+		bool rotates = false;
+
+		for (uint32_t frame = 1; frame < frameCount; frame++)
+		{
+			const BonePose& pose = frames[frame * bones + bone];
+			min = glm::min(min, pose.translation);
+			max = glm::max(max, pose.translation);
+
+			if (std::abs(glm::dot(pose.rotation, frames[bone].rotation)) < 1.0f - ANIMATION_ROTATION_TOLERANCE)
+				rotates = true;
+		}
+
+		glm::vec3 extent = max - min;
+		if (std::max(std::max(extent.x, extent.y), extent.z) <= ANIMATION_TRANSLATION_TOLERANCE)
+		{
+			tracks[bone].translation = ~static_cast<int32_t>(constantTranslations.size());
+			constantTranslations.push_back((min + max) / 2.0f);
+		}
+		else
+		{
+			tracks[bone].translation = static_cast<int32_t>(translationTracks++);
+			translationMins.push_back(min);
+			translationScales.push_back(extent / TRANSLATION_STEPS);
+		}
+
+		if (!rotates)
+		{
+			tracks[bone].rotation = ~static_cast<int32_t>(constantRotations.size());
+			constantRotations.push_back(frames[bone].rotation);
+		}
+		else
+		{
+			tracks[bone].rotation = static_cast<int32_t>(rotationTracks++);
+		}
+	}
+
+	translationKeys.assign(frameCount * translationTracks * 3, 0);
+	rotationKeys.assign(frameCount * rotationTracks * 3, 0);
+
+	for (uint32_t frame = 0; frame < frameCount; frame++)
+	{
+		uint16_t* translationFrame = translationKeys.data() + frame * translationTracks * 3;
+		uint16_t* rotationFrame = rotationKeys.data() + frame * rotationTracks * 3;
+
+		for (size_t bone = 0; bone < bones; bone++)
+		{
+			const BonePose& pose = frames[frame * bones + bone];
+			const Track& track = tracks[bone];
+
+			if (track.translation >= 0)
+			{
+				const glm::vec3& min = translationMins[track.translation];
+				const glm::vec3& scale = translationScales[track.translation];
+				for (int axis = 0; axis < 3; axis++)
+				{
+					float steps = scale[axis] > 0.0f ? (pose.translation[axis] - min[axis]) / scale[axis] : 0.0f;
+					translationFrame[track.translation * 3 + axis] = static_cast<uint16_t>(std::max(0.0f, std::min(std::round(steps), TRANSLATION_STEPS)));
+				}
+			}
+
+			if (track.rotation >= 0)
+			{
+				packRotation(pose.rotation, rotationFrame + track.rotation * 3);
+			}
+		}
+	}
+}
+
+void QuantizedClip::sample(float time, BonePose* poses) const
+{
+	if (frameCount == 0)
+		return;
+
+	float position = std::max(0.0f, std::min(time, duration)) * framesPerSecond;
+	uint32_t frame = std::min(static_cast<uint32_t>(position), frameCount - 1);
+	uint32_t next = std::min(frame + 1, frameCount - 1);
+	float alpha = std::min(position - frame, 1.0f);
+
+	const uint16_t* translations = translationKeys.data() + frame * translationTracks * 3;
+	const uint16_t* nextTranslations = translationKeys.data() + next * translationTracks * 3;
+	const uint16_t* rotations = rotationKeys.data() + frame * rotationTracks * 3;
+	const uint16_t* nextRotations = rotationKeys.data() + next * rotationTracks * 3;
+
+	for (size_t bone = 0; bone < tracks.size(); bone++)
+	{
+		const Track& track = tracks[bone];
+
+		if (track.translation < 0)
+		{
+			poses[bone].translation = constantTranslations[~track.translation];
+		}
+		else
+		{
+			const uint16_t* a = translations + track.translation * 3;
+			const uint16_t* b = nextTranslations + track.translation * 3;
+
+			// Interpolated in steps, then scaled once.
+			glm::vec3 steps(
+				a[0] + (b[0] - a[0]) * alpha,
+				a[1] + (b[1] - a[1]) * alpha,
+				a[2] + (b[2] - a[2]) * alpha);
+			poses[bone].translation = translationMins[track.translation] + steps * translationScales[track.translation];
+		}
+
+		if (track.rotation < 0)
+		{
+			poses[bone].rotation = constantRotations[~track.rotation];
+		}
+		else
+		{
+			glm::vec4 a = unpackRotation(rotations + track.rotation * 3);
+			glm::vec4 b = unpackRotation(nextRotations + track.rotation * 3);
+			poses[bone].rotation = interpolateRotation(a, b, alpha);
+		}
+	}
+}
+
+const std::string& QuantizedClip::getName() const
+{
+	return name;
+}
+
+float QuantizedClip::getDuration() const
+{
+	return duration;
+}
+
+size_t QuantizedClip::getBoneCount() const
+{
+	return tracks.size();
+}
+
+size_t QuantizedClip::getFrameCount() const
+{
+	return frameCount;
+}
+
+size_t QuantizedClip::getAnimatedTrackCount() const
+{
+	return translationTracks + rotationTracks;
+}
+
+size_t QuantizedClip::getBytes() const
+{
+	return sizeof(QuantizedClip) +
+		tracks.capacity() * sizeof(Track) +
+		constantTranslations.capacity() * sizeof(glm::vec3) +
+		constantRotations.capacity() * sizeof(glm::vec4) +
+		translationMins.capacity() * sizeof(glm::vec3) +
+		translationScales.capacity() * sizeof(glm::vec3) +
+		translationKeys.capacity() * sizeof(uint16_t) +
+		rotationKeys.capacity() * sizeof(uint16_t);
+}
+
+void QuantizedClip::packRotation(const glm::vec4& rotation, uint16_t* key)
+{
+	glm::vec4 unit = normalizeRotation(rotation);
+
+	// q and -q are the same rotation, the largest component is dropped and made positive.
+	int largest = 0;
+	for (int i = 1; i < 4; i++)
+	{
+		if (std::abs(unit[i]) > std::abs(unit[largest]))
+			largest = i;
+	}
+	float sign = unit[largest] < 0.0f ? -1.0f : 1.0f;
+
+	int component = 0;
+	for (int i = 0; i < 4; i++)
+	{
+		if (i == largest)
+			continue;
+
+		float value = (unit[i] * sign / ROTATION_COMPONENT_RANGE) * 0.5f + 0.5f;
+		key[component++] = static_cast<uint16_t>(std::max(0.0f, std::min(std::round(value * ROTATION_COMPONENT_STEPS), ROTATION_COMPONENT_STEPS)));
+	}
+
+	// Which component was dropped goes in the top bits of the first two.
+	key[0] |= static_cast<uint16_t>((largest >> 1) << 15);
+	key[1] |= static_cast<uint16_t>((largest & 1) << 15);
+}
+
+glm::vec4 QuantizedClip::unpackRotation(const uint16_t* key)
+{
+	int largest = ((key[0] >> 15) << 1) | (key[1] >> 15);
+
+	const float scale = 2.0f * ROTATION_COMPONENT_RANGE / ROTATION_COMPONENT_STEPS;
+	float a = (key[0] & 0x7FFF) * scale - ROTATION_COMPONENT_RANGE;
+	float b = (key[1] & 0x7FFF) * scale - ROTATION_COMPONENT_RANGE;
+	float c = (key[2] & 0x7FFF) * scale - ROTATION_COMPONENT_RANGE;
+	float d = std::sqrt(std::max(0.0f, 1.0f - a * a - b * b - c * c));
+
+	switch (largest)
+	{
+	case 0:
+		return glm::vec4(d, a, b, c);
+	case 1:
+		return glm::vec4(a, d, b, c);
+	case 2:
+		return glm::vec4(a, b, d, c);
+	default:
+		return glm::vec4(a, b, c, d);
+	}
+}
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+#include <glm/glm.hpp>
+
+// Keys are resampled to about this many frames per second when a clip is quantized.
+#define ANIMATION_SAMPLE_RATE 30.0f
+
+// Tracks that move less than this over the whole clip are stored once.
+#define ANIMATION_TRANSLATION_TOLERANCE 1e-3f
+#define ANIMATION_ROTATION_TOLERANCE 1e-6f
+
+// Where a bone is relative to its rest position, rotating about it.
+struct BonePose
+{
+	glm::vec3 translation = glm::vec3(0.0f);
+	// Unit quaternion, x y z w.
+	glm::vec4 rotation = glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+};
+
+// Keyframes of one bone as authored, times in seconds and ascending.
+struct BoneTrack
+{
+	std::vector<float> times;
+	std::vector<glm::vec3> translations;
+	std::vector<glm::vec4> rotations;
+};
+
+// Full precision keyframes, one track per bone of the model it plays on.
+// Only used to build a QuantizedClip and to check it against.
+class AnimationClip
+{
+public:
+	AnimationClip();
+
+	// Interpolates every track at 'time', clamped to the clip. Bones without keys stay at rest.
+	void sample(float time, BonePose* poses) const;
+
+	size_t getBytes() const;
+
+	std::string name;
+	float duration;
+
+	std::vector<BoneTrack> tracks;
+};
+
+// A clip resampled at a fixed rate and quantized to 16 bits, what actors play.
+// Translations are stored relative to each track's range, rotations as their three smallest
+// components, 6 bytes a key each. Keys are laid out frame by frame so sampling every bone
+// at one time reads two contiguous runs, and tracks that do not move are stored once.
+class QuantizedClip
+{
+public:
+	QuantizedClip();
+
+	void build(const AnimationClip& clip, float sampleRate = ANIMATION_SAMPLE_RATE);
+
+	// Interpolates between the two frames around 'time', clamped to the clip.
+	void sample(float time, BonePose* poses) const;
+
+	const std::string& getName() const;
+	float getDuration() const;
+
+	size_t getBoneCount() const;
+	size_t getFrameCount() const;
+	// Tracks with keys on every frame, out of twice the bone count.
+	size_t getAnimatedTrackCount() const;
+
+	size_t getBytes() const;
+
+private:
+	// Negative indices are ~index into the constants.
+	struct Track
+	{
+		int32_t translation;
+		int32_t rotation;
+	};
+
+	static void packRotation(const glm::vec4& rotation, uint16_t* key);
+	static glm::vec4 unpackRotation(const uint16_t* key);
+
+	std::string name;
+	float duration;
+	float framesPerSecond;
+	uint32_t frameCount;
+
+	std::vector<Track> tracks;
+
+	std::vector<glm::vec3> constantTranslations;
+	std::vector<glm::vec4> constantRotations;
+
+	// Per animated translation track, key * scale + min gives the translation.
+	std::vector<glm::vec3> translationMins;
+	std::vector<glm::vec3> translationScales;
+
+	// Three per key, every animated track of frame 0, then frame 1 and so on.
+	size_t translationTracks;
+	size_t rotationTracks;
+	std::vector<uint16_t> translationKeys;
+	std::vector<uint16_t> rotationKeys;
+};
@@ -0,0 +1,196 @@
+#include "skinning.h"
+
+#include <cmath>
+#include <algorithm>
+
+void SkinnedModel::build(const std::vector<Vertex>& vertices, const std::vector<Bone>& bones)
+{
+	this->bones = bones;
+	this->vertices.resize(vertices.size());
+	outOfRangeBones = 0;
+
+	// Indices past the skeleton go to the first bone, counted so --verify can catch them.
+	int last = static_cast<int>(getPaletteSize()) - 1;
+
+	for (size_t i = 0; i < vertices.size(); i++)
+	{
+		const Vertex& vertex = vertices[i];
+		SkinVertex& skin = this->vertices[i];
+
+		skin.position[0] = vertex.position.x;
+		skin.position[1] = vertex.position.y;
+		skin.position[2] = vertex.position.z;
+		skin.weight = std::max(0.0f, std::min(vertex.skin.x, 1.0f));
+
+		skin.normal[0] = vertex.normal.x;
+		skin.normal[1] = vertex.normal.y;
+		skin.normal[2] = vertex.normal.z;
+
+		for (int bone = 0; bone < 2; bone++)
+		{
+			int index = static_cast<int>(vertex.skin[bone + 1]);
+			if (index < 0 || index > last)
+			{
+				outOfRangeBones++;
+				index = 0;
+			}
+			skin.bones[bone] = static_cast<uint16_t>(index);
+		}
+	}
+}
+
+size_t SkinnedModel::getPaletteSize() const
+{
+	return std::max<size_t>(bones.size(), 1);
+}
+
+size_t SkinnedModel::getBytes() const
+{
+	return sizeof(SkinnedModel) + vertices.capacity() * sizeof(SkinVertex) + bones.capacity() * sizeof(Bone);
+}
+
+void Skinning::buildPalette(const SkinnedModel& model, const BonePose* poses, BoneMatrix* palette)
+{
+	if (model.bones.empty())
+	{
+		for (int i = 0; i < 4; i++)
+		{
+			for (int j = 0; j < 4; j++)
+			{
+				palette[0].columns[i][j] = i == j ? 1.0f : 0.0f;
+			}
+		}
+		return;
+	}
+
+	for (size_t bone = 0; bone < model.bones.size(); bone++)
+	{
+		const glm::vec4& q = poses[bone].rotation;
+		const glm::vec3& rest = model.bones[bone].defaultPosition;
+
+		float xx = q.x * q.x, yy = q.y * q.y, zz = q.z * q.z;
+		float xy = q.x * q.y, xz = q.x * q.z, yz = q.y * q.z;
+		float wx = q.w * q.x, wy = q.w * q.y, wz = q.w * q.z;
+
+		float (&m)[4][4] = palette[bone].columns;
+		m[0][0] = 1.0f - 2.0f * (yy + zz);
+		m[0][1] = 2.0f * (xy + wz);
+		m[0][2] = 2.0f * (xz - wy);
+		m[0][3] = 0.0f;
+
+		m[1][0] = 2.0f * (xy - wz);
+		m[1][1] = 1.0f - 2.0f * (xx + zz);
+		m[1][2] = 2.0f * (yz + wx);
+		m[1][3] = 0.0f;
+
+		m[2][0] = 2.0f * (xz + wy);
+		m[2][1] = 2.0f * (yz - wx);
+		m[2][2] = 1.0f - 2.0f * (xx + yy);
+		m[2][3] = 0.0f;
+
+		// Rotating about the rest position, then moving: rest + translation - R * rest.
+		for (int row = 0; row < 3; row++)
+		{
+			m[3][row] = rest[row] + poses[bone].translation[row] -
+				(m[0][row] * rest.x + m[1][row] * rest.y + m[2][row] * rest.z);
+		}
+		m[3][3] = 1.0f;
+	}
+}
+
+void Skinning::skin(const SkinVertex* vertices, size_t count, const BoneMatrix* palette, SkinnedVertex* output)
+{
+#if SKINNING_SSE
+	const __m128 one = _mm_set1_ps(1.0f);
+	const __m128 half = _mm_set1_ps(0.5f);
+	const __m128 three = _mm_set1_ps(3.0f);
+
+	for (size_t i = 0; i < count; i++)
+	{
+		const SkinVertex& vertex = vertices[i];
+		const BoneMatrix& a = palette[vertex.bones[0]];
+		const BoneMatrix& b = palette[vertex.bones[1]];
+
+		// Blending the matrices once costs less than transforming by both.
+		__m128 weightA = _mm_set1_ps(vertex.weight);
+		__m128 weightB = _mm_sub_ps(one, weightA);
+
+		__m128 column0 = _mm_add_ps(_mm_mul_ps(_mm_load_ps(a.columns[0]), weightA), _mm_mul_ps(_mm_load_ps(b.columns[0]), weightB));
+		__m128 column1 = _mm_add_ps(_mm_mul_ps(_mm_load_ps(a.columns[1]), weightA), _mm_mul_ps(_mm_load_ps(b.columns[1]), weightB));
+		__m128 column2 = _mm_add_ps(_mm_mul_ps(_mm_load_ps(a.columns[2]), weightA), _mm_mul_ps(_mm_load_ps(b.columns[2]), weightB));
+		__m128 column3 = _mm_add_ps(_mm_mul_ps(_mm_load_ps(a.columns[3]), weightA), _mm_mul_ps(_mm_load_ps(b.columns[3]), weightB));
+
+		// The fourth lanes hold the weight and bone indices, only x y z are broadcast.
+		__m128 position = _mm_load_ps(vertex.position);
+		__m128 normal = _mm_load_ps(vertex.normal);
+
+		__m128 skinnedPosition = _mm_add_ps(
+			_mm_add_ps(
+				_mm_mul_ps(column0, _mm_shuffle_ps(position, position, _MM_SHUFFLE(0, 0, 0, 0))),
+				_mm_mul_ps(column1, _mm_shuffle_ps(position, position, _MM_SHUFFLE(1, 1, 1, 1)))),
+			_mm_add_ps(
+				_mm_mul_ps(column2, _mm_shuffle_ps(position, position, _MM_SHUFFLE(2, 2, 2, 2))),
+				column3));
+
+		__m128 skinnedNormal = _mm_add_ps(
+			_mm_add_ps(
+				_mm_mul_ps(column0, _mm_shuffle_ps(normal, normal, _MM_SHUFFLE(0, 0, 0, 0))),
+				_mm_mul_ps(column1, _mm_shuffle_ps(normal, normal, _MM_SHUFFLE(1, 1, 1, 1)))),
+			_mm_mul_ps(column2, _mm_shuffle_ps(normal, normal, _MM_SHUFFLE(2, 2, 2, 2))));
+
+		// Blended rotations shorten the normal. w is 0, so the 4 lane dot product is the length.
+		__m128 squared = _mm_mul_ps(skinnedNormal, skinnedNormal);
+		squared = _mm_add_ps(squared, _mm_shuffle_ps(squared, squared, _MM_SHUFFLE(1, 0, 3, 2)));
+		squared = _mm_add_ps(squared, _mm_shuffle_ps(squared, squared, _MM_SHUFFLE(2, 3, 0, 1)));
+
+		// Estimate refined by one Newton-Raphson step, zero length normals stay zero.
+		__m128 estimate = _mm_rsqrt_ps(squared);
+		estimate = _mm_mul_ps(_mm_mul_ps(half, estimate), _mm_sub_ps(three, _mm_mul_ps(_mm_mul_ps(squared, estimate), estimate)));
+		estimate = _mm_and_ps(estimate, _mm_cmpgt_ps(squared, _mm_setzero_ps()));
+
+		_mm_store_ps(output[i].position, skinnedPosition);
+		_mm_store_ps(output[i].normal, _mm_mul_ps(skinnedNormal, estimate));
+	}
+#else
+	skinScalar(vertices, count, palette, output);
+#endif
+}
+
+void Skinning::skinScalar(const SkinVertex* vertices, size_t count, const BoneMatrix* palette, SkinnedVertex* output)
+{
+	for (size_t i = 0; i < count; i++)
+	{
+		const SkinVertex& vertex = vertices[i];
+		const BoneMatrix& a = palette[vertex.bones[0]];
+		const BoneMatrix& b = palette[vertex.bones[1]];
+
+		float weightA = vertex.weight;
+		float weightB = 1.0f - weightA;
+
+		float columns[4][4];
+		for (int column = 0; column < 4; column++)
+		{
+			for (int row = 0; row < 4; row++)
+			{
+				columns[column][row] = a.columns[column][row] * weightA + b.columns[column][row] * weightB;
+			}
+		}
+
+		float length = 0.0f;
+		for (int row = 0; row < 4; row++)
+		{
+			output[i].position[row] = columns[0][row] * vertex.position[0] + columns[1][row] * vertex.position[1] +
+				columns[2][row] * vertex.position[2] + columns[3][row];
+			output[i].normal[row] = columns[0][row] * vertex.normal[0] + columns[1][row] * vertex.normal[1] +
+				columns[2][row] * vertex.normal[2];
+
+			length += output[i].normal[row] * output[i].normal[row];
+		}
+
+		float scale = length > 0.0f ? 1.0f / std::sqrt(length) : 0.0f;
+		for (int row = 0; row < 4; row++)
+		{
+			output[i].normal[row] *= scale;
+		}
+	}
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+#include <glm/glm.hpp>
+
+#include "graphics/vertex.h"
+
+#include "loader/modeldata.h"
+
+#include "animation/clip.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define SKINNING_SSE 1
+#else
+#define SKINNING_SSE 0
+#endif
+
+// Column major like glm::mat4, the fourth row is always 0 0 0 1.
+struct alignas(16) BoneMatrix
+{
+	float columns[4][4];
+};
+
+// A vertex with what skinning needs and nothing else, 32 bytes.
+// 'weight' is of the first bone, the second gets the rest.
+struct alignas(16) SkinVertex
+{
+	float position[3];
+	float weight;
+	float normal[3];
+	uint16_t bones[2];
+};
+
+// Positions have w 1 and normals w 0, stored straight from SSE registers.
+struct alignas(16) SkinnedVertex
+{
+	float position[4];
+	float normal[4];
+};
+
+// The parts of a model every actor playing on it shares.
+struct SkinnedModel
+{
+	// Every vertex of the model in ModelData order, with bone indices clamped to 'bones'.
+	std::vector<SkinVertex> vertices;
+	std::vector<Bone> bones;
+
+	// Bone indices past 'bones' that build() moved to the first bone.
+	size_t outOfRangeBones = 0;
+
+	// Vertex::skin is weight, first bone, second bone, the loaders store bone indices decoded.
+	void build(const std::vector<Vertex>& vertices, const std::vector<Bone>& bones);
+
+	// At least one, models without bones get the identity.
+	size_t getPaletteSize() const;
+
+	size_t getBytes() const;
+};
+
+class Skinning
+{
+public:
+	// Bones have no parents in the MDL, each turns about its own rest position in model space.
+	// 'palette' holds getPaletteSize() matrices, 'poses' one per bone.
+	static void buildPalette(const SkinnedModel& model, const BonePose* poses, BoneMatrix* palette);
+
+	// Blends the two bone matrices of each vertex and transforms it, with SSE where available.
+	static void skin(const SkinVertex* vertices, size_t count, const BoneMatrix* palette, SkinnedVertex* output);
+	// The same without SSE, kept to check the fast path against.
+	static void skinScalar(const SkinVertex* vertices, size_t count, const BoneMatrix* palette, SkinnedVertex* output);
+};
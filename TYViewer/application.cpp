@@ -1,7 +1,36 @@
 #include "application.h"
 
+#include <fstream>
+
+#include "util/allocation.h"
+
+// Frames to skip before checking for per-frame heap allocations.
+#define FRAME_ALLOCATION_WARMUP 2
+
+// Camera pitch while recording a turntable, in degrees.
+#define TURNTABLE_PITCH -20.0f
+
+// Where the camera is put to frame a model picked in the browser, like headless images.
+#define BROWSER_VIEW_YAW 120.0f
+#define BROWSER_VIEW_PITCH -20.0f
+
 std::string Application::APPLICATION_PATH = "";
 std::string Application::ARCHIVE_PATH = "";
+std::string Application::TRACE_PATH = "";
+
+// First "<prefix>_NNNN.<extension>" next to the executable that does not exist yet.
+static std::string findFreePath(const std::string& prefix, const std::string& extension)
+{
+	for (unsigned int i = 0; ; i++)
+	{
+		char number[16];
+		snprintf(number, sizeof(number), "_%04u.", i);
+
+		std::string path = Application::APPLICATION_PATH + prefix + number + extension;
+		if (!std::ifstream(path).good())
+			return path;
+	}
+}
 
 void Application::resize(int width, int height)
 {
@@ -31,46 +60,52 @@ Application::Application(GLFWwindow* window) :
 
 void Application::initialize()
 {
-	Debug::log("Initializing application...");
+	LOG_INFO(General, "Initializing application...");
 	content.initialize();
 	
 	if (Config::archive.empty())
 	{
-		Debug::log("ERROR: No archive path specified in config!");
+		LOG_ERROR(General, "No archive path specified in config!");
+		Debug::flush();
 		std::cout << "ERROR: No archive path specified in config.cfg!" << std::endl;
 		std::cin.get();
 		terminate();
 		return;
 	}
 
-	Debug::log("Loading archive: " + Config::archive);
+	LOG_INFO(Archive, "Loading archive: " + Config::archive);
 	if (!content.loadRKV(Config::archive))
 	{
-		Debug::log("ERROR: Failed to load archive: " + Config::archive);
+		LOG_ERROR(General, "Failed to load archive: " + Config::archive);
+		Debug::flush();
 		std::cout << "ERROR: Failed to load archive: " + Config::archive << std::endl;
 		std::cout << "Have you entered correct path in 'config.cfg'?" << std::endl;
 		std::cin.get();
 		terminate();
 		return;
 	}
-	Debug::log("Archive loaded successfully");
+	LOG_INFO(Archive, "Archive loaded successfully");
 
 	Mouse::initialize(window);
 	Keyboard::initialize(window);
 
 	renderer.initialize();
+	capture.initialize();
+	gpuTimer.initialize();
 
 	//content.defaultTexture = content.load<Texture>("front_yellow.dds");
 
 	grid = new Grid({ 800, 800 }, 50.0f, glm::vec4(0.4f, 0.4f, 0.4f, 1.0f));
 
 	Font* font = content.load<Font>("font_frontend_pc.wfn");
+	overlay.initialize(font);
 	//labels.push_back(new Text("This is a longer sentence with spaces!", font, glm::vec3(0,0,0)));
 
 	shader = content.load<Shader>("standard.shader");
 	if (shader == nullptr)
 	{
-		Debug::log("ERROR: Failed to load shader: standard.shader");
+		LOG_ERROR(General, "Failed to load shader: standard.shader");
+		Debug::flush();
 		std::cout << "Failed to load shader file!" << std::endl;
 		std::cin.get();
 		terminate();
@@ -83,7 +118,8 @@ void Application::initialize()
 	basic = content.load<Shader>("standard.shader");
 	if (basic == nullptr)
 	{
-		Debug::log("ERROR: Failed to load basic shader: standard.shader");
+		LOG_ERROR(General, "Failed to load basic shader: standard.shader");
+		Debug::flush();
 		std::cout << "Failed to load shader file!" << std::endl;
 		std::cin.get();
 		terminate();
@@ -95,18 +131,20 @@ void Application::initialize()
 	Model* loadedModel = nullptr;
 	if(Config::model != "")
 	{
-		Debug::log("Loading model from config: " + Config::model);
-		loadedModel = content.load<Model>(Config::model);
+		LOG_INFO(Content, "Loading model from config: " + Config::model);
+		modelName = Config::model;
 	}
 	else
 	{
-		Debug::log("Loading default model: act_01_ty.mdl");
-		loadedModel = content.load<Model>("act_01_ty.mdl");
+		LOG_INFO(Content, "Loading default model: act_01_ty.mdl");
+		modelName = "act_01_ty.mdl";
 	}
+	loadedModel = content.load<Model>(modelName);
 
 	if (loadedModel == nullptr)
 	{
-		Debug::log("ERROR: Failed to load model! The program will exit.");
+		LOG_ERROR(General, "Failed to load model! The program will exit.");
+		Debug::flush();
 		std::cout << "Failed to load model file!" << std::endl;
 		std::cin.get();
 		terminate();
@@ -114,6 +152,9 @@ void Application::initialize()
 	}
 
 	models.push_back(loadedModel);
+	buildPicker();
+
+	browser.initialize(&content, font, APPLICATION_PATH + "thumbnail_cache");
 }
 void Application::run()
 {
@@ -122,31 +163,93 @@ void Application::run()
 
 	float dt = 0.0f;
 
+	// The frame loop should not touch the heap once everything is loaded.
+	// Debug builds count global allocations to catch regressions.
+	unsigned int frame = 0;
+	size_t reportedAllocations = 0;
+
 	while (!glfwWindowShouldClose(window))
 	{
+		AllocationStats before = Allocation::getTotal();
+
 		elapsed = static_cast<float>(glfwGetTime());
 		dt = elapsed - previous;
 		previous = elapsed;
 
-		Keyboard::process(window, dt);
-		Mouse::process(window, dt);
+		frameStart = elapsed;
+		frameTime = dt;
+
+		{
+			TRACE_ZONE("Frame");
+			ALLOCATION_SCOPE(Frame);
+
+			Keyboard::process(window, dt);
+			Mouse::process(window, dt);
+
+			update(dt);
+			render(*shader);
+
+			glfwPollEvents();
+		}
+
+		AllocationStats after = Allocation::getTotal();
+		size_t frameAllocations = after.count - before.count;
+		overlay.addAllocations(frameAllocations, after.bytes - before.bytes);
+
+		FrameAllocator& frameAllocator = renderer.getFrameAllocator();
+		overlay.setFrameArena(frameAllocator.getUsed(), frameAllocator.getCapacity(), frameAllocator.getGrowCount());
 
-		update(dt);
-		render(*shader);
-		
-		glfwPollEvents();
+		if (Allocation::isCounting() && frame > FRAME_ALLOCATION_WARMUP && frameAllocations != reportedAllocations)
+		{
+			if (frameAllocations > 0)
+			{
+				LOG_WARNING(General, "Frame " + std::to_string(frame) + " made " + std::to_string(frameAllocations) + " heap allocations (expected 0)");
+			}
+			reportedAllocations = frameAllocations;
+		}
+		frame++;
 	}
 
 	terminate();
 }
 void Application::terminate()
 {
+	browser.terminate();
+	capture.terminate();
+	gpuTimer.terminate();
+
+	if (Trace::isEnabled())
+	{
+		toggleTrace();
+	}
+
 	Config::save(Application::APPLICATION_PATH + "config.cfg");
 	glfwTerminate();
+
+	Allocation::report();
+	Debug::shutdown();
 }
 
 void Application::update(float dt)
 {
+	TRACE_ZONE("Application::update");
+
+	if (Keyboard::isKeyPressed(GLFW_KEY_TAB))
+	{
+		browser.toggle();
+	}
+	browser.update(Config::windowResolutionX, Config::windowResolutionY);
+
+	std::string selected;
+	Model* model = browser.takeSelection(selected);
+	if (model != nullptr)
+	{
+		showModel(model, selected);
+	}
+
+	// Letters type into the browser's filter while it is open.
+	bool typing = browser.isOpen();
+
 	float mouseInputX = Mouse::getMouseDelta().x;
 	float mouseInputY = Mouse::getMouseDelta().y;
 
@@ -159,6 +262,20 @@ void Application::update(float dt)
 		(Keyboard::isKeyHeld(GLFW_KEY_S)) ? -1.0f : 
 		0.0f;
 
+	if (typing)
+	{
+		horizontal = 0.0f;
+		vertical = 0.0f;
+	}
+
+	// Clicks on the browser belong to it.
+	bool mouseDown = Mouse::isButtonHeld(GLFW_MOUSE_BUTTON_LEFT);
+	if (mouseDown && !mouseWasDown && !browser.isOpen())
+	{
+		pick();
+	}
+	mouseWasDown = mouseDown;
+
 	if (Mouse::isButtonHeld(GLFW_MOUSE_BUTTON_MIDDLE))
 	{
 		camera.localRotate(glm::vec3(mouseInputX, -mouseInputY, 0.0f) * 0.1f);
@@ -171,56 +288,82 @@ void Application::update(float dt)
 	else
 		camera.localTranslate(glm::vec3(horizontal, 0.0f, vertical) * 820.0f * dt);
 
-	if (Keyboard::isKeyPressed(GLFW_KEY_1))
+	if (!typing)
 	{
-		drawGrid = !drawGrid;
+		if (Keyboard::isKeyPressed(GLFW_KEY_1))
+		{
+			drawGrid = !drawGrid;
+		}
+		if (Keyboard::isKeyPressed(GLFW_KEY_2))
+		{
+			drawBounds = !drawBounds;
+		}
+		if (Keyboard::isKeyPressed(GLFW_KEY_3))
+		{
+			drawColliders = !drawColliders;
+		}
+		if (Keyboard::isKeyPressed(GLFW_KEY_4))
+		{
+			drawBones = !drawBones;
+		}
+		if (Keyboard::isKeyPressed(GLFW_KEY_5))
+		{
+			drawCollision = !drawCollision;
+		}
+
+		if (Keyboard::isKeyPressed(GLFW_KEY_F))
+		{
+			wireframe = !wireframe;
+			if (wireframe)
+			{
+				glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
+			}
+			else
+			{
+				glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+			}
+		}
+
+		if (Keyboard::isKeyPressed(GLFW_KEY_T))
+		{
+			LOG_INFO
+			(
+				General,
+				"Camera Position : { " +
+				std::to_string(camera.getPosition().x) +
+				", " +
+				std::to_string(camera.getPosition().y) +
+				", " +
+				std::to_string(camera.getPosition().z) + " }"
+			);
+			LOG_INFO
+			(
+				General,
+				"Camera Rotation : { " +
+				std::to_string(camera.getRotation().x) +
+				", " +
+				std::to_string(camera.getRotation().y) +
+				", " +
+				std::to_string(camera.getRotation().z) + " }"
+			);
+		}
 	}
-	if (Keyboard::isKeyPressed(GLFW_KEY_2))
+
+	if (Keyboard::isKeyPressed(GLFW_KEY_F3))
 	{
-		drawBounds = !drawBounds;
+		drawOverlay = !drawOverlay;
 	}
-	if (Keyboard::isKeyPressed(GLFW_KEY_3))
+	if (Keyboard::isKeyPressed(GLFW_KEY_F12))
 	{
-		drawColliders = !drawColliders;
+		capture.requestScreenshot(findFreePath("screenshot", "png"));
 	}
-	if (Keyboard::isKeyPressed(GLFW_KEY_4))
+	if (Keyboard::isKeyPressed(GLFW_KEY_F9))
 	{
-		drawBones = !drawBones;
+		toggleTrace();
 	}
-
-	if (Keyboard::isKeyPressed(GLFW_KEY_F))
+	if (Keyboard::isKeyPressed(GLFW_KEY_F11) && !capture.isRecording())
 	{
-		wireframe = !wireframe;
-		if (wireframe)
-		{
-			glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
-		}
-		else
-		{
-			glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
-		}
-	}
-
-	if (Keyboard::isKeyPressed(GLFW_KEY_T))
-	{
-		Debug::log
-		(
-			"Camera Position : { " +
-			std::to_string(camera.getPosition().x) +
-			", " +
-			std::to_string(camera.getPosition().y) +
-			", " +
-			std::to_string(camera.getPosition().z) + " }"
-		);
-		Debug::log
-		(
-			"Camera Rotation : { " +
-			std::to_string(camera.getRotation().x) +
-			", " +
-			std::to_string(camera.getRotation().y) +
-			", " +
-			std::to_string(camera.getRotation().z) + " }"
-		);
+		startTurntable();
 	}
 
 	if (Keyboard::isKeyHeld(GLFW_KEY_KP_ADD))
@@ -235,10 +378,163 @@ void Application::update(float dt)
 		if (camera.getFieldOfView() > 120.0f)
 			camera.setFieldOfView(120.0f);
 	}
+
+	if (turntable)
+	{
+		updateTurntable();
+	}
+}
+
+void Application::toggleTrace()
+{
+	if (!Trace::isEnabled())
+	{
+		Trace::start();
+		return;
+	}
+
+	Trace::stop(TRACE_PATH.empty() ? findFreePath("trace", "json") : TRACE_PATH);
+	TRACE_PATH.clear();
+}
+
+void Application::showModel(Model* model, const std::string& name)
+{
+	// Picking the model on display again hands back the same one.
+	if (name == modelName)
+		return;
+
+	LOG_INFO(General, "Showing model: " + name);
+
+	models[0] = model;
+	content.unloadModel(modelName);
+
+	modelName = name;
+	Config::model = name;
+
+	glm::vec3 center = model->bounds_crn + model->bounds_size / 2.0f;
+	center.z = -center.z;
+
+	float radius = glm::length(model->bounds_size) / 2.0f;
+	if (radius <= 0.0f)
+		radius = 100.0f;
+
+	float distance = radius / std::sin(glm::radians(camera.getFieldOfView() / 2.0f));
+	camera.orbit(center, distance, BROWSER_VIEW_YAW, BROWSER_VIEW_PITCH);
+
+	buildPicker();
+}
+
+void Application::buildPicker()
+{
+	TRACE_ZONE("Application::buildPicker");
+
+	picker.clear();
+	collisionPicker.clear();
+	hasPick = false;
+
+	picker.addModel(modelName, *models[0]);
+	picker.addInstance(0, glm::mat4(1.0f));
+	picker.build();
+
+	if (!models[0]->collision.empty())
+	{
+		collisionPicker.addCollision(modelName, models[0]->collision);
+		collisionPicker.addInstance(0, glm::mat4(1.0f));
+		collisionPicker.build();
+	}
+}
+
+void Application::pick()
+{
+	// Same view as the frame is drawn with, the ray comes out in model space.
+	glm::mat4 view = glm::scale(camera.getViewMatrix(), glm::vec3(1.0f, 1.0f, -1.0f));
+	Ray ray = Picker::getRay(camera.getProjectionMatrix() * view, Mouse::getMousePosition(),
+		Config::windowResolutionX, Config::windowResolutionY);
+
+	// What is drawn is what gets picked, a model without collision has nothing to hit.
+	pickedCollision = drawCollision;
+	const Picker& source = pickedCollision ? collisionPicker : picker;
+
+	double start = glfwGetTime();
+	hasPick = source.pick(ray, picked);
+	double microseconds = (glfwGetTime() - start) * 1000000.0;
+
+	if (!hasPick)
+	{
+		LOG_INFO(General, "Picked nothing (" + std::to_string(microseconds) + " us)");
+		return;
+	}
+
+	if (pickedCollision)
+	{
+		LOG_INFO(General, "Picked " + source.getModelName(picked.model) +
+			" collision triangle " + std::to_string(picked.triangle) +
+			" at " + std::to_string(picked.distance) + " units (" + std::to_string(microseconds) + " us)");
+		return;
+	}
+
+	const std::string& component = picker.getComponentName(picked.model, picked.component);
+	LOG_INFO(General, "Picked " + picker.getModelName(picked.model) +
+		" component " + std::to_string(picked.component) + (component.empty() ? "" : " (" + component + ")") +
+		", mesh " + std::to_string(picked.mesh) +
+		", texture " + picker.getTexture(picked.model, picked.mesh) +
+		", triangle " + std::to_string(picked.triangle) +
+		" at " + std::to_string(picked.distance) + " units (" + std::to_string(microseconds) + " us)");
+}
+
+void Application::startTurntable()
+{
+	if (models.empty() || Config::turntableFrames == 0)
+		return;
+
+	if (!capture.startSequence(APPLICATION_PATH + "turntable", Config::turntableFrames, Config::captureEncoder))
+		return;
+
+	turntable = true;
+	turntablePosition = camera.getPosition();
+	turntableRotation = camera.getRotation();
+}
+
+void Application::updateTurntable()
+{
+	if (!capture.isRecording())
+	{
+		turntable = false;
+		camera.setPosition(turntablePosition);
+		camera.setRotation(turntableRotation);
+		return;
+	}
+
+	// Step by frame rather than time so every recorded frame is evenly spaced.
+	Model* model = models[0];
+	glm::vec3 center = model->bounds_crn + model->bounds_size / 2.0f;
+	center.z = -center.z;
+
+	float radius = glm::length(model->bounds_size) / 2.0f;
+	float distance = radius / std::sin(glm::radians(camera.getFieldOfView() / 2.0f));
+
+	float yaw = 90.0f + 360.0f * (float)capture.getSequenceFrame() / (float)capture.getSequenceLength();
+	camera.orbit(center, distance, yaw, TURNTABLE_PITCH);
 }
 
 void Application::render(Shader& shader)
 {
+	TRACE_ZONE("Application::render");
+
+	renderer.beginFrame();
+	gpuTimer.beginFrame();
+
+	// Thumbnails go into their atlas before the frame itself is drawn.
+	gpuTimer.begin(GpuPass::Thumbnails);
+
+	if (wireframe)
+		glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+
+	browser.generate(shader, Config::windowResolutionX, Config::windowResolutionY);
+
+	if (wireframe)
+		glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
+
 	renderer.clear(glm::vec4(Config::backgroundR, Config::backgroundG, Config::backgroundB, 1.0f));
 
 	// Display as a left-handed coordinate system.
@@ -251,6 +547,8 @@ void Application::render(Shader& shader)
 
 	glm::mat4 vpmatrix = projection * view;
 
+	gpuTimer.begin(GpuPass::Models);
+
 	shader.bind();
 	shader.setUniformMat4("VPMatrix", vpmatrix);
 
@@ -259,10 +557,7 @@ void Application::render(Shader& shader)
 		renderer.draw(*model, shader);
 	}
 
-	for (auto& label : labels)
-	{
-		label->draw(shader);
-	}
+	gpuTimer.begin(GpuPass::Grid);
 
 	basic->bind();
 	basic->setUniformMat4("VPMatrix", vpmatrix);
@@ -273,6 +568,8 @@ void Application::render(Shader& shader)
 		renderer.draw(*grid, *basic);
 	}
 
+	gpuTimer.begin(GpuPass::Overlays);
+
 	for (auto& model : models)
 	{
 		if (drawBounds)
@@ -300,7 +597,61 @@ void Application::render(Shader& shader)
 				renderer.drawSphere(bone.defaultPosition, 2.0f, glm::vec4(1, 1, 1, 1));
 			}
 		}
+
+		if (drawCollision)
+		{
+			model->drawCollision(*basic, glm::mat4(1.0f), glm::vec4(0, 1, 1, 0.35f));
+		}
 	}
 
+	if (hasPick)
+	{
+		const Picker& source = pickedCollision ? collisionPicker : picker;
+
+		glm::vec3 min;
+		glm::vec3 max;
+		source.getMeshBounds(picked, min, max);
+		renderer.drawHollowBox(min, max - min, glm::vec4(1, 1, 0, 1));
+
+		glm::vec3 corners[3];
+		if (source.getTriangle(picked, corners))
+		{
+			renderer.drawTriangle(corners[0], corners[1], corners[2], glm::vec4(1, 0, 1, 1));
+		}
+	}
+
+	gpuTimer.begin(GpuPass::Text);
+
+	shader.bind();
+	shader.setUniformMat4("VPMatrix", vpmatrix);
+
+	for (auto& label : labels)
+	{
+		label->draw(shader);
+	}
+
+	// Captured before the performance overlay so it never ends up in screenshots.
+	capture.captureFrame(Config::windowResolutionX, Config::windowResolutionY);
+
+	if (wireframe)
+		glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+
+	browser.draw(*basic, Config::windowResolutionX, Config::windowResolutionY);
+
+	if (drawOverlay)
+	{
+		overlay.draw(*basic, Config::windowResolutionX, Config::windowResolutionY);
+	}
+
+	if (wireframe)
+		glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
+
+	gpuTimer.end();
+
+	float cpuTime = static_cast<float>(glfwGetTime()) - frameStart;
+	overlay.addFrame(cpuTime * 1000.0f, frameTime * 1000.0f, gpuTimer, RenderStats::getCurrentFrame());
+	overlay.setMemory(content.getMemoryUsage());
+	RenderStats::endFrame();
+
 	renderer.render(window);
 }
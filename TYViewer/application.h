@@ -18,16 +18,27 @@
 #include "graphics/mesh.h"
 #include "graphics/texture.h"
 #include "graphics/text.h"
+#include "graphics/capture.h"
+#include "graphics/gputimer.h"
+#include "graphics/overlay.h"
+
+#include "browser/modelbrowser.h"
+
+#include "picking/picker.h"
 
 #include "grid.h"
 
 #include "config.h"
 
+#include "util/trace.h"
+
 class Application
 {
 public:
 	static std::string APPLICATION_PATH;
 	static std::string ARCHIVE_PATH;
+	// Where the trace is written when recording stops, numbered files if empty.
+	static std::string TRACE_PATH;
 
 public:
 	Application(GLFWwindow* window);
@@ -42,17 +53,55 @@ public:
 	void resize(int width, int height);
 
 private:
+	void toggleTrace();
+
+	// Replaces the model on display with one picked in the browser.
+	void showModel(Model* model, const std::string& name);
+
+	// Picks against the model on display, or its collision layer while that is drawn. Rebuilt whenever it changes.
+	void buildPicker();
+	void pick();
+
+	void startTurntable();
+	void updateTurntable();
+
 	bool drawGrid = true;
 	bool drawBounds = true;
 	bool drawColliders = true;
 	bool drawBones = true;
+	// Off by default, the translucent layer covers most of the model.
+	bool drawCollision = false;
+
+	bool drawOverlay = false;
 
 	bool wireframe = false;
 
+	// Start of the current frame and length of the previous one, in seconds.
+	float frameStart = 0.0f;
+	float frameTime = 0.0f;
+
+	bool turntable = false;
+	glm::vec3 turntablePosition;
+	glm::vec3 turntableRotation;
+
 	GLFWwindow* window;
 
 	Renderer renderer;
 	Camera camera;
+	FrameCapture capture;
+
+	GpuTimer gpuTimer;
+	PerformanceOverlay overlay;
+	ModelBrowser browser;
+
+	Picker picker;
+	Picker collisionPicker;
+	PickResult picked;
+	bool hasPick = false;
+	// Whether 'picked' came from collisionPicker.
+	bool pickedCollision = false;
+	// Mouse::isButtonPressed fires while held, clicks are found from this instead.
+	bool mouseWasDown = false;
 
 	Content content;
 
@@ -62,6 +111,8 @@ private:
 	Grid* grid;
 
 	std::vector<Model*> models;
+	// Entry of models[0], unloaded when another model is shown.
+	std::string modelName;
 	std::vector<Text*> labels;
 	Mesh* mesh;
 };
\ No newline at end of file
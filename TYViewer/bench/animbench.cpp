@@ -0,0 +1,489 @@
+#include "animbench.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <algorithm>
+
+#include "bench/loadbench.h"
+
+#include "loader/modelbuilder.h"
+
+#include "util/json.h"
+
+#include "config.h"
+#include "debug.h"
+#include "util/timing.h"
+#include "util/stringext.h"
+
+// Clips and actors are made from this seed, the same for every run and machine.
+#define ANIMATION_BENCHMARK_SEED 20261
+
+// One frame at 60 Hz.
+#define ANIMATION_BENCHMARK_STEP (1.0f / 60.0f)
+
+// Authored keys per second on average, spaced unevenly.
+#define ANIMATION_BENCHMARK_KEY_RATE 30.0f
+// Share of bones that hold still, their tracks are stored once.
+#define ANIMATION_BENCHMARK_STILL_BONES 0.25f
+
+// Largest quantization errors --verify accepts on frames, in degrees and relative to the model size.
+// Errors between frames depend on the sample rate and are only reported.
+#define ANIMATION_BENCHMARK_MAX_ROTATION_ERROR 0.05f
+#define ANIMATION_BENCHMARK_MAX_TRANSLATION_ERROR 1e-4f
+// Between SSE and scalar skinning, relative to the position.
+#define ANIMATION_BENCHMARK_MAX_SKIN_ERROR 1e-4f
+
+bool AnimationBenchmark::isRequested(int argc, char* argv[])
+{
+	for (int i = 1; i < argc; i++)
+	{
+		if (std::string(argv[i]) == "--bench-anim")
+			return true;
+	}
+	return false;
+}
+
+bool AnimationBenchmark::parseArguments(int argc, char* argv[], AnimationBenchmarkOptions& options)
+{
+	for (int i = 1; i < argc; i++)
+	{
+		std::string argument = argv[i];
+		bool hasValue = i + 1 < argc;
+
+		if (argument == "--bench-anim" && hasValue)
+		{
+			splitList(argv[++i], options.models);
+		}
+		else if (argument == "--trace" && hasValue)
+		{
+			// Handled before the benchmark starts.
+			i++;
+		}
+		else if (argument == "--archive" && hasValue)
+		{
+			options.archive = argv[++i];
+		}
+		else if (argument == "--json" && hasValue)
+		{
+			options.json = argv[++i];
+		}
+		else if (argument == "--actors" && hasValue)
+		{
+			options.actors = std::atoi(argv[++i]);
+			if (options.actors <= 0)
+				return false;
+		}
+		else if (argument == "--frames" && hasValue)
+		{
+			options.frames = std::atoi(argv[++i]);
+			if (options.frames <= 0)
+				return false;
+		}
+		else if (argument == "--clips" && hasValue)
+		{
+			options.clips = std::atoi(argv[++i]);
+			if (options.clips <= 0)
+				return false;
+		}
+		else if (argument == "--threads" && hasValue)
+		{
+			int threads = std::atoi(argv[++i]);
+			if (threads <= 0)
+				return false;
+			options.threads = static_cast<unsigned int>(threads);
+		}
+		else if (argument == "--verify")
+		{
+			options.verify = true;
+		}
+		else if (argument.size() > 2 && argument.compare(0, 2, "--") == 0)
+		{
+			return false;
+		}
+		else
+		{
+			splitList(argument, options.models);
+		}
+	}
+
+	return !options.models.empty();
+}
+
+void AnimationBenchmark::printUsage()
+{
+	std::cout <<
+		"Usage: TYViewer --bench-anim <model>[,<model>...] [options]" << std::endl <<
+		"  --actors <n>       Actors playing at once, sharing the models in turn (default: 256)" << std::endl <<
+		"  --frames <n>       Frames of 1/60 s to measure (default: 300)" << std::endl <<
+		"  --clips <n>        Clips made for each model (default: 4)" << std::endl <<
+		"  --threads <n>      Threads posing and skinning (default: one per core)" << std::endl <<
+		"  --verify           Check quantized clips and SSE skinning, fails past their tolerances" << std::endl <<
+		"  --archive <path>   Archive to load models from (default: config.cfg)" << std::endl <<
+		"  --json <file>      Write timings and skinned vertices per second as JSON" << std::endl <<
+		"  --trace <file>     Record a Chrome trace of the run" << std::endl;
+}
+
+AnimationBenchmark::AnimationBenchmark(const AnimationBenchmarkOptions& options) :
+	options(options)
+{}
+
+int AnimationBenchmark::run()
+{
+	if (!loadModels())
+		return -1;
+
+	std::mt19937 random(ANIMATION_BENCHMARK_SEED);
+	std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+	size_t clipCount = models.size() * options.clips;
+	clips.resize(clipCount);
+	quantized.resize(clipCount);
+
+	size_t keyframeBytes = 0;
+	size_t quantizedBytes = 0;
+	size_t tracks = 0;
+	size_t animatedTracks = 0;
+
+	for (size_t model = 0; model < models.size(); model++)
+	{
+		for (int clip = 0; clip < options.clips; clip++)
+		{
+			size_t index = model * options.clips + clip;
+			makeClip(models[model].bones, sizes[model], ANIMATION_BENCHMARK_SEED + static_cast<unsigned int>(index), 1.0f + 0.5f * clip, clips[index]);
+			clips[index].name = options.models[model] + "#" + std::to_string(clip);
+			quantized[index].build(clips[index]);
+
+			keyframeBytes += clips[index].getBytes();
+			quantizedBytes += quantized[index].getBytes();
+			tracks += quantized[index].getBoneCount() * 2;
+			animatedTracks += quantized[index].getAnimatedTrackCount();
+		}
+	}
+
+	printf("Clips: %zu, keyframes %.1f KB, quantized %.1f KB (%.1fx smaller), %zu of %zu tracks animated\n", clipCount,
+		keyframeBytes / 1024.0, quantizedBytes / 1024.0, quantizedBytes > 0 ? (double)keyframeBytes / quantizedBytes : 0.0, animatedTracks, tracks);
+
+	Animator animator(options.threads);
+	for (int actor = 0; actor < options.actors; actor++)
+	{
+		size_t model = actor % models.size();
+		size_t clip = model * options.clips + (actor / models.size()) % options.clips;
+
+		animator.addActor(models[model], quantized[clip], unit(random) * quantized[clip].getDuration(), 0.8f + 0.4f * unit(random));
+	}
+
+	printf("Actors: %zu on %u threads, %zu vertices skinned per frame\n", animator.getActorCount(), animator.getThreads(), animator.getVertexCount());
+	fflush(stdout);
+
+	// Sizes every output buffer before measuring.
+	animator.update(0.0f);
+	animator.skin();
+
+	std::vector<double> updates;
+	std::vector<double> skins;
+	updates.reserve(options.frames);
+	skins.reserve(options.frames);
+
+	double skinTotal = 0.0;
+	for (int frame = 0; frame < options.frames; frame++)
+	{
+		auto start = std::chrono::high_resolution_clock::now();
+		animator.update(ANIMATION_BENCHMARK_STEP);
+		updates.push_back(millisecondsSince(start));
+
+		start = std::chrono::high_resolution_clock::now();
+		animator.skin();
+		skins.push_back(millisecondsSince(start));
+		skinTotal += skins.back();
+	}
+
+	double verticesPerSecond = skinTotal > 0.0 ? animator.getVertexCount() * (double)options.frames / (skinTotal / 1000.0) : 0.0;
+
+	// One thread, to show what SSE and the workers each add.
+	int singleFrames = std::max(1, std::min(options.frames, 30));
+	double simdVerticesPerSecond = measureSingleThread(animator, false, singleFrames);
+	double scalarVerticesPerSecond = measureSingleThread(animator, true, singleFrames);
+
+	LoadPercentiles update = LoadBenchmark::getPercentiles(updates);
+	LoadPercentiles skin = LoadBenchmark::getPercentiles(skins);
+
+	printf("Update ms: p50 %.3f, p90 %.3f, p99 %.3f, mean %.3f\n", update.p50, update.p90, update.p99, update.mean);
+	printf("Skin ms:   p50 %.3f, p90 %.3f, p99 %.3f, mean %.3f\n", skin.p50, skin.p90, skin.p99, skin.mean);
+	printf("Skinned vertices/s: %.1f M on %u threads, %.1f M SSE on one, %.1f M scalar on one\n",
+		verticesPerSecond / 1e6, animator.getThreads(), simdVerticesPerSecond / 1e6, scalarVerticesPerSecond / 1e6);
+
+	AnimationErrors errors;
+	bool failed = false;
+
+	if (options.verify)
+	{
+		measureQuantization(errors);
+		measureSkinning(animator, errors);
+
+		printf("Quantization error: %.4f degrees, %.6f of model size on frames; %.4f degrees, %.6f between them\n",
+			errors.rotation, errors.translation, errors.resampledRotation, errors.resampledTranslation);
+		printf("SSE against scalar skinning: %.2e\n", errors.skin);
+
+		if (errors.rotation > ANIMATION_BENCHMARK_MAX_ROTATION_ERROR || errors.translation > ANIMATION_BENCHMARK_MAX_TRANSLATION_ERROR)
+		{
+			LOG_ERROR(General, "Quantized clips differ from their keyframes by more than the tolerance");
+			failed = true;
+		}
+		if (errors.skin > ANIMATION_BENCHMARK_MAX_SKIN_ERROR)
+		{
+			LOG_ERROR(General, "SSE skinning differs from the scalar path by " + std::to_string(errors.skin));
+			failed = true;
+		}
+	}
+	fflush(stdout);
+
+	if (!options.json.empty() && !writeJSON(animator, updates, skins, verticesPerSecond, simdVerticesPerSecond, scalarVerticesPerSecond,
+		errors, failed))
+	{
+		LOG_ERROR(General, "Failed to write animation benchmark results: " + options.json);
+		return -1;
+	}
+
+	return failed ? 1 : 0;
+}
+
+void AnimationBenchmark::makeClip(const std::vector<Bone>& bones, float size, unsigned int seed, float duration, AnimationClip& clip)
+{
+	std::mt19937 random(seed);
+	std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+	const float tau = 6.28318531f;
+
+	clip.duration = duration;
+	clip.tracks.assign(bones.size(), BoneTrack());
+
+	for (auto& track : clip.tracks)
+	{
+		bool still = unit(random) < ANIMATION_BENCHMARK_STILL_BONES;
+
+		glm::vec3 axis(unit(random) * 2.0f - 1.0f, unit(random) * 2.0f - 1.0f, unit(random) * 2.0f - 1.0f);
+		axis = glm::dot(axis, axis) > 1e-6f ? glm::normalize(axis) : glm::vec3(0.0f, 1.0f, 0.0f);
+
+		float amplitude = still ? 0.0f : glm::radians(5.0f + 15.0f * unit(random));
+		float lift = still ? 0.0f : size * 0.02f * unit(random);
+		float phase = unit(random) * tau;
+		// Whole cycles over the clip, so it loops without a jump.
+		float cycles = static_cast<float>(1 + random() % 2);
+
+		for (float time = 0.0f; ; time += (0.5f + unit(random)) / ANIMATION_BENCHMARK_KEY_RATE)
+		{
+			time = std::min(time, duration);
+
+			float wave = std::sin(tau * cycles * time / duration + phase);
+			float angle = amplitude * wave;
+
+			track.times.push_back(time);
+			track.translations.push_back(glm::vec3(0.0f, lift * wave, 0.0f));
+			track.rotations.push_back(glm::vec4(axis * std::sin(angle / 2.0f), std::cos(angle / 2.0f)));
+
+			if (time >= duration)
+				break;
+		}
+	}
+}
+
+bool AnimationBenchmark::loadModels()
+{
+	archivePath = options.archive.empty() ? Config::archive : options.archive;
+	if (archivePath.empty())
+	{
+		LOG_ERROR(General, "No archive specified, use --archive or config.cfg");
+		return false;
+	}
+
+	if (!archive.load(archivePath))
+	{
+		LOG_ERROR(General, "Failed to load archive: " + archivePath);
+		return false;
+	}
+
+	// Loaders log per file, keep that out of the measurements.
+	Debug::setLevel(Debug::Level::Warning);
+
+	for (auto& name : options.models)
+	{
+		ModelData data;
+		if (!ModelBuilder::build(archive, name, data))
+		{
+			LOG_ERROR(General, "Failed to load model: " + name + " (" + data.error + ")");
+			return false;
+		}
+
+		if (data.bones.empty())
+		{
+			LOG_WARNING(General, name + " has no bones, it is skinned by the identity");
+		}
+
+		SkinnedModel model;
+		model.build(data.vertices, data.bones);
+
+		printf("%s: %zu vertices, %zu bones\n", name.c_str(), model.vertices.size(), model.bones.size());
+
+		models.push_back(std::move(model));
+		sizes.push_back(std::max(glm::length(data.boundsSize), 1.0f));
+	}
+	fflush(stdout);
+
+	return true;
+}
+
+void AnimationBenchmark::measureQuantization(AnimationErrors& errors) const
+{
+	std::vector<BonePose> expected;
+	std::vector<BonePose> actual;
+
+	for (size_t i = 0; i < clips.size(); i++)
+	{
+		const AnimationClip& clip = clips[i];
+		const QuantizedClip& quantizedClip = quantized[i];
+		float size = sizes[i / options.clips];
+
+		expected.assign(clip.tracks.size(), BonePose());
+		actual.assign(clip.tracks.size(), BonePose());
+
+		// Four samples per frame, the first of each on the frame.
+		size_t samples = (quantizedClip.getFrameCount() - 1) * 4;
+		for (size_t sample = 0; sample <= samples; sample++)
+		{
+			float time = samples > 0 ? clip.duration * sample / samples : 0.0f;
+			clip.sample(time, expected.data());
+			quantizedClip.sample(time, actual.data());
+
+			bool onFrame = sample % 4 == 0;
+			float& rotation = onFrame ? errors.rotation : errors.resampledRotation;
+			float& translation = onFrame ? errors.translation : errors.resampledTranslation;
+
+			for (size_t bone = 0; bone < expected.size(); bone++)
+			{
+				// From the chord between the two, acos of their dot product loses small angles to rounding.
+				const glm::vec4& a = expected[bone].rotation;
+				const glm::vec4& b = actual[bone].rotation;
+				glm::vec4 chord = glm::dot(a, b) < 0.0f ? a + b : a - b;
+				float angle = 4.0f * std::asin(std::min(std::sqrt(glm::dot(chord, chord)) / 2.0f, 1.0f));
+				rotation = std::max(rotation, glm::degrees(angle));
+				translation = std::max(translation, glm::length(expected[bone].translation - actual[bone].translation) / size);
+			}
+		}
+	}
+}
+
+void AnimationBenchmark::measureSkinning(const Animator& animator, AnimationErrors& errors) const
+{
+	std::vector<SkinnedVertex> expected;
+
+	for (size_t actor = 0; actor < animator.getActorCount(); actor++)
+	{
+		const SkinnedModel& model = models[actor % models.size()];
+		const std::vector<SkinnedVertex>& actual = animator.getVertices(actor);
+
+		expected.resize(model.vertices.size());
+		Skinning::skinScalar(model.vertices.data(), model.vertices.size(), animator.getPalette(actor).data(), expected.data());
+
+		for (size_t i = 0; i < expected.size(); i++)
+		{
+			for (int axis = 0; axis < 3; axis++)
+			{
+				float difference = std::abs(expected[i].position[axis] - actual[i].position[axis]);
+				errors.skin = std::max(errors.skin, difference / std::max(1.0f, std::abs(expected[i].position[axis])));
+			}
+		}
+	}
+}
+
+double AnimationBenchmark::measureSingleThread(const Animator& animator, bool scalar, int frames) const
+{
+	size_t largest = 0;
+	for (auto& model : models)
+	{
+		largest = std::max(largest, model.vertices.size());
+	}
+	std::vector<SkinnedVertex> output(largest);
+
+	auto start = std::chrono::high_resolution_clock::now();
+	for (int frame = 0; frame < frames; frame++)
+	{
+		for (size_t actor = 0; actor < animator.getActorCount(); actor++)
+		{
+			const SkinnedModel& model = models[actor % models.size()];
+			if (scalar)
+				Skinning::skinScalar(model.vertices.data(), model.vertices.size(), animator.getPalette(actor).data(), output.data());
+			else
+				Skinning::skin(model.vertices.data(), model.vertices.size(), animator.getPalette(actor).data(), output.data());
+		}
+	}
+	double milliseconds = millisecondsSince(start);
+
+	return milliseconds > 0.0 ? animator.getVertexCount() * (double)frames / (milliseconds / 1000.0) : 0.0;
+}
+
+bool AnimationBenchmark::writeJSON(const Animator& animator, const std::vector<double>& updates, const std::vector<double>& skins,
+	double verticesPerSecond, double simdVerticesPerSecond, double scalarVerticesPerSecond,
+	const AnimationErrors& errors, bool failed) const
+{
+	std::ofstream stream(options.json, std::ios::out | std::ios::trunc);
+	if (stream.fail())
+		return false;
+
+	LoadPercentiles update = LoadBenchmark::getPercentiles(updates);
+	LoadPercentiles skin = LoadBenchmark::getPercentiles(skins);
+
+	size_t quantizedBytes = 0;
+	size_t keyframeBytes = 0;
+	for (size_t i = 0; i < clips.size(); i++)
+	{
+		keyframeBytes += clips[i].getBytes();
+		quantizedBytes += quantized[i].getBytes();
+	}
+
+	stream << std::fixed << std::setprecision(4);
+	stream << "{" << std::endl;
+	stream << "\t\"archive\": \"" << Json::escape(archivePath) << "\"," << std::endl;
+
+	stream << "\t\"models\": [";
+	for (size_t i = 0; i < options.models.size(); i++)
+	{
+		stream << (i > 0 ? ", " : "") << "\"" << Json::escape(options.models[i]) << "\"";
+	}
+	stream << "]," << std::endl;
+
+	stream << "\t\"actors\": " << animator.getActorCount() << "," << std::endl;
+	stream << "\t\"threads\": " << animator.getThreads() << "," << std::endl;
+	stream << "\t\"frames\": " << options.frames << "," << std::endl;
+	stream << "\t\"verticesPerFrame\": " << animator.getVertexCount() << "," << std::endl;
+	stream << "\t\"clips\": " << clips.size() << "," << std::endl;
+	stream << "\t\"keyframeBytes\": " << keyframeBytes << "," << std::endl;
+	stream << "\t\"quantizedBytes\": " << quantizedBytes << "," << std::endl;
+	stream << "\t\"updateMilliseconds\": { \"p50\": " << update.p50 << ", \"p90\": " << update.p90 << ", \"p99\": " << update.p99 <<
+		", \"mean\": " << update.mean << ", \"min\": " << update.min << ", \"max\": " << update.max << " }," << std::endl;
+	stream << "\t\"skinMilliseconds\": { \"p50\": " << skin.p50 << ", \"p90\": " << skin.p90 << ", \"p99\": " << skin.p99 <<
+		", \"mean\": " << skin.mean << ", \"min\": " << skin.min << ", \"max\": " << skin.max << " }," << std::endl;
+	stream << "\t\"verticesPerSecond\": " << verticesPerSecond << "," << std::endl;
+	stream << "\t\"simdVerticesPerSecond\": " << simdVerticesPerSecond << "," << std::endl;
+	stream << "\t\"scalarVerticesPerSecond\": " << scalarVerticesPerSecond << "," << std::endl;
+
+	if (options.verify)
+	{
+		stream << std::setprecision(6);
+		stream << "\t\"rotationErrorDegrees\": " << errors.rotation << "," << std::endl;
+		stream << "\t\"translationError\": " << errors.translation << "," << std::endl;
+		stream << "\t\"resampledRotationErrorDegrees\": " << errors.resampledRotation << "," << std::endl;
+		stream << "\t\"resampledTranslationError\": " << errors.resampledTranslation << "," << std::endl;
+		stream << "\t\"skinError\": " << errors.skin << "," << std::endl;
+	}
+
+	stream << "\t\"failed\": " << (failed ? "true" : "false") << std::endl;
+	stream << "}" << std::endl;
+
+	return true;
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "loader/archive.h"
+#include "loader/modeldata.h"
+
+#include "animation/clip.h"
+#include "animation/skinning.h"
+#include "animation/animator.h"
+
+struct AnimationBenchmarkOptions
+{
+	std::vector<std::string> models;
+
+	std::string archive;
+	std::string json;
+
+	// Actors share the models and their clips in turn, each starting at its own time.
+	int actors = 256;
+	int frames = 300;
+
+	// Clips made for each model.
+	int clips = 4;
+
+	// Threads posing and skinning, 0 uses every core.
+	unsigned int threads = 0;
+
+	// Checks quantized clips against their keyframes and SSE skinning against the scalar path.
+	bool verify = false;
+};
+
+// Largest differences found by --verify.
+struct AnimationErrors
+{
+	// Quantized keys against the keyframes at the same time, in degrees and relative to the model size.
+	float rotation = 0.0f;
+	float translation = 0.0f;
+
+	// Between frames, where the resampled clip cuts across keys it did not land on.
+	float resampledRotation = 0.0f;
+	float resampledTranslation = 0.0f;
+
+	// SSE against scalar skinned positions, relative to the position.
+	float skin = 0.0f;
+};
+
+// Plays clips on many actors at once and measures posing and CPU skinning, no GPU needed.
+// The archive's animation files are not decoded yet, clips are made from seeded noise over each model's bones.
+// Usage: TYViewer --bench-anim <model>[,<model>...] [options]
+class AnimationBenchmark
+{
+public:
+	static bool isRequested(int argc, char* argv[]);
+	static bool parseArguments(int argc, char* argv[], AnimationBenchmarkOptions& options);
+	static void printUsage();
+
+	AnimationBenchmark(const AnimationBenchmarkOptions& options);
+
+	int run();
+
+	// Keys at uneven times, as authored clips have them, looping smoothly over 'duration'.
+	static void makeClip(const std::vector<Bone>& bones, float size, unsigned int seed, float duration, AnimationClip& clip);
+
+private:
+	bool loadModels();
+
+	// Samples every quantized clip against its keyframes, on and between its frames.
+	void measureQuantization(AnimationErrors& errors) const;
+	// Skins every actor with the scalar path and compares.
+	void measureSkinning(const Animator& animator, AnimationErrors& errors) const;
+
+	// Skins every actor on the calling thread, the vertices per second of 'frames' frames.
+	double measureSingleThread(const Animator& animator, bool scalar, int frames) const;
+
+	bool writeJSON(const Animator& animator, const std::vector<double>& updates, const std::vector<double>& skins,
+		double verticesPerSecond, double simdVerticesPerSecond, double scalarVerticesPerSecond,
+		const AnimationErrors& errors, bool failed) const;
+
+	AnimationBenchmarkOptions options;
+
+	Archive archive;
+	std::string archivePath;
+
+	std::vector<SkinnedModel> models;
+	// Length of each model's bounds, what translations are scaled by.
+	std::vector<float> sizes;
+	// options.clips per model, in model order.
+	std::vector<AnimationClip> clips;
+	std::vector<QuantizedClip> quantized;
+};
@@ -0,0 +1,339 @@
+#include "benchmark.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <algorithm>
+
+#include "debug.h"
+
+#include "util/json.h"
+
+// Calibration grows the batch until one batch takes at least this long.
+#define BENCHMARK_MIN_BATCH_SECONDS 0.001
+
+const void* volatile benchmarkSink = nullptr;
+
+double BenchmarkResult::getBytesPerSecond() const
+{
+	return medianNs > 0.0 ? bytes / (medianNs / 1e9) : 0.0;
+}
+
+double BenchmarkResult::getItemsPerSecond() const
+{
+	return medianNs > 0.0 ? items / (medianNs / 1e9) : 0.0;
+}
+
+BenchmarkState::BenchmarkState(const BenchmarkSettings& settings, BenchmarkResult& result) :
+	settings(settings),
+	result(result),
+	started(false),
+	calibrated(false),
+	batchSize(1),
+	remaining(0),
+	measuredSeconds(0.0)
+{}
+
+bool BenchmarkState::keepRunning()
+{
+	if (remaining > 0)
+	{
+		remaining--;
+		return true;
+	}
+
+	Clock::time_point now = Clock::now();
+
+	if (started)
+	{
+		double elapsed = std::chrono::duration<double>(now - batchStart).count();
+
+		if (!calibrated)
+		{
+			// Aim for batches long enough to time accurately, spread over the minimum sample count.
+			double target = std::max(BENCHMARK_MIN_BATCH_SECONDS, settings.minSeconds / settings.minSamples);
+			if (elapsed < target)
+			{
+				double scale = elapsed > 0.0 ? target / elapsed : 10.0;
+				batchSize = static_cast<uint64_t>(std::ceil(batchSize * std::min(scale * 1.2, 10.0)));
+			}
+			else
+			{
+				calibrated = true;
+			}
+		}
+		else
+		{
+			result.samples.push_back(elapsed * 1e9 / batchSize);
+			result.iterations += batchSize;
+			measuredSeconds += elapsed;
+
+			bool enough = result.samples.size() >= settings.minSamples && measuredSeconds >= settings.minSeconds;
+			if (enough || result.samples.size() >= settings.maxSamples)
+				return false;
+		}
+	}
+
+	started = true;
+	remaining = batchSize - 1;
+	batchStart = Clock::now();
+	return true;
+}
+
+void BenchmarkState::setBytesProcessed(size_t bytes)
+{
+	result.bytes = bytes;
+}
+
+void BenchmarkState::setItemsProcessed(size_t items, const char* label)
+{
+	result.items = items;
+	result.itemLabel = label;
+}
+
+void BenchmarkState::skip(const std::string& reason)
+{
+	result.skipped = true;
+	result.reason = reason;
+}
+
+const BenchmarkSettings& BenchmarkState::getSettings() const
+{
+	return settings;
+}
+
+bool Benchmark::isRequested(int argc, char* argv[])
+{
+	for (int i = 1; i < argc; i++)
+	{
+		if (std::string(argv[i]) == "--bench-parsers")
+			return true;
+	}
+	return false;
+}
+
+bool Benchmark::parseArguments(int argc, char* argv[], BenchmarkSettings& settings)
+{
+	for (int i = 1; i < argc; i++)
+	{
+		std::string argument = argv[i];
+		bool hasValue = i + 1 < argc;
+
+		if (argument == "--bench-parsers")
+		{
+			continue;
+		}
+		else if (argument == "--trace" && hasValue)
+		{
+			// Handled before benchmarks start.
+			i++;
+		}
+		else if (argument == "--filter" && hasValue)
+		{
+			settings.filter = argv[++i];
+		}
+		else if (argument == "--min-time" && hasValue)
+		{
+			settings.minSeconds = std::atof(argv[++i]);
+			if (settings.minSeconds <= 0.0)
+				return false;
+		}
+		else if (argument == "--inputs" && hasValue)
+		{
+			settings.inputs = argv[++i];
+		}
+		else if (argument == "--archive" && hasValue)
+		{
+			settings.archive = argv[++i];
+		}
+		else if (argument == "--json" && hasValue)
+		{
+			settings.json = argv[++i];
+		}
+		else
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void Benchmark::printUsage()
+{
+	std::cout <<
+		"Usage: TYViewer --bench-parsers [options]" << std::endl <<
+		"  --filter <text>    Only run benchmarks whose name contains <text>" << std::endl <<
+		"  --min-time <s>     Minimum measuring time per benchmark (default: 0.5)" << std::endl <<
+		"  --inputs <dir>     Directory with .mdl/.mdg pairs (default: TEST_FILES)" << std::endl <<
+		"  --archive <path>   Also benchmark a real archive" << std::endl <<
+		"  --json <file>      Write results as JSON" << std::endl;
+}
+
+int Benchmark::run(const BenchmarkSettings& settings)
+{
+	// Loaders log per file, keep that out of the measurements.
+	Debug::setLevel(Debug::Level::Warning);
+
+	std::vector<BenchmarkResult> results = runAll(settings);
+
+	if (!settings.json.empty() && !writeJSON(settings.json, results))
+	{
+		LOG_ERROR(General, "Failed to write benchmark results: " + settings.json);
+		return -1;
+	}
+
+	return 0;
+}
+
+bool Benchmark::add(const char* name, Function function)
+{
+	getCases().push_back({ name, function });
+	return true;
+}
+
+std::vector<Benchmark::Case>& Benchmark::getCases()
+{
+	static std::vector<Case> cases;
+	return cases;
+}
+
+std::vector<BenchmarkResult> Benchmark::runAll(const BenchmarkSettings& settings)
+{
+	std::vector<Case> cases = getCases();
+	std::sort(cases.begin(), cases.end(), [](const Case& a, const Case& b) { return std::string(a.name) < b.name; });
+
+	std::vector<BenchmarkResult> results;
+	for (auto& benchmarkCase : cases)
+	{
+		if (!settings.filter.empty() && std::string(benchmarkCase.name).find(settings.filter) == std::string::npos)
+			continue;
+
+		BenchmarkResult result;
+		result.name = benchmarkCase.name;
+
+		BenchmarkState state(settings, result);
+		benchmarkCase.function(state);
+
+		if (!result.skipped && result.samples.empty())
+		{
+			result.skipped = true;
+			result.reason = "no samples";
+		}
+
+		if (!result.skipped)
+		{
+			std::vector<double> sorted = result.samples;
+			std::sort(sorted.begin(), sorted.end());
+
+			double sum = 0.0;
+			for (double sample : sorted)
+			{
+				sum += sample;
+			}
+			result.meanNs = sum / sorted.size();
+			result.minNs = sorted.front();
+			result.medianNs = sorted.size() % 2 == 1 ?
+				sorted[sorted.size() / 2] :
+				(sorted[sorted.size() / 2 - 1] + sorted[sorted.size() / 2]) / 2.0;
+
+			double variance = 0.0;
+			for (double sample : sorted)
+			{
+				variance += (sample - result.meanNs) * (sample - result.meanNs);
+			}
+			result.stddevNs = sorted.size() > 1 ? std::sqrt(variance / (sorted.size() - 1)) : 0.0;
+		}
+
+		results.push_back(result);
+		print({ result });
+	}
+
+	return results;
+}
+
+std::string Benchmark::formatTime(double nanoseconds)
+{
+	char buffer[32];
+	if (nanoseconds >= 1e9)
+		snprintf(buffer, sizeof(buffer), "%.2f s", nanoseconds / 1e9);
+	else if (nanoseconds >= 1e6)
+		snprintf(buffer, sizeof(buffer), "%.2f ms", nanoseconds / 1e6);
+	else if (nanoseconds >= 1e3)
+		snprintf(buffer, sizeof(buffer), "%.2f us", nanoseconds / 1e3);
+	else
+		snprintf(buffer, sizeof(buffer), "%.1f ns", nanoseconds);
+	return buffer;
+}
+
+void Benchmark::print(const std::vector<BenchmarkResult>& results)
+{
+	for (auto& result : results)
+	{
+		if (result.skipped)
+		{
+			printf("%-40s skipped: %s\n", result.name.c_str(), result.reason.c_str());
+			continue;
+		}
+
+		printf("%-40s %12s  +-%5.1f%%  %10zu it", result.name.c_str(), formatTime(result.medianNs).c_str(),
+			result.meanNs > 0.0 ? result.stddevNs / result.meanNs * 100.0 : 0.0, result.iterations);
+
+		if (result.bytes > 0)
+			printf("  %10.1f MB/s", result.getBytesPerSecond() / (1024.0 * 1024.0));
+		if (result.items > 0)
+			printf("  %10.2f M %s/s", result.getItemsPerSecond() / 1e6, result.itemLabel.c_str());
+
+		printf("\n");
+	}
+	fflush(stdout);
+}
+
+bool Benchmark::writeJSON(const std::string& path, const std::vector<BenchmarkResult>& results)
+{
+	std::ofstream stream(path, std::ios::out | std::ios::trunc);
+	if (stream.fail())
+		return false;
+
+	stream << std::setprecision(10);
+	stream << "{" << std::endl;
+	stream << "\t\"benchmarks\": [" << std::endl;
+
+	for (size_t i = 0; i < results.size(); i++)
+	{
+		const BenchmarkResult& result = results[i];
+
+		stream << "\t\t{ \"name\": \"" << Json::escape(result.name) << "\"";
+		if (result.skipped)
+		{
+			stream << ", \"skipped\": true, \"reason\": \"" << Json::escape(result.reason) << "\" }";
+		}
+		else
+		{
+			stream << ", \"iterations\": " << result.iterations;
+			stream << ", \"medianNs\": " << result.medianNs;
+			stream << ", \"meanNs\": " << result.meanNs;
+			stream << ", \"minNs\": " << result.minNs;
+			stream << ", \"stddevNs\": " << result.stddevNs;
+			stream << ", \"bytesPerSecond\": " << result.getBytesPerSecond();
+			stream << ", \"itemsPerSecond\": " << result.getItemsPerSecond();
+			stream << ", \"itemLabel\": \"" << Json::escape(result.itemLabel) << "\"";
+
+			stream << ", \"samples\": [";
+			for (size_t j = 0; j < result.samples.size(); j++)
+			{
+				stream << (j > 0 ? ", " : "") << result.samples[j];
+			}
+			stream << "] }";
+		}
+		stream << (i + 1 < results.size() ? "," : "") << std::endl;
+	}
+
+	stream << "\t]" << std::endl;
+	stream << "}" << std::endl;
+
+	return !stream.fail();
+}
@@ -0,0 +1,139 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdint>
+
+// Small benchmark harness in the style of Google Benchmark.
+// Setup goes before the loop, only the loop body is timed:
+//
+//	BENCHMARK_CASE(Example)
+//	{
+//		std::vector<char> input = ...;
+//		while (state.keepRunning())
+//		{
+//			parse(input);
+//		}
+//		state.setBytesProcessed(input.size());
+//	}
+
+struct BenchmarkSettings
+{
+	// Minimum time spent measuring a case, after calibration.
+	double minSeconds = 0.5;
+	unsigned int minSamples = 10;
+	unsigned int maxSamples = 100;
+
+	// Only cases whose name contains this run.
+	std::string filter;
+
+	// Inputs the cases read from, real game files where available.
+	std::string inputs = "TEST_FILES";
+	std::string archive;
+
+	std::string json;
+};
+
+struct BenchmarkResult
+{
+	std::string name;
+
+	bool skipped = false;
+	std::string reason;
+
+	size_t iterations = 0;
+
+	// Per-iteration times of each sample, in nanoseconds.
+	std::vector<double> samples;
+
+	double meanNs = 0.0;
+	double medianNs = 0.0;
+	double minNs = 0.0;
+	double stddevNs = 0.0;
+
+	// Per iteration, as reported by the case.
+	size_t bytes = 0;
+	size_t items = 0;
+	std::string itemLabel;
+
+	double getBytesPerSecond() const;
+	double getItemsPerSecond() const;
+};
+
+class BenchmarkState
+{
+public:
+	BenchmarkState(const BenchmarkSettings& settings, BenchmarkResult& result);
+
+	bool keepRunning();
+
+	void setBytesProcessed(size_t bytes);
+	void setItemsProcessed(size_t items, const char* label);
+
+	// Marks the case as not runnable, e.g. missing input files.
+	void skip(const std::string& reason);
+
+	const BenchmarkSettings& getSettings() const;
+
+private:
+	typedef std::chrono::high_resolution_clock Clock;
+
+	const BenchmarkSettings& settings;
+	BenchmarkResult& result;
+
+	bool started;
+	bool calibrated;
+
+	uint64_t batchSize;
+	uint64_t remaining;
+
+	Clock::time_point batchStart;
+	double measuredSeconds;
+};
+
+class Benchmark
+{
+public:
+	typedef void(*Function)(BenchmarkState& state);
+
+	// Usage: TYViewer --bench-parsers [options]
+	static bool isRequested(int argc, char* argv[]);
+	static bool parseArguments(int argc, char* argv[], BenchmarkSettings& settings);
+	static void printUsage();
+
+	static int run(const BenchmarkSettings& settings);
+
+	static bool add(const char* name, Function function);
+
+	static std::vector<BenchmarkResult> runAll(const BenchmarkSettings& settings);
+
+	static void print(const std::vector<BenchmarkResult>& results);
+	static std::string formatTime(double nanoseconds);
+	static bool writeJSON(const std::string& path, const std::vector<BenchmarkResult>& results);
+
+private:
+	struct Case
+	{
+		const char* name;
+		Function function;
+	};
+
+	// Function-local so registration from other translation units is order independent.
+	static std::vector<Case>& getCases();
+};
+
+// What doNotOptimize stores to. The pointer itself is volatile, so the store can't be dropped.
+extern const void* volatile benchmarkSink;
+
+// Stops the optimizer from discarding a result that is never used.
+template<typename T>
+inline void doNotOptimize(const T& value)
+{
+	benchmarkSink = &value;
+}
+
+#define BENCHMARK_CASE(name) \
+	static void name(BenchmarkState& state); \
+	static const bool name##Registered = Benchmark::add(#name, name); \
+	static void name(BenchmarkState& state)
@@ -0,0 +1,462 @@
+#include "flythrough.h"
+
+#include <cmath>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <algorithm>
+
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/constants.hpp>
+
+#include "bench/loadbench.h"
+
+#include "graphics/renderstats.h"
+
+#include "util/json.h"
+
+#include "config.h"
+#include "util/timing.h"
+#include "util/stringext.h"
+
+// One lap of the path, from FLYTHROUGH_FAR_DISTANCE scene radii away down to FLYTHROUGH_NEAR_DISTANCE and back.
+#define FLYTHROUGH_FAR_DISTANCE 2.0f
+#define FLYTHROUGH_NEAR_DISTANCE 0.35f
+
+#define FLYTHROUGH_GRID_SPACING 1.2f
+
+bool FlythroughBenchmark::isRequested(int argc, char* argv[])
+{
+	for (int i = 1; i < argc; i++)
+	{
+		if (std::string(argv[i]) == "--bench-flythrough")
+			return true;
+	}
+	return false;
+}
+
+bool FlythroughBenchmark::parseArguments(int argc, char* argv[], FlythroughOptions& options)
+{
+	for (int i = 1; i < argc; i++)
+	{
+		std::string argument = argv[i];
+		bool hasValue = i + 1 < argc;
+
+		if (argument == "--bench-flythrough" && hasValue)
+		{
+			splitList(argv[++i], options.models);
+		}
+		else if (argument == "--trace" && hasValue)
+		{
+			// Handled before the benchmark starts.
+			i++;
+		}
+		else if (argument == "--archive" && hasValue)
+		{
+			options.archive = argv[++i];
+		}
+		else if (argument == "--json" && hasValue)
+		{
+			options.json = argv[++i];
+		}
+		else if (argument == "--frames" && hasValue)
+		{
+			options.frames = std::atoi(argv[++i]);
+			if (options.frames <= 0)
+				return false;
+		}
+		else if (argument == "--warmup" && hasValue)
+		{
+			options.warmup = std::atoi(argv[++i]);
+			if (options.warmup < 0)
+				return false;
+		}
+		else if (argument == "--size" && hasValue)
+		{
+			std::string size = argv[++i];
+			size_t x = size.find('x');
+			if (x == std::string::npos)
+				return false;
+
+			options.width = std::atoi(size.substr(0, x).c_str());
+			options.height = std::atoi(size.substr(x + 1).c_str());
+			if (options.width <= 0 || options.height <= 0)
+				return false;
+		}
+		else if (argument == "--grid" && hasValue)
+		{
+			options.grid = std::atoi(argv[++i]);
+			if (options.grid <= 0)
+				return false;
+		}
+		else if (argument == "--software")
+		{
+			options.software = true;
+		}
+		else if (argument.size() > 2 && argument.compare(0, 2, "--") == 0)
+		{
+			return false;
+		}
+		else
+		{
+			splitList(argument, options.models);
+		}
+	}
+
+	return !options.models.empty();
+}
+
+void FlythroughBenchmark::printUsage()
+{
+	std::cout <<
+		"Usage: TYViewer --bench-flythrough <model>[,<model>...] [options]" << std::endl <<
+		"  --frames <n>       Measured frames along the camera path (default: 300)" << std::endl <<
+		"  --warmup <n>       Unmeasured frames rendered first (default: 10)" << std::endl <<
+		"  --size <w>x<h>     Framebuffer size (default: 1280x720)" << std::endl <<
+		"  --grid <n>         Repeat the models on an n x n grid as a synthetic level (default: 1)" << std::endl <<
+		"  --archive <path>   Archive to load models from (default: config.cfg)" << std::endl <<
+		"  --json <file>      Write the summary and every frame as JSON" << std::endl <<
+		"  --software         Use Mesa's software rasterizer" << std::endl <<
+		"  --trace <file>     Record a Chrome trace of the run" << std::endl;
+}
+
+FlythroughBenchmark::FlythroughBenchmark(const FlythroughOptions& options) :
+	options(options),
+	context(),
+	renderer(),
+	framebuffer(),
+	camera(glm::vec3(0.0f), glm::vec3(90.0f, 0.0f, 0.0f), 70.0f, (float)options.width / (float)options.height, 0.2f, 30000.0f),
+	content(),
+	shader(nullptr),
+	sceneCenter(0.0f),
+	sceneRadius(0.0f)
+{}
+
+int FlythroughBenchmark::run()
+{
+	if (!initialize() || !loadScene())
+		return -1;
+
+	for (int i = 0; i < options.warmup; i++)
+	{
+		renderFrame(i, options.warmup);
+		glFinish();
+		RenderStats::endFrame();
+	}
+
+	std::vector<FlythroughFrame> frames(options.frames);
+
+	auto start = std::chrono::high_resolution_clock::now();
+
+	for (int i = 0; i < options.frames; i++)
+	{
+		TRACE_ZONE("Flythrough frame");
+
+		auto frameStart = std::chrono::high_resolution_clock::now();
+
+		renderFrame(i, options.frames);
+		frames[i].cpuMilliseconds = millisecondsSince(frameStart);
+
+		glFinish();
+		frames[i].frameMilliseconds = millisecondsSince(frameStart);
+
+		const RenderStats::Frame& stats = RenderStats::getCurrentFrame();
+		frames[i].drawCalls = stats.drawCalls;
+		frames[i].stateChanges = stats.stateChanges;
+		frames[i].triangles = stats.triangles;
+		RenderStats::endFrame();
+
+		// Query results arrive GPU_TIMER_FRAMES later, beginFrame() of frame i collects those of frame i - GPU_TIMER_FRAMES.
+		if (i >= GPU_TIMER_FRAMES)
+			frames[i - GPU_TIMER_FRAMES].gpuMilliseconds = gpuTimer.getTotalMilliseconds();
+	}
+
+	double wall = millisecondsSince(start);
+
+	// The last frames' queries are only collected by the next beginFrame().
+	gpuTimer.beginFrame();
+	if (options.frames >= GPU_TIMER_FRAMES)
+		frames[options.frames - GPU_TIMER_FRAMES].gpuMilliseconds = gpuTimer.getTotalMilliseconds();
+
+	print(frames, wall);
+
+	if (!options.json.empty() && !writeJSON(frames, wall))
+	{
+		LOG_ERROR(General, "Failed to write flythrough results: " + options.json);
+		return -1;
+	}
+
+	return 0;
+}
+
+bool FlythroughBenchmark::initialize()
+{
+	archive = options.archive.empty() ? Config::archive : options.archive;
+	if (archive.empty())
+	{
+		LOG_ERROR(General, "No archive specified, use --archive or config.cfg");
+		return false;
+	}
+
+	if (!context.create(options.software))
+		return false;
+
+	renderer.initialize();
+	gpuTimer.initialize();
+
+	if (!framebuffer.create(options.width, options.height))
+		return false;
+
+	content.initialize();
+	if (!content.loadRKV(archive))
+	{
+		LOG_ERROR(General, "Failed to load archive: " + archive);
+		return false;
+	}
+
+	shader = content.load<Shader>("standard.shader");
+	if (shader == nullptr)
+	{
+		LOG_ERROR(General, "Failed to load shader: standard.shader");
+		return false;
+	}
+	shader->bind();
+	shader->setUniform4f("tintColour", glm::vec4(1, 1, 1, 1));
+	shader->setUniform1i("diffuseTexture", 0);
+
+	return true;
+}
+
+bool FlythroughBenchmark::loadScene()
+{
+	glm::vec3 min(0.0f);
+	glm::vec3 max(0.0f);
+
+	for (auto& name : options.models)
+	{
+		Model* model = content.load<Model>(name);
+		if (model == nullptr)
+		{
+			LOG_ERROR(General, "Failed to load model: " + name);
+			return false;
+		}
+
+		// Displayed as a left-handed coordinate system, z is flipped by the view.
+		glm::vec3 corner = model->bounds_crn;
+		corner.z = -corner.z - model->bounds_size.z;
+
+		if (models.empty())
+		{
+			min = corner;
+			max = corner + model->bounds_size;
+		}
+		else
+		{
+			min = glm::min(min, corner);
+			max = glm::max(max, corner + model->bounds_size);
+		}
+
+		models.push_back(model);
+	}
+
+	// The models as a whole are repeated, spaced by their combined footprint.
+	glm::vec3 size = max - min;
+	float spacing = std::max(std::max(size.x, size.z), 1.0f) * FLYTHROUGH_GRID_SPACING;
+	float offset = (options.grid - 1) * spacing / 2.0f;
+
+	for (int x = 0; x < options.grid; x++)
+	{
+		for (int z = 0; z < options.grid; z++)
+		{
+			// Instances are placed in model space, where z is not flipped yet.
+			instances.push_back(glm::translate(glm::mat4(1.0f), glm::vec3(x * spacing - offset, 0.0f, -(z * spacing - offset))));
+		}
+	}
+
+	sceneCenter = (min + max) / 2.0f;
+	sceneRadius = std::max(glm::length(glm::vec3(size.x + 2.0f * offset, size.y, size.z + 2.0f * offset)) / 2.0f, 1.0f);
+
+	camera.setClipPlaneFar(std::max(30000.0f, sceneRadius * FLYTHROUGH_FAR_DISTANCE * 4.0f));
+
+	size_t triangles = 0;
+	for (auto& model : models)
+	{
+		for (auto& mesh : model->getMeshes())
+		{
+			triangles += mesh->getIndexCount() / 3;
+		}
+	}
+
+	printf("Scene: %zu models x %zu instances, %zu triangles, radius %.1f\n", models.size(), instances.size(), triangles * instances.size(), sceneRadius);
+	fflush(stdout);
+
+	// Loaders log per file, keep that out of the measurements.
+	Debug::setLevel(Debug::Level::Warning);
+
+	return true;
+}
+
+void FlythroughBenchmark::placeCamera(Camera& camera, const glm::vec3& center, float radius, int index, int count)
+{
+	float t = static_cast<float>(index) / static_cast<float>(count);
+	float wave = std::sin(t * glm::pi<float>());
+
+	// One lap around the scene, moving in close halfway and dipping towards the ground.
+	float yaw = 360.0f * t;
+	float pitch = -35.0f + 25.0f * wave;
+	float distance = radius * (FLYTHROUGH_FAR_DISTANCE - (FLYTHROUGH_FAR_DISTANCE - FLYTHROUGH_NEAR_DISTANCE) * wave);
+
+	camera.orbit(center, distance, yaw, pitch);
+}
+
+void FlythroughBenchmark::renderFrame(int index, int count)
+{
+	gpuTimer.beginFrame();
+
+	placeCamera(camera, sceneCenter, sceneRadius, index, count);
+
+	framebuffer.bind();
+
+	renderer.beginFrame();
+	renderer.clear(glm::vec4(Config::backgroundR, Config::backgroundG, Config::backgroundB, 1.0f));
+
+	gpuTimer.begin(GpuPass::Models);
+
+	// Display as a left-handed coordinate system.
+	glm::mat4 view = camera.getViewMatrix();
+	view = glm::scale(view, glm::vec3(1.0f, 1.0f, -1.0f));
+
+	shader->bind();
+	shader->setUniformMat4("VPMatrix", camera.getProjectionMatrix() * view);
+
+	for (auto& instance : instances)
+	{
+		for (auto& model : models)
+		{
+			model->draw(*shader, instance);
+		}
+	}
+
+	gpuTimer.end();
+
+	framebuffer.unbind();
+}
+
+void FlythroughBenchmark::print(const std::vector<FlythroughFrame>& frames, double wallMilliseconds) const
+{
+	std::vector<double> cpu;
+	std::vector<double> frame;
+	std::vector<double> gpu;
+	double draws = 0.0;
+	double stateChanges = 0.0;
+	double triangles = 0.0;
+
+	for (auto& f : frames)
+	{
+		cpu.push_back(f.cpuMilliseconds);
+		frame.push_back(f.frameMilliseconds);
+		if (f.gpuMilliseconds >= 0.0)
+			gpu.push_back(f.gpuMilliseconds);
+
+		draws += f.drawCalls;
+		stateChanges += f.stateChanges;
+		triangles += f.triangles;
+	}
+
+	printf("\n%-8s %9s %9s %9s %9s\n", "", "p50", "p90", "p99", "max");
+
+	const char* labels[] = { "CPU", "Frame", "GPU" };
+	std::vector<double>* values[] = { &cpu, &frame, &gpu };
+	for (int i = 0; i < 3; i++)
+	{
+		if (values[i]->empty())
+		{
+			printf("%-8s %9s\n", labels[i], "n/a");
+			continue;
+		}
+
+		LoadPercentiles p = LoadBenchmark::getPercentiles(*values[i]);
+		printf("%-8s %7.3fms %7.3fms %7.3fms %7.3fms\n", labels[i], p.p50, p.p90, p.p99, p.max);
+	}
+
+	size_t count = frames.size();
+	printf("\n%zu frames in %.1f ms (%.1f fps)\n", count, wallMilliseconds, count * 1000.0 / wallMilliseconds);
+	printf("Per frame: %.1f draws, %.1f state changes, %.0f triangles\n", draws / count, stateChanges / count, triangles / count);
+	fflush(stdout);
+}
+
+bool FlythroughBenchmark::writeJSON(const std::vector<FlythroughFrame>& frames, double wallMilliseconds) const
+{
+	std::ofstream stream(options.json, std::ios::out | std::ios::trunc);
+	if (stream.fail())
+		return false;
+
+	std::vector<double> cpu;
+	std::vector<double> frame;
+	std::vector<double> gpu;
+	for (auto& f : frames)
+	{
+		cpu.push_back(f.cpuMilliseconds);
+		frame.push_back(f.frameMilliseconds);
+		if (f.gpuMilliseconds >= 0.0)
+			gpu.push_back(f.gpuMilliseconds);
+	}
+
+	auto writePercentiles = [&stream](const char* name, const std::vector<double>& values)
+	{
+		LoadPercentiles p = LoadBenchmark::getPercentiles(values);
+		stream << "\t\t\"" << name << "\": { \"p50\": " << p.p50 << ", \"p90\": " << p.p90 << ", \"p99\": " << p.p99 <<
+			", \"mean\": " << p.mean << ", \"min\": " << p.min << ", \"max\": " << p.max << ", \"samples\": " << values.size() << " }";
+	};
+
+	stream << std::fixed << std::setprecision(4);
+	stream << "{" << std::endl;
+	stream << "\t\"renderer\": \"" << Json::escape(reinterpret_cast<const char*>(glGetString(GL_RENDERER))) << "\"," << std::endl;
+	stream << "\t\"backend\": \"" << Json::escape(context.getBackend()) << "\"," << std::endl;
+	stream << "\t\"archive\": \"" << Json::escape(archive) << "\"," << std::endl;
+
+	stream << "\t\"models\": [";
+	for (size_t i = 0; i < options.models.size(); i++)
+	{
+		stream << (i > 0 ? ", " : "") << "\"" << Json::escape(options.models[i]) << "\"";
+	}
+	stream << "]," << std::endl;
+
+	stream << "\t\"grid\": " << options.grid << "," << std::endl;
+	stream << "\t\"width\": " << options.width << "," << std::endl;
+	stream << "\t\"height\": " << options.height << "," << std::endl;
+	stream << "\t\"frames\": " << frames.size() << "," << std::endl;
+	stream << "\t\"wallMilliseconds\": " << wallMilliseconds << "," << std::endl;
+
+	stream << "\t\"summary\": {" << std::endl;
+	writePercentiles("cpu", cpu);
+	stream << "," << std::endl;
+	writePercentiles("frame", frame);
+	if (!gpu.empty())
+	{
+		stream << "," << std::endl;
+		writePercentiles("gpu", gpu);
+	}
+	stream << std::endl << "\t}," << std::endl;
+
+	stream << "\t\"perFrame\": [" << std::endl;
+	for (size_t i = 0; i < frames.size(); i++)
+	{
+		const FlythroughFrame& f = frames[i];
+
+		stream << "\t\t{ \"cpu\": " << f.cpuMilliseconds;
+		stream << ", \"frame\": " << f.frameMilliseconds;
+		if (f.gpuMilliseconds >= 0.0)
+			stream << ", \"gpu\": " << f.gpuMilliseconds;
+		stream << ", \"draws\": " << f.drawCalls;
+		stream << ", \"stateChanges\": " << f.stateChanges;
+		stream << ", \"triangles\": " << f.triangles << " }";
+		stream << (i + 1 < frames.size() ? "," : "") << std::endl;
+	}
+	stream << "\t]" << std::endl;
+	stream << "}" << std::endl;
+
+	return !stream.fail();
+}
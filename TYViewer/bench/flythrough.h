@@ -0,0 +1,97 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <glad/glad.h>
+
+#include "content.h"
+
+#include "graphics/camera.h"
+#include "graphics/renderer.h"
+#include "graphics/context.h"
+#include "graphics/framebuffer.h"
+#include "graphics/gputimer.h"
+
+struct FlythroughOptions
+{
+	std::vector<std::string> models;
+
+	std::string archive;
+	std::string json;
+
+	int frames = 300;
+
+	// Rendered before measuring, lets the driver finish compiling and uploading.
+	int warmup = 10;
+
+	int width = 1280;
+	int height = 720;
+
+	// Copies of the models along each side of a square, a synthetic level of grid * grid instances.
+	int grid = 1;
+
+	bool software = false;
+};
+
+struct FlythroughFrame
+{
+	// Building and submitting the frame, without waiting on the GPU.
+	double cpuMilliseconds = 0.0;
+	// Until glFinish returned.
+	double frameMilliseconds = 0.0;
+	// From timer queries, negative where they are not available.
+	double gpuMilliseconds = -1.0;
+
+	size_t drawCalls = 0;
+	size_t stateChanges = 0;
+	size_t triangles = 0;
+};
+
+// Flies a scripted camera path through the loaded models for a fixed number of frames
+// in an offscreen context and reports per-frame CPU/GPU times and render counters.
+// Usage: TYViewer --bench-flythrough <model>[,<model>...] [options]
+class FlythroughBenchmark
+{
+public:
+	static bool isRequested(int argc, char* argv[]);
+	static bool parseArguments(int argc, char* argv[], FlythroughOptions& options);
+	static void printUsage();
+
+	FlythroughBenchmark(const FlythroughOptions& options);
+
+	int run();
+
+	// Camera of frame 'index' of 'count', the same for every run and machine.
+	static void placeCamera(Camera& camera, const glm::vec3& center, float radius, int index, int count);
+
+private:
+	bool initialize();
+	bool loadScene();
+
+	void renderFrame(int index, int count);
+
+	void print(const std::vector<FlythroughFrame>& frames, double wallMilliseconds) const;
+	bool writeJSON(const std::vector<FlythroughFrame>& frames, double wallMilliseconds) const;
+
+	FlythroughOptions options;
+
+	// Declared first so every GL object below is released while the context still exists.
+	OffscreenContext context;
+
+	Renderer renderer;
+	Framebuffer framebuffer;
+	Camera camera;
+	GpuTimer gpuTimer;
+
+	Content content;
+	Shader* shader;
+
+	std::string archive;
+
+	std::vector<Model*> models;
+	std::vector<glm::mat4> instances;
+
+	glm::vec3 sceneCenter;
+	float sceneRadius;
+};
@@ -0,0 +1,385 @@
+#include "loadbench.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <algorithm>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include "config.h"
+#include "util/timing.h"
+#include "util/stringext.h"
+#include "util/json.h"
+
+bool LoadBenchmark::isRequested(int argc, char* argv[])
+{
+	for (int i = 1; i < argc; i++)
+	{
+		if (std::string(argv[i]) == "--bench-load")
+			return true;
+	}
+	return false;
+}
+
+bool LoadBenchmark::parseArguments(int argc, char* argv[], LoadBenchmarkOptions& options)
+{
+	for (int i = 1; i < argc; i++)
+	{
+		std::string argument = argv[i];
+		bool hasValue = i + 1 < argc;
+
+		if (argument == "--bench-load" && hasValue)
+		{
+			splitList(argv[++i], options.models);
+		}
+		else if (argument == "--trace" && hasValue)
+		{
+			// Handled before the benchmark starts.
+			i++;
+		}
+		else if (argument == "--iterations" && hasValue)
+		{
+			options.iterations = std::atoi(argv[++i]);
+			if (options.iterations <= 0)
+				return false;
+		}
+		else if (argument == "--archive" && hasValue)
+		{
+			options.archive = argv[++i];
+		}
+		else if (argument == "--json" && hasValue)
+		{
+			options.json = argv[++i];
+		}
+		else if (argument == "--drop-page-cache")
+		{
+			options.dropPageCache = true;
+		}
+		else if (argument == "--software")
+		{
+			options.software = true;
+		}
+		else if (argument.size() > 2 && argument.compare(0, 2, "--") == 0)
+		{
+			return false;
+		}
+		else
+		{
+			splitList(argument, options.models);
+		}
+	}
+
+	return !options.models.empty();
+}
+
+void LoadBenchmark::printUsage()
+{
+	std::cout <<
+		"Usage: TYViewer --bench-load <model>[,<model>...] [options]" << std::endl <<
+		"  --iterations <n>   Cold and warm runs per model (default: 10)" << std::endl <<
+		"  --archive <path>   Archive to load models from (default: config.cfg)" << std::endl <<
+		"  --json <file>      Write percentiles and every run as JSON" << std::endl <<
+		"  --drop-page-cache  Evict the archive from the OS page cache before cold runs (Linux)" << std::endl <<
+		"  --software         Use Mesa's software rasterizer" << std::endl <<
+		"  --trace <file>     Record a Chrome trace of the run" << std::endl;
+}
+
+LoadBenchmark::LoadBenchmark(const LoadBenchmarkOptions& options) :
+	options(options),
+	context(),
+	content()
+{}
+
+int LoadBenchmark::run()
+{
+	if (!initialize())
+		return -1;
+
+	std::vector<LoadBenchmarkResult> results(options.models.size());
+	int failures = 0;
+
+	for (size_t i = 0; i < options.models.size(); i++)
+	{
+		measure(options.models[i], results[i]);
+		if (!results[i].loaded)
+		{
+			failures++;
+			continue;
+		}
+
+		print(results[i]);
+	}
+
+	if (!options.json.empty() && !writeJSON(results))
+	{
+		LOG_ERROR(General, "Failed to write load benchmark results: " + options.json);
+		return -1;
+	}
+
+	return failures == 0 ? 0 : 1;
+}
+
+bool LoadBenchmark::initialize()
+{
+	archive = options.archive.empty() ? Config::archive : options.archive;
+	if (archive.empty())
+	{
+		LOG_ERROR(General, "No archive specified, use --archive or config.cfg");
+		return false;
+	}
+
+	if (!context.create(options.software))
+		return false;
+
+	content.initialize();
+	if (!content.loadRKV(archive))
+	{
+		LOG_ERROR(General, "Failed to load archive: " + archive);
+		return false;
+	}
+
+#ifndef __linux__
+	if (options.dropPageCache)
+	{
+		LOG_WARNING(General, "--drop-page-cache is only supported on Linux, cold runs will read from the OS cache");
+	}
+#endif
+
+	// Loaders log per file, keep that out of the measurements.
+	Debug::setLevel(Debug::Level::Warning);
+
+	return true;
+}
+
+void LoadBenchmark::measure(const std::string& name, LoadBenchmarkResult& result)
+{
+	result.name = name;
+
+	for (int i = 0; i < options.iterations; i++)
+	{
+		content.unloadAll();
+		if (options.dropPageCache && !dropPageCache())
+		{
+			if (result.pageCacheKept == 0)
+			{
+				LOG_WARNING(General, "Failed to drop the page cache for " + archive + ", cold runs of " + name + " may read it from the OS cache");
+			}
+			result.pageCacheKept++;
+		}
+
+		if (!loadOnce(name, result.cold))
+		{
+			LOG_ERROR(General, "Failed to load model: " + name);
+			return;
+		}
+	}
+
+	// The last cold run leaves textures cached and the archive in the page cache.
+	for (int i = 0; i < options.iterations; i++)
+	{
+		content.unloadModel(name);
+		loadOnce(name, result.warm);
+	}
+
+	Model* model = content.load<Model>(name);
+	for (auto& mesh : model->getMeshes())
+	{
+		result.vertices += mesh->getVertexCount();
+		result.triangles += mesh->getIndexCount() / 3;
+	}
+	result.loaded = true;
+
+	content.unloadAll();
+}
+
+bool LoadBenchmark::loadOnce(const std::string& name, LoadRuns& runs)
+{
+	TRACE_ZONE_DETAIL("LoadBenchmark::loadOnce", name);
+
+	auto start = std::chrono::high_resolution_clock::now();
+
+	Model* model = content.load<Model>(name);
+	if (model == nullptr)
+		return false;
+
+	// Uploads only count once the driver has actually consumed them.
+	auto finishStart = std::chrono::high_resolution_clock::now();
+	glFinish();
+	double finish = millisecondsSince(finishStart);
+
+	runs.totals.push_back(millisecondsSince(start));
+
+	LoadTimings timings = model->loadTimings;
+	timings.upload += finish;
+	runs.stages.push_back(timings);
+
+	return true;
+}
+
+bool LoadBenchmark::dropPageCache()
+{
+#ifdef __linux__
+	int file = open(archive.c_str(), O_RDONLY);
+	if (file < 0)
+		return false;
+
+	bool dropped = posix_fadvise(file, 0, 0, POSIX_FADV_DONTNEED) == 0;
+	close(file);
+	return dropped;
+#else
+	return false;
+#endif
+}
+
+LoadPercentiles LoadBenchmark::getPercentiles(std::vector<double> values)
+{
+	LoadPercentiles percentiles;
+	if (values.empty())
+		return percentiles;
+
+	std::sort(values.begin(), values.end());
+
+	// Linear interpolation between the closest ranks.
+	auto percentile = [&values](double p)
+	{
+		double rank = p * (values.size() - 1);
+		size_t lower = static_cast<size_t>(rank);
+		size_t upper = std::min(lower + 1, values.size() - 1);
+		return values[lower] + (values[upper] - values[lower]) * (rank - lower);
+	};
+
+	percentiles.p50 = percentile(0.50);
+	percentiles.p90 = percentile(0.90);
+	percentiles.p99 = percentile(0.99);
+
+	double sum = 0.0;
+	for (double value : values)
+	{
+		sum += value;
+	}
+	percentiles.mean = sum / values.size();
+	percentiles.min = values.front();
+	percentiles.max = values.back();
+
+	return percentiles;
+}
+
+static std::vector<double> getStage(const LoadRuns& runs, double LoadTimings::* stage)
+{
+	std::vector<double> values;
+	for (auto& timings : runs.stages)
+	{
+		values.push_back(timings.*stage);
+	}
+	return values;
+}
+
+void LoadBenchmark::print(const LoadBenchmarkResult& result) const
+{
+	printf("%s (%zu vertices, %zu triangles)\n", result.name.c_str(), result.vertices, result.triangles);
+	printf("  %-6s %-7s %9s %9s %9s   read / parse / build / upload (p50)\n", "", "", "p50", "p90", "p99");
+
+	const LoadRuns* runs[] = { &result.cold, &result.warm };
+	const char* labels[] = { "cold", "warm" };
+
+	for (int i = 0; i < 2; i++)
+	{
+		LoadPercentiles total = getPercentiles(runs[i]->totals);
+		printf("  %-6s %-7s %7.2fms %7.2fms %7.2fms   %.2f / %.2f / %.2f / %.2f ms\n", labels[i], "total",
+			total.p50, total.p90, total.p99,
+			getPercentiles(getStage(*runs[i], &LoadTimings::read)).p50,
+			getPercentiles(getStage(*runs[i], &LoadTimings::parse)).p50,
+			getPercentiles(getStage(*runs[i], &LoadTimings::build)).p50,
+			getPercentiles(getStage(*runs[i], &LoadTimings::upload)).p50);
+	}
+
+	if (result.pageCacheKept > 0)
+	{
+		printf("  %d of %d cold runs kept the archive in the page cache\n", result.pageCacheKept, options.iterations);
+	}
+	fflush(stdout);
+}
+
+static void writePercentiles(std::ofstream& stream, const char* name, const LoadPercentiles& percentiles)
+{
+	stream << "\"" << name << "\": { ";
+	stream << "\"p50\": " << percentiles.p50 << ", ";
+	stream << "\"p90\": " << percentiles.p90 << ", ";
+	stream << "\"p99\": " << percentiles.p99 << ", ";
+	stream << "\"mean\": " << percentiles.mean << ", ";
+	stream << "\"min\": " << percentiles.min << ", ";
+	stream << "\"max\": " << percentiles.max << " }";
+}
+
+static void writeRuns(std::ofstream& stream, const char* name, const LoadRuns& runs)
+{
+	stream << "\t\t\t\"" << name << "\": {" << std::endl;
+	stream << "\t\t\t\t";
+	writePercentiles(stream, "total", LoadBenchmark::getPercentiles(runs.totals));
+	stream << "," << std::endl << "\t\t\t\t";
+	writePercentiles(stream, "read", LoadBenchmark::getPercentiles(getStage(runs, &LoadTimings::read)));
+	stream << "," << std::endl << "\t\t\t\t";
+	writePercentiles(stream, "parse", LoadBenchmark::getPercentiles(getStage(runs, &LoadTimings::parse)));
+	stream << "," << std::endl << "\t\t\t\t";
+	writePercentiles(stream, "build", LoadBenchmark::getPercentiles(getStage(runs, &LoadTimings::build)));
+	stream << "," << std::endl << "\t\t\t\t";
+	writePercentiles(stream, "upload", LoadBenchmark::getPercentiles(getStage(runs, &LoadTimings::upload)));
+	stream << "," << std::endl;
+
+	stream << "\t\t\t\t\"runs\": [";
+	for (size_t i = 0; i < runs.totals.size(); i++)
+	{
+		stream << (i > 0 ? ", " : "") << runs.totals[i];
+	}
+	stream << "]" << std::endl;
+	stream << "\t\t\t}";
+}
+
+bool LoadBenchmark::writeJSON(const std::vector<LoadBenchmarkResult>& results) const
+{
+	std::ofstream stream(options.json, std::ios::out | std::ios::trunc);
+	if (stream.fail())
+		return false;
+
+	stream << std::fixed << std::setprecision(3);
+	stream << "{" << std::endl;
+	stream << "\t\"renderer\": \"" << Json::escape(reinterpret_cast<const char*>(glGetString(GL_RENDERER))) << "\"," << std::endl;
+	stream << "\t\"backend\": \"" << Json::escape(context.getBackend()) << "\"," << std::endl;
+	stream << "\t\"archive\": \"" << Json::escape(archive) << "\"," << std::endl;
+	stream << "\t\"iterations\": " << options.iterations << "," << std::endl;
+	stream << "\t\"dropPageCache\": " << (options.dropPageCache ? "true" : "false") << "," << std::endl;
+	stream << "\t\"models\": [" << std::endl;
+
+	for (size_t i = 0; i < results.size(); i++)
+	{
+		const LoadBenchmarkResult& result = results[i];
+
+		stream << "\t\t{" << std::endl;
+		stream << "\t\t\t\"name\": \"" << Json::escape(result.name) << "\"," << std::endl;
+		stream << "\t\t\t\"loaded\": " << (result.loaded ? "true" : "false");
+
+		if (result.loaded)
+		{
+			stream << "," << std::endl;
+			stream << "\t\t\t\"vertices\": " << result.vertices << "," << std::endl;
+			stream << "\t\t\t\"triangles\": " << result.triangles << "," << std::endl;
+			stream << "\t\t\t\"pageCacheKept\": " << result.pageCacheKept << "," << std::endl;
+			writeRuns(stream, "cold", result.cold);
+			stream << "," << std::endl;
+			writeRuns(stream, "warm", result.warm);
+		}
+
+		stream << std::endl << "\t\t}" << (i + 1 < results.size() ? "," : "") << std::endl;
+	}
+
+	stream << "\t]" << std::endl;
+	stream << "}" << std::endl;
+
+	return !stream.fail();
+}
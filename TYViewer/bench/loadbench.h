@@ -0,0 +1,94 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <glad/glad.h>
+
+#include "content.h"
+
+#include "graphics/context.h"
+
+struct LoadBenchmarkOptions
+{
+	std::vector<std::string> models;
+
+	std::string archive;
+	std::string json;
+
+	int iterations = 10;
+
+	// Evicts the archive from the OS page cache before every cold run (Linux only).
+	bool dropPageCache = false;
+	bool software = false;
+};
+
+// Percentiles of one stage over all runs, in milliseconds.
+struct LoadPercentiles
+{
+	double p50 = 0.0;
+	double p90 = 0.0;
+	double p99 = 0.0;
+
+	double mean = 0.0;
+	double min = 0.0;
+	double max = 0.0;
+};
+
+struct LoadRuns
+{
+	std::vector<LoadTimings> stages;
+	std::vector<double> totals;
+};
+
+struct LoadBenchmarkResult
+{
+	std::string name;
+	bool loaded = false;
+
+	size_t vertices = 0;
+	size_t triangles = 0;
+
+	// Cold runs start with empty Content caches, warm runs keep textures cached
+	// and find the archive in the OS page cache.
+	LoadRuns cold;
+	LoadRuns warm;
+
+	// Cold runs --drop-page-cache failed to evict the archive for, they read it from the OS cache.
+	int pageCacheKept = 0;
+};
+
+// Times the full Content::load<Model> path, split into read, parse, build and upload.
+// Usage: TYViewer --bench-load <model>[,<model>...] [options]
+class LoadBenchmark
+{
+public:
+	static bool isRequested(int argc, char* argv[]);
+	static bool parseArguments(int argc, char* argv[], LoadBenchmarkOptions& options);
+	static void printUsage();
+
+	LoadBenchmark(const LoadBenchmarkOptions& options);
+
+	int run();
+
+	static LoadPercentiles getPercentiles(std::vector<double> values);
+
+private:
+	bool initialize();
+
+	void measure(const std::string& name, LoadBenchmarkResult& result);
+	bool loadOnce(const std::string& name, LoadRuns& runs);
+
+	bool dropPageCache();
+
+	void print(const LoadBenchmarkResult& result) const;
+	bool writeJSON(const std::vector<LoadBenchmarkResult>& results) const;
+
+	LoadBenchmarkOptions options;
+
+	// Declared first so every GL object below is released while the context still exists.
+	OffscreenContext context;
+
+	Content content;
+	std::string archive;
+};
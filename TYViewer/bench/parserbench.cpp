@@ -0,0 +1,628 @@
+#include "benchmark.h"
+#include "synthetic.h"
+
+#include <cstring>
+#include <fstream>
+#include <filesystem>
+#include <algorithm>
+
+#include "loader/archive.h"
+#include "loader/modelbuilder.h"
+#include "loader/assets/mdl2.h"
+#include "loader/assets/mdg.h"
+#include "loader/assets/wfn.h"
+
+#include "util/parser.h"
+
+namespace fs = std::filesystem;
+
+// Synthetic inputs are sized to be comparable to real game files.
+#define BENCH_ARCHIVE_ENTRIES 4096
+#define BENCH_STRIP_COUNT 256
+#define BENCH_STRIP_LENGTH 64
+#define BENCH_SHADER_COPIES 16
+
+struct ModelInput
+{
+	std::string name;
+	std::vector<char> mdl;
+	std::vector<char> mdg;
+};
+
+static bool readFile(const fs::path& path, std::vector<char>& data)
+{
+	std::ifstream stream(path, std::ios::binary | std::ios::ate);
+	if (stream.fail())
+		return false;
+
+	data.resize(static_cast<size_t>(stream.tellg()));
+	stream.seekg(0, std::ios::beg);
+	stream.read(data.data(), data.size());
+	return !stream.fail();
+}
+
+static bool writeFile(const fs::path& path, const std::vector<char>& data)
+{
+	return SyntheticAssets::writeFile(path.string(), data);
+}
+
+static fs::path getTempPath(const std::string& name)
+{
+	std::error_code error;
+	fs::path directory = fs::temp_directory_path(error);
+	return (error ? fs::path(".") : directory) / ("tyviewer_bench_" + name);
+}
+
+template<typename T>
+static void writeValue(std::vector<char>& buffer, size_t offset, T value)
+{
+	memcpy(&buffer[offset], &value, sizeof(T));
+}
+
+// TY 1 models are the .mdl files without an .mdg next to them.
+static std::vector<ModelInput> loadInputs(const BenchmarkSettings& settings, bool ty2)
+{
+	std::vector<ModelInput> inputs;
+
+	std::error_code error;
+	for (auto& entry : fs::directory_iterator(settings.inputs, error))
+	{
+		fs::path path = entry.path();
+
+		std::string extension = path.extension().string();
+		std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+		if (extension != ".mdl")
+			continue;
+
+		fs::path mdgPath = path;
+		mdgPath.replace_extension(".mdg");
+		if (fs::exists(mdgPath) != ty2)
+			continue;
+
+		ModelInput input;
+		input.name = path.filename().string();
+		if (!readFile(path, input.mdl) || (ty2 && !readFile(mdgPath, input.mdg)))
+			continue;
+
+		inputs.push_back(std::move(input));
+	}
+
+	std::sort(inputs.begin(), inputs.end(), [](const ModelInput& a, const ModelInput& b) { return a.name < b.name; });
+	return inputs;
+}
+
+// Archive of 'count' small files named like the game's, e.g. "P0486_Name.mdl".
+static std::vector<char> createArchive(size_t count, std::vector<std::string>& names, bool rkv1 = false)
+{
+	std::vector<SyntheticEntry> entries;
+	SyntheticAssets::createFillerEntries(count, 64, entries);
+
+	for (auto& entry : entries)
+	{
+		names.push_back(entry.name);
+	}
+
+	std::vector<char> archive;
+	if (rkv1)
+		SyntheticAssets::createRKV1(entries, archive);
+	else
+		SyntheticAssets::createRKV2(entries, archive);
+	return archive;
+}
+
+// Roughly the size of P0486_B1FlowerPot at scale 1, larger scales chain more meshes per cell.
+static SyntheticModelOptions getScaledModel(unsigned int scale)
+{
+	SyntheticModelOptions options;
+	options.components = 2;
+	options.textures = 2;
+	options.stripsPerMesh = 4;
+	options.stripLength = 16;
+	options.meshesPerCell = scale;
+	return options;
+}
+
+static Vertex toVertex(const mdl2::Vertex& vertex)
+{
+	return Vertex(glm::vec4(vertex.position[0], vertex.position[1], vertex.position[2], 1.0f), glm::vec2(vertex.texcoord[0], vertex.texcoord[1]));
+}
+
+BENCHMARK_CASE(ArchiveLoadRKV2)
+{
+	std::vector<std::string> names;
+	fs::path path = getTempPath("archive.rkv");
+	if (!writeFile(path, createArchive(BENCH_ARCHIVE_ENTRIES, names)))
+		return state.skip("could not write " + path.string());
+
+	while (state.keepRunning())
+	{
+		Archive archive;
+		archive.load(path.string());
+		doNotOptimize(archive);
+	}
+
+	state.setBytesProcessed(static_cast<size_t>(fs::file_size(path)));
+	state.setItemsProcessed(names.size(), "entries");
+
+	fs::remove(path);
+}
+
+BENCHMARK_CASE(ArchiveLoadRKV1)
+{
+	std::vector<std::string> names;
+	fs::path path = getTempPath("archive1.rkv");
+	if (!writeFile(path, createArchive(BENCH_ARCHIVE_ENTRIES, names, true)))
+		return state.skip("could not write " + path.string());
+
+	while (state.keepRunning())
+	{
+		Archive archive;
+		archive.load(path.string());
+		doNotOptimize(archive);
+	}
+
+	state.setBytesProcessed(static_cast<size_t>(fs::file_size(path)));
+	state.setItemsProcessed(names.size(), "entries");
+
+	fs::remove(path);
+}
+
+BENCHMARK_CASE(ArchiveLookup)
+{
+	std::vector<std::string> names;
+	fs::path path = getTempPath("lookup.rkv");
+	if (!writeFile(path, createArchive(BENCH_ARCHIVE_ENTRIES, names)))
+		return state.skip("could not write " + path.string());
+
+	Archive archive;
+	archive.load(path.string());
+
+	// Lookups arrive in whatever case the caller uses.
+	for (size_t i = 0; i < names.size(); i += 2)
+	{
+		std::transform(names[i].begin(), names[i].end(), names[i].begin(), ::toupper);
+	}
+
+	File file;
+	while (state.keepRunning())
+	{
+		for (auto& name : names)
+		{
+			archive.getFile(name, file);
+		}
+		doNotOptimize(file);
+	}
+
+	state.setItemsProcessed(names.size(), "lookups");
+
+	fs::remove(path);
+}
+
+BENCHMARK_CASE(ArchiveReadFiles)
+{
+	std::vector<std::string> names;
+	fs::path path = getTempPath("read.rkv");
+	if (!writeFile(path, createArchive(BENCH_ARCHIVE_ENTRIES / 8, names)))
+		return state.skip("could not write " + path.string());
+
+	Archive archive;
+	archive.load(path.string());
+
+	size_t bytes = 0;
+	std::vector<char> data;
+	while (state.keepRunning())
+	{
+		bytes = 0;
+		for (auto& name : names)
+		{
+			archive.getFileData(name, data);
+			bytes += data.size();
+		}
+		doNotOptimize(data);
+	}
+
+	state.setBytesProcessed(bytes);
+	state.setItemsProcessed(names.size(), "files");
+
+	fs::remove(path);
+}
+
+BENCHMARK_CASE(ArchiveLoadReal)
+{
+	const std::string& path = state.getSettings().archive;
+	if (path.empty())
+		return state.skip("no --archive given");
+
+	std::error_code error;
+	size_t size = static_cast<size_t>(fs::file_size(path, error));
+	if (error)
+		return state.skip("could not open " + path);
+
+	while (state.keepRunning())
+	{
+		Archive archive;
+		archive.load(path);
+		doNotOptimize(archive);
+	}
+
+	state.setBytesProcessed(size);
+}
+
+BENCHMARK_CASE(Mdl2LoadTY1)
+{
+	std::vector<ModelInput> inputs = loadInputs(state.getSettings(), false);
+	if (inputs.empty())
+		return state.skip("no TY 1 models in " + state.getSettings().inputs);
+
+	size_t bytes = 0;
+	size_t vertices = 0;
+	for (auto& input : inputs)
+	{
+		mdl2 mdl;
+		if (!mdl.load(input.mdl.data(), 0))
+			continue;
+
+		bytes += input.mdl.size();
+		for (auto& subobject : mdl.subobjects)
+			for (auto& mesh : subobject.meshes)
+				for (auto& segment : mesh.segments)
+					vertices += segment.vertices.size();
+	}
+
+	while (state.keepRunning())
+	{
+		for (auto& input : inputs)
+		{
+			mdl2 mdl;
+			mdl.load(input.mdl.data(), 0);
+			doNotOptimize(mdl);
+		}
+	}
+
+	state.setBytesProcessed(bytes);
+	state.setItemsProcessed(vertices, "verts");
+}
+
+BENCHMARK_CASE(Mdl2LoadTY2MDL3)
+{
+	std::vector<ModelInput> inputs = loadInputs(state.getSettings(), true);
+	if (inputs.empty())
+		return state.skip("no TY 2 models in " + state.getSettings().inputs);
+
+	size_t bytes = 0;
+	for (auto& input : inputs)
+	{
+		bytes += input.mdl.size();
+	}
+
+	while (state.keepRunning())
+	{
+		for (auto& input : inputs)
+		{
+			mdl2 mdl;
+			mdl.loadTY2MDL3(input.mdl.data(), 0);
+			doNotOptimize(mdl);
+		}
+	}
+
+	state.setBytesProcessed(bytes);
+	state.setItemsProcessed(inputs.size(), "models");
+}
+
+// loadWithMDL3Metadata is the public entry to parseMDGPC.
+BENCHMARK_CASE(MdgParsePC)
+{
+	std::vector<ModelInput> inputs = loadInputs(state.getSettings(), true);
+
+	std::vector<mdl2> mdls;
+	std::vector<const ModelInput*> parsed;
+	size_t bytes = 0;
+	size_t vertices = 0;
+
+	for (auto& input : inputs)
+	{
+		mdl2 mdl;
+		if (!mdl.loadTY2MDL3(input.mdl.data(), 0))
+			continue;
+
+		mdg mesh;
+		if (!mesh.loadWithMDL3Metadata(input.mdg.data(), input.mdg.size(), mdl.mdl3Metadata, input.mdl.data(), 0))
+			continue;
+
+		for (auto& data : mesh.meshes)
+		{
+			vertices += data.vertices.size();
+		}
+		bytes += input.mdg.size();
+
+		mdls.push_back(std::move(mdl));
+		parsed.push_back(&input);
+	}
+
+	if (parsed.empty())
+		return state.skip("no parseable TY 2 models in " + state.getSettings().inputs);
+
+	while (state.keepRunning())
+	{
+		for (size_t i = 0; i < parsed.size(); i++)
+		{
+			mdg mesh;
+			mesh.loadWithMDL3Metadata(parsed[i]->mdg.data(), parsed[i]->mdg.size(), mdls[i].mdl3Metadata, parsed[i]->mdl.data(), 0);
+			doNotOptimize(mesh);
+		}
+	}
+
+	state.setBytesProcessed(bytes);
+	state.setItemsProcessed(vertices, "verts");
+}
+
+BENCHMARK_CASE(ModelBuilderBuild)
+{
+	std::vector<ModelInput> inputs = loadInputs(state.getSettings(), true);
+	if (inputs.empty())
+		return state.skip("no TY 2 models in " + state.getSettings().inputs);
+
+	size_t bytes = 0;
+	size_t vertices = 0;
+	for (auto& input : inputs)
+	{
+		ModelData model;
+		if (ModelBuilder::build(input.name, input.mdl, &input.mdg, model))
+			vertices += model.vertices.size();
+
+		bytes += input.mdl.size() + input.mdg.size();
+	}
+
+	while (state.keepRunning())
+	{
+		for (auto& input : inputs)
+		{
+			ModelData model;
+			ModelBuilder::build(input.name, input.mdl, &input.mdg, model);
+			doNotOptimize(model);
+		}
+	}
+
+	state.setBytesProcessed(bytes);
+	state.setItemsProcessed(vertices, "verts");
+}
+
+BENCHMARK_CASE(StripToIndexReal)
+{
+	std::vector<ModelInput> inputs = loadInputs(state.getSettings(), true);
+
+	struct Strips
+	{
+		std::vector<Vertex> vertices;
+		std::vector<uint16_t> counts;
+	};
+	std::vector<Strips> meshes;
+	size_t vertices = 0;
+
+	for (auto& input : inputs)
+	{
+		mdl2 mdl;
+		mdg mesh;
+		if (!mdl.loadTY2MDL3(input.mdl.data(), 0) ||
+			!mesh.loadWithMDL3Metadata(input.mdg.data(), input.mdg.size(), mdl.mdl3Metadata, input.mdl.data(), 0))
+			continue;
+
+		for (auto& data : mesh.meshes)
+		{
+			Strips strips;
+			for (auto& vertex : data.vertices)
+			{
+				strips.vertices.push_back(toVertex(vertex));
+			}
+			strips.counts = data.stripVertexCounts;
+
+			vertices += strips.vertices.size();
+			meshes.push_back(std::move(strips));
+		}
+	}
+
+	if (meshes.empty())
+		return state.skip("no parseable TY 2 models in " + state.getSettings().inputs);
+
+	std::vector<unsigned int> indices;
+	while (state.keepRunning())
+	{
+		for (auto& strips : meshes)
+		{
+			StripStats stats;
+			indices.clear();
+			ModelBuilder::buildStripIndices(strips.vertices.data(), strips.vertices.size(), strips.counts, indices, stats);
+		}
+		doNotOptimize(indices);
+	}
+
+	state.setItemsProcessed(vertices, "verts");
+}
+
+// A grid made of row strips, like most of the game's level geometry.
+BENCHMARK_CASE(StripToIndexSynthetic)
+{
+	std::vector<Vertex> vertices;
+	std::vector<uint16_t> counts;
+
+	for (int strip = 0; strip < BENCH_STRIP_COUNT; strip++)
+	{
+		for (int i = 0; i < BENCH_STRIP_LENGTH; i++)
+		{
+			float x = static_cast<float>(i / 2);
+			float z = static_cast<float>(strip + i % 2);
+			vertices.push_back(Vertex(glm::vec4(x, 0.0f, z, 1.0f), glm::vec2(x / BENCH_STRIP_LENGTH, z / BENCH_STRIP_COUNT)));
+		}
+		counts.push_back(BENCH_STRIP_LENGTH);
+	}
+
+	std::vector<unsigned int> indices;
+	while (state.keepRunning())
+	{
+		StripStats stats;
+		indices.clear();
+		ModelBuilder::buildStripIndices(vertices.data(), vertices.size(), counts, indices, stats);
+		doNotOptimize(indices);
+	}
+
+	state.setBytesProcessed(vertices.size() * sizeof(Vertex));
+	state.setItemsProcessed(vertices.size(), "verts");
+}
+
+// Synthetic models at 1x, 10x and 100x the size of a real prop, time per vertex should stay flat.
+static void benchmarkMdl2Synthetic(BenchmarkState& state, unsigned int scale)
+{
+	std::vector<char> data;
+	SyntheticAssets::createMDL2(getScaledModel(scale), data);
+
+	size_t vertices = 0;
+	mdl2 check;
+	if (!check.load(data.data(), 0))
+		return state.skip("generated model failed to parse");
+
+	for (auto& subobject : check.subobjects)
+		for (auto& mesh : subobject.meshes)
+			for (auto& segment : mesh.segments)
+				vertices += segment.vertices.size();
+
+	while (state.keepRunning())
+	{
+		mdl2 mdl;
+		mdl.load(data.data(), 0);
+		doNotOptimize(mdl);
+	}
+
+	state.setBytesProcessed(data.size());
+	state.setItemsProcessed(vertices, "verts");
+}
+
+static void benchmarkMdgSynthetic(BenchmarkState& state, unsigned int scale)
+{
+	std::vector<char> mdlData;
+	std::vector<char> mdgData;
+	SyntheticAssets::createMDL3(getScaledModel(scale), mdlData, mdgData);
+
+	mdl2 mdl;
+	mdg check;
+	if (!mdl.loadTY2MDL3(mdlData.data(), 0) ||
+		!check.loadWithMDL3Metadata(mdgData.data(), mdgData.size(), mdl.mdl3Metadata, mdlData.data(), 0))
+		return state.skip("generated model failed to parse");
+
+	size_t vertices = 0;
+	for (auto& data : check.meshes)
+	{
+		vertices += data.vertices.size();
+	}
+
+	while (state.keepRunning())
+	{
+		mdg mesh;
+		mesh.loadWithMDL3Metadata(mdgData.data(), mdgData.size(), mdl.mdl3Metadata, mdlData.data(), 0);
+		doNotOptimize(mesh);
+	}
+
+	state.setBytesProcessed(mdgData.size());
+	state.setItemsProcessed(vertices, "verts");
+}
+
+static void benchmarkBuildSynthetic(BenchmarkState& state, unsigned int scale)
+{
+	std::vector<char> mdlData;
+	std::vector<char> mdgData;
+	SyntheticAssets::createMDL3(getScaledModel(scale), mdlData, mdgData);
+
+	ModelData check;
+	if (!ModelBuilder::build("synthetic.mdl", mdlData, &mdgData, check))
+		return state.skip("generated model failed to build");
+
+	while (state.keepRunning())
+	{
+		ModelData model;
+		ModelBuilder::build("synthetic.mdl", mdlData, &mdgData, model);
+		doNotOptimize(model);
+	}
+
+	state.setBytesProcessed(mdlData.size() + mdgData.size());
+	state.setItemsProcessed(check.vertices.size(), "verts");
+}
+
+#define BENCHMARK_SCALED(name, function) \
+	static const bool name##Registered1 = Benchmark::add(#name "/x1", [](BenchmarkState& state) { function(state, 1); }); \
+	static const bool name##Registered10 = Benchmark::add(#name "/x10", [](BenchmarkState& state) { function(state, 10); }); \
+	static const bool name##Registered100 = Benchmark::add(#name "/x100", [](BenchmarkState& state) { function(state, 100); });
+
+BENCHMARK_SCALED(Mdl2LoadTY1Synthetic, benchmarkMdl2Synthetic)
+BENCHMARK_SCALED(MdgParsePCSynthetic, benchmarkMdgSynthetic)
+BENCHMARK_SCALED(ModelBuilderBuildSynthetic, benchmarkBuildSynthetic)
+
+BENCHMARK_CASE(WFNLoad)
+{
+	const unsigned int first = 32;
+	const unsigned int count = 224;
+	const unsigned int dataOffset = 64;
+
+	// Records are indexed from 0, the font only fills [first, first + count).
+	std::vector<char> data(dataOffset + (first + count) * 32, 0);
+	writeValue<uint32_t>(data, 0, count);
+	writeValue<float>(data, 12, 8.0f);
+	writeValue<float>(data, 36, static_cast<float>(first));
+	writeValue<uint32_t>(data, 40, dataOffset);
+
+	for (unsigned int i = first; i < first + count; i++)
+	{
+		size_t offset = dataOffset + i * 32;
+		writeValue<float>(data, offset + 8, (i % 16) / 16.0f);
+		writeValue<float>(data, offset + 12, (i / 16) / 16.0f);
+		writeValue<float>(data, offset + 16, (i % 16 + 1) / 16.0f);
+		writeValue<float>(data, offset + 20, (i / 16 + 1) / 16.0f);
+		writeValue<float>(data, offset + 24, 12.0f);
+	}
+
+	while (state.keepRunning())
+	{
+		WFN font;
+		font.load(data);
+		doNotOptimize(font);
+	}
+
+	state.setBytesProcessed(data.size());
+	state.setItemsProcessed(count, "glyphs");
+}
+
+BENCHMARK_CASE(ParserParseShader)
+{
+	// Same shape as the game's shaders: "#line" starts each stage, properties select branches.
+	std::string source;
+	for (int stage = 0; stage < 2; stage++)
+	{
+		source += "#line 1\n";
+		for (int i = 0; i < BENCH_SHADER_COPIES; i++)
+		{
+			std::string n = std::to_string(i);
+			source += stage == 0 ? "V_IN vec3 position;\nV_IN vec2 texcoord;\nV_OUT vec2 uv" + n + ";\n" : "P_IN vec2 uv" + n + ";\n";
+			source += "#if TEX\n\tuniform sampler2D tex" + n + "; // diffuse\n#elif ALPHA\n\tuniform float alpha" + n + ";\n#else\n\tvec4 colour" + n + ";\n#endif\n";
+		}
+		source += "void main()\n{\n\tgl_Position = vec4(0.0);\n}\n";
+	}
+
+	fs::path path = getTempPath("parser.shader");
+	if (!writeFile(path, std::vector<char>(source.begin(), source.end())))
+		return state.skip("could not write " + path.string());
+
+	std::unordered_map<std::string, int> properties = { { "TEX", 1 }, { "ALPHA", 0 } };
+
+	std::ifstream stream(path, std::ios::binary);
+	while (state.keepRunning())
+	{
+		stream.clear();
+		stream.seekg(0, std::ios::beg);
+
+		std::pair<std::string, std::string> shader = Parser::parseShader(stream, properties);
+		doNotOptimize(shader);
+	}
+	stream.close();
+
+	state.setBytesProcessed(source.size());
+
+	fs::remove(path);
+}
\ No newline at end of file
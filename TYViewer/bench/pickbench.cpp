@@ -0,0 +1,416 @@
+#include "pickbench.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <algorithm>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "bench/loadbench.h"
+#include "bench/flythrough.h"
+
+#include "loader/modelbuilder.h"
+
+#include "graphics/camera.h"
+
+#include "util/json.h"
+
+#include "config.h"
+#include "debug.h"
+#include "util/timing.h"
+#include "util/stringext.h"
+
+// Same layout as the flythrough's synthetic level.
+#define PICK_BENCHMARK_GRID_SPACING 1.2f
+
+// Pixels are chosen from this seed, the same for every run and machine.
+#define PICK_BENCHMARK_SEED 20260
+
+bool PickBenchmark::isRequested(int argc, char* argv[])
+{
+	for (int i = 1; i < argc; i++)
+	{
+		if (std::string(argv[i]) == "--bench-pick")
+			return true;
+	}
+	return false;
+}
+
+bool PickBenchmark::parseArguments(int argc, char* argv[], PickBenchmarkOptions& options)
+{
+	for (int i = 1; i < argc; i++)
+	{
+		std::string argument = argv[i];
+		bool hasValue = i + 1 < argc;
+
+		if (argument == "--bench-pick" && hasValue)
+		{
+			splitList(argv[++i], options.models);
+		}
+		else if (argument == "--trace" && hasValue)
+		{
+			// Handled before the benchmark starts.
+			i++;
+		}
+		else if (argument == "--archive" && hasValue)
+		{
+			options.archive = argv[++i];
+		}
+		else if (argument == "--json" && hasValue)
+		{
+			options.json = argv[++i];
+		}
+		else if (argument == "--frames" && hasValue)
+		{
+			options.frames = std::atoi(argv[++i]);
+			if (options.frames <= 0)
+				return false;
+		}
+		else if (argument == "--rays" && hasValue)
+		{
+			options.rays = std::atoi(argv[++i]);
+			if (options.rays <= 0)
+				return false;
+		}
+		else if (argument == "--size" && hasValue)
+		{
+			std::string size = argv[++i];
+			size_t x = size.find('x');
+			if (x == std::string::npos)
+				return false;
+
+			options.width = std::atoi(size.substr(0, x).c_str());
+			options.height = std::atoi(size.substr(x + 1).c_str());
+			if (options.width <= 0 || options.height <= 0)
+				return false;
+		}
+		else if (argument == "--grid" && hasValue)
+		{
+			options.grid = std::atoi(argv[++i]);
+			if (options.grid <= 0)
+				return false;
+		}
+		else if (argument == "--threads" && hasValue)
+		{
+			int threads = std::atoi(argv[++i]);
+			if (threads <= 0)
+				return false;
+			options.threads = static_cast<unsigned int>(threads);
+		}
+		else if (argument == "--verify" && hasValue)
+		{
+			options.verify = std::atoi(argv[++i]);
+			if (options.verify < 0)
+				return false;
+		}
+		else if (argument.size() > 2 && argument.compare(0, 2, "--") == 0)
+		{
+			return false;
+		}
+		else
+		{
+			splitList(argument, options.models);
+		}
+	}
+
+	return !options.models.empty();
+}
+
+void PickBenchmark::printUsage()
+{
+	std::cout <<
+		"Usage: TYViewer --bench-pick <model>[,<model>...] [options]" << std::endl <<
+		"  --frames <n>       Camera positions along the flythrough path (default: 60)" << std::endl <<
+		"  --rays <n>         Picks at random pixels from each position (default: 256)" << std::endl <<
+		"  --size <w>x<h>     Screen the rays go through (default: 1280x720)" << std::endl <<
+		"  --grid <n>         Repeat the models on an n x n grid as a synthetic level (default: 1)" << std::endl <<
+		"  --threads <n>      Threads building the hierarchies (default: one per core)" << std::endl <<
+		"  --verify <n>       Check the first <n> picks against every triangle, fails on a mismatch" << std::endl <<
+		"  --archive <path>   Archive to load models from (default: config.cfg)" << std::endl <<
+		"  --json <file>      Write the build time and pick percentiles as JSON" << std::endl <<
+		"  --trace <file>     Record a Chrome trace of the run" << std::endl;
+}
+
+PickBenchmark::PickBenchmark(const PickBenchmarkOptions& options) :
+	options(options),
+	sceneCenter(0.0f),
+	sceneRadius(1.0f)
+{}
+
+int PickBenchmark::run()
+{
+	if (!loadScene())
+		return -1;
+
+	auto start = std::chrono::high_resolution_clock::now();
+
+	for (auto& model : models)
+	{
+		picker.addModel(model);
+	}
+	for (auto& instance : instances)
+	{
+		for (size_t model = 0; model < models.size(); model++)
+		{
+			picker.addInstance(model, instance);
+		}
+	}
+	picker.build(options.threads);
+
+	double build = millisecondsSince(start);
+
+	printf("Built %zu nodes over %zu triangles in %.2f ms, %.1f MB\n", picker.getNodeCount(), picker.getTriangleCount(),
+		build, picker.getBytes() / (1024.0 * 1024.0));
+	fflush(stdout);
+
+	Camera camera(glm::vec3(0.0f), glm::vec3(90.0f, 0.0f, 0.0f), 70.0f, (float)options.width / (float)options.height, 0.2f, 30000.0f);
+	camera.setClipPlaneFar(std::max(30000.0f, sceneRadius * 8.0f));
+
+	std::mt19937 random(PICK_BENCHMARK_SEED);
+
+	std::vector<double> picks;
+	picks.reserve(static_cast<size_t>(options.frames) * options.rays);
+
+	size_t hits = 0;
+	size_t verified = 0;
+	size_t mismatches = 0;
+
+	for (int frame = 0; frame < options.frames; frame++)
+	{
+		FlythroughBenchmark::placeCamera(camera, sceneCenter, sceneRadius, frame, options.frames);
+
+		// Display as a left-handed coordinate system.
+		glm::mat4 view = glm::scale(camera.getViewMatrix(), glm::vec3(1.0f, 1.0f, -1.0f));
+		glm::mat4 viewProjection = camera.getProjectionMatrix() * view;
+
+		for (int i = 0; i < options.rays; i++)
+		{
+			glm::vec2 pixel(static_cast<float>(random() % options.width), static_cast<float>(random() % options.height));
+			Ray ray = Picker::getRay(viewProjection, pixel, options.width, options.height);
+
+			PickResult result;
+			auto pickStart = std::chrono::high_resolution_clock::now();
+			bool hit = picker.pick(ray, result);
+			picks.push_back(millisecondsSince(pickStart) * 1000.0);
+
+			if (hit)
+				hits++;
+
+			if (verified < static_cast<size_t>(options.verify))
+			{
+				verified++;
+
+				PickResult expected;
+				bool expectedHit = pickLinear(ray, expected);
+
+				// Triangles at the same distance may be reported either way.
+				float tolerance = 1e-4f * std::max(1.0f, expected.distance);
+				if (hit != expectedHit || (hit && std::abs(result.distance - expected.distance) > tolerance))
+				{
+					mismatches++;
+					LOG_ERROR(General, "Pick " + std::to_string(picks.size() - 1) + " differs from the linear test: " +
+						(hit ? std::to_string(result.distance) : std::string("miss")) + " against " +
+						(expectedHit ? std::to_string(expected.distance) : std::string("miss")));
+				}
+			}
+		}
+	}
+
+	LoadPercentiles percentiles = LoadBenchmark::getPercentiles(picks);
+
+	printf("%zu picks, %.1f%% hit\n", picks.size(), picks.empty() ? 0.0 : hits * 100.0 / picks.size());
+	printf("Pick us: p50 %.2f, p90 %.2f, p99 %.2f, mean %.2f, max %.2f\n",
+		percentiles.p50, percentiles.p90, percentiles.p99, percentiles.mean, percentiles.max);
+	if (options.verify > 0)
+	{
+		printf("Verified %zu picks against every triangle, %zu mismatches\n", verified, mismatches);
+	}
+	fflush(stdout);
+
+	if (!options.json.empty() && !writeJSON(build, picks, hits, mismatches))
+	{
+		LOG_ERROR(General, "Failed to write pick benchmark results: " + options.json);
+		return -1;
+	}
+
+	return mismatches == 0 ? 0 : 1;
+}
+
+bool PickBenchmark::loadScene()
+{
+	archivePath = options.archive.empty() ? Config::archive : options.archive;
+	if (archivePath.empty())
+	{
+		LOG_ERROR(General, "No archive specified, use --archive or config.cfg");
+		return false;
+	}
+
+	if (!archive.load(archivePath))
+	{
+		LOG_ERROR(General, "Failed to load archive: " + archivePath);
+		return false;
+	}
+
+	// Loaders log per file, keep that out of the measurements.
+	Debug::setLevel(Debug::Level::Warning);
+
+	glm::vec3 min(0.0f);
+	glm::vec3 max(0.0f);
+
+	for (auto& name : options.models)
+	{
+		ModelData data;
+		if (!ModelBuilder::build(archive, name, data))
+		{
+			LOG_ERROR(General, "Failed to load model: " + name + " (" + data.error + ")");
+			return false;
+		}
+
+		// Displayed as a left-handed coordinate system, z is flipped by the view.
+		glm::vec3 corner = data.boundsCorner;
+		corner.z = -corner.z - data.boundsSize.z;
+
+		if (models.empty())
+		{
+			min = corner;
+			max = corner + data.boundsSize;
+		}
+		else
+		{
+			min = glm::min(min, corner);
+			max = glm::max(max, corner + data.boundsSize);
+		}
+
+		models.push_back(std::move(data));
+	}
+
+	// The models as a whole are repeated, spaced by their combined footprint.
+	glm::vec3 size = max - min;
+	float spacing = std::max(std::max(size.x, size.z), 1.0f) * PICK_BENCHMARK_GRID_SPACING;
+	float offset = (options.grid - 1) * spacing / 2.0f;
+
+	for (int x = 0; x < options.grid; x++)
+	{
+		for (int z = 0; z < options.grid; z++)
+		{
+			// Instances are placed in model space, where z is not flipped yet.
+			instances.push_back(glm::translate(glm::mat4(1.0f), glm::vec3(x * spacing - offset, 0.0f, -(z * spacing - offset))));
+		}
+	}
+
+	sceneCenter = (min + max) / 2.0f;
+	sceneRadius = std::max(glm::length(glm::vec3(size.x + 2.0f * offset, size.y, size.z + 2.0f * offset)) / 2.0f, 1.0f);
+
+	size_t triangles = 0;
+	for (auto& model : models)
+	{
+		triangles += model.indices.size() / 3;
+	}
+
+	printf("Scene: %zu models x %zu instances, %zu triangles, radius %.1f\n", models.size(), instances.size(), triangles * instances.size(), sceneRadius);
+	fflush(stdout);
+
+	return true;
+}
+
+bool PickBenchmark::pickLinear(const Ray& ray, PickResult& result) const
+{
+	bool hit = false;
+
+	for (size_t instance = 0; instance < instances.size(); instance++)
+	{
+		for (size_t model = 0; model < models.size(); model++)
+		{
+			const ModelData& data = models[model];
+			for (size_t mesh = 0; mesh < data.meshes.size(); mesh++)
+			{
+				const MeshRange& range = data.meshes[mesh];
+				if (range.vertexOffset + range.vertexCount > data.vertices.size() ||
+					range.indexOffset + range.indexCount > data.indices.size())
+					continue;
+
+				for (size_t triangle = 0; triangle < range.indexCount / 3; triangle++)
+				{
+					const unsigned int* indices = &data.indices[range.indexOffset + triangle * 3];
+					if (indices[0] >= range.vertexCount || indices[1] >= range.vertexCount || indices[2] >= range.vertexCount)
+						continue;
+
+					glm::vec3 corners[3];
+					for (int corner = 0; corner < 3; corner++)
+					{
+						corners[corner] = glm::vec3(instances[instance] * data.vertices[range.vertexOffset + indices[corner]].position);
+					}
+
+					// Moller-Trumbore, as the hierarchy does it.
+					glm::vec3 e1 = corners[1] - corners[0];
+					glm::vec3 e2 = corners[2] - corners[0];
+					glm::vec3 p = glm::cross(ray.direction, e2);
+					float determinant = glm::dot(e1, p);
+					if (std::abs(determinant) <= 1e-12f)
+						continue;
+
+					float inverse = 1.0f / determinant;
+					glm::vec3 s = ray.origin - corners[0];
+					float u = glm::dot(s, p) * inverse;
+					glm::vec3 q = glm::cross(s, e1);
+					float v = glm::dot(ray.direction, q) * inverse;
+					float t = glm::dot(e2, q) * inverse;
+
+					if (u < 0.0f || v < 0.0f || u + v > 1.0f || t <= 0.0f || t >= result.distance)
+						continue;
+
+					hit = true;
+					result.distance = t;
+					result.position = ray.origin + ray.direction * t;
+					result.model = model;
+					result.instance = instance * models.size() + model;
+					result.mesh = mesh;
+					result.component = range.component;
+					result.triangle = static_cast<uint32_t>(triangle);
+				}
+			}
+		}
+	}
+
+	return hit;
+}
+
+bool PickBenchmark::writeJSON(double buildMilliseconds, const std::vector<double>& picks, size_t hits, size_t mismatches) const
+{
+	std::ofstream stream(options.json, std::ios::out | std::ios::trunc);
+	if (stream.fail())
+		return false;
+
+	LoadPercentiles p = LoadBenchmark::getPercentiles(picks);
+
+	stream << std::fixed << std::setprecision(4);
+	stream << "{" << std::endl;
+	stream << "\t\"archive\": \"" << Json::escape(archivePath) << "\"," << std::endl;
+
+	stream << "\t\"models\": [";
+	for (size_t i = 0; i < options.models.size(); i++)
+	{
+		stream << (i > 0 ? ", " : "") << "\"" << Json::escape(options.models[i]) << "\"";
+	}
+	stream << "]," << std::endl;
+
+	stream << "\t\"grid\": " << options.grid << "," << std::endl;
+	stream << "\t\"instances\": " << picker.getInstanceCount() << "," << std::endl;
+	stream << "\t\"triangles\": " << picker.getTriangleCount() << "," << std::endl;
+	stream << "\t\"nodes\": " << picker.getNodeCount() << "," << std::endl;
+	stream << "\t\"bytes\": " << picker.getBytes() << "," << std::endl;
+	stream << "\t\"buildMilliseconds\": " << buildMilliseconds << "," << std::endl;
+	stream << "\t\"picks\": " << picks.size() << "," << std::endl;
+	stream << "\t\"hits\": " << hits << "," << std::endl;
+	stream << "\t\"mismatches\": " << mismatches << "," << std::endl;
+	stream << "\t\"pickMicroseconds\": { \"p50\": " << p.p50 << ", \"p90\": " << p.p90 << ", \"p99\": " << p.p99 <<
+		", \"mean\": " << p.mean << ", \"min\": " << p.min << ", \"max\": " << p.max << " }" << std::endl;
+	stream << "}" << std::endl;
+
+	return true;
+}
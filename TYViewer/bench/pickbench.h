@@ -0,0 +1,69 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "loader/archive.h"
+#include "loader/modeldata.h"
+
+#include "picking/picker.h"
+
+struct PickBenchmarkOptions
+{
+	std::vector<std::string> models;
+
+	std::string archive;
+	std::string json;
+
+	// Camera positions along the flythrough path, and rays cast from each.
+	int frames = 60;
+	int rays = 256;
+
+	int width = 1280;
+	int height = 720;
+
+	// Copies of the models along each side of a square, laid out like the flythrough's level.
+	int grid = 1;
+
+	// Threads building the meshes, 0 uses every core.
+	unsigned int threads = 0;
+
+	// Rays also tested against every triangle of the scene, the two must agree.
+	int verify = 0;
+};
+
+// Builds the pick hierarchies over a synthetic level and times picks through the screen from
+// the flythrough's camera path. No GPU or OpenGL needed.
+// Usage: TYViewer --bench-pick <model>[,<model>...] [options]
+class PickBenchmark
+{
+public:
+	static bool isRequested(int argc, char* argv[]);
+	static bool parseArguments(int argc, char* argv[], PickBenchmarkOptions& options);
+	static void printUsage();
+
+	PickBenchmark(const PickBenchmarkOptions& options);
+
+	int run();
+
+private:
+	bool loadScene();
+
+	// The closest hit by testing every triangle, for --verify.
+	bool pickLinear(const Ray& ray, PickResult& result) const;
+
+	bool writeJSON(double buildMilliseconds, const std::vector<double>& picks, size_t hits, size_t mismatches) const;
+
+	PickBenchmarkOptions options;
+
+	Archive archive;
+	std::string archivePath;
+
+	std::vector<ModelData> models;
+	std::vector<glm::mat4> instances;
+
+	Picker picker;
+
+	glm::vec3 sceneCenter;
+	float sceneRadius;
+};
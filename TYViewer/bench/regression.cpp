@@ -0,0 +1,373 @@
+#include "regression.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <algorithm>
+#include <filesystem>
+
+#include "headless.h"
+
+#include "util/json.h"
+
+#include "debug.h"
+#include "util/stringext.h"
+
+bool Regression::isRequested(int argc, char* argv[])
+{
+	for (int i = 1; i < argc; i++)
+	{
+		if (std::string(argv[i]) == "--perf-check")
+			return true;
+	}
+	return false;
+}
+
+bool Regression::parseArguments(int argc, char* argv[], RegressionOptions& options)
+{
+	// Shorter than a standalone run, the repeats make up for it.
+	options.benchmarks.minSeconds = 0.2;
+
+	for (int i = 1; i < argc; i++)
+	{
+		std::string argument = argv[i];
+		bool hasValue = i + 1 < argc;
+
+		if (argument == "--perf-check" && hasValue)
+		{
+			options.baseline = argv[++i];
+		}
+		else if (argument == "--trace" && hasValue)
+		{
+			// Handled before the check starts.
+			i++;
+		}
+		else if (argument == "--update")
+		{
+			options.update = true;
+		}
+		else if (argument == "--repeats" && hasValue)
+		{
+			options.repeats = std::atoi(argv[++i]);
+			if (options.repeats <= 0)
+				return false;
+		}
+		else if (argument == "--threshold" && hasValue)
+		{
+			options.threshold = std::atof(argv[++i]) / 100.0;
+			if (options.threshold <= 0.0)
+				return false;
+		}
+		else if (argument == "--min-time" && hasValue)
+		{
+			options.benchmarks.minSeconds = std::atof(argv[++i]);
+			if (options.benchmarks.minSeconds <= 0.0)
+				return false;
+		}
+		else if (argument == "--filter" && hasValue)
+		{
+			options.benchmarks.filter = argv[++i];
+		}
+		else if (argument == "--inputs" && hasValue)
+		{
+			options.benchmarks.inputs = argv[++i];
+		}
+		else if (argument == "--no-parsers")
+		{
+			options.parsers = false;
+		}
+		else if (argument == "--models" && hasValue)
+		{
+			splitList(argv[++i], options.models);
+		}
+		else if (argument == "--archive" && hasValue)
+		{
+			options.archive = argv[++i];
+		}
+		else if (argument == "--software")
+		{
+			options.software = true;
+		}
+		else
+		{
+			return false;
+		}
+	}
+
+	return !options.baseline.empty();
+}
+
+void Regression::printUsage()
+{
+	std::cout <<
+		"Usage: TYViewer --perf-check <baseline.json> [options]" << std::endl <<
+		"  --update             Write the measurements as the new baseline" << std::endl <<
+		"  --repeats <n>        Runs of every suite (default: 5)" << std::endl <<
+		"  --threshold <pct>    Slowdown that counts as a regression (default: 10)" << std::endl <<
+		"  --min-time <s>       Minimum time per parser benchmark and run (default: 0.2)" << std::endl <<
+		"  --filter <text>      Only run parser benchmarks whose name contains <text>" << std::endl <<
+		"  --inputs <dir>       Directory with .mdl/.mdg pairs (default: TEST_FILES)" << std::endl <<
+		"  --no-parsers         Skip the parser benchmarks" << std::endl <<
+		"  --models <a,b,...>   Also load and render these models headless" << std::endl <<
+		"  --archive <path>     Archive for --models (default: config.cfg)" << std::endl <<
+		"  --software           Use Mesa's software rasterizer for --models" << std::endl;
+}
+
+Regression::Regression(const RegressionOptions& options) :
+	options(options)
+{}
+
+int Regression::run()
+{
+	// Loaders log per file, keep that out of the measurements.
+	Debug::setLevel(Debug::Level::Warning);
+
+	std::vector<RegressionMetric> metrics;
+
+	for (int repeat = 0; repeat < options.repeats; repeat++)
+	{
+		printf("Run %d of %d\n", repeat + 1, options.repeats);
+		fflush(stdout);
+
+		if (options.parsers)
+			runParsers(metrics);
+
+		if (!options.models.empty() && !runHeadless(metrics))
+			return -1;
+	}
+
+	if (metrics.empty())
+	{
+		LOG_ERROR(General, "Nothing was measured");
+		return -1;
+	}
+
+	for (auto& metric : metrics)
+	{
+		summarize(metric);
+	}
+
+	if (options.update)
+	{
+		if (!writeBaseline(metrics))
+		{
+			LOG_ERROR(General, "Failed to write baseline: " + options.baseline);
+			return -1;
+		}
+
+		printf("Wrote baseline with %zu metrics to %s\n", metrics.size(), options.baseline.c_str());
+		return 0;
+	}
+
+	std::vector<RegressionMetric> baseline;
+	if (!loadBaseline(baseline))
+	{
+		LOG_ERROR(General, "Failed to read baseline: " + options.baseline + ", create one with --update");
+		return -1;
+	}
+
+	return compare(baseline, metrics);
+}
+
+void Regression::runParsers(std::vector<RegressionMetric>& metrics)
+{
+	std::vector<BenchmarkResult> results = Benchmark::runAll(options.benchmarks);
+
+	for (auto& result : results)
+	{
+		if (result.skipped)
+			continue;
+
+		// One sample per run, batches within a run share machine state and would understate the noise.
+		getMetric(metrics, "parsers/" + result.name).samples.push_back(result.medianNs);
+	}
+}
+
+bool Regression::runHeadless(std::vector<RegressionMetric>& metrics)
+{
+	std::error_code error;
+	std::filesystem::path output = std::filesystem::temp_directory_path(error) / "tyviewer_perf_check";
+	std::filesystem::create_directories(output, error);
+
+	HeadlessOptions headlessOptions;
+	headlessOptions.models = options.models;
+	headlessOptions.archive = options.archive;
+	headlessOptions.output = output.string();
+	headlessOptions.software = options.software;
+
+	Headless headless(headlessOptions);
+	if (headless.run() < 0)
+	{
+		LOG_ERROR(General, "Headless suite failed to start");
+		return false;
+	}
+
+	for (auto& result : headless.getResults())
+	{
+		if (!result.loaded)
+			continue;
+
+		getMetric(metrics, "headless/" + result.name + "/load").samples.push_back(result.loadMilliseconds * 1e6);
+		getMetric(metrics, "headless/" + result.name + "/render").samples.push_back(result.renderMilliseconds * 1e6);
+	}
+
+	std::filesystem::remove_all(output, error);
+	return true;
+}
+
+RegressionMetric& Regression::getMetric(std::vector<RegressionMetric>& metrics, const std::string& name)
+{
+	for (auto& metric : metrics)
+	{
+		if (metric.name == name)
+			return metric;
+	}
+
+	metrics.push_back(RegressionMetric());
+	metrics.back().name = name;
+	return metrics.back();
+}
+
+void Regression::summarize(RegressionMetric& metric)
+{
+	std::vector<double> sorted = metric.samples;
+	std::sort(sorted.begin(), sorted.end());
+
+	size_t n = sorted.size();
+	if (n == 0)
+		return;
+
+	metric.median = n % 2 == 1 ? sorted[n / 2] : (sorted[n / 2 - 1] + sorted[n / 2]) / 2.0;
+
+	// Distribution-free interval from order statistics: ranks n/2 -+ 1.96 * sqrt(n) / 2.
+	double half = 0.98 * std::sqrt(static_cast<double>(n));
+	double lowRank = std::floor(n / 2.0 - half);
+	double highRank = std::ceil(n / 2.0 + half);
+
+	metric.low = sorted[static_cast<size_t>(std::max(0.0, lowRank))];
+	metric.high = sorted[static_cast<size_t>(std::min(static_cast<double>(n - 1), highRank))];
+}
+
+bool Regression::loadBaseline(std::vector<RegressionMetric>& metrics) const
+{
+	Json root;
+	if (!Json::load(options.baseline, root))
+		return false;
+
+	const Json* list = root.find("metrics");
+	if (list == nullptr || list->type != Json::Type::Array)
+		return false;
+
+	for (auto& item : list->array)
+	{
+		RegressionMetric metric;
+		metric.name = item.getString("name");
+		metric.median = item.getNumber("median");
+		metric.low = item.getNumber("low", metric.median);
+		metric.high = item.getNumber("high", metric.median);
+
+		if (!metric.name.empty() && metric.median > 0.0)
+			metrics.push_back(metric);
+	}
+
+	return true;
+}
+
+bool Regression::writeBaseline(const std::vector<RegressionMetric>& metrics) const
+{
+	std::ofstream stream(options.baseline, std::ios::out | std::ios::trunc);
+	if (stream.fail())
+		return false;
+
+	stream << std::setprecision(10);
+	stream << "{" << std::endl;
+	stream << "\t\"repeats\": " << options.repeats << "," << std::endl;
+	stream << "\t\"metrics\": [" << std::endl;
+
+	for (size_t i = 0; i < metrics.size(); i++)
+	{
+		const RegressionMetric& metric = metrics[i];
+
+		stream << "\t\t{ \"name\": \"" << Json::escape(metric.name) << "\"";
+		stream << ", \"median\": " << metric.median;
+		stream << ", \"low\": " << metric.low;
+		stream << ", \"high\": " << metric.high;
+		stream << ", \"samples\": " << metric.samples.size() << " }";
+		stream << (i + 1 < metrics.size() ? "," : "") << std::endl;
+	}
+
+	stream << "\t]" << std::endl;
+	stream << "}" << std::endl;
+
+	return !stream.fail();
+}
+
+int Regression::compare(const std::vector<RegressionMetric>& baseline, const std::vector<RegressionMetric>& current) const
+{
+	int regressions = 0;
+	int improvements = 0;
+
+	printf("\n%-48s %12s %12s %8s  %s\n", "Metric", "Baseline", "Current", "Change", "Status");
+
+	for (auto& metric : current)
+	{
+		const RegressionMetric* reference = nullptr;
+		for (auto& candidate : baseline)
+		{
+			if (candidate.name == metric.name)
+				reference = &candidate;
+		}
+
+		if (reference == nullptr)
+		{
+			printf("%-48s %12s %12s %8s  new\n", metric.name.c_str(), "-", Benchmark::formatTime(metric.median).c_str(), "");
+			continue;
+		}
+
+		double change = metric.median / reference->median - 1.0;
+
+		// Both the relative change and non-overlapping intervals are needed, so noisy
+		// metrics don't fail on a bad run and stable ones don't fail on tiny shifts.
+		bool slower = change > options.threshold && metric.low > reference->high;
+		bool faster = change < -options.threshold && metric.high < reference->low;
+
+		std::string status = "ok";
+		if (slower)
+		{
+			status = "REGRESSED, now " + Benchmark::formatTime(metric.low) + " .. " + Benchmark::formatTime(metric.high) +
+				", was " + Benchmark::formatTime(reference->low) + " .. " + Benchmark::formatTime(reference->high);
+			regressions++;
+		}
+		else if (faster)
+		{
+			status = "faster";
+			improvements++;
+		}
+
+		printf("%-48s %12s %12s %+7.1f%%  %s\n", metric.name.c_str(),
+			Benchmark::formatTime(reference->median).c_str(), Benchmark::formatTime(metric.median).c_str(),
+			change * 100.0, status.c_str());
+	}
+
+	for (auto& reference : baseline)
+	{
+		bool measured = false;
+		for (auto& metric : current)
+		{
+			measured |= metric.name == reference.name;
+		}
+
+		if (!measured)
+			printf("%-48s %12s %12s %8s  not measured\n", reference.name.c_str(), Benchmark::formatTime(reference.median).c_str(), "-", "");
+	}
+
+	printf("\n%d regressed, %d faster (threshold %.0f%%, 95%% confidence)\n", regressions, improvements, options.threshold * 100.0);
+	if (improvements > 0 && regressions == 0)
+		printf("Consider updating the baseline with --update\n");
+
+	fflush(stdout);
+	return regressions > 0 ? 1 : 0;
+}
\ No newline at end of file
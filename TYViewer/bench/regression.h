@@ -0,0 +1,70 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "benchmark.h"
+
+struct RegressionOptions
+{
+	std::string baseline;
+
+	// Writes the measurements as the new baseline instead of comparing.
+	bool update = false;
+
+	// Every suite runs this many times, interleaved so drift hits all metrics alike.
+	int repeats = 5;
+
+	// Relative slowdown that fails the check, if it is also outside the noise.
+	double threshold = 0.10;
+
+	bool parsers = true;
+	BenchmarkSettings benchmarks;
+
+	// Models rendered by the headless suite, none skips it.
+	std::vector<std::string> models;
+	std::string archive;
+	bool software = false;
+};
+
+// One measured quantity, in nanoseconds.
+struct RegressionMetric
+{
+	std::string name;
+	std::vector<double> samples;
+
+	double median = 0.0;
+
+	// 95% confidence interval of the median.
+	double low = 0.0;
+	double high = 0.0;
+};
+
+// Runs the benchmark suites and compares them with a stored baseline.
+// Usage: TYViewer --perf-check <baseline.json> [options]
+class Regression
+{
+public:
+	static bool isRequested(int argc, char* argv[]);
+	static bool parseArguments(int argc, char* argv[], RegressionOptions& options);
+	static void printUsage();
+
+	Regression(const RegressionOptions& options);
+
+	// 0 when nothing regressed, 1 on regressions, -1 on errors.
+	int run();
+
+private:
+	void runParsers(std::vector<RegressionMetric>& metrics);
+	bool runHeadless(std::vector<RegressionMetric>& metrics);
+
+	static RegressionMetric& getMetric(std::vector<RegressionMetric>& metrics, const std::string& name);
+	static void summarize(RegressionMetric& metric);
+
+	bool loadBaseline(std::vector<RegressionMetric>& metrics) const;
+	bool writeBaseline(const std::vector<RegressionMetric>& metrics) const;
+
+	int compare(const std::vector<RegressionMetric>& baseline, const std::vector<RegressionMetric>& current) const;
+
+	RegressionOptions options;
+};
@@ -0,0 +1,688 @@
+#include "skinbench.h"
+
+#include <cmath>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <fstream>
+#include <iomanip>
+#include <algorithm>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "bench/loadbench.h"
+#include "bench/animbench.h"
+
+#include "graphics/renderstats.h"
+
+#include "util/json.h"
+
+#include "config.h"
+#include "debug.h"
+#include "util/timing.h"
+#include "util/stringext.h"
+
+// Actors are placed and timed from this seed, the same in both modes and on every machine.
+#define SKINNING_BENCHMARK_SEED 20262
+
+// One frame at 60 Hz.
+#define SKINNING_BENCHMARK_STEP (1.0f / 60.0f)
+
+#define SKINNING_BENCHMARK_GRID_SPACING 1.2f
+
+// Channel difference under which --verify counts two pixels the same, and the share of differing
+// pixels it accepts. Edges land on other pixels where the two paths round differently.
+#define SKINNING_BENCHMARK_PIXEL_TOLERANCE 8
+#define SKINNING_BENCHMARK_MAX_PIXEL_DIFFERENCE 0.01
+
+static bool splitCounts(const std::string& list, std::vector<int>& counts)
+{
+	std::vector<std::string> values;
+	splitList(list, values);
+
+	counts.clear();
+	for (auto& value : values)
+	{
+		int count = std::atoi(value.c_str());
+		if (count <= 0)
+			return false;
+		counts.push_back(count);
+	}
+	return !counts.empty();
+}
+
+// One timing of every frame, skipping those with no result.
+static std::vector<double> getTimings(const std::vector<FlythroughFrame>& frames, double FlythroughFrame::* timing)
+{
+	std::vector<double> values;
+	for (auto& frame : frames)
+	{
+		if (frame.*timing >= 0.0)
+			values.push_back(frame.*timing);
+	}
+	return values;
+}
+
+static const char* getModeName(SkinningMode mode)
+{
+	return mode == SkinningMode::CPU ? "CPU" : "GPU";
+}
+
+bool SkinningBenchmark::isRequested(int argc, char* argv[])
+{
+	for (int i = 1; i < argc; i++)
+	{
+		if (std::string(argv[i]) == "--bench-skin")
+			return true;
+	}
+	return false;
+}
+
+bool SkinningBenchmark::parseArguments(int argc, char* argv[], SkinningBenchmarkOptions& options)
+{
+	for (int i = 1; i < argc; i++)
+	{
+		std::string argument = argv[i];
+		bool hasValue = i + 1 < argc;
+
+		if (argument == "--bench-skin" && hasValue)
+		{
+			splitList(argv[++i], options.models);
+		}
+		else if (argument == "--trace" && hasValue)
+		{
+			// Handled before the benchmark starts.
+			i++;
+		}
+		else if (argument == "--archive" && hasValue)
+		{
+			options.archive = argv[++i];
+		}
+		else if (argument == "--json" && hasValue)
+		{
+			options.json = argv[++i];
+		}
+		else if (argument == "--actors" && hasValue)
+		{
+			if (!splitCounts(argv[++i], options.actors))
+				return false;
+		}
+		else if (argument == "--frames" && hasValue)
+		{
+			options.frames = std::atoi(argv[++i]);
+			if (options.frames <= 0)
+				return false;
+		}
+		else if (argument == "--warmup" && hasValue)
+		{
+			options.warmup = std::atoi(argv[++i]);
+			if (options.warmup < 0)
+				return false;
+		}
+		else if (argument == "--size" && hasValue)
+		{
+			std::string size = argv[++i];
+			size_t x = size.find('x');
+			if (x == std::string::npos)
+				return false;
+
+			options.width = std::atoi(size.substr(0, x).c_str());
+			options.height = std::atoi(size.substr(x + 1).c_str());
+			if (options.width <= 0 || options.height <= 0)
+				return false;
+		}
+		else if (argument == "--clips" && hasValue)
+		{
+			options.clips = std::atoi(argv[++i]);
+			if (options.clips <= 0)
+				return false;
+		}
+		else if (argument == "--threads" && hasValue)
+		{
+			int threads = std::atoi(argv[++i]);
+			if (threads <= 0)
+				return false;
+			options.threads = static_cast<unsigned int>(threads);
+		}
+		else if (argument == "--verify")
+		{
+			options.verify = true;
+		}
+		else if (argument == "--software")
+		{
+			options.software = true;
+		}
+		else if (argument.size() > 2 && argument.compare(0, 2, "--") == 0)
+		{
+			return false;
+		}
+		else
+		{
+			splitList(argument, options.models);
+		}
+	}
+
+	return !options.models.empty();
+}
+
+void SkinningBenchmark::printUsage()
+{
+	std::cout <<
+		"Usage: TYViewer --bench-skin <model>[,<model>...] [options]" << std::endl <<
+		"  --actors <n>[,<n>...]  Actor counts to measure, each on the CPU and the GPU (default: 16,64,256)" << std::endl <<
+		"  --frames <n>           Measured frames of 1/60 s per count and mode (default: 120)" << std::endl <<
+		"  --warmup <n>           Unmeasured frames rendered first (default: 10)" << std::endl <<
+		"  --size <w>x<h>         Framebuffer size (default: 1280x720)" << std::endl <<
+		"  --clips <n>            Clips made for each model (default: 4)" << std::endl <<
+		"  --threads <n>          Threads posing and skinning (default: one per core)" << std::endl <<
+		"  --verify               Check bone indices and compare the first frame of both modes, fails on either" << std::endl <<
+		"  --archive <path>       Archive to load models from (default: config.cfg)" << std::endl <<
+		"  --json <file>          Write every count's timings and upload sizes as JSON" << std::endl <<
+		"  --software             Use Mesa's software rasterizer" << std::endl <<
+		"  --trace <file>         Record a Chrome trace of the run" << std::endl;
+}
+
+SkinningBenchmark::SkinningBenchmark(const SkinningBenchmarkOptions& options) :
+	options(options),
+	context(),
+	renderer(),
+	framebuffer(),
+	camera(glm::vec3(0.0f), glm::vec3(90.0f, 0.0f, 0.0f), 70.0f, (float)options.width / (float)options.height, 0.2f, 30000.0f),
+	content(),
+	staticShader(nullptr),
+	skinnedShader(nullptr),
+	palette(),
+	boundsMin(0.0f),
+	boundsMax(0.0f),
+	animator(options.threads),
+	sceneCenter(0.0f),
+	sceneRadius(0.0f)
+{}
+
+SkinningBenchmark::~SkinningBenchmark()
+{
+	delete staticShader;
+	delete skinnedShader;
+}
+
+int SkinningBenchmark::run()
+{
+	if (!initialize() || !loadModels())
+		return -1;
+
+	std::vector<SkinningRun> runs;
+	bool failed = false;
+
+	// Both modes send indices past the skeleton to the first bone, so comparing pixels can't catch them.
+	if (options.verify)
+	{
+		for (size_t i = 0; i < skinned.size(); i++)
+		{
+			if (!skinned[i].bones.empty() && skinned[i].outOfRangeBones > 0)
+			{
+				LOG_ERROR(General, options.models[i] + " has " + std::to_string(skinned[i].outOfRangeBones) +
+					" vertex bone indices past its " + std::to_string(skinned[i].bones.size()) + " bones");
+				failed = true;
+			}
+		}
+	}
+
+	for (int count : options.actors)
+	{
+		TRACE_ZONE("Skinning actor count");
+
+		SkinningRun result;
+		result.actors = count;
+
+		addActors(count);
+		result.vertices = animator.getVertexCount();
+
+		for (int actor = 0; actor < count; actor++)
+		{
+			result.bones += skinned[actorModels[actor]].bones.size();
+		}
+
+		if (options.verify)
+		{
+			result.pixelDifference = comparePixels();
+			if (result.pixelDifference > SKINNING_BENCHMARK_MAX_PIXEL_DIFFERENCE)
+			{
+				LOG_ERROR(General, "GPU skinning differs from the CPU at " + std::to_string(count) + " actors in " +
+					std::to_string(result.pixelDifference * 100.0) + "% of pixels");
+				failed = true;
+			}
+		}
+
+		measure(SkinningMode::CPU, result.cpu);
+		result.cpuUploadBytes = result.vertices * sizeof(SkinnedVertex);
+
+		addActors(count);
+		measure(SkinningMode::GPU, result.gpu);
+		result.gpuUploadBytes = palette.getUploadBytes();
+
+		runs.push_back(std::move(result));
+	}
+
+	print(runs);
+
+	if (!options.json.empty() && !writeJSON(runs))
+	{
+		LOG_ERROR(General, "Failed to write skinning benchmark results: " + options.json);
+		return -1;
+	}
+
+	return failed ? 1 : 0;
+}
+
+bool SkinningBenchmark::initialize()
+{
+	archive = options.archive.empty() ? Config::archive : options.archive;
+	if (archive.empty())
+	{
+		LOG_ERROR(General, "No archive specified, use --archive or config.cfg");
+		return false;
+	}
+
+	if (!context.create(options.software))
+		return false;
+
+	renderer.initialize();
+	gpuTimer.initialize();
+	palette.initialize();
+
+	if (!framebuffer.create(options.width, options.height))
+		return false;
+
+	content.initialize();
+	if (!content.loadRKV(archive))
+	{
+		LOG_ERROR(General, "Failed to load archive: " + archive);
+		return false;
+	}
+
+	// Built in rather than standard.shader, so both modes differ only in their vertex shader.
+	staticShader = Shader::createDefault();
+	skinnedShader = Shader::createSkinned();
+
+	for (Shader* shader : { staticShader, skinnedShader })
+	{
+		shader->bind();
+		shader->setUniform4f("tintColour", glm::vec4(1, 1, 1, 1));
+		shader->setUniform1i("diffuseTexture", 0);
+	}
+	skinnedShader->setUniform1i("bonePalette", BONE_PALETTE_TEXTURE_UNIT);
+
+	return true;
+}
+
+bool SkinningBenchmark::loadModels()
+{
+	std::vector<Vertex> vertices;
+
+	for (auto& name : options.models)
+	{
+		Model* model = content.load<Model>(name);
+		if (model == nullptr)
+		{
+			LOG_ERROR(General, "Failed to load model: " + name);
+			return false;
+		}
+
+		if (model->bones.empty())
+		{
+			LOG_WARNING(General, name + " has no bones, the GPU draws it static and the CPU skins it by the identity");
+		}
+
+		// In draw order, so the CPU's skinned vertices line up with every mesh's own.
+		SkinnedVertexBuffer::gatherVertices(*model, vertices);
+
+		SkinnedModel skinnedModel;
+		skinnedModel.build(vertices, model->bones);
+
+		float size = std::max(glm::length(model->bounds_size), 1.0f);
+		for (int clip = 0; clip < options.clips; clip++)
+		{
+			AnimationClip keyframes;
+			AnimationBenchmark::makeClip(model->bones, size, SKINNING_BENCHMARK_SEED + static_cast<unsigned int>(clips.size()), 1.0f + 0.5f * clip, keyframes);
+
+			clips.emplace_back();
+			clips.back().build(keyframes);
+		}
+
+		// Displayed as a left-handed coordinate system, z is flipped by the view.
+		glm::vec3 corner = model->bounds_crn;
+		corner.z = -corner.z - model->bounds_size.z;
+
+		boundsMin = models.empty() ? corner : glm::min(boundsMin, corner);
+		boundsMax = models.empty() ? corner + model->bounds_size : glm::max(boundsMax, corner + model->bounds_size);
+
+		printf("%s: %zu vertices, %zu bones, %zu meshes\n", name.c_str(), skinnedModel.vertices.size(), skinnedModel.bones.size(), model->getMeshes().size());
+
+		models.push_back(model);
+		skinned.push_back(std::move(skinnedModel));
+	}
+	fflush(stdout);
+
+	// Loaders log per file, keep that out of the measurements.
+	Debug::setLevel(Debug::Level::Warning);
+
+	return true;
+}
+
+void SkinningBenchmark::addActors(int count)
+{
+	std::mt19937 random(SKINNING_BENCHMARK_SEED);
+	std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+	animator.clear();
+	actorModels.clear();
+	instances.clear();
+
+	int side = static_cast<int>(std::ceil(std::sqrt(static_cast<double>(count))));
+
+	glm::vec3 size = boundsMax - boundsMin;
+	float spacing = std::max(std::max(size.x, size.z), 1.0f) * SKINNING_BENCHMARK_GRID_SPACING;
+	float offset = (side - 1) * spacing / 2.0f;
+
+	for (int actor = 0; actor < count; actor++)
+	{
+		size_t model = actor % models.size();
+		size_t clip = model * options.clips + (actor / models.size()) % options.clips;
+
+		animator.addActor(skinned[model], clips[clip], unit(random) * clips[clip].getDuration(), 0.8f + 0.4f * unit(random));
+		actorModels.push_back(model);
+
+		// Placed in model space, where z is not flipped yet.
+		int x = actor % side;
+		int z = actor / side;
+		instances.push_back(glm::translate(glm::mat4(1.0f), glm::vec3(x * spacing - offset, 0.0f, -(z * spacing - offset))));
+	}
+
+	// Actors keep their model between counts, only the new ones need buffers.
+	while (buffers.size() < static_cast<size_t>(count))
+	{
+		std::unique_ptr<SkinnedVertexBuffer> buffer(new SkinnedVertexBuffer());
+		buffer->setup(*models[buffers.size() % models.size()]);
+		buffers.push_back(std::move(buffer));
+	}
+
+	sceneCenter = (boundsMin + boundsMax) / 2.0f;
+	sceneRadius = std::max(glm::length(glm::vec3(size.x + 2.0f * offset, size.y, size.z + 2.0f * offset)) / 2.0f, 1.0f);
+
+	camera.setClipPlaneFar(std::max(30000.0f, sceneRadius * 8.0f));
+}
+
+void SkinningBenchmark::measure(SkinningMode mode, std::vector<FlythroughFrame>& frames)
+{
+	TRACE_ZONE_DETAIL("SkinningBenchmark::measure", getModeName(mode));
+
+	for (int i = 0; i < options.warmup; i++)
+	{
+		renderFrame(mode, SKINNING_BENCHMARK_STEP, i, options.warmup);
+		glFinish();
+		RenderStats::endFrame();
+	}
+
+	frames.assign(options.frames, FlythroughFrame());
+
+	for (int i = 0; i < options.frames; i++)
+	{
+		auto frameStart = std::chrono::high_resolution_clock::now();
+
+		renderFrame(mode, SKINNING_BENCHMARK_STEP, i, options.frames);
+		frames[i].cpuMilliseconds = millisecondsSince(frameStart);
+
+		glFinish();
+		frames[i].frameMilliseconds = millisecondsSince(frameStart);
+
+		const RenderStats::Frame& stats = RenderStats::getCurrentFrame();
+		frames[i].drawCalls = stats.drawCalls;
+		frames[i].stateChanges = stats.stateChanges;
+		frames[i].triangles = stats.triangles;
+		RenderStats::endFrame();
+
+		// Query results arrive GPU_TIMER_FRAMES later, beginFrame() of frame i collects those of frame i - GPU_TIMER_FRAMES.
+		if (i >= GPU_TIMER_FRAMES)
+			frames[i - GPU_TIMER_FRAMES].gpuMilliseconds = gpuTimer.getTotalMilliseconds();
+	}
+
+	// The last frames' queries are only collected by the next beginFrame().
+	gpuTimer.beginFrame();
+	if (options.frames >= GPU_TIMER_FRAMES)
+		frames[options.frames - GPU_TIMER_FRAMES].gpuMilliseconds = gpuTimer.getTotalMilliseconds();
+}
+
+void SkinningBenchmark::renderFrame(SkinningMode mode, float seconds, int index, int count)
+{
+	gpuTimer.beginFrame();
+
+	// Both modes pose the same way, only where the vertices are skinned differs.
+	animator.update(seconds);
+
+	if (mode == SkinningMode::CPU)
+	{
+		animator.skin();
+		for (size_t actor = 0; actor < animator.getActorCount(); actor++)
+		{
+			buffers[actor]->upload(animator.getVertices(actor));
+		}
+	}
+	else
+	{
+		// Models without bones stay static, they need neither a palette nor the skinned shader.
+		palette.clear();
+		paletteOffsets.assign(animator.getActorCount(), -1);
+		for (size_t actor = 0; actor < animator.getActorCount(); actor++)
+		{
+			if (skinned[actorModels[actor]].bones.empty())
+				continue;
+
+			const std::vector<BoneMatrix>& bones = animator.getPalette(actor);
+			paletteOffsets[actor] = palette.add(bones.data(), bones.size());
+		}
+		palette.upload();
+		palette.bind();
+	}
+
+	FlythroughBenchmark::placeCamera(camera, sceneCenter, sceneRadius, index, count);
+
+	framebuffer.bind();
+
+	renderer.beginFrame();
+	renderer.clear(glm::vec4(Config::backgroundR, Config::backgroundG, Config::backgroundB, 1.0f));
+
+	gpuTimer.begin(GpuPass::Models);
+
+	// Display as a left-handed coordinate system.
+	glm::mat4 view = camera.getViewMatrix();
+	view = glm::scale(view, glm::vec3(1.0f, 1.0f, -1.0f));
+
+	for (Shader* shader : { staticShader, skinnedShader })
+	{
+		shader->bind();
+		shader->setUniformMat4("VPMatrix", camera.getProjectionMatrix() * view);
+	}
+
+	if (mode == SkinningMode::CPU)
+	{
+		for (size_t actor = 0; actor < animator.getActorCount(); actor++)
+		{
+			buffers[actor]->draw(*models[actorModels[actor]], *staticShader, instances[actor]);
+		}
+	}
+	else
+	{
+		// Static actors first, then every skinned one, so the program changes once.
+		for (size_t actor = 0; actor < animator.getActorCount(); actor++)
+		{
+			if (paletteOffsets[actor] < 0)
+				models[actorModels[actor]]->draw(*staticShader, instances[actor]);
+		}
+
+		for (size_t actor = 0; actor < animator.getActorCount(); actor++)
+		{
+			if (paletteOffsets[actor] < 0)
+				continue;
+
+			skinnedShader->setUniform1i("paletteOffset", paletteOffsets[actor]);
+			skinnedShader->setUniform1i("boneCount", static_cast<int>(skinned[actorModels[actor]].bones.size()));
+			models[actorModels[actor]]->draw(*skinnedShader, instances[actor]);
+		}
+	}
+
+	gpuTimer.end();
+
+	framebuffer.unbind();
+}
+
+double SkinningBenchmark::comparePixels()
+{
+	std::vector<unsigned char> pixels[2];
+
+	SkinningMode modes[] = { SkinningMode::CPU, SkinningMode::GPU };
+	for (int i = 0; i < 2; i++)
+	{
+		// A step of zero poses every actor where addActors() left it.
+		renderFrame(modes[i], 0.0f, 0, 1);
+		framebuffer.read(pixels[i]);
+		RenderStats::endFrame();
+	}
+
+	size_t different = 0;
+	size_t count = pixels[0].size() / 4;
+	for (size_t i = 0; i < count; i++)
+	{
+		for (int channel = 0; channel < 3; channel++)
+		{
+			if (std::abs(pixels[0][i * 4 + channel] - pixels[1][i * 4 + channel]) > SKINNING_BENCHMARK_PIXEL_TOLERANCE)
+			{
+				different++;
+				break;
+			}
+		}
+	}
+
+	return count > 0 ? static_cast<double>(different) / count : 0.0;
+}
+
+void SkinningBenchmark::print(const std::vector<SkinningRun>& runs) const
+{
+	printf("\n%7s %10s %6s %4s %10s %10s %10s %12s\n", "Actors", "Vertices", "Bones", "", "CPU p50", "Frame p50", "GPU p50", "Upload/frame");
+
+	for (auto& run : runs)
+	{
+		const std::vector<FlythroughFrame>* modes[] = { &run.cpu, &run.gpu };
+		size_t uploads[] = { run.cpuUploadBytes, run.gpuUploadBytes };
+
+		for (int mode = 0; mode < 2; mode++)
+		{
+			std::vector<double> cpu = getTimings(*modes[mode], &FlythroughFrame::cpuMilliseconds);
+			std::vector<double> frame = getTimings(*modes[mode], &FlythroughFrame::frameMilliseconds);
+			std::vector<double> gpu = getTimings(*modes[mode], &FlythroughFrame::gpuMilliseconds);
+
+			char gpuColumn[32] = "n/a";
+			if (!gpu.empty())
+				snprintf(gpuColumn, sizeof(gpuColumn), "%.3fms", LoadBenchmark::getPercentiles(gpu).p50);
+
+			if (mode == 0)
+				printf("%7d %10zu %6zu ", run.actors, run.vertices, run.bones);
+			else
+				printf("%7s %10s %6s ", "", "", "");
+
+			printf("%4s %8.3fms %8.3fms %10s %9.1f KB\n", getModeName(static_cast<SkinningMode>(mode)),
+				LoadBenchmark::getPercentiles(cpu).p50, LoadBenchmark::getPercentiles(frame).p50, gpuColumn, uploads[mode] / 1024.0);
+		}
+
+		double cpuFrame = LoadBenchmark::getPercentiles(getTimings(run.cpu, &FlythroughFrame::frameMilliseconds)).p50;
+		double gpuFrame = LoadBenchmark::getPercentiles(getTimings(run.gpu, &FlythroughFrame::frameMilliseconds)).p50;
+
+		printf("%7s %10s %6s %4s GPU skinning %.2fx the CPU's frame rate", "", "", "", "", gpuFrame > 0.0 ? cpuFrame / gpuFrame : 0.0);
+		if (run.pixelDifference >= 0.0)
+			printf(", %.3f%% of pixels differ", run.pixelDifference * 100.0);
+		printf("\n");
+	}
+
+	printf("\nPosed and skinned on %u threads\n", animator.getThreads());
+	fflush(stdout);
+}
+
+bool SkinningBenchmark::writeJSON(const std::vector<SkinningRun>& runs) const
+{
+	std::ofstream stream(options.json, std::ios::out | std::ios::trunc);
+	if (stream.fail())
+		return false;
+
+	auto writePercentiles = [&stream](const char* name, const std::vector<double>& values)
+	{
+		LoadPercentiles p = LoadBenchmark::getPercentiles(values);
+		stream << "\"" << name << "\": { \"p50\": " << p.p50 << ", \"p90\": " << p.p90 << ", \"p99\": " << p.p99 <<
+			", \"mean\": " << p.mean << ", \"min\": " << p.min << ", \"max\": " << p.max << ", \"samples\": " << values.size() << " }";
+	};
+
+	auto writeMode = [&stream, &writePercentiles](const char* name, const std::vector<FlythroughFrame>& frames, size_t uploadBytes)
+	{
+		std::vector<double> cpu = getTimings(frames, &FlythroughFrame::cpuMilliseconds);
+		std::vector<double> frame = getTimings(frames, &FlythroughFrame::frameMilliseconds);
+		std::vector<double> gpu = getTimings(frames, &FlythroughFrame::gpuMilliseconds);
+
+		double draws = 0.0;
+		for (auto& f : frames)
+		{
+			draws += f.drawCalls;
+		}
+
+		stream << "\t\t\t\"" << name << "\": {" << std::endl;
+		stream << "\t\t\t\t\"uploadBytes\": " << uploadBytes << "," << std::endl;
+		stream << "\t\t\t\t\"draws\": " << (frames.empty() ? 0.0 : draws / frames.size()) << "," << std::endl;
+		stream << "\t\t\t\t";
+		writePercentiles("cpu", cpu);
+		stream << "," << std::endl << "\t\t\t\t";
+		writePercentiles("frame", frame);
+		if (!gpu.empty())
+		{
+			stream << "," << std::endl << "\t\t\t\t";
+			writePercentiles("gpu", gpu);
+		}
+		stream << std::endl << "\t\t\t}";
+	};
+
+	stream << std::fixed << std::setprecision(4);
+	stream << "{" << std::endl;
+	stream << "\t\"renderer\": \"" << Json::escape(reinterpret_cast<const char*>(glGetString(GL_RENDERER))) << "\"," << std::endl;
+	stream << "\t\"backend\": \"" << Json::escape(context.getBackend()) << "\"," << std::endl;
+	stream << "\t\"archive\": \"" << Json::escape(archive) << "\"," << std::endl;
+
+	stream << "\t\"models\": [";
+	for (size_t i = 0; i < options.models.size(); i++)
+	{
+		stream << (i > 0 ? ", " : "") << "\"" << Json::escape(options.models[i]) << "\"";
+	}
+	stream << "]," << std::endl;
+
+	stream << "\t\"width\": " << options.width << "," << std::endl;
+	stream << "\t\"height\": " << options.height << "," << std::endl;
+	stream << "\t\"frames\": " << options.frames << "," << std::endl;
+	stream << "\t\"threads\": " << animator.getThreads() << "," << std::endl;
+
+	stream << "\t\"runs\": [" << std::endl;
+	for (size_t i = 0; i < runs.size(); i++)
+	{
+		const SkinningRun& run = runs[i];
+
+		stream << "\t\t{" << std::endl;
+		stream << "\t\t\t\"actors\": " << run.actors << "," << std::endl;
+		stream << "\t\t\t\"vertices\": " << run.vertices << "," << std::endl;
+		stream << "\t\t\t\"bones\": " << run.bones << "," << std::endl;
+		if (run.pixelDifference >= 0.0)
+			stream << "\t\t\t\"pixelDifference\": " << run.pixelDifference << "," << std::endl;
+		writeMode("cpuSkinning", run.cpu, run.cpuUploadBytes);
+		stream << "," << std::endl;
+		writeMode("gpuSkinning", run.gpu, run.gpuUploadBytes);
+		stream << std::endl << "\t\t}" << (i + 1 < runs.size() ? "," : "") << std::endl;
+	}
+	stream << "\t]" << std::endl;
+	stream << "}" << std::endl;
+
+	return !stream.fail();
+}
@@ -0,0 +1,145 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <glad/glad.h>
+
+#include "content.h"
+
+#include "graphics/camera.h"
+#include "graphics/renderer.h"
+#include "graphics/context.h"
+#include "graphics/framebuffer.h"
+#include "graphics/gputimer.h"
+#include "graphics/bonepalette.h"
+#include "graphics/skinbuffer.h"
+
+#include "animation/clip.h"
+#include "animation/skinning.h"
+#include "animation/animator.h"
+
+#include "bench/flythrough.h"
+
+struct SkinningBenchmarkOptions
+{
+	std::vector<std::string> models;
+
+	std::string archive;
+	std::string json;
+
+	// Each count is measured on its own, skinned on the CPU and then on the GPU.
+	std::vector<int> actors = { 16, 64, 256 };
+
+	int frames = 120;
+	int warmup = 10;
+
+	int width = 1280;
+	int height = 720;
+
+	// Clips made for each model.
+	int clips = 4;
+
+	// Threads posing and skinning, 0 uses every core.
+	unsigned int threads = 0;
+
+	// Compares the first frame of both modes, fails when they differ.
+	bool verify = false;
+
+	bool software = false;
+};
+
+enum class SkinningMode
+{
+	CPU,
+	GPU
+};
+
+// Both modes at one actor count.
+struct SkinningRun
+{
+	int actors = 0;
+	size_t vertices = 0;
+	// In the palette each frame.
+	size_t bones = 0;
+
+	// Sent to the GPU every frame, skinned vertices or bone palettes.
+	size_t cpuUploadBytes = 0;
+	size_t gpuUploadBytes = 0;
+
+	std::vector<FlythroughFrame> cpu;
+	std::vector<FlythroughFrame> gpu;
+
+	// Share of pixels --verify found to differ, negative when not checked.
+	double pixelDifference = -1.0;
+};
+
+// Plays the same actors skinned on the CPU, streaming their vertices, and on the GPU, streaming only
+// their bone palettes, at increasing actor counts in an offscreen context.
+// Clips are made the way --bench-anim makes them, the archive's animations are not decoded yet.
+// Usage: TYViewer --bench-skin <model>[,<model>...] [options]
+class SkinningBenchmark
+{
+public:
+	static bool isRequested(int argc, char* argv[]);
+	static bool parseArguments(int argc, char* argv[], SkinningBenchmarkOptions& options);
+	static void printUsage();
+
+	SkinningBenchmark(const SkinningBenchmarkOptions& options);
+	~SkinningBenchmark();
+
+	int run();
+
+private:
+	bool initialize();
+	bool loadModels();
+
+	// Places 'count' actors on a square grid, every one starting where it did in the other mode.
+	void addActors(int count);
+
+	void measure(SkinningMode mode, std::vector<FlythroughFrame>& frames);
+	void renderFrame(SkinningMode mode, float seconds, int index, int count);
+
+	// Renders the current pose in both modes.
+	double comparePixels();
+
+	void print(const std::vector<SkinningRun>& runs) const;
+	bool writeJSON(const std::vector<SkinningRun>& runs) const;
+
+	SkinningBenchmarkOptions options;
+
+	// Declared first so every GL object below is released while the context still exists.
+	OffscreenContext context;
+
+	Renderer renderer;
+	Framebuffer framebuffer;
+	Camera camera;
+	GpuTimer gpuTimer;
+
+	Content content;
+	Shader* staticShader;
+	Shader* skinnedShader;
+
+	BonePaletteBuffer palette;
+	// Each actor's first bone in the palette this frame, -1 for static models.
+	std::vector<int> paletteOffsets;
+
+	std::string archive;
+
+	std::vector<Model*> models;
+	std::vector<SkinnedModel> skinned;
+	std::vector<QuantizedClip> clips;
+
+	// Footprint of the models together, what the grid is spaced by.
+	glm::vec3 boundsMin;
+	glm::vec3 boundsMax;
+
+	Animator animator;
+	std::vector<size_t> actorModels;
+	std::vector<glm::mat4> instances;
+	std::vector<std::unique_ptr<SkinnedVertexBuffer>> buffers;
+
+	glm::vec3 sceneCenter;
+	float sceneRadius;
+};
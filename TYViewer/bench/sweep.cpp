@@ -0,0 +1,345 @@
+#include "sweep.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <algorithm>
+
+#include "loader/modelbuilder.h"
+
+#include "util/json.h"
+#include "util/allocation.h"
+#include "util/trace.h"
+
+#include "config.h"
+#include "debug.h"
+
+static std::string escapeCSV(const std::string& s)
+{
+	if (s.find_first_of(",\"\n") == std::string::npos)
+		return s;
+
+	std::string escaped = "\"";
+	for (char c : s)
+	{
+		if (c == '"')
+			escaped += '"';
+		escaped += c;
+	}
+	return escaped + "\"";
+}
+
+bool ArchiveSweep::isRequested(int argc, char* argv[])
+{
+	for (int i = 1; i < argc; i++)
+	{
+		if (std::string(argv[i]) == "--sweep")
+			return true;
+	}
+	return false;
+}
+
+bool ArchiveSweep::parseArguments(int argc, char* argv[], SweepOptions& options)
+{
+	for (int i = 1; i < argc; i++)
+	{
+		std::string argument = argv[i];
+		bool hasValue = i + 1 < argc;
+
+		if (argument == "--sweep")
+		{
+			// The mode itself, takes no value.
+		}
+		else if (argument == "--trace" && hasValue)
+		{
+			// Handled before the sweep starts.
+			i++;
+		}
+		else if (argument == "--archive" && hasValue)
+		{
+			options.archive = argv[++i];
+		}
+		else if (argument == "--threads" && hasValue)
+		{
+			int threads = std::atoi(argv[++i]);
+			if (threads <= 0)
+				return false;
+			options.threads = static_cast<unsigned int>(threads);
+		}
+		else if (argument == "--csv" && hasValue)
+		{
+			options.csv = argv[++i];
+		}
+		else if (argument == "--json" && hasValue)
+		{
+			options.json = argv[++i];
+		}
+		else if (argument == "--filter" && hasValue)
+		{
+			options.filter = argv[++i];
+		}
+		else
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void ArchiveSweep::printUsage()
+{
+	std::cout <<
+		"Usage: TYViewer --sweep [options]" << std::endl <<
+		"  --archive <path>   Archive to sweep (default: config.cfg)" << std::endl <<
+		"  --threads <n>      Worker threads (default: one per core)" << std::endl <<
+		"  --filter <text>    Only build models whose name contains <text>" << std::endl <<
+		"  --csv <file>       Write every model as a CSV row, most expensive first" << std::endl <<
+		"  --json <file>      Write the summary and every model as JSON" << std::endl <<
+		"  --trace <file>     Record a Chrome trace of the sweep" << std::endl;
+}
+
+ArchiveSweep::ArchiveSweep(const SweepOptions& options) :
+	options(options),
+	threads(options.threads)
+{}
+
+int ArchiveSweep::run()
+{
+	if (options.archive.empty())
+		options.archive = Config::archive;
+
+	if (options.archive.empty())
+	{
+		LOG_ERROR(General, "No archive specified, use --archive or config.cfg");
+		return -1;
+	}
+
+	if (!archive.load(options.archive))
+	{
+		LOG_ERROR(General, "Failed to load archive: " + options.archive);
+		return -1;
+	}
+
+	std::vector<std::string> names = ModelBatch::getModelNames(archive, {}, options.filter);
+
+	if (names.empty())
+	{
+		LOG_ERROR(General, "No models to sweep in " + options.archive);
+		return -1;
+	}
+
+	// Failures end up in the report with their reason, one warning per model would bury the summary.
+	Debug::setLevel(Debug::Level::Error);
+
+	threads = ModelBatch::getThreadCount(options.threads, names.size());
+
+	printf("Sweeping %zu models from %s on %u threads\n", names.size(), options.archive.c_str(), threads);
+	fflush(stdout);
+
+	std::vector<SweepResult> results(names.size());
+	double wall = ModelBatch::parallelFor(names.size(), threads, "Sweep", [&](size_t i)
+	{
+		sweepModel(archive, names[i], results[i]);
+	});
+
+	std::stable_sort(results.begin(), results.end(), [](const SweepResult& a, const SweepResult& b)
+	{
+		return a.getCost() > b.getCost();
+	});
+
+	print(results, wall);
+
+	if (!options.csv.empty() && !writeCSV(results))
+	{
+		LOG_ERROR(General, "Failed to write sweep CSV: " + options.csv);
+		return -1;
+	}
+
+	if (!options.json.empty() && !writeJSON(results, wall))
+	{
+		LOG_ERROR(General, "Failed to write sweep JSON: " + options.json);
+		return -1;
+	}
+
+	return ModelBatch::countFailed(results) > 0 ? 1 : 0;
+}
+
+void ArchiveSweep::sweepModel(const Archive& archive, const std::string& name, SweepResult& result)
+{
+	TRACE_ZONE_DETAIL("ArchiveSweep::sweepModel", name);
+
+	result.name = name;
+
+	ModelBatch::guard(result, [&]()
+	{
+		ModelData model;
+		bool built = ModelBuilder::build(archive, name, model);
+
+		result.isTY2 = model.isTY2;
+		result.fileBytes = model.fileBytes;
+		result.timings = model.timings;
+
+		if (!built)
+		{
+			result.reason = model.error.empty() ? "build failed" : model.error;
+			return;
+		}
+
+		if (!ModelBuilder::validate(model, result.reason))
+			return;
+
+		result.meshes = model.meshes.size();
+		result.vertices = model.vertices.size();
+		result.triangles = model.indices.size() / 3;
+		result.degenerate = model.strips.degenerate;
+		result.stripEfficiency = result.vertices > 0 ? static_cast<double>(result.triangles) / result.vertices : 0.0;
+
+		result.cpuBytes = model.getHeapBytes();
+		result.gpuBytes = model.vertices.size() * sizeof(Vertex) + model.indices.size() * sizeof(unsigned int);
+
+		result.status = result.triangles > 0 ? BatchStatus::Ok : BatchStatus::Empty;
+	});
+}
+
+void ArchiveSweep::print(const std::vector<SweepResult>& results, double wallMilliseconds) const
+{
+	double cpu = 0.0;
+	size_t vertices = 0;
+	size_t triangles = 0;
+	size_t degenerate = 0;
+	size_t cpuBytes = 0;
+
+	for (auto& result : results)
+	{
+		cpu += result.timings.read + result.getCost();
+		vertices += result.vertices;
+		triangles += result.triangles;
+		degenerate += result.degenerate;
+		cpuBytes += result.cpuBytes;
+	}
+
+	printf("\n%-40s %6s %10s %10s %10s %10s %6s %10s\n", "Model", "Format", "Parse", "Build", "Vertices", "Triangles", "Eff", "Memory");
+
+	size_t shown = std::min(results.size(), static_cast<size_t>(20));
+	for (size_t i = 0; i < shown; i++)
+	{
+		const SweepResult& result = results[i];
+		if (result.status == BatchStatus::Failed)
+			continue;
+
+		printf("%-40s %6s %8.2fms %8.2fms %10zu %10zu %6.2f %8.1fKB\n", result.name.c_str(), result.isTY2 ? "TY2" : "TY1",
+			result.timings.parse, result.timings.build, result.vertices, result.triangles,
+			result.stripEfficiency, result.cpuBytes / 1024.0);
+	}
+	if (results.size() > shown)
+		printf("... %zu more, see --csv or --json\n", results.size() - shown);
+
+	ModelBatch::printResults(results);
+	printf("%zu vertices, %zu triangles, %zu degenerate skipped, %.1f MB held\n", vertices, triangles, degenerate, cpuBytes / (1024.0 * 1024.0));
+	ModelBatch::printTiming(wallMilliseconds, cpu, threads);
+
+	if (Allocation::isCounting())
+	{
+		printf("\n%-8s %12s %14s %14s\n", "Scope", "Allocations", "Bytes", "Peak");
+		for (int i = 0; i < static_cast<int>(AllocationScope::Count); i++)
+		{
+			AllocationStats stats = Allocation::getStats(static_cast<AllocationScope>(i));
+			printf("%-8s %12zu %14zu %14zu\n", Allocation::getName(static_cast<AllocationScope>(i)), stats.count, stats.bytes, stats.peak);
+		}
+	}
+	fflush(stdout);
+}
+
+bool ArchiveSweep::writeCSV(const std::vector<SweepResult>& results) const
+{
+	std::ofstream stream(options.csv, std::ios::out | std::ios::trunc);
+	if (stream.fail())
+		return false;
+
+	stream << std::fixed << std::setprecision(3);
+	stream << "name,status,reason,format,file_bytes,read_ms,parse_ms,build_ms,cost_ms,meshes,vertices,triangles,degenerate,strip_efficiency,cpu_bytes,gpu_bytes" << std::endl;
+
+	for (auto& result : results)
+	{
+		stream << escapeCSV(result.name) << ",";
+		stream << ModelBatch::getStatusName(result.status) << ",";
+		stream << escapeCSV(result.reason) << ",";
+		stream << (result.isTY2 ? "TY2" : "TY1") << ",";
+		stream << result.fileBytes << ",";
+		stream << result.timings.read << ",";
+		stream << result.timings.parse << ",";
+		stream << result.timings.build << ",";
+		stream << result.getCost() << ",";
+		stream << result.meshes << ",";
+		stream << result.vertices << ",";
+		stream << result.triangles << ",";
+		stream << result.degenerate << ",";
+		stream << result.stripEfficiency << ",";
+		stream << result.cpuBytes << ",";
+		stream << result.gpuBytes << std::endl;
+	}
+
+	return !stream.fail();
+}
+
+bool ArchiveSweep::writeJSON(const std::vector<SweepResult>& results, double wallMilliseconds) const
+{
+	std::ofstream stream(options.json, std::ios::out | std::ios::trunc);
+	if (stream.fail())
+		return false;
+
+	stream << std::fixed << std::setprecision(3);
+	stream << "{" << std::endl;
+	stream << "\t\"archive\": \"" << Json::escape(options.archive) << "\"," << std::endl;
+	stream << "\t\"threads\": " << threads << "," << std::endl;
+	stream << "\t\"wallMilliseconds\": " << wallMilliseconds << "," << std::endl;
+	stream << "\t\"models\": " << results.size() << "," << std::endl;
+	stream << "\t\"failed\": " << ModelBatch::countFailed(results) << "," << std::endl;
+
+	if (Allocation::isCounting())
+	{
+		stream << "\t\"allocations\": {" << std::endl;
+		for (int i = 0; i < static_cast<int>(AllocationScope::Count); i++)
+		{
+			AllocationStats stats = Allocation::getStats(static_cast<AllocationScope>(i));
+			stream << "\t\t\"" << Allocation::getName(static_cast<AllocationScope>(i)) << "\": { \"count\": " << stats.count <<
+				", \"bytes\": " << stats.bytes << ", \"peak\": " << stats.peak << " }" <<
+				(i + 1 < static_cast<int>(AllocationScope::Count) ? "," : "") << std::endl;
+		}
+		stream << "\t}," << std::endl;
+	}
+
+	stream << "\t\"results\": [" << std::endl;
+
+	for (size_t i = 0; i < results.size(); i++)
+	{
+		const SweepResult& result = results[i];
+
+		stream << "\t\t{ \"name\": \"" << Json::escape(result.name) << "\"";
+		stream << ", \"status\": \"" << ModelBatch::getStatusName(result.status) << "\"";
+		if (!result.reason.empty())
+			stream << ", \"reason\": \"" << Json::escape(result.reason) << "\"";
+		stream << ", \"format\": \"" << (result.isTY2 ? "TY2" : "TY1") << "\"";
+		stream << ", \"fileBytes\": " << result.fileBytes;
+		stream << ", \"read\": " << result.timings.read;
+		stream << ", \"parse\": " << result.timings.parse;
+		stream << ", \"build\": " << result.timings.build;
+		stream << ", \"cost\": " << result.getCost();
+		stream << ", \"meshes\": " << result.meshes;
+		stream << ", \"vertices\": " << result.vertices;
+		stream << ", \"triangles\": " << result.triangles;
+		stream << ", \"degenerate\": " << result.degenerate;
+		stream << ", \"stripEfficiency\": " << result.stripEfficiency;
+		stream << ", \"cpuBytes\": " << result.cpuBytes;
+		stream << ", \"gpuBytes\": " << result.gpuBytes << " }";
+		stream << (i + 1 < results.size() ? "," : "") << std::endl;
+	}
+
+	stream << "\t]" << std::endl;
+	stream << "}" << std::endl;
+
+	return !stream.fail();
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "loader/archive.h"
+#include "loader/modeldata.h"
+#include "loader/modelbatch.h"
+
+struct SweepOptions
+{
+	std::string archive;
+
+	std::string csv;
+	std::string json;
+
+	// Only models whose name contains this.
+	std::string filter;
+
+	// 0 uses every core.
+	unsigned int threads = 0;
+};
+
+struct SweepResult : BatchResult
+{
+	bool isTY2 = false;
+
+	// .mdl plus .mdg.
+	size_t fileBytes = 0;
+
+	LoadTimings timings;
+
+	size_t meshes = 0;
+	size_t vertices = 0;
+	size_t triangles = 0;
+	size_t degenerate = 0;
+
+	// Triangles per stored vertex, 1 for one long strip and 1/3 for a plain triangle list.
+	double stripEfficiency = 0.0;
+
+	// Heap held by the ModelData, and what Content would upload of it.
+	size_t cpuBytes = 0;
+	size_t gpuBytes = 0;
+
+	inline double getCost() const
+	{
+		return timings.parse + timings.build;
+	}
+};
+
+// Parses and builds every .mdl (and .mdg) in an archive on all cores, without a GL context,
+// and reports per model results sorted by cost. Exits with 1 if any model failed.
+// Usage: TYViewer --sweep [options]
+class ArchiveSweep
+{
+public:
+	static bool isRequested(int argc, char* argv[]);
+	static bool parseArguments(int argc, char* argv[], SweepOptions& options);
+	static void printUsage();
+
+	ArchiveSweep(const SweepOptions& options);
+
+	int run();
+
+	// Builds one model of the archive, never throws.
+	static void sweepModel(const Archive& archive, const std::string& name, SweepResult& result);
+
+private:
+
+	void print(const std::vector<SweepResult>& results, double wallMilliseconds) const;
+
+	bool writeCSV(const std::vector<SweepResult>& results) const;
+	bool writeJSON(const std::vector<SweepResult>& results, double wallMilliseconds) const;
+
+	SweepOptions options;
+
+	Archive archive;
+	unsigned int threads;
+};
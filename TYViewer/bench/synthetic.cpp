@@ -0,0 +1,704 @@
+#include "synthetic.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <algorithm>
+#include <filesystem>
+
+#include "debug.h"
+
+#define MDL2_SIGNATURE 843859021
+
+#define MDL2_HEADER_SIZE 80
+#define MDL2_SUBOBJECT_SIZE 80
+#define MDL2_MESH_SIZE 16
+#define MDL2_SEGMENT_HEADER_SIZE 52
+#define MDL2_COLLIDER_SIZE 32
+#define MDL2_BONE_SIZE 16
+
+#define MDL3_HEADER_SIZE 0x70
+#define MDL3_COMPONENT_SIZE 0x40
+
+#define MDG_MESH_HEADER_SIZE 0x10
+#define MDG_VERTEX_SIZE 48
+
+#define RKV1_NAME_SIZE 32
+#define RKV1_ENTRY_SIZE 64
+#define RKV1_FOLDER_SIZE 256
+#define RKV2_ENTRY_SIZE 20
+
+struct GridVertex
+{
+	float position[3];
+	float normal[3];
+	float texcoord[2];
+};
+
+// Little helpers for building files front to back and patching offsets afterwards.
+template<typename T>
+static size_t append(std::vector<char>& buffer, T value)
+{
+	size_t offset = buffer.size();
+	const char* bytes = reinterpret_cast<const char*>(&value);
+	buffer.insert(buffer.end(), bytes, bytes + sizeof(T));
+	return offset;
+}
+
+template<typename T>
+static void write(std::vector<char>& buffer, size_t offset, T value)
+{
+	memcpy(&buffer[offset], &value, sizeof(T));
+}
+
+static size_t appendString(std::vector<char>& buffer, const std::string& s)
+{
+	size_t offset = buffer.size();
+	buffer.insert(buffer.end(), s.begin(), s.end());
+	buffer.push_back('\0');
+	return offset;
+}
+
+static size_t reserve(std::vector<char>& buffer, size_t size)
+{
+	size_t offset = buffer.size();
+	buffer.resize(buffer.size() + size, 0);
+	return offset;
+}
+
+static void align(std::vector<char>& buffer, size_t alignment)
+{
+	buffer.resize((buffer.size() + alignment - 1) / alignment * alignment, 0);
+}
+
+static float getHeight(const SyntheticModelOptions& options, float x, float z)
+{
+	float k = 12.0f / options.size;
+	return options.size * (0.05f + 0.02f * std::sin(x * k) * std::cos(z * k));
+}
+
+// Patches tile the model's square footprint, 'connectors' repeats the vertices
+// around each strip break the way the game's .mdg strips are joined.
+static std::vector<GridVertex> createPatch(const SyntheticModelOptions& options, unsigned int patch, unsigned int patchCount, bool connectors)
+{
+	unsigned int side = static_cast<unsigned int>(std::ceil(std::sqrt(static_cast<float>(patchCount))));
+	float patchSize = options.size / side;
+
+	float originX = -options.size / 2.0f + (patch % side) * patchSize;
+	float originZ = -options.size / 2.0f + (patch / side) * patchSize;
+
+	unsigned int columns = std::max(1u, options.stripLength / 2);
+	float dx = patchSize / columns;
+	float dz = patchSize / options.stripsPerMesh;
+
+	std::vector<GridVertex> vertices;
+	vertices.reserve(options.stripsPerMesh * (options.stripLength + 2));
+
+	for (unsigned int strip = 0; strip < options.stripsPerMesh; strip++)
+	{
+		if (connectors && strip > 0)
+		{
+			vertices.push_back(vertices.back());
+		}
+
+		for (unsigned int i = 0; i < options.stripLength; i++)
+		{
+			GridVertex vertex;
+
+			float x = originX + (i / 2) * dx;
+			float z = originZ + (strip + i % 2) * dz;
+			float y = getHeight(options, x, z);
+
+			vertex.position[0] = x;
+			vertex.position[1] = y;
+			vertex.position[2] = z;
+
+			// Normal from the height field's slope.
+			float nx = -(getHeight(options, x + 0.01f, z) - y) / 0.01f;
+			float nz = -(getHeight(options, x, z + 0.01f) - y) / 0.01f;
+			float length = std::sqrt(nx * nx + 1.0f + nz * nz);
+
+			vertex.normal[0] = nx / length;
+			vertex.normal[1] = 1.0f / length;
+			vertex.normal[2] = nz / length;
+
+			vertex.texcoord[0] = (x - originX) / patchSize;
+			vertex.texcoord[1] = (z - originZ) / patchSize;
+
+			if (connectors && strip > 0 && i == 0)
+			{
+				vertices.push_back(vertex);
+			}
+			vertices.push_back(vertex);
+		}
+	}
+
+	return vertices;
+}
+
+void SyntheticAssets::createMDL2(const SyntheticModelOptions& options, std::vector<char>& mdl)
+{
+	mdl.clear();
+
+	const unsigned int meshCount = options.components * options.meshesPerCell;
+
+	reserve(mdl, MDL2_HEADER_SIZE);
+	write<uint32_t>(mdl, 0, MDL2_SIGNATURE);
+	write<uint16_t>(mdl, 6, static_cast<uint16_t>(options.components));
+	write<uint16_t>(mdl, 8, static_cast<uint16_t>(options.colliders));
+	write<uint16_t>(mdl, 10, static_cast<uint16_t>(options.bones));
+
+	write<float>(mdl, 32, -options.size / 2.0f);
+	write<float>(mdl, 36, 0.0f);
+	write<float>(mdl, 40, -options.size / 2.0f);
+	write<float>(mdl, 48, options.size);
+	write<float>(mdl, 52, options.size * 0.1f);
+	write<float>(mdl, 56, options.size);
+
+	size_t subobjectOffset = reserve(mdl, options.components * MDL2_SUBOBJECT_SIZE);
+	write<uint32_t>(mdl, 12, static_cast<uint32_t>(subobjectOffset));
+
+	size_t meshOffset = reserve(mdl, meshCount * MDL2_MESH_SIZE);
+
+	std::vector<size_t> nameOffsets;
+	std::vector<size_t> materialOffsets;
+
+	for (unsigned int component = 0; component < options.components; component++)
+	{
+		size_t subobject = subobjectOffset + component * MDL2_SUBOBJECT_SIZE;
+
+		// Each component covers the whole model, close enough for bounds drawing.
+		write<float>(mdl, subobject + 0, -options.size / 2.0f);
+		write<float>(mdl, subobject + 8, -options.size / 2.0f);
+		write<float>(mdl, subobject + 16, options.size);
+		write<float>(mdl, subobject + 20, options.size * 0.1f);
+		write<float>(mdl, subobject + 24, options.size);
+
+		write<uint32_t>(mdl, subobject + 56, options.meshesPerCell * options.stripsPerMesh * (options.stripLength - 2));
+		write<uint16_t>(mdl, subobject + 66, static_cast<uint16_t>(options.meshesPerCell));
+		write<uint32_t>(mdl, subobject + 68, static_cast<uint32_t>(meshOffset + component * options.meshesPerCell * MDL2_MESH_SIZE));
+
+		for (unsigned int i = 0; i < options.meshesPerCell; i++)
+		{
+			unsigned int patch = component * options.meshesPerCell + i;
+			size_t mesh = meshOffset + patch * MDL2_MESH_SIZE;
+
+			std::vector<GridVertex> vertices = createPatch(options, patch, meshCount, false);
+
+			write<uint32_t>(mdl, mesh + 4, static_cast<uint32_t>(mdl.size()));
+			write<uint32_t>(mdl, mesh + 12, options.stripsPerMesh);
+
+			// Every strip is its own segment, TY 1 has no connector vertices.
+			for (unsigned int strip = 0; strip < options.stripsPerMesh; strip++)
+			{
+				const GridVertex* segment = &vertices[strip * options.stripLength];
+				const unsigned int count = options.stripLength;
+
+				size_t header = reserve(mdl, MDL2_SEGMENT_HEADER_SIZE);
+				write<uint32_t>(mdl, header + 12, count);
+
+				for (unsigned int v = 0; v < count; v++)
+				{
+					append<float>(mdl, segment[v].position[0]);
+					append<float>(mdl, segment[v].position[1]);
+					append<float>(mdl, segment[v].position[2]);
+				}
+
+				// Normals are read back as unsigned byte / 128.
+				reserve(mdl, 4);
+				for (unsigned int v = 0; v < count; v++)
+				{
+					for (int axis = 0; axis < 3; axis++)
+					{
+						append<uint8_t>(mdl, static_cast<uint8_t>(std::abs(segment[v].normal[axis]) * 127.0f));
+					}
+					append<uint8_t>(mdl, 0);
+				}
+
+				// UV and skin, 4.12 fixed point.
+				reserve(mdl, 4);
+				for (unsigned int v = 0; v < count; v++)
+				{
+					append<int16_t>(mdl, static_cast<int16_t>(segment[v].texcoord[0] * 4096.0f));
+					append<int16_t>(mdl, static_cast<int16_t>((1.0f - segment[v].texcoord[1]) * 4096.0f));
+					append<int16_t>(mdl, 4096);
+					append<int8_t>(mdl, static_cast<int8_t>(options.bones > 0 ? patch % options.bones : 0));
+					append<int8_t>(mdl, 0);
+				}
+
+				reserve(mdl, 4);
+				for (unsigned int v = 0; v < count; v++)
+				{
+					append<uint32_t>(mdl, 0x80808080);
+				}
+			}
+		}
+	}
+
+	size_t colliderOffset = mdl.size();
+	write<uint32_t>(mdl, 16, static_cast<uint32_t>(colliderOffset));
+	for (unsigned int i = 0; i < options.colliders; i++)
+	{
+		size_t collider = reserve(mdl, MDL2_COLLIDER_SIZE);
+		float angle = i * 6.2831853f / std::max(1u, options.colliders);
+		write<float>(mdl, collider + 0, std::cos(angle) * options.size * 0.4f);
+		write<float>(mdl, collider + 4, options.size * 0.05f);
+		write<float>(mdl, collider + 8, std::sin(angle) * options.size * 0.4f);
+		write<float>(mdl, collider + 12, options.size * 0.05f);
+	}
+
+	size_t boneOffset = mdl.size();
+	write<uint32_t>(mdl, 20, static_cast<uint32_t>(boneOffset));
+	for (unsigned int i = 0; i < options.bones; i++)
+	{
+		size_t bone = reserve(mdl, MDL2_BONE_SIZE);
+		write<float>(mdl, bone + 4, options.size * 0.1f * i / std::max(1u, options.bones));
+	}
+
+	write<uint32_t>(mdl, 68, static_cast<uint32_t>(appendString(mdl, options.name)));
+
+	for (unsigned int component = 0; component < options.components; component++)
+	{
+		size_t subobject = subobjectOffset + component * MDL2_SUBOBJECT_SIZE;
+		std::string texture = "synthetic_" + std::to_string(component % std::max(1u, options.textures));
+
+		write<uint32_t>(mdl, subobject + 48, static_cast<uint32_t>(appendString(mdl, "component_" + std::to_string(component))));
+		write<uint32_t>(mdl, subobject + 52, static_cast<uint32_t>(appendString(mdl, texture)));
+
+		size_t material = appendString(mdl, texture);
+		for (unsigned int i = 0; i < options.meshesPerCell; i++)
+		{
+			write<uint32_t>(mdl, meshOffset + (component * options.meshesPerCell + i) * MDL2_MESH_SIZE, static_cast<uint32_t>(material));
+		}
+	}
+}
+
+void SyntheticAssets::createMDL3(const SyntheticModelOptions& options, std::vector<char>& mdl, std::vector<char>& mdg)
+{
+	mdl.clear();
+	mdg.clear();
+
+	// The collision texture goes last so regular texture indices match TY 1 models.
+	const unsigned int textureCount = options.textures + (options.collisionMeshes > 0 ? 1 : 0);
+	const unsigned int meshCount = options.components * options.textures * options.meshesPerCell + options.collisionMeshes;
+
+	// Meshes in the order the loader walks them: texture, component, then the chain.
+	struct MeshEntry
+	{
+		unsigned int texture;
+		unsigned int component;
+		std::vector<GridVertex> vertices;
+		size_t header;
+	};
+	std::vector<MeshEntry> meshes;
+
+	unsigned int patch = 0;
+	for (unsigned int texture = 0; texture < textureCount; texture++)
+	{
+		bool collision = texture == options.textures;
+		for (unsigned int component = 0; component < options.components; component++)
+		{
+			unsigned int chain = collision ? (component == 0 ? options.collisionMeshes : 0) : options.meshesPerCell;
+			for (unsigned int i = 0; i < chain; i++)
+			{
+				meshes.push_back({ texture, component, createPatch(options, patch++ % meshCount, meshCount, true), 0 });
+			}
+		}
+	}
+
+	// .mdg: magic, mesh headers, then every mesh's vertices back to back.
+	mdg.insert(mdg.end(), { 'M', 'D', 'G', '3' });
+
+	for (auto& mesh : meshes)
+	{
+		mesh.header = reserve(mdg, MDG_MESH_HEADER_SIZE + options.stripsPerMesh * 2);
+		align(mdg, 4);
+
+		unsigned int connectors = (options.stripsPerMesh - 1) * 2;
+		write<uint16_t>(mdg, mesh.header + 0x0, static_cast<uint16_t>(mesh.vertices.size() - connectors));
+		write<uint16_t>(mdg, mesh.header + 0x4, static_cast<uint16_t>(connectors));
+		write<uint16_t>(mdg, mesh.header + 0x6, static_cast<uint16_t>(options.stripsPerMesh));
+
+		for (unsigned int strip = 0; strip < options.stripsPerMesh; strip++)
+		{
+			write<uint16_t>(mdg, mesh.header + MDG_MESH_HEADER_SIZE + strip * 2, static_cast<uint16_t>(options.stripLength));
+		}
+	}
+
+	for (size_t i = 0; i + 1 < meshes.size(); i++)
+	{
+		bool sameCell = meshes[i].texture == meshes[i + 1].texture && meshes[i].component == meshes[i + 1].component;
+		if (sameCell)
+			write<int32_t>(mdg, meshes[i].header + 0xC, static_cast<int32_t>(meshes[i + 1].header));
+	}
+
+	for (auto& mesh : meshes)
+	{
+		for (auto& vertex : mesh.vertices)
+		{
+			append<uint32_t>(mdg, 0xFFFFFFFF);
+			append<float>(mdg, vertex.texcoord[0]);
+			append<float>(mdg, 1.0f - vertex.texcoord[1]);
+			append<float>(mdg, vertex.position[0]);
+			append<float>(mdg, vertex.position[1]);
+			append<float>(mdg, vertex.position[2]);
+			append<float>(mdg, 1.0f);
+			append<float>(mdg, 27.0f);
+			append<float>(mdg, 27.0f);
+			append<float>(mdg, vertex.normal[0]);
+			append<float>(mdg, vertex.normal[1]);
+			append<float>(mdg, vertex.normal[2]);
+		}
+	}
+
+	// .mdl: MDL3 header, texture list, component descriptions, lookup table, strings.
+	mdl.insert(mdl.end(), { 'M', 'D', 'L', '3' });
+	reserve(mdl, MDL3_HEADER_SIZE - 4);
+
+	write<uint16_t>(mdl, 0x4, static_cast<uint16_t>(options.components));
+	write<uint16_t>(mdl, 0x6, static_cast<uint16_t>(textureCount));
+	write<uint16_t>(mdl, 0xE, static_cast<uint16_t>(std::min(meshCount, 0xFFFFu)));
+	write<uint16_t>(mdl, 0x1E, static_cast<uint16_t>(std::min(meshCount * options.stripsPerMesh, 0xFFFFu)));
+
+	write<float>(mdl, 0x30, -options.size / 2.0f);
+	write<float>(mdl, 0x34, 0.0f);
+	write<float>(mdl, 0x38, -options.size / 2.0f);
+	write<float>(mdl, 0x40, options.size);
+	write<float>(mdl, 0x44, options.size * 0.1f);
+	write<float>(mdl, 0x48, options.size);
+
+	size_t textureList = reserve(mdl, textureCount * 4);
+	write<uint32_t>(mdl, 0x54, static_cast<uint32_t>(textureList));
+
+	align(mdl, 16);
+	size_t componentList = reserve(mdl, options.components * MDL3_COMPONENT_SIZE);
+	write<uint16_t>(mdl, 0x50, static_cast<uint16_t>(componentList));
+
+	size_t lookupTable = reserve(mdl, textureCount * options.components * 4);
+	write<uint32_t>(mdl, 0x68, static_cast<uint32_t>(lookupTable));
+
+	for (size_t i = 0; i < meshes.size(); i++)
+	{
+		bool first = i == 0 || meshes[i - 1].texture != meshes[i].texture || meshes[i - 1].component != meshes[i].component;
+		if (first)
+			write<int32_t>(mdl, lookupTable + (meshes[i].texture * options.components + meshes[i].component) * 4, static_cast<int32_t>(meshes[i].header));
+	}
+
+	for (unsigned int component = 0; component < options.components; component++)
+	{
+		size_t description = componentList + component * MDL3_COMPONENT_SIZE;
+		write<float>(mdl, description + 0, -options.size / 2.0f);
+		write<float>(mdl, description + 8, -options.size / 2.0f);
+		write<float>(mdl, description + 16, options.size);
+		write<float>(mdl, description + 20, options.size * 0.1f);
+		write<float>(mdl, description + 24, options.size);
+	}
+
+	write<uint16_t>(mdl, componentList + 0x34, static_cast<uint16_t>(std::min<size_t>(mdl.size(), 0xFFFF)));
+
+	for (unsigned int texture = 0; texture < textureCount; texture++)
+	{
+		std::string name = texture == options.textures ? "CM_Synthetic" : "synthetic_" + std::to_string(texture);
+		write<uint32_t>(mdl, textureList + texture * 4, static_cast<uint32_t>(appendString(mdl, name)));
+	}
+
+	for (unsigned int component = 0; component < options.components; component++)
+	{
+		size_t name = appendString(mdl, "component_" + std::to_string(component));
+		write<uint32_t>(mdl, componentList + component * MDL3_COMPONENT_SIZE + 0x30, static_cast<uint32_t>(name));
+	}
+}
+
+void SyntheticAssets::createRKV1(const std::vector<SyntheticEntry>& entries, std::vector<char>& archive)
+{
+	archive.clear();
+
+	// File data first, then the file table, the folder table and the counts at the very end.
+	std::vector<size_t> offsets;
+	for (auto& entry : entries)
+	{
+		offsets.push_back(archive.size());
+		archive.insert(archive.end(), entry.data.begin(), entry.data.end());
+		align(archive, 16);
+	}
+
+	for (size_t i = 0; i < entries.size(); i++)
+	{
+		size_t record = reserve(archive, RKV1_ENTRY_SIZE);
+
+		std::string name = entries[i].name.substr(0, RKV1_NAME_SIZE - 1);
+		memcpy(&archive[record], name.c_str(), name.size());
+
+		write<uint32_t>(archive, record + 32, 0);
+		write<uint32_t>(archive, record + 36, static_cast<uint32_t>(entries[i].data.size()));
+		write<uint32_t>(archive, record + 44, static_cast<uint32_t>(offsets[i]));
+		write<uint32_t>(archive, record + 52, 0);
+	}
+
+	size_t folder = reserve(archive, RKV1_FOLDER_SIZE);
+	memcpy(&archive[folder], "synthetic", 9);
+
+	append<uint32_t>(archive, static_cast<uint32_t>(entries.size()));
+	append<uint32_t>(archive, 1);
+}
+
+void SyntheticAssets::createRKV2(const std::vector<SyntheticEntry>& entries, std::vector<char>& archive)
+{
+	archive.clear();
+
+	archive.insert(archive.end(), { 'R', 'K', 'V', '2' });
+	size_t header = reserve(archive, 24);
+
+	std::vector<size_t> offsets;
+	for (auto& entry : entries)
+	{
+		offsets.push_back(archive.size());
+		archive.insert(archive.end(), entry.data.begin(), entry.data.end());
+		align(archive, 16);
+	}
+
+	size_t infoOffset = reserve(archive, entries.size() * RKV2_ENTRY_SIZE);
+
+	size_t nameOffset = archive.size();
+	for (size_t i = 0; i < entries.size(); i++)
+	{
+		size_t record = infoOffset + i * RKV2_ENTRY_SIZE;
+		write<uint32_t>(archive, record + 0, static_cast<uint32_t>(appendString(archive, entries[i].name) - nameOffset));
+		write<uint32_t>(archive, record + 8, static_cast<uint32_t>(entries[i].data.size()));
+		write<uint32_t>(archive, record + 12, static_cast<uint32_t>(offsets[i]));
+	}
+
+	write<uint32_t>(archive, header + 0, static_cast<uint32_t>(entries.size()));
+	write<uint32_t>(archive, header + 4, static_cast<uint32_t>(archive.size() - nameOffset));
+	write<uint32_t>(archive, header + 16, static_cast<uint32_t>(infoOffset));
+
+	// The loader always reads 0x100 bytes per name.
+	reserve(archive, 0x100);
+}
+
+void SyntheticAssets::createFillerEntries(size_t count, size_t size, std::vector<SyntheticEntry>& entries)
+{
+	const char* extensions[] = { "mdl", "mdg", "dds", "wav" };
+
+	for (size_t i = 0; i < count; i++)
+	{
+		char name[64];
+		snprintf(name, sizeof(name), "P%04zu_SyntheticAsset%zu.%s", i, i * 7919 % 1000, extensions[i % 4]);
+
+		SyntheticEntry entry;
+		entry.name = name;
+		entry.data.resize(size, static_cast<char>(i));
+		entries.push_back(std::move(entry));
+	}
+}
+
+bool SyntheticAssets::writeFile(const std::string& path, const std::vector<char>& data)
+{
+	std::ofstream stream(path, std::ios::binary | std::ios::trunc);
+	if (stream.fail())
+		return false;
+
+	stream.write(data.data(), data.size());
+	return !stream.fail();
+}
+
+bool SyntheticAssets::isRequested(int argc, char* argv[])
+{
+	for (int i = 1; i < argc; i++)
+	{
+		if (std::string(argv[i]) == "--generate")
+			return true;
+	}
+	return false;
+}
+
+bool SyntheticAssets::parseArguments(int argc, char* argv[], SyntheticCorpusOptions& options)
+{
+	for (int i = 1; i < argc; i++)
+	{
+		std::string argument = argv[i];
+		bool hasValue = i + 1 < argc;
+		unsigned int value = hasValue ? static_cast<unsigned int>(std::strtoul(argv[i + 1], nullptr, 10)) : 0;
+
+		if (argument == "--generate" && hasValue)
+		{
+			options.output = argv[++i];
+		}
+		else if (argument == "--ty1" && hasValue)
+		{
+			options.ty1Models = value;
+			i++;
+		}
+		else if (argument == "--ty2" && hasValue)
+		{
+			options.ty2Models = value;
+			i++;
+		}
+		else if (argument == "--archive" && hasValue)
+		{
+			options.archive = argv[++i];
+			if (options.archive == "none")
+				options.archive.clear();
+			else if (options.archive != "rkv1" && options.archive != "rkv2")
+				return false;
+		}
+		else if (argument == "--entries" && hasValue)
+		{
+			options.entries = value;
+			i++;
+		}
+		else if (argument == "--components" && hasValue)
+		{
+			options.model.components = std::max(1u, value);
+			i++;
+		}
+		else if (argument == "--textures" && hasValue)
+		{
+			options.model.textures = std::max(1u, value);
+			i++;
+		}
+		else if (argument == "--meshes" && hasValue)
+		{
+			options.model.meshesPerCell = std::max(1u, value);
+			i++;
+		}
+		else if (argument == "--strips" && hasValue)
+		{
+			// The .mdg PC parser rejects more than 1000 strips per mesh.
+			options.model.stripsPerMesh = std::min(std::max(1u, value), 1000u);
+			i++;
+		}
+		else if (argument == "--strip-length" && hasValue)
+		{
+			options.model.stripLength = std::min(std::max(4u, value), 255u);
+			i++;
+		}
+		else if (argument == "--collision" && hasValue)
+		{
+			options.model.collisionMeshes = value;
+			i++;
+		}
+		else if (argument == "--colliders" && hasValue)
+		{
+			options.model.colliders = value;
+			i++;
+		}
+		else if (argument == "--bones" && hasValue)
+		{
+			options.model.bones = std::min(value, 127u);
+			i++;
+		}
+		else
+		{
+			return false;
+		}
+	}
+
+	return !options.output.empty();
+}
+
+void SyntheticAssets::printUsage()
+{
+	std::cout <<
+		"Usage: TYViewer --generate <dir> [options]" << std::endl <<
+		"  --ty1 <n>            TY 1 models (default: 4)" << std::endl <<
+		"  --ty2 <n>            TY 2 model pairs (default: 4)" << std::endl <<
+		"  --archive <format>   rkv1, rkv2 or none (default: rkv2)" << std::endl <<
+		"  --entries <n>        Archive entries, filled up with dummy files (default: models only)" << std::endl <<
+		"  --components <n>     Components per model (default: 4)" << std::endl <<
+		"  --textures <n>       Textures per model (default: 2)" << std::endl <<
+		"  --meshes <n>         Meshes per component and texture (default: 1)" << std::endl <<
+		"  --strips <n>         Strips per mesh, at most 1000 (default: 8)" << std::endl <<
+		"  --strip-length <n>   Vertices per strip, 4 to 255 (default: 32)" << std::endl <<
+		"  --collision <n>      TY 2 collision meshes per model (default: 0)" << std::endl <<
+		"  --colliders <n>      TY 1 colliders per model (default: 0)" << std::endl <<
+		"  --bones <n>          TY 1 bones per model (default: 0)" << std::endl;
+}
+
+int SyntheticAssets::run(const SyntheticCorpusOptions& options)
+{
+	std::error_code error;
+	std::filesystem::create_directories(options.output, error);
+	if (error)
+	{
+		LOG_ERROR(General, "Failed to create directory: " + options.output);
+		return -1;
+	}
+
+	std::vector<SyntheticEntry> entries;
+	size_t bytes = 0;
+
+	auto add = [&](const std::string& name, const std::vector<char>& data)
+	{
+		if (!writeFile(options.output + "/" + name, data))
+		{
+			LOG_ERROR(General, "Failed to write: " + name);
+			return false;
+		}
+
+		entries.push_back({ name, data });
+		bytes += data.size();
+		return true;
+	};
+
+	for (unsigned int i = 0; i < options.ty1Models; i++)
+	{
+		char name[32];
+		snprintf(name, sizeof(name), "S%04u_SyntheticTY1", i);
+
+		SyntheticModelOptions model = options.model;
+		model.name = name;
+
+		std::vector<char> mdl;
+		createMDL2(model, mdl);
+
+		if (!add(model.name + ".mdl", mdl))
+			return -1;
+	}
+
+	for (unsigned int i = 0; i < options.ty2Models; i++)
+	{
+		char name[32];
+		snprintf(name, sizeof(name), "S%04u_SyntheticTY2", i);
+
+		SyntheticModelOptions model = options.model;
+		model.name = name;
+
+		std::vector<char> mdl;
+		std::vector<char> mdg;
+		createMDL3(model, mdl, mdg);
+
+		if (!add(model.name + ".mdl", mdl) || !add(model.name + ".mdg", mdg))
+			return -1;
+	}
+
+	LOG_INFO(General, "Generated " + std::to_string(entries.size()) + " model files, " + std::to_string(bytes) + " bytes");
+
+	if (options.archive.empty())
+		return 0;
+
+	if (options.entries > entries.size())
+	{
+		createFillerEntries(options.entries - entries.size(), 256, entries);
+	}
+
+	std::vector<char> archive;
+	if (options.archive == "rkv1")
+		createRKV1(entries, archive);
+	else
+		createRKV2(entries, archive);
+
+	std::string path = options.output + "/synthetic.rkv";
+	if (!writeFile(path, archive))
+	{
+		LOG_ERROR(General, "Failed to write archive: " + path);
+		return -1;
+	}
+
+	LOG_INFO(General, "Wrote " + path + " with " + std::to_string(entries.size()) + " entries, " + std::to_string(archive.size()) + " bytes");
+	return 0;
+}
\ No newline at end of file
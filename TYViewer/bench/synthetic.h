@@ -0,0 +1,82 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+// Shape of a generated model. Every mesh is a patch of a gently curved grid,
+// built from strips of 'stripLength' vertices.
+struct SyntheticModelOptions
+{
+	std::string name = "synthetic";
+
+	unsigned int components = 4;
+	unsigned int textures = 2;
+
+	// Meshes chained in each component/texture cell of the TY 2 lookup table,
+	// segments per mesh for TY 1.
+	unsigned int meshesPerCell = 1;
+
+	unsigned int stripsPerMesh = 8;
+
+	// At most 255, the .mdg strip descriptors store it in a byte.
+	unsigned int stripLength = 32;
+
+	// TY 2 meshes using a "CM_" texture, the loader skips these as collision geometry.
+	unsigned int collisionMeshes = 0;
+
+	unsigned int colliders = 0;
+	unsigned int bones = 0;
+
+	// Width of the model. The .mdg PC parser only accepts positions within +-1000.
+	float size = 400.0f;
+};
+
+struct SyntheticEntry
+{
+	std::string name;
+	std::vector<char> data;
+};
+
+// What --generate writes.
+struct SyntheticCorpusOptions
+{
+	std::string output;
+
+	unsigned int ty1Models = 4;
+	unsigned int ty2Models = 4;
+
+	// "rkv1", "rkv2" or empty for loose files only.
+	std::string archive = "rkv2";
+
+	// Archive entries including the models, the rest is filler.
+	unsigned int entries = 0;
+
+	SyntheticModelOptions model;
+};
+
+// Writes files in the formats the loaders accept, for benchmarks and stress tests
+// at sizes the two TEST_FILES models can't reach.
+// Usage: TYViewer --generate <dir> [options]
+class SyntheticAssets
+{
+public:
+	// TY 1 .mdl with embedded geometry.
+	static void createMDL2(const SyntheticModelOptions& options, std::vector<char>& mdl);
+
+	// TY 2 .mdl (MDL3 header) and its PC .mdg.
+	static void createMDL3(const SyntheticModelOptions& options, std::vector<char>& mdl, std::vector<char>& mdg);
+
+	static void createRKV1(const std::vector<SyntheticEntry>& entries, std::vector<char>& archive);
+	static void createRKV2(const std::vector<SyntheticEntry>& entries, std::vector<char>& archive);
+
+	// 'count' entries named like the game's files, 'size' bytes each.
+	static void createFillerEntries(size_t count, size_t size, std::vector<SyntheticEntry>& entries);
+
+	static bool writeFile(const std::string& path, const std::vector<char>& data);
+
+	static bool isRequested(int argc, char* argv[]);
+	static bool parseArguments(int argc, char* argv[], SyntheticCorpusOptions& options);
+	static void printUsage();
+
+	static int run(const SyntheticCorpusOptions& options);
+};
\ No newline at end of file
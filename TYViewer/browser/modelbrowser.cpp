@@ -0,0 +1,952 @@
+#include "modelbrowser.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "input/keyboard.h"
+#include "input/mouse.h"
+
+#include "util/trace.h"
+
+#include "content.h"
+#include "config.h"
+#include "debug.h"
+#include "util/timing.h"
+
+#define BROWSER_SLOTS_PER_ROW (BROWSER_ATLAS_SIZE / BROWSER_THUMBNAIL_SIZE)
+#define BROWSER_SLOT_COUNT (BROWSER_SLOTS_PER_ROW * BROWSER_SLOTS_PER_ROW)
+#define BROWSER_THUMBNAIL_BYTES (BROWSER_THUMBNAIL_SIZE * BROWSER_THUMBNAIL_SIZE * 4)
+
+// Share of the window the panel may cover, from the left.
+#define BROWSER_WIDTH_FRACTION 0.5f
+#define BROWSER_MAX_COLUMNS 8
+
+#define BROWSER_MARGIN 8.0f
+#define BROWSER_PADDING 6.0f
+#define BROWSER_TEXT_SCALE 0.45f
+
+#define BROWSER_MAX_FILTER_LENGTH 48
+
+// Rows past either edge of the view whose thumbnails are loaded ahead of scrolling.
+#define BROWSER_PREFETCH_ROWS 2
+
+// Thumbnails rendered per frame at most, however much of the budget is left.
+#define BROWSER_MAX_RENDERS 8
+
+// Same view as headless images.
+#define BROWSER_CAMERA_YAW 120.0f
+#define BROWSER_CAMERA_PITCH -20.0f
+
+static const glm::vec4 panelColour(0.08f, 0.08f, 0.08f, 0.92f);
+static const glm::vec4 cellColour(0.16f, 0.16f, 0.16f, 1.0f);
+static const glm::vec4 hoverColour(0.4f, 0.4f, 0.4f, 1.0f);
+static const glm::vec4 cursorColour(0.9f, 0.6f, 0.15f, 1.0f);
+
+// Pixel coordinates from the top left, the projection has y pointing up like the glyph quads.
+static void addQuad(std::vector<Vertex>& vertices, std::vector<unsigned int>& indices, float x, float y, float width, float height,
+	const glm::vec2& uvMin = glm::vec2(0.0f), const glm::vec2& uvMax = glm::vec2(1.0f))
+{
+	unsigned int first = static_cast<unsigned int>(vertices.size());
+
+	vertices.push_back(Vertex(glm::vec4(x, -y, 0.0f, 1.0f), glm::vec2(uvMin.x, uvMax.y)));
+	vertices.push_back(Vertex(glm::vec4(x + width, -y, 0.0f, 1.0f), glm::vec2(uvMax.x, uvMax.y)));
+	vertices.push_back(Vertex(glm::vec4(x, -(y + height), 0.0f, 1.0f), glm::vec2(uvMin.x, uvMin.y)));
+	vertices.push_back(Vertex(glm::vec4(x + width, -(y + height), 0.0f, 1.0f), glm::vec2(uvMax.x, uvMin.y)));
+
+	unsigned int order[6] = { 0, 1, 2, 1, 3, 2 };
+	for (unsigned int index : order)
+	{
+		indices.push_back(first + index);
+	}
+}
+
+// Places the unit quad over a rectangle in pixels.
+static glm::mat4 getQuadMatrix(float x, float y, float width, float height)
+{
+	glm::mat4 matrix = glm::translate(glm::mat4(1.0f), glm::vec3(x, -y, 0.0f));
+	return glm::scale(matrix, glm::vec3(width, height, 1.0f));
+}
+
+// The name without its extension, cut short with ".." if wider than 'width' pixels.
+static void fitLabel(Font* font, const std::string& name, char* text, size_t size, float width)
+{
+	size_t length = std::min(std::min(name.find_last_of('.'), name.size()), size - 3);
+
+	FontRegion region;
+	float dots = font->tryGetFontRegion('.', region) ? region.xAdvance * 2.0f * BROWSER_TEXT_SCALE : 0.0f;
+
+	float x = 0.0f;
+	size_t fit = 0;
+	size_t fitWithDots = 0;
+	for (size_t i = 0; i < length; i++)
+	{
+		if (name[i] == ' ')
+			x += font->getSpaceWidth() * BROWSER_TEXT_SCALE;
+		else if (font->tryGetFontRegion(name[i], region))
+			x += region.xAdvance * BROWSER_TEXT_SCALE;
+
+		if (x > width)
+			break;
+
+		fit = i + 1;
+		if (x + dots <= width)
+			fitWithDots = i + 1;
+	}
+
+	if (fit == length)
+	{
+		memcpy(text, name.data(), length);
+		text[length] = '\0';
+		return;
+	}
+
+	memcpy(text, name.data(), fitWithDots);
+	memcpy(text + fitWithDots, "..", 3);
+}
+
+ModelBrowser::ModelBrowser() :
+	content(nullptr),
+	font(nullptr),
+	archive(nullptr),
+	open(false),
+	frame(0),
+	filterChanged(false),
+	scroll(0.0f),
+	cursor(0),
+	mouseWasDown(false),
+	requestedFirst(SIZE_MAX),
+	requestedLast(SIZE_MAX),
+	camera(glm::vec3(0.0f), glm::vec3(90.0f, 0.0f, 0.0f), 70.0f, 1.0f, 0.2f, 30000.0f),
+	fbo(0),
+	depth(0),
+	atlas(nullptr),
+	quad(nullptr),
+	cells(nullptr),
+	thumbnails(nullptr),
+	header(nullptr),
+	pendingEntry(-1)
+{}
+
+ModelBrowser::~ModelBrowser()
+{
+	// GL objects go in terminate(), while the context still exists.
+	loader.stop();
+}
+
+void ModelBrowser::initialize(Content* content, Font* font, const std::string& cachePath)
+{
+	this->content = content;
+	this->font = font;
+
+	archive = content->getArchive();
+	if (archive == nullptr)
+		return;
+
+	size_t count = archive->getNameIndex().getCount();
+	entrySlots.assign(count, -1);
+	entryFailed.assign(count, false);
+	slotEntries.assign(BROWSER_SLOT_COUNT, -1);
+	slotFrames.assign(BROWSER_SLOT_COUNT, 0);
+
+	// Without the cache every thumbnail is rendered again each session, which still works.
+	cache.open(cachePath, BROWSER_THUMBNAIL_SIZE);
+	loader.start(archive, &cache);
+
+	unsigned int colour = 0;
+	glGenTextures(1, &colour);
+	glBindTexture(GL_TEXTURE_2D, colour);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, BROWSER_ATLAS_SIZE, BROWSER_ATLAS_SIZE, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	atlas = new Texture(colour);
+
+	glGenRenderbuffers(1, &depth);
+	glBindRenderbuffer(GL_RENDERBUFFER, depth);
+	glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, BROWSER_ATLAS_SIZE, BROWSER_ATLAS_SIZE);
+	glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+	glGenFramebuffers(1, &fbo);
+	glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, colour, 0);
+	glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, depth);
+
+	GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+	if (status != GL_FRAMEBUFFER_COMPLETE)
+		LOG_ERROR(Render, "Thumbnail atlas incomplete, status " + std::to_string(status));
+
+	// Transparent until thumbnails land in it.
+	glViewport(0, 0, BROWSER_ATLAS_SIZE, BROWSER_ATLAS_SIZE);
+	glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+	glClear(GL_COLOR_BUFFER_BIT);
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	glViewport(0, 0, Config::windowResolutionX, Config::windowResolutionY);
+
+	for (auto& readback : readbacks)
+	{
+		glGenBuffers(1, &readback.buffer);
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, readback.buffer);
+		glBufferData(GL_PIXEL_PACK_BUFFER, BROWSER_THUMBNAIL_BYTES, nullptr, GL_STREAM_READ);
+	}
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+	addQuad(vertices, indices, 0.0f, 0.0f, 1.0f, 1.0f);
+	quad = new Mesh(vertices, indices, content->defaultTexture);
+	quad->setup();
+
+	vertices.clear();
+	indices.clear();
+	cells = new Mesh(vertices, indices, content->defaultTexture);
+	thumbnails = new Mesh(vertices, indices, atlas);
+
+	if (font != nullptr)
+	{
+		header = new Text("", font, glm::vec3(0.0f));
+		header->setScale(glm::vec3(BROWSER_TEXT_SCALE, BROWSER_TEXT_SCALE, 1.0f));
+	}
+
+	applyFilter();
+}
+
+void ModelBrowser::terminate()
+{
+	if (selection.valid())
+		selection.wait();
+
+	if (archive == nullptr)
+		return;
+
+	// Keeps what was rendered last.
+	collectReadbacks(true);
+	loader.stop();
+
+	for (auto& readback : readbacks)
+	{
+		glDeleteBuffers(1, &readback.buffer);
+		readback.buffer = 0;
+	}
+
+	glDeleteFramebuffers(1, &fbo);
+	glDeleteRenderbuffers(1, &depth);
+	fbo = 0;
+	depth = 0;
+
+	delete thumbnails;
+	delete cells;
+	delete quad;
+	delete atlas;
+	thumbnails = nullptr;
+	cells = nullptr;
+	quad = nullptr;
+	atlas = nullptr;
+
+	delete header;
+	header = nullptr;
+	for (auto& label : labels)
+	{
+		delete label;
+	}
+	labels.clear();
+	labelEntries.clear();
+
+	archive = nullptr;
+}
+
+void ModelBrowser::toggle()
+{
+	open = !open;
+
+	// Asks again for whatever is in view once reopened.
+	requestedFirst = SIZE_MAX;
+	requestedLast = SIZE_MAX;
+
+	if (!open)
+	{
+		wanted.clear();
+		loader.request(wanted);
+	}
+}
+
+bool ModelBrowser::isOpen() const
+{
+	return open;
+}
+
+void ModelBrowser::update(int width, int height)
+{
+	frame++;
+
+	if (!open || archive == nullptr)
+		return;
+
+	TRACE_ZONE("ModelBrowser::update");
+
+	// Escape clears the filter first, then closes.
+	if (Keyboard::isKeyPressed(GLFW_KEY_ESCAPE) && filter.empty())
+	{
+		toggle();
+		return;
+	}
+
+	typeFilter();
+	if (filterChanged)
+	{
+		applyFilter();
+		filterChanged = false;
+	}
+
+	Layout layout = getLayout(width, height);
+
+	// One row per notch.
+	scroll -= static_cast<float>(Mouse::getMouseScrollDelta()) * layout.cellHeight;
+
+	if (Keyboard::isKeyPressed(GLFW_KEY_PAGE_UP))
+		scroll -= layout.gridHeight;
+	if (Keyboard::isKeyPressed(GLFW_KEY_PAGE_DOWN))
+		scroll += layout.gridHeight;
+
+	if (!entries.empty())
+	{
+		size_t columns = static_cast<size_t>(layout.columns);
+		size_t previous = cursor;
+
+		if (Keyboard::isKeyPressed(GLFW_KEY_LEFT) && cursor > 0)
+			cursor--;
+		if (Keyboard::isKeyPressed(GLFW_KEY_RIGHT) && cursor + 1 < entries.size())
+			cursor++;
+		if (Keyboard::isKeyPressed(GLFW_KEY_UP) && cursor >= columns)
+			cursor -= columns;
+		if (Keyboard::isKeyPressed(GLFW_KEY_DOWN) && cursor + columns < entries.size())
+			cursor += columns;
+
+		if (cursor != previous)
+			moveCursor(layout);
+
+		if (Keyboard::isKeyPressed(GLFW_KEY_ENTER))
+			select(entries[cursor]);
+	}
+
+	size_t rows = (entries.size() + layout.columns - 1) / layout.columns;
+	float maxScroll = std::max(0.0f, rows * layout.cellHeight - layout.gridHeight);
+	scroll = std::min(std::max(scroll, 0.0f), maxScroll);
+
+	// Mouse::isButtonPressed doesn't track the previous state, so clicks are found here.
+	bool down = Mouse::isButtonHeld(GLFW_MOUSE_BUTTON_LEFT);
+	if (down && !mouseWasDown)
+	{
+		int64_t cell = getCellAt(layout, Mouse::getMousePosition());
+		if (cell >= 0)
+		{
+			cursor = static_cast<size_t>(cell);
+			select(entries[cursor]);
+		}
+	}
+	mouseWasDown = down;
+
+	requestThumbnails(layout);
+}
+
+void ModelBrowser::generate(Shader& shader, int width, int height)
+{
+	if (archive == nullptr)
+		return;
+
+	collectReadbacks(false);
+
+	if (!open)
+		return;
+
+	TRACE_ZONE("ModelBrowser::generate");
+
+	auto start = std::chrono::high_resolution_clock::now();
+
+	bool bound = false;
+	unsigned int processed = 0;
+	unsigned int renders = 0;
+
+	// At least one per frame, so a tiny budget is slow rather than stuck.
+	while (processed == 0 || (millisecondsSince(start) < Config::thumbnailBudget && renders < BROWSER_MAX_RENDERS))
+	{
+		int64_t slot = findFreeSlot();
+		if (slot < 0 || findFreeReadback() < 0)
+			break;
+
+		if (!loader.poll(result))
+			break;
+
+		processed++;
+
+		if (!result.error.empty())
+		{
+			LOG_DEBUG(Content, "No thumbnail for " + archive->getNameIndex().getName(result.entry) + ": " + result.error);
+			entryFailed[result.entry] = true;
+			continue;
+		}
+
+		if (slotEntries[slot] >= 0)
+		{
+			uint32_t evicted = static_cast<uint32_t>(slotEntries[slot]);
+			entrySlots[evicted] = -1;
+			loader.forget(evicted);
+		}
+
+		entrySlots[result.entry] = static_cast<int32_t>(slot);
+		slotEntries[slot] = result.entry;
+		slotFrames[slot] = frame;
+
+		if (result.cached)
+		{
+			uploadThumbnail(result, static_cast<uint32_t>(slot));
+			continue;
+		}
+
+		if (!bound)
+		{
+			glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+			glEnable(GL_SCISSOR_TEST);
+			bound = true;
+		}
+
+		renderThumbnail(shader, result, static_cast<uint32_t>(slot));
+		renders++;
+	}
+
+	if (bound)
+	{
+		glDisable(GL_SCISSOR_TEST);
+		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+		glViewport(0, 0, width, height);
+	}
+}
+
+void ModelBrowser::draw(Shader& shader, int width, int height)
+{
+	if (!open || archive == nullptr)
+		return;
+
+	TRACE_ZONE("ModelBrowser::draw");
+
+	Layout layout = getLayout(width, height);
+
+	size_t first = 0;
+	size_t last = 0;
+	getVisibleCells(layout, first, last);
+
+	int64_t hovered = getCellAt(layout, Mouse::getMousePosition());
+
+	auto getCellPosition = [&](size_t cell)
+	{
+		return glm::vec2(
+			BROWSER_MARGIN + (cell % layout.columns) * layout.cellWidth,
+			layout.gridTop + (cell / layout.columns) * layout.cellHeight - scroll);
+	};
+
+	glm::mat4 projection = glm::ortho(0.0f, (float)width, -(float)height, 0.0f, -1.0f, 1.0f);
+
+	glDisable(GL_DEPTH_TEST);
+
+	shader.bind();
+	shader.setUniformMat4("VPMatrix", projection);
+
+	shader.setUniform4f("tintColour", panelColour);
+	quad->draw(shader, getQuadMatrix(0.0f, 0.0f, layout.panelWidth, (float)height));
+
+	// Cells scrolled under the header are cut off.
+	glEnable(GL_SCISSOR_TEST);
+	glScissor(0, 0, static_cast<int>(layout.panelWidth), static_cast<int>(layout.gridHeight));
+
+	// Highlights fill the whole cell, the cell background leaves a border of them.
+	if (cursor >= first && cursor < last)
+	{
+		glm::vec2 position = getCellPosition(cursor);
+		shader.setUniform4f("tintColour", cursorColour);
+		quad->draw(shader, getQuadMatrix(position.x, position.y, layout.cellWidth, layout.cellHeight));
+	}
+	if (hovered >= 0 && static_cast<size_t>(hovered) != cursor)
+	{
+		glm::vec2 position = getCellPosition(static_cast<size_t>(hovered));
+		shader.setUniform4f("tintColour", hoverColour);
+		quad->draw(shader, getQuadMatrix(position.x, position.y, layout.cellWidth, layout.cellHeight));
+	}
+
+	vertices.clear();
+	indices.clear();
+	for (size_t i = first; i < last; i++)
+	{
+		glm::vec2 position = getCellPosition(i);
+		addQuad(vertices, indices, position.x + BROWSER_PADDING / 2.0f, position.y + BROWSER_PADDING / 2.0f,
+			layout.cellWidth - BROWSER_PADDING, layout.cellHeight - BROWSER_PADDING);
+	}
+	cells->update(vertices, indices);
+
+	shader.setUniform4f("tintColour", cellColour);
+	cells->draw(shader, glm::mat4(1.0f));
+
+	const float texel = 1.0f / BROWSER_ATLAS_SIZE;
+
+	vertices.clear();
+	indices.clear();
+	for (size_t i = first; i < last; i++)
+	{
+		int32_t slot = entrySlots[entries[i]];
+		if (slot < 0)
+			continue;
+
+		glm::vec2 uvMin((slot % BROWSER_SLOTS_PER_ROW) * BROWSER_THUMBNAIL_SIZE * texel, (slot / BROWSER_SLOTS_PER_ROW) * BROWSER_THUMBNAIL_SIZE * texel);
+		glm::vec2 uvMax = uvMin + glm::vec2(BROWSER_THUMBNAIL_SIZE * texel);
+
+		glm::vec2 position = getCellPosition(i);
+		addQuad(vertices, indices, position.x + BROWSER_PADDING, position.y + BROWSER_PADDING,
+			BROWSER_THUMBNAIL_SIZE, BROWSER_THUMBNAIL_SIZE, uvMin, uvMax);
+	}
+	thumbnails->update(vertices, indices);
+
+	shader.setUniform4f("tintColour", glm::vec4(1.0f));
+	thumbnails->draw(shader, glm::mat4(1.0f));
+
+	updateLabels(layout, first, last);
+	for (size_t i = first; i < last && !labels.empty(); i++)
+	{
+		Text* label = labels[i % labels.size()];
+
+		// Text positions are scaled along with the glyphs.
+		glm::vec2 position = getCellPosition(i);
+		label->setPosition(glm::vec3(
+			(position.x + BROWSER_PADDING) / BROWSER_TEXT_SCALE,
+			-(position.y + BROWSER_PADDING * 1.5f + BROWSER_THUMBNAIL_SIZE) / BROWSER_TEXT_SCALE,
+			0.0f));
+		label->draw(shader);
+	}
+
+	glDisable(GL_SCISSOR_TEST);
+
+	if (header != nullptr)
+	{
+		header->setPosition(glm::vec3(BROWSER_MARGIN / BROWSER_TEXT_SCALE, -BROWSER_MARGIN / BROWSER_TEXT_SCALE, 0.0f));
+		header->draw(shader);
+	}
+
+	glEnable(GL_DEPTH_TEST);
+}
+
+Model* ModelBrowser::takeSelection(std::string& name)
+{
+	if (!selection.valid() || selection.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+		return nullptr;
+
+	bool loaded = selection.get();
+
+	// Picked something else while this one loaded.
+	if (pendingEntry >= 0)
+	{
+		uint32_t entry = static_cast<uint32_t>(pendingEntry);
+		pendingEntry = -1;
+		select(entry);
+		return nullptr;
+	}
+
+	if (!loaded)
+	{
+		LOG_WARNING(Content, "Failed to load model: " + selectionName);
+		return nullptr;
+	}
+
+	Model* model = content->addModel(selectionName, selectionData);
+	selectionData = ModelData();
+
+	name = selectionName;
+	return model;
+}
+
+ModelBrowser::Layout ModelBrowser::getLayout(int width, int height) const
+{
+	Layout layout;
+	layout.cellWidth = BROWSER_THUMBNAIL_SIZE + BROWSER_PADDING * 2.0f;
+
+	float lineHeight = font != nullptr ? font->getLineHeight() * BROWSER_TEXT_SCALE : 0.0f;
+	layout.cellHeight = layout.cellWidth + lineHeight;
+
+	int columns = static_cast<int>((width * BROWSER_WIDTH_FRACTION - BROWSER_MARGIN * 2.0f) / layout.cellWidth);
+	layout.columns = std::min(std::max(columns, 1), BROWSER_MAX_COLUMNS);
+	layout.panelWidth = layout.columns * layout.cellWidth + BROWSER_MARGIN * 2.0f;
+
+	layout.gridTop = lineHeight + BROWSER_MARGIN * 2.0f;
+	layout.gridHeight = std::max(0.0f, height - layout.gridTop);
+	return layout;
+}
+
+void ModelBrowser::getVisibleCells(const Layout& layout, size_t& first, size_t& last) const
+{
+	size_t firstRow = static_cast<size_t>(scroll / layout.cellHeight);
+	size_t lastRow = static_cast<size_t>((scroll + layout.gridHeight) / layout.cellHeight);
+
+	first = std::min(firstRow * layout.columns, entries.size());
+	last = std::min((lastRow + 1) * layout.columns, entries.size());
+}
+
+int64_t ModelBrowser::getCellAt(const Layout& layout, const glm::vec2& position) const
+{
+	if (position.x < BROWSER_MARGIN || position.x >= layout.panelWidth - BROWSER_MARGIN)
+		return -1;
+	if (position.y < layout.gridTop || position.y >= layout.gridTop + layout.gridHeight)
+		return -1;
+
+	size_t column = static_cast<size_t>((position.x - BROWSER_MARGIN) / layout.cellWidth);
+	size_t row = static_cast<size_t>((position.y - layout.gridTop + scroll) / layout.cellHeight);
+
+	size_t cell = row * layout.columns + std::min(column, static_cast<size_t>(layout.columns - 1));
+	return cell < entries.size() ? static_cast<int64_t>(cell) : -1;
+}
+
+void ModelBrowser::typeFilter()
+{
+	size_t length = filter.size();
+
+	// Key codes of letters, digits and these match their ASCII characters.
+	bool shift = Keyboard::isKeyHeld(GLFW_KEY_LEFT_SHIFT) || Keyboard::isKeyHeld(GLFW_KEY_RIGHT_SHIFT);
+	for (int key = GLFW_KEY_A; key <= GLFW_KEY_Z; key++)
+	{
+		if (Keyboard::isKeyPressed(key))
+			filter += static_cast<char>('a' + (key - GLFW_KEY_A));
+	}
+	for (int key = GLFW_KEY_0; key <= GLFW_KEY_9; key++)
+	{
+		if (Keyboard::isKeyPressed(key))
+			filter += static_cast<char>(key);
+	}
+	if (Keyboard::isKeyPressed(GLFW_KEY_MINUS))
+		filter += shift ? '_' : '-';
+	if (Keyboard::isKeyPressed(GLFW_KEY_PERIOD))
+		filter += '.';
+	if (Keyboard::isKeyPressed(GLFW_KEY_SPACE))
+		filter += ' ';
+
+	if (filter.size() > BROWSER_MAX_FILTER_LENGTH)
+		filter.resize(BROWSER_MAX_FILTER_LENGTH);
+
+	if (Keyboard::isKeyPressed(GLFW_KEY_BACKSPACE) && !filter.empty())
+	{
+		filter.pop_back();
+		length = SIZE_MAX;
+	}
+	if (Keyboard::isKeyPressed(GLFW_KEY_ESCAPE) && !filter.empty())
+	{
+		filter.clear();
+		length = SIZE_MAX;
+	}
+
+	if (filter.size() != length)
+		filterChanged = true;
+}
+
+void ModelBrowser::applyFilter()
+{
+	TRACE_ZONE_DETAIL("ModelBrowser::applyFilter", filter);
+
+	const NameIndex& index = archive->getNameIndex();
+
+	if (filter.empty())
+	{
+		entries = index.getEntries("mdl");
+	}
+	else
+	{
+		NameQuery query;
+		query.text = filter;
+		query.extension = "mdl";
+		query.limit = index.getCount();
+
+		entries.clear();
+		for (auto& match : index.search(query))
+		{
+			entries.push_back(match.entry);
+		}
+	}
+
+	scroll = 0.0f;
+	cursor = 0;
+	requestedFirst = SIZE_MAX;
+	requestedLast = SIZE_MAX;
+	std::fill(labelEntries.begin(), labelEntries.end(), -1);
+
+	updateHeader();
+}
+
+void ModelBrowser::moveCursor(const Layout& layout)
+{
+	float top = (cursor / layout.columns) * layout.cellHeight;
+	if (top < scroll)
+		scroll = top;
+	else if (top + layout.cellHeight > scroll + layout.gridHeight)
+		scroll = top + layout.cellHeight - layout.gridHeight;
+}
+
+void ModelBrowser::requestThumbnails(const Layout& layout)
+{
+	size_t first = 0;
+	size_t last = 0;
+	getVisibleCells(layout, first, last);
+
+	// Slots in view are never replaced.
+	for (size_t i = first; i < last; i++)
+	{
+		int32_t slot = entrySlots[entries[i]];
+		if (slot >= 0)
+			slotFrames[slot] = frame;
+	}
+
+	if (first == requestedFirst && last == requestedLast)
+		return;
+
+	requestedFirst = first;
+	requestedLast = last;
+
+	auto want = [this](size_t begin, size_t end)
+	{
+		for (size_t i = begin; i < end; i++)
+		{
+			uint32_t entry = entries[i];
+			if (entrySlots[entry] < 0 && !entryFailed[entry])
+				wanted.push_back(entry);
+		}
+	};
+
+	// What is in view, then the rows below, then the rows above.
+	size_t ahead = static_cast<size_t>(layout.columns) * BROWSER_PREFETCH_ROWS;
+	wanted.clear();
+	want(first, last);
+	want(last, std::min(last + ahead, entries.size()));
+	want(first - std::min(first, ahead), first);
+
+	loader.request(wanted);
+}
+
+void ModelBrowser::select(uint32_t entry)
+{
+	if (selection.valid())
+	{
+		pendingEntry = entry;
+		return;
+	}
+
+	selectionName = archive->getNameIndex().getName(entry);
+	selectionData = ModelData();
+
+	selection = std::async(std::launch::async, [this]()
+	{
+		TRACE_ZONE_DETAIL("ModelBrowser::select", selectionName);
+
+		try
+		{
+			return content->loadModelData(selectionName, selectionData);
+		}
+		catch (const std::exception& e)
+		{
+			LOG_WARNING(Content, "Failed to load " + selectionName + ": " + e.what());
+			return false;
+		}
+	});
+}
+
+int64_t ModelBrowser::findFreeSlot()
+{
+	int64_t oldest = -1;
+	for (size_t slot = 0; slot < slotEntries.size(); slot++)
+	{
+		if (slotEntries[slot] < 0)
+			return static_cast<int64_t>(slot);
+
+		if (slotFrames[slot] < frame && (oldest < 0 || slotFrames[slot] < slotFrames[oldest]))
+			oldest = static_cast<int64_t>(slot);
+	}
+	return oldest;
+}
+
+int ModelBrowser::findFreeReadback() const
+{
+	for (int i = 0; i < BROWSER_READBACK_BUFFERS; i++)
+	{
+		if (!readbacks[i].busy)
+			return i;
+	}
+	return -1;
+}
+
+void ModelBrowser::uploadThumbnail(const ThumbnailResult& result, uint32_t slot)
+{
+	TRACE_ZONE("ModelBrowser::uploadThumbnail");
+
+	atlas->bind(0);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+	glTexSubImage2D(GL_TEXTURE_2D, 0,
+		(slot % BROWSER_SLOTS_PER_ROW) * BROWSER_THUMBNAIL_SIZE, (slot / BROWSER_SLOTS_PER_ROW) * BROWSER_THUMBNAIL_SIZE,
+		BROWSER_THUMBNAIL_SIZE, BROWSER_THUMBNAIL_SIZE, GL_RGBA, GL_UNSIGNED_BYTE, result.pixels.data());
+}
+
+void ModelBrowser::renderThumbnail(Shader& shader, const ThumbnailResult& result, uint32_t slot)
+{
+	const ModelData& data = result.data;
+
+	TRACE_ZONE_DETAIL("ModelBrowser::renderThumbnail", data.name);
+
+	int x = (slot % BROWSER_SLOTS_PER_ROW) * BROWSER_THUMBNAIL_SIZE;
+	int y = (slot / BROWSER_SLOTS_PER_ROW) * BROWSER_THUMBNAIL_SIZE;
+
+	glViewport(x, y, BROWSER_THUMBNAIL_SIZE, BROWSER_THUMBNAIL_SIZE);
+	glScissor(x, y, BROWSER_THUMBNAIL_SIZE, BROWSER_THUMBNAIL_SIZE);
+
+	// Transparent, so the cell shows through whatever the background is set to.
+	glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+	glm::vec3 center = data.boundsCorner + data.boundsSize / 2.0f;
+	center.z = -center.z;
+
+	float radius = glm::length(data.boundsSize) / 2.0f;
+	if (radius <= 0.0f)
+		radius = 100.0f;
+
+	float distance = radius / std::sin(glm::radians(camera.getFieldOfView() / 2.0f));
+	camera.orbit(center, distance, BROWSER_CAMERA_YAW, BROWSER_CAMERA_PITCH);
+
+	// Display as a left-handed coordinate system.
+	glm::mat4 view = glm::scale(camera.getViewMatrix(), glm::vec3(1.0f, 1.0f, -1.0f));
+
+	shader.bind();
+	shader.setUniformMat4("VPMatrix", camera.getProjectionMatrix() * view);
+
+	// Textures only live for this one thumbnail, shared ones are uploaded once.
+	std::vector<std::pair<const ThumbnailTexture*, Texture*>> textures;
+
+	for (size_t i = 0; i < data.meshes.size(); i++)
+	{
+		const MeshRange& range = data.meshes[i];
+		if (range.vertexOffset + range.vertexCount > data.vertices.size() ||
+			range.indexOffset + range.indexCount > data.indices.size())
+			continue;
+
+		Texture* texture = content->defaultTexture;
+
+		const ThumbnailTexture* source = result.textures[i].get();
+		if (source != nullptr)
+		{
+			auto it = std::find_if(textures.begin(), textures.end(), [source](const std::pair<const ThumbnailTexture*, Texture*>& pair) { return pair.first == source; });
+			if (it != textures.end())
+			{
+				texture = it->second;
+			}
+			else
+			{
+				unsigned int id = 0;
+				glGenTextures(1, &id);
+				glBindTexture(GL_TEXTURE_2D, id);
+				glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+				glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, source->width, source->height, 0, GL_RGBA, GL_UNSIGNED_BYTE, source->texels.data());
+				glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+				glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+				texture = new Texture(id);
+				textures.push_back({ source, texture });
+			}
+		}
+
+		Mesh mesh(
+			std::vector<Vertex>(data.vertices.begin() + range.vertexOffset, data.vertices.begin() + range.vertexOffset + range.vertexCount),
+			std::vector<unsigned int>(data.indices.begin() + range.indexOffset, data.indices.begin() + range.indexOffset + range.indexCount),
+			texture);
+		mesh.setup();
+		mesh.draw(shader, glm::mat4(1.0f));
+	}
+
+	for (auto& pair : textures)
+	{
+		delete pair.second;
+	}
+
+	// Copied into a pixel buffer now, read from it a few frames later, see collectReadbacks().
+	int index = findFreeReadback();
+	if (result.key.empty() || index < 0)
+		return;
+
+	Readback& readback = readbacks[index];
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, readback.buffer);
+	glPixelStorei(GL_PACK_ALIGNMENT, 4);
+	glReadPixels(x, y, BROWSER_THUMBNAIL_SIZE, BROWSER_THUMBNAIL_SIZE, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+	readback.busy = true;
+	readback.frame = frame;
+	readback.key = result.key;
+}
+
+void ModelBrowser::collectReadbacks(bool wait)
+{
+	for (auto& readback : readbacks)
+	{
+		if (!readback.busy || (!wait && frame < readback.frame + BROWSER_READBACK_FRAMES))
+			continue;
+
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, readback.buffer);
+
+		const unsigned char* data = static_cast<const unsigned char*>(glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, BROWSER_THUMBNAIL_BYTES, GL_MAP_READ_BIT));
+		if (data != nullptr)
+		{
+			std::vector<unsigned char> pixels(data, data + BROWSER_THUMBNAIL_BYTES);
+			glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+			loader.save(readback.key, std::move(pixels));
+		}
+
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+		readback.busy = false;
+	}
+}
+
+void ModelBrowser::updateLabels(const Layout& layout, size_t first, size_t last)
+{
+	if (font == nullptr)
+		return;
+
+	// Enough for every cell in view, so cell i always has label i modulo the count.
+	if (labels.size() < last - first)
+	{
+		while (labels.size() < last - first)
+		{
+			Text* label = new Text("", font, glm::vec3(0.0f));
+			label->setScale(glm::vec3(BROWSER_TEXT_SCALE, BROWSER_TEXT_SCALE, 1.0f));
+			labels.push_back(label);
+		}
+		labelEntries.assign(labels.size(), -1);
+	}
+
+	const NameIndex& index = archive->getNameIndex();
+
+	for (size_t i = first; i < last; i++)
+	{
+		int64_t& shown = labelEntries[i % labels.size()];
+		if (shown == entries[i])
+			continue;
+
+		char text[64];
+		fitLabel(font, index.getName(entries[i]), text, sizeof(text), layout.cellWidth - BROWSER_PADDING * 2.0f);
+		labels[i % labels.size()]->setText(text);
+		shown = entries[i];
+	}
+}
+
+void ModelBrowser::updateHeader()
+{
+	if (header == nullptr)
+		return;
+
+	char text[128];
+	snprintf(text, sizeof(text), "%zu models   Filter: %s_", entries.size(), filter.c_str());
+	header->setText(text);
+}
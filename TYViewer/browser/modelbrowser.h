@@ -0,0 +1,158 @@
+#pragma once
+
+#include <future>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+#include "graphics/mesh.h"
+#include "graphics/text.h"
+#include "graphics/camera.h"
+#include "graphics/shader.h"
+#include "graphics/texture.h"
+
+#include "loader/modeldata.h"
+
+#include "util/font.h"
+
+#include "thumbnailcache.h"
+#include "thumbnailloader.h"
+
+// Thumbnails in pixels, and the atlas they are drawn from. Its 256 slots cover a full screen of cells.
+#define BROWSER_THUMBNAIL_SIZE 128
+#define BROWSER_ATLAS_SIZE 2048
+
+// Rendered thumbnails are read back through these, a few frames later so the GPU never stalls.
+#define BROWSER_READBACK_BUFFERS 8
+#define BROWSER_READBACK_FRAMES 2
+
+class Content;
+class Model;
+
+// Every model of the archive as a grid of thumbnails, opened with Tab. Typing filters it by name.
+// Only the cells in view exist, their labels and quads come from a fixed pool as it scrolls.
+// Thumbnails are read from the disk cache or rendered into an atlas on the GPU, as many per
+// frame as fit in Config::thumbnailBudget, while the loader thread decodes the next ones.
+// Clicking a cell loads that model in the background, takeSelection() hands it over.
+class ModelBrowser
+{
+public:
+	ModelBrowser();
+	~ModelBrowser();
+
+	// Thumbnails are cached in 'cachePath'.
+	void initialize(Content* content, Font* font, const std::string& cachePath);
+	void terminate();
+
+	void toggle();
+	bool isOpen() const;
+
+	// Letters go to the filter while open.
+	void update(int width, int height);
+
+	// Fills the atlas, call before anything else is drawn in a frame.
+	void generate(Shader& shader, int width, int height);
+	// Screen-space grid over everything else.
+	void draw(Shader& shader, int width, int height);
+
+	// The model the user picked once it finished loading, null otherwise.
+	// It is cached in the Content like any other model, 'name' is its entry.
+	Model* takeSelection(std::string& name);
+
+private:
+	struct Layout
+	{
+		int columns = 1;
+		float panelWidth = 0.0f;
+		float gridTop = 0.0f;
+		float gridHeight = 0.0f;
+		float cellWidth = 0.0f;
+		float cellHeight = 0.0f;
+	};
+
+	struct Readback
+	{
+		unsigned int buffer = 0;
+		uint64_t frame = 0;
+		bool busy = false;
+		std::string key;
+	};
+
+	Layout getLayout(int width, int height) const;
+	// Cells from 'first' up to 'last' are at least partly in view.
+	void getVisibleCells(const Layout& layout, size_t& first, size_t& last) const;
+	// The cell under a window position in pixels, -1 if none.
+	int64_t getCellAt(const Layout& layout, const glm::vec2& position) const;
+
+	void typeFilter();
+	void applyFilter();
+	void moveCursor(const Layout& layout);
+	void requestThumbnails(const Layout& layout);
+	void select(uint32_t entry);
+
+	// -1 if every slot is still in view.
+	int64_t findFreeSlot();
+	int findFreeReadback() const;
+	void uploadThumbnail(const ThumbnailResult& result, uint32_t slot);
+	void renderThumbnail(Shader& shader, const ThumbnailResult& result, uint32_t slot);
+	// Saves finished readbacks, 'wait' also those the GPU is still working on.
+	void collectReadbacks(bool wait);
+
+	void updateLabels(const Layout& layout, size_t first, size_t last);
+	void updateHeader();
+
+	Content* content;
+	Font* font;
+	const Archive* archive;
+
+	bool open;
+	uint64_t frame;
+
+	std::string filter;
+	bool filterChanged;
+	// Name index entries in grid order.
+	std::vector<uint32_t> entries;
+
+	float scroll;
+	size_t cursor;
+	bool mouseWasDown;
+
+	// What was last handed to the loader, it is only asked again when this changes.
+	size_t requestedFirst;
+	size_t requestedLast;
+	std::vector<uint32_t> wanted;
+
+	ThumbnailCache cache;
+	ThumbnailLoader loader;
+	ThumbnailResult result;
+	Camera camera;
+
+	unsigned int fbo;
+	unsigned int depth;
+	Texture* atlas;
+
+	// Atlas slot of each entry or -1, and the entry in each slot or -1.
+	std::vector<int32_t> entrySlots;
+	std::vector<bool> entryFailed;
+	std::vector<int64_t> slotEntries;
+	// Last frame each slot was in view, the oldest is replaced first.
+	std::vector<uint64_t> slotFrames;
+
+	Readback readbacks[BROWSER_READBACK_BUFFERS];
+
+	Mesh* quad;
+	Mesh* cells;
+	Mesh* thumbnails;
+	std::vector<Vertex> vertices;
+	std::vector<unsigned int> indices;
+
+	Text* header;
+	std::vector<Text*> labels;
+	std::vector<int64_t> labelEntries;
+
+	// The model being loaded and the one picked while it was, which replaces it.
+	std::future<bool> selection;
+	std::string selectionName;
+	ModelData selectionData;
+	int64_t pendingEntry;
+};
@@ -0,0 +1,145 @@
+#include "thumbnailcache.h"
+
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+
+#include <SOIL2/SOIL2.h>
+
+#include "loader/modelbuilder.h"
+
+#include "util/trace.h"
+
+#include "debug.h"
+
+// Bumped whenever thumbnails are drawn differently, older ones are then rendered again.
+#define THUMBNAIL_CACHE_VERSION 1
+
+// Entries without a CRC are identified by where they are and when they were written.
+static std::uint32_t getSignature(const File& file)
+{
+	if (file.crc != 0)
+		return file.crc;
+
+	std::uint32_t hash = 2166136261u;
+	std::int64_t fields[] = { file.size, file.offset, file.date };
+	for (std::int64_t field : fields)
+	{
+		for (int i = 0; i < 8; i++)
+		{
+			hash ^= static_cast<std::uint32_t>((field >> (i * 8)) & 0xFF);
+			hash *= 16777619u;
+		}
+	}
+	return hash;
+}
+
+static void flipRows(std::vector<unsigned char>& pixels, int width, int height)
+{
+	const size_t stride = static_cast<size_t>(width) * 4;
+	std::vector<unsigned char> row(stride);
+	for (int y = 0; y < height / 2; y++)
+	{
+		unsigned char* a = &pixels[y * stride];
+		unsigned char* b = &pixels[(height - 1 - y) * stride];
+		memcpy(row.data(), a, stride);
+		memcpy(a, b, stride);
+		memcpy(b, row.data(), stride);
+	}
+}
+
+ThumbnailCache::ThumbnailCache() :
+	size(0)
+{}
+
+bool ThumbnailCache::open(const std::string& directory, int size)
+{
+	std::filesystem::path path = std::filesystem::path(directory) / std::to_string(size);
+
+	std::error_code error;
+	std::filesystem::create_directories(path, error);
+	if (error)
+	{
+		LOG_WARNING(General, "Failed to create thumbnail cache: " + path.string());
+		return false;
+	}
+
+	this->directory = path.string();
+	this->size = size;
+	return true;
+}
+
+std::string ThumbnailCache::getKey(const Archive& archive, const std::string& model)
+{
+	File mdl;
+	if (!archive.getFile(model, mdl))
+		return std::string();
+
+	File mdg;
+	std::uint32_t geometry = 0;
+	if (archive.getFile(ModelBuilder::getMDGName(model), mdg))
+		geometry = getSignature(mdg);
+
+	char key[32];
+	snprintf(key, sizeof(key), "%08x%08x_%d", getSignature(mdl), geometry, THUMBNAIL_CACHE_VERSION);
+	return key;
+}
+
+bool ThumbnailCache::load(const std::string& key, std::vector<unsigned char>& pixels) const
+{
+	if (directory.empty())
+		return false;
+
+	TRACE_ZONE_DETAIL("ThumbnailCache::load", key);
+
+	std::string path = getPath(key);
+	if (!std::filesystem::exists(path))
+		return false;
+
+	int width = 0;
+	int height = 0;
+	int channels = 0;
+	unsigned char* data = SOIL_load_image(path.c_str(), &width, &height, &channels, SOIL_LOAD_RGBA);
+	if (data == nullptr)
+		return false;
+
+	// Sizes are part of the directory, anything else was not written by us.
+	bool valid = width == size && height == size;
+	if (valid)
+	{
+		pixels.assign(data, data + static_cast<size_t>(width) * height * 4);
+		flipRows(pixels, width, height);
+	}
+
+	SOIL_free_image_data(data);
+	return valid;
+}
+
+bool ThumbnailCache::save(const std::string& key, const std::vector<unsigned char>& pixels) const
+{
+	if (directory.empty() || pixels.size() != static_cast<size_t>(size) * size * 4)
+		return false;
+
+	TRACE_ZONE_DETAIL("ThumbnailCache::save", key);
+
+	std::vector<unsigned char> rows = pixels;
+	flipRows(rows, size, size);
+
+	std::string path = getPath(key);
+	if (SOIL_save_image(path.c_str(), SOIL_SAVE_TYPE_PNG, size, size, 4, rows.data()) == 0)
+	{
+		LOG_WARNING(General, "Failed to save thumbnail: " + path);
+		return false;
+	}
+	return true;
+}
+
+int ThumbnailCache::getSize() const
+{
+	return size;
+}
+
+std::string ThumbnailCache::getPath(const std::string& key) const
+{
+	return (std::filesystem::path(directory) / (key + ".png")).string();
+}
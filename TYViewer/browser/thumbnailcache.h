@@ -0,0 +1,35 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "loader/archive.h"
+
+// Thumbnails the model browser rendered, saved as PNGs so each model is only rendered once.
+// Files are named after the CRCs of the model's entries, so a changed model gets a new file
+// and thumbnails of one archive are reused by any other holding the same model.
+// Any number of threads may load and save at once, as long as they use different keys.
+class ThumbnailCache
+{
+public:
+	ThumbnailCache();
+
+	// Creates '<directory>/<size>' if needed, false if it can't.
+	bool open(const std::string& directory, int size);
+
+	// From the CRCs of the .mdl and .mdg, or their size, offset and date in archives without CRCs.
+	// Empty if the model is not in the archive.
+	static std::string getKey(const Archive& archive, const std::string& model);
+
+	// RGBA rows bottom to top like OpenGL, false if not cached or unreadable.
+	bool load(const std::string& key, std::vector<unsigned char>& pixels) const;
+	bool save(const std::string& key, const std::vector<unsigned char>& pixels) const;
+
+	int getSize() const;
+
+private:
+	std::string getPath(const std::string& key) const;
+
+	std::string directory;
+	int size;
+};
@@ -0,0 +1,238 @@
+#include "thumbnailloader.h"
+
+#include <algorithm>
+
+#include "loader/modelbuilder.h"
+
+#include "graphics/rasterizer.h"
+
+#include "util/trace.h"
+
+#include "debug.h"
+
+// Finished entries waiting for the render thread, past this the loader waits rather than
+// working ahead on entries that may have scrolled away by the time they are drawn.
+#define THUMBNAIL_LOADER_READY_LIMIT 4
+
+// Largest texture side kept, thumbnails are too small to show more.
+#define THUMBNAIL_LOADER_TEXTURE_SIZE 64
+
+// Shrunk textures are dropped once they add up to this, models in flight keep theirs.
+#define THUMBNAIL_LOADER_TEXTURE_CACHE_BYTES (16 * 1024 * 1024)
+
+ThumbnailLoader::ThumbnailLoader() :
+	archive(nullptr),
+	cache(nullptr),
+	running(false),
+	queueNext(0),
+	textureBytes(0)
+{}
+
+ThumbnailLoader::~ThumbnailLoader()
+{
+	stop();
+}
+
+void ThumbnailLoader::start(const Archive* archive, const ThumbnailCache* cache)
+{
+	stop();
+
+	this->archive = archive;
+	this->cache = cache;
+
+	issued.assign(archive->getNameIndex().getCount(), false);
+	queue.clear();
+	queueNext = 0;
+	results.clear();
+
+	running = true;
+	thread = std::thread(&ThumbnailLoader::run, this);
+}
+
+void ThumbnailLoader::stop()
+{
+	if (!thread.joinable())
+		return;
+
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		running = false;
+	}
+	condition.notify_all();
+	thread.join();
+
+	results.clear();
+	textures.clear();
+	textureBytes = 0;
+}
+
+void ThumbnailLoader::request(const std::vector<uint32_t>& entries)
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		queue.assign(entries.begin(), entries.end());
+		queueNext = 0;
+	}
+	condition.notify_all();
+}
+
+void ThumbnailLoader::forget(uint32_t entry)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	if (entry < issued.size())
+		issued[entry] = false;
+}
+
+bool ThumbnailLoader::poll(ThumbnailResult& result)
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		if (results.empty())
+			return false;
+
+		result = std::move(results.front());
+		results.pop_front();
+	}
+	condition.notify_all();
+	return true;
+}
+
+void ThumbnailLoader::save(const std::string& key, std::vector<unsigned char>&& pixels)
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		saves.emplace_back(key, std::move(pixels));
+	}
+	condition.notify_all();
+}
+
+void ThumbnailLoader::run()
+{
+	Trace::setThreadName("Thumbnails");
+
+	std::unique_lock<std::mutex> lock(mutex);
+	while (true)
+	{
+		condition.wait(lock, [this]()
+		{
+			return !running || !saves.empty() || (queueNext < queue.size() && results.size() < THUMBNAIL_LOADER_READY_LIMIT);
+		});
+
+		// Saves go first, they hold on to pixels and are quick.
+		if (!saves.empty())
+		{
+			std::pair<std::string, std::vector<unsigned char>> save = std::move(saves.front());
+			saves.pop_front();
+
+			lock.unlock();
+			cache->save(save.first, save.second);
+			lock.lock();
+			continue;
+		}
+
+		if (!running)
+			break;
+
+		uint32_t entry = queue[queueNext++];
+		if (entry >= issued.size() || issued[entry])
+			continue;
+		issued[entry] = true;
+
+		lock.unlock();
+		ThumbnailResult result;
+		load(entry, result);
+		lock.lock();
+
+		results.push_back(std::move(result));
+	}
+}
+
+void ThumbnailLoader::load(uint32_t entry, ThumbnailResult& result)
+{
+	const std::string& name = archive->getNameIndex().getName(entry);
+
+	TRACE_ZONE_DETAIL("ThumbnailLoader::load", name);
+
+	result.entry = entry;
+	result.key = ThumbnailCache::getKey(*archive, name);
+
+	if (!result.key.empty() && cache->load(result.key, result.pixels))
+	{
+		result.cached = true;
+		return;
+	}
+
+	try
+	{
+		if (!ModelBuilder::build(*archive, name, result.data))
+		{
+			result.error = result.data.error.empty() ? "build failed" : result.data.error;
+			return;
+		}
+
+		result.textures.resize(result.data.meshes.size());
+		for (size_t i = 0; i < result.data.meshes.size(); i++)
+		{
+			if (!result.data.meshes[i].texture.empty())
+				result.textures[i] = getTexture(result.data.meshes[i].texture + ".dds");
+		}
+	}
+	catch (const std::exception& e)
+	{
+		result.error = std::string("exception: ") + e.what();
+	}
+	catch (...)
+	{
+		result.error = "unknown exception";
+	}
+}
+
+std::shared_ptr<const ThumbnailTexture> ThumbnailLoader::getTexture(const std::string& name)
+{
+	auto it = textures.find(name);
+	if (it != textures.end())
+		return it->second;
+
+	if (textureBytes > THUMBNAIL_LOADER_TEXTURE_CACHE_BYTES)
+	{
+		textures.clear();
+		textureBytes = 0;
+	}
+
+	TRACE_ZONE_DETAIL("ThumbnailLoader::getTexture", name);
+
+	// Missing and broken textures are remembered too, as null.
+	std::shared_ptr<ThumbnailTexture> texture;
+
+	std::vector<char> data;
+	SoftwareTexture decoded;
+	if (archive->getFileData(name, data) && decoded.load(data))
+	{
+		// First mip that fits, or the smallest there is.
+		int level = 0;
+		while (level + 1 < decoded.getLevels() &&
+			std::max(decoded.getLevel(level).width, decoded.getLevel(level).height) > THUMBNAIL_LOADER_TEXTURE_SIZE)
+		{
+			level++;
+		}
+
+		const SoftwareTexture::Level& source = decoded.getLevel(level);
+
+		texture = std::make_shared<ThumbnailTexture>();
+		texture->width = source.width;
+		texture->height = source.height;
+		texture->texels.resize(source.texels.size());
+
+		// Loaded textures are flipped the same way, see Content::load<Texture>.
+		for (int y = 0; y < source.height; y++)
+		{
+			std::copy_n(&source.texels[static_cast<size_t>(source.height - 1 - y) * source.width], source.width,
+				&texture->texels[static_cast<size_t>(y) * source.width]);
+		}
+
+		textureBytes += texture->texels.size() * sizeof(uint32_t);
+	}
+
+	textures[name] = texture;
+	return texture;
+}
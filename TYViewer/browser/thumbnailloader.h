@@ -0,0 +1,91 @@
+#pragma once
+
+#include <deque>
+#include <mutex>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include <cstdint>
+#include <unordered_map>
+#include <condition_variable>
+
+#include "loader/archive.h"
+#include "loader/modeldata.h"
+
+#include "thumbnailcache.h"
+
+// A texture shrunk to what a thumbnail needs, rows bottom to top ready for glTexImage2D.
+struct ThumbnailTexture
+{
+	int width = 0;
+	int height = 0;
+	std::vector<uint32_t> texels;
+};
+
+// What the loader thread made of one entry.
+struct ThumbnailResult
+{
+	// Name index entry of the model.
+	uint32_t entry = 0;
+	std::string key;
+
+	// Read from the cache, nothing left to render.
+	bool cached = false;
+	std::vector<unsigned char> pixels;
+
+	// Otherwise the model to render, unless 'error' is set.
+	ModelData data;
+	// One per mesh range, null where the texture is missing.
+	std::vector<std::shared_ptr<const ThumbnailTexture>> textures;
+	std::string error;
+};
+
+// Reads cached thumbnails and decodes models on a background thread in the order the browser
+// wants them, so the render thread only uploads and draws. Cache writes happen there as well.
+class ThumbnailLoader
+{
+public:
+	ThumbnailLoader();
+	~ThumbnailLoader();
+
+	void start(const Archive* archive, const ThumbnailCache* cache);
+	// Finishes the queued saves, drops everything else.
+	void stop();
+
+	// Replaces what is left to load, most wanted first. Entries handed out before are skipped.
+	void request(const std::vector<uint32_t>& entries);
+	// Lets 'entry' be loaded again, once its thumbnail was dropped.
+	void forget(uint32_t entry);
+
+	// Takes a finished entry, false if none is ready. Never waits.
+	bool poll(ThumbnailResult& result);
+
+	// RGBA rows bottom to top, written to the cache on the loader thread.
+	void save(const std::string& key, std::vector<unsigned char>&& pixels);
+
+private:
+	void run();
+	void load(uint32_t entry, ThumbnailResult& result);
+	std::shared_ptr<const ThumbnailTexture> getTexture(const std::string& name);
+
+	const Archive* archive;
+	const ThumbnailCache* cache;
+
+	std::thread thread;
+	std::mutex mutex;
+	std::condition_variable condition;
+	bool running;
+
+	std::vector<uint32_t> queue;
+	size_t queueNext;
+	// Entries taken from the queue since they were last forgotten.
+	std::vector<bool> issued;
+
+	std::deque<ThumbnailResult> results;
+	std::deque<std::pair<std::string, std::vector<unsigned char>>> saves;
+
+	// Only touched by the loader thread.
+	std::unordered_map<std::string, std::shared_ptr<const ThumbnailTexture>> textures;
+	size_t textureBytes;
+};
@@ -3,6 +3,7 @@
 #include <fstream>
 
 #include <sstream>
+#include <vector>
 #include <iostream>
 
 std::string Config::model = "";
@@ -15,6 +16,13 @@ float Config::backgroundR = 0.2f;
 float Config::backgroundG = 0.2f;
 float Config::backgroundB = 0.2f;
 
+std::string Config::logFilter = "";
+
+unsigned int Config::turntableFrames = 360;
+std::string Config::captureEncoder = "";
+
+float Config::thumbnailBudget = 2.0f;
+
 
 bool Config::save(const std::string& path)
 {
@@ -35,6 +43,13 @@ bool Config::save(const std::string& path)
 		std::to_string(backgroundG) << " " <<
 		std::to_string(backgroundB) << std::endl;
 
+	stream << "LogFilter" << "=" << logFilter << std::endl;
+
+	stream << "TurntableFrames" << "=" << std::to_string(turntableFrames) << std::endl;
+	stream << "CaptureEncoder" << "=" << captureEncoder << std::endl;
+
+	stream << "ThumbnailBudget" << "=" << std::to_string(thumbnailBudget) << std::endl;
+
 	stream.close();
 	return true;
 }
@@ -94,5 +109,24 @@ bool Config::load(const std::string& path)
 			backgroundG = rgb[1];
 			backgroundB = rgb[2];
 		}
+
+		else if (name == "LogFilter")
+		{
+			logFilter = value;
+		}
+
+		else if (name == "TurntableFrames")
+		{
+			turntableFrames = std::stoi(value);
+		}
+		else if (name == "CaptureEncoder")
+		{
+			captureEncoder = value;
+		}
+
+		else if (name == "ThumbnailBudget")
+		{
+			thumbnailBudget = std::stof(value);
+		}
 	}
 }
@@ -15,6 +15,18 @@ public:
 	static float backgroundR;
 	static float backgroundG;
 	static float backgroundB;
+
+	// Log level filter, e.g. "info MDG:debug Archive:warning".
+	static std::string logFilter;
+
+	// Frames recorded by the turntable capture.
+	static unsigned int turntableFrames;
+	// Command raw RGBA frames are piped to, PNG sequence if empty.
+	// "{width}" and "{height}" are replaced with the frame size.
+	static std::string captureEncoder;
+
+	// Milliseconds per frame the model browser may spend uploading and rendering thumbnails.
+	static float thumbnailBudget;
 	
 
 	static bool save(const std::string& path);
@@ -1,5 +1,9 @@
 #include "content.h"
 
+#include <chrono>
+
+#include "util/trace.h"
+
 void Content::initialize()
 {
 	createDefaultTexture();
@@ -11,6 +15,157 @@ bool Content::loadRKV(const std::string& path)
 	return archive->load(path);
 }
 
+bool Content::loadModelData(const std::string& name, ModelData& data)
+{
+	if (archive == NULL)
+	{
+		LOG_ERROR(Content, "Failed to load asset because no archive is loaded!");
+		return false;
+	}
+
+	return ModelBuilder::build(*archive, name, data);
+}
+
+Model* Content::createModel(const ModelData& data)
+{
+	TRACE_ZONE_DETAIL("Content::createModel", data.name);
+
+	std::vector<Mesh*> meshes;
+	meshes.reserve(data.meshes.size());
+
+	for (auto& range : data.meshes)
+	{
+		std::vector<Vertex> vertices(data.vertices.begin() + range.vertexOffset, data.vertices.begin() + range.vertexOffset + range.vertexCount);
+		std::vector<unsigned int> indices(data.indices.begin() + range.indexOffset, data.indices.begin() + range.indexOffset + range.indexCount);
+
+		// TY 2 models without MDL3 metadata have no material info.
+		Texture* texture = defaultTexture;
+		if (!range.texture.empty() || !data.isTY2)
+		{
+			texture = load<Texture>(range.texture + ".dds");
+			if (texture == defaultTexture)
+			{
+				LOG_WARNING(Content, "Failed to load texture: '" + range.texture + "' !");
+			}
+		}
+
+		meshes.push_back(new Mesh(vertices, indices, texture));
+	}
+
+	if (meshes.empty())
+	{
+		LOG_WARNING(Content, "No meshes created for model: " + data.name);
+	}
+	else
+	{
+		LOG_INFO(Content, "Successfully created model: " + data.name + " with " + std::to_string(meshes.size()) + " meshes");
+	}
+
+	Model* model = new Model(meshes);
+	model->bounds_crn = data.boundsCorner;
+	model->bounds_size = data.boundsSize;
+
+	model->colliders = data.colliders;
+	model->bounds = data.bounds;
+	model->bones = data.bones;
+
+	model->ranges = data.meshes;
+	model->components = data.components;
+	model->collision = data.collision;
+
+	return model;
+}
+
+Model* Content::addModel(const std::string& name, const ModelData& data)
+{
+	auto it = models.find(name);
+	if (it != models.end())
+		return it->second;
+
+	auto start = std::chrono::high_resolution_clock::now();
+
+	Model* model = createModel(data);
+	model->setup();
+
+	model->loadTimings = data.timings;
+	model->loadBytes = data.getHeapBytes();
+	model->loadTimings.upload = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+
+	models[name] = model;
+	return model;
+}
+
+MemoryUsage Content::getMemoryUsage() const
+{
+	MemoryUsage total;
+	for (auto& it : models)
+	{
+		MemoryUsage usage = it.second->getMemoryUsage();
+		total.cpuRetained += usage.cpuRetained;
+		total.cpuOther += usage.cpuOther;
+		total.cpuTransient = std::max(total.cpuTransient, usage.cpuTransient);
+		total.gpuBuffers += usage.gpuBuffers;
+	}
+
+	for (auto& it : textures)
+	{
+		total.gpuTextures += it.second->getGpuBytes();
+		total.textures++;
+	}
+
+	if (defaultTexture != NULL)
+	{
+		total.gpuTextures += defaultTexture->getGpuBytes();
+		total.textures++;
+	}
+
+	return total;
+}
+
+const Archive* Content::getArchive() const
+{
+	return archive;
+}
+
+bool Content::unloadModel(const std::string& name)
+{
+	auto it = models.find(name);
+	if (it == models.end())
+		return false;
+
+	delete it->second;
+	models.erase(it);
+	return true;
+}
+
+void Content::unloadAll()
+{
+	for (auto& it : models)
+	{
+		delete it.second;
+	}
+	models.clear();
+
+	// Fonts are kept, and so are the textures they draw with.
+	for (auto it = textures.begin(); it != textures.end();)
+	{
+		bool ownedByFont = false;
+		for (auto& font : fonts)
+		{
+			ownedByFont = ownedByFont || font.second->getTexture() == it->second;
+		}
+
+		if (ownedByFont)
+		{
+			++it;
+			continue;
+		}
+
+		delete it->second;
+		it = textures.erase(it);
+	}
+}
+
 void Content::createDefaultTexture()
 {
 	// Gosh darn it, you said this map didn't need cs source!!!
@@ -4,6 +4,7 @@
 #include <fstream>
 #include <iostream>
 #include <cmath>
+#include <chrono>
 
 #include <unordered_map>
 #include <vector>
@@ -22,8 +23,12 @@
 #include "util/font.h"
 #include "model.h"
 
+#include "loader/modelbuilder.h"
+
 #include "util/bitconverter.h"
 #include "util/stringext.h"
+#include "util/trace.h"
+#include "util/allocation.h"
 
 #include "debug.h"
 
@@ -45,21 +50,33 @@ public:
 	void initialize();
 	bool loadRKV(const std::string& path);
 
+	// Specialized for Texture, Shader, Model and Font in content.inl, other types don't link.
 	template<typename T>
-	T* load(const std::string& name)
-	{}
+	T* load(const std::string& name);
+
+	// CPU side of load<Model>, reads and decodes without touching OpenGL.
+	bool loadModelData(const std::string& name, ModelData& data);
+
+	// Builds a Model from decoded data, resolving its textures.
+	// Call setup() on the result before drawing it.
+	Model* createModel(const ModelData& data);
+
+	// GL side of load<Model>, creates, uploads and caches a model decoded elsewhere.
+	// Returns the cached one if 'name' is loaded already.
+	Model* addModel(const std::string& name, const ModelData& data);
 
-	template<>
-	Texture* load<Texture>(const std::string& name);
+	// Deletes a cached model, its textures stay cached since other models may share them.
+	bool unloadModel(const std::string& name);
 
-	template<>
-	Shader* load<Shader>(const std::string& name);
+	// Deletes every cached model and texture, shaders and fonts (with their textures) are kept.
+	void unloadAll();
 
-	template<>
-	Model* load<Model>(const std::string& name);
+	// Totals of every cached model, with each cached texture counted once.
+	// cpuTransient is the largest single load, loads never overlap.
+	MemoryUsage getMemoryUsage() const;
 
-	template<>
-	Font* load<Font>(const std::string& name);
+	// Null until loadRKV() is called. Const, so safe to read from other threads.
+	const Archive* getArchive() const;
 
 private:
 	void createDefaultTexture();
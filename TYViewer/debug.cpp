@@ -1,8 +1,318 @@
 #include "debug.h"
 
-#include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <sstream>
+#include <thread>
+
+// Messages longer than this are truncated.
+#define LOG_MESSAGE_SIZE 256
+// Must be a power of two.
+#define LOG_QUEUE_SIZE 4096
+
+std::atomic<int> Debug::thresholds[static_cast<int>(Debug::Module::Count)] =
+{
+	{ static_cast<int>(LOG_DEBUG_COMPILED ? Debug::Level::Debug : Debug::Level::Info) },
+	{ static_cast<int>(LOG_DEBUG_COMPILED ? Debug::Level::Debug : Debug::Level::Info) },
+	{ static_cast<int>(LOG_DEBUG_COMPILED ? Debug::Level::Debug : Debug::Level::Info) },
+	{ static_cast<int>(LOG_DEBUG_COMPILED ? Debug::Level::Debug : Debug::Level::Info) },
+	{ static_cast<int>(LOG_DEBUG_COMPILED ? Debug::Level::Debug : Debug::Level::Info) },
+	{ static_cast<int>(LOG_DEBUG_COMPILED ? Debug::Level::Debug : Debug::Level::Info) },
+	{ static_cast<int>(LOG_DEBUG_COMPILED ? Debug::Level::Debug : Debug::Level::Info) }
+};
+
+static const char* levelNames[] = { "debug", "info", "warning", "error", "none" };
+static const char* moduleNames[] = { "General", "Archive", "Content", "MDL", "MDG", "Render", "Server" };
+
+// Bounded multi-producer queue (Vyukov style) drained by one writer thread.
+// Producers never take a lock, they only claim a slot with a CAS on the tail.
+class LogQueue
+{
+public:
+	LogQueue() :
+		head(0),
+		tail(0),
+		dropped(0),
+		running(false)
+	{
+		for (size_t i = 0; i < LOG_QUEUE_SIZE; i++)
+		{
+			slots[i].sequence.store(i, std::memory_order_relaxed);
+		}
+	}
+
+	~LogQueue()
+	{
+		stop();
+	}
+
+	void push(Debug::Level level, Debug::Module module, const std::string& message)
+	{
+		start();
+
+		size_t position = tail.load(std::memory_order_relaxed);
+		Slot* slot = nullptr;
+
+		for (;;)
+		{
+			slot = &slots[position & (LOG_QUEUE_SIZE - 1)];
+			size_t sequence = slot->sequence.load(std::memory_order_acquire);
+			intptr_t difference = (intptr_t)sequence - (intptr_t)position;
+
+			if (difference == 0)
+			{
+				if (tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+					break;
+			}
+			else if (difference < 0)
+			{
+				// Full. Debug spam is dropped, anything more important waits for the writer.
+				if (level == Debug::Level::Debug)
+				{
+					dropped.fetch_add(1, std::memory_order_relaxed);
+					return;
+				}
+				wake.notify_one();
+				std::this_thread::yield();
+				position = tail.load(std::memory_order_relaxed);
+			}
+			else
+			{
+				position = tail.load(std::memory_order_relaxed);
+			}
+		}
+
+		slot->level = level;
+		slot->module = module;
+		slot->length = static_cast<uint16_t>(std::min(message.size(), (size_t)LOG_MESSAGE_SIZE));
+		memcpy(slot->text, message.data(), slot->length);
+
+		slot->sequence.store(position + 1, std::memory_order_release);
+
+		if (level >= Debug::Level::Warning || position - head.load(std::memory_order_relaxed) > LOG_QUEUE_SIZE / 2)
+		{
+			wake.notify_one();
+		}
+	}
+
+	void flush()
+	{
+		if (!running.load(std::memory_order_acquire))
+			return;
+
+		size_t target = tail.load(std::memory_order_acquire);
+		while (head.load(std::memory_order_acquire) < target)
+		{
+			wake.notify_one();
+			std::this_thread::yield();
+		}
+		fflush(stdout);
+	}
+
+	void stop()
+	{
+		std::lock_guard<std::mutex> guard(lifetime);
+		if (!running.load(std::memory_order_acquire))
+			return;
+
+		running.store(false, std::memory_order_release);
+		wake.notify_one();
+		writer.join();
+	}
+
+private:
+	struct Slot
+	{
+		std::atomic<size_t> sequence;
+		Debug::Level level;
+		Debug::Module module;
+		uint16_t length;
+		char text[LOG_MESSAGE_SIZE];
+	};
+
+	void start()
+	{
+		if (running.load(std::memory_order_acquire))
+			return;
+
+		std::lock_guard<std::mutex> guard(lifetime);
+		if (running.load(std::memory_order_relaxed))
+			return;
+
+		running.store(true, std::memory_order_release);
+		writer = std::thread(&LogQueue::drain, this);
+	}
+
+	bool pop(std::string& line)
+	{
+		size_t position = head.load(std::memory_order_relaxed);
+		Slot& slot = slots[position & (LOG_QUEUE_SIZE - 1)];
+
+		if (slot.sequence.load(std::memory_order_acquire) != position + 1)
+			return false;
+
+		line.clear();
+		if (slot.level != Debug::Level::Info)
+		{
+			line += '[';
+			line += levelNames[static_cast<int>(slot.level)];
+			line += "] ";
+		}
+		if (slot.module != Debug::Module::General)
+		{
+			line += '[';
+			line += moduleNames[static_cast<int>(slot.module)];
+			line += "] ";
+		}
+		line.append(slot.text, slot.length);
+		line += '\n';
+
+		slot.sequence.store(position + LOG_QUEUE_SIZE, std::memory_order_release);
+		head.store(position + 1, std::memory_order_release);
+		return true;
+	}
+
+	void drain()
+	{
+		std::string line;
+		line.reserve(LOG_MESSAGE_SIZE + 32);
+
+		for (;;)
+		{
+			bool wrote = false;
+			while (pop(line))
+			{
+				fwrite(line.data(), 1, line.size(), stdout);
+				wrote = true;
+			}
+
+			size_t lost = dropped.exchange(0, std::memory_order_relaxed);
+			if (lost > 0)
+			{
+				fprintf(stdout, "[warning] %zu log messages dropped (queue full)\n", lost);
+				wrote = true;
+			}
+
+			if (wrote)
+			{
+				fflush(stdout);
+			}
+
+			if (!running.load(std::memory_order_acquire) && head.load(std::memory_order_relaxed) == tail.load(std::memory_order_acquire))
+				break;
+
+			// Producers only signal for warnings and errors, otherwise poll.
+			std::unique_lock<std::mutex> lock(sleep);
+			wake.wait_for(lock, std::chrono::milliseconds(10));
+		}
+	}
+
+	Slot slots[LOG_QUEUE_SIZE];
+
+	alignas(64) std::atomic<size_t> head;
+	alignas(64) std::atomic<size_t> tail;
+	std::atomic<size_t> dropped;
+
+	std::atomic<bool> running;
+	std::thread writer;
+	std::mutex lifetime;
+
+	std::mutex sleep;
+	std::condition_variable wake;
+};
+
+static LogQueue& queue()
+{
+	static LogQueue instance;
+	return instance;
+}
 
 void Debug::log(const std::string& message)
 {
-	std::cout << message << std::endl;
+	log(Level::Info, Module::General, message);
+}
+
+void Debug::log(Level level, Module module, const std::string& message)
+{
+	if (!isEnabled(level, module))
+		return;
+
+	queue().push(level, module, message);
+}
+
+void Debug::setLevel(Level level)
+{
+	for (auto& threshold : thresholds)
+	{
+		threshold.store(static_cast<int>(level), std::memory_order_relaxed);
+	}
+}
+
+void Debug::setLevel(Module module, Level level)
+{
+	thresholds[static_cast<int>(module)].store(static_cast<int>(level), std::memory_order_relaxed);
+}
+
+void Debug::setFilter(const std::string& filter)
+{
+	std::istringstream iss(filter);
+	std::string entry;
+	while (iss >> entry)
+	{
+		size_t cutoff = entry.find_first_of(':');
+
+		Level level;
+		if (cutoff == std::string::npos)
+		{
+			if (parseLevel(entry, level))
+				setLevel(level);
+			continue;
+		}
+
+		Module module;
+		if (parseModule(entry.substr(0, cutoff), module) && parseLevel(entry.substr(cutoff + 1), level))
+		{
+			setLevel(module, level);
+		}
+	}
+}
+
+bool Debug::parseLevel(const std::string& name, Level& level)
+{
+	for (int i = 0; i <= static_cast<int>(Level::None); i++)
+	{
+		if (name == levelNames[i])
+		{
+			level = static_cast<Level>(i);
+			return true;
+		}
+	}
+	return false;
+}
+
+bool Debug::parseModule(const std::string& name, Module& module)
+{
+	for (int i = 0; i < static_cast<int>(Module::Count); i++)
+	{
+		if (name == moduleNames[i])
+		{
+			module = static_cast<Module>(i);
+			return true;
+		}
+	}
+	return false;
+}
+
+void Debug::flush()
+{
+	queue().flush();
+}
+
+void Debug::shutdown()
+{
+	queue().stop();
 }
@@ -1,9 +1,84 @@
 #pragma once
 
+#include <atomic>
 #include <string>
 
+// Debug level messages only exist in debug builds.
+// In release builds LOG_DEBUG expands to nothing, so its arguments are never evaluated.
+#ifdef _DEBUG
+#define LOG_DEBUG_COMPILED 1
+#else
+#define LOG_DEBUG_COMPILED 0
+#endif
+
 class Debug
 {
 public:
+	enum class Level
+	{
+		Debug,
+		Info,
+		Warning,
+		Error,
+		None
+	};
+
+	enum class Module
+	{
+		General,
+		Archive,
+		Content,
+		MDL,
+		MDG,
+		Render,
+		Server,
+
+		Count
+	};
+
+	// Kept for general purpose messages, same as LOG_INFO(General, ...).
 	static void log(const std::string& message);
-};
\ No newline at end of file
+	static void log(Level level, Module module, const std::string& message);
+
+	static inline bool isEnabled(Level level, Module module)
+	{
+		return static_cast<int>(level) >= thresholds[static_cast<int>(module)].load(std::memory_order_relaxed);
+	}
+
+	static void setLevel(Level level);
+	static void setLevel(Module module, Level level);
+
+	// Applies filters in the form "MDG:debug Content:warning".
+	static void setFilter(const std::string& filter);
+
+	static bool parseLevel(const std::string& name, Level& level);
+	static bool parseModule(const std::string& name, Module& module);
+
+	// Blocks until every queued message has been written.
+	static void flush();
+	static void shutdown();
+
+private:
+	static std::atomic<int> thresholds[static_cast<int>(Module::Count)];
+};
+
+// Message expressions are only evaluated when the level/module is enabled,
+// so string building costs nothing for filtered messages.
+#define LOG(level, module, message) \
+	do \
+	{ \
+		if (Debug::isEnabled(Debug::Level::level, Debug::Module::module)) \
+			Debug::log(Debug::Level::level, Debug::Module::module, message); \
+	} while (0)
+
+#if LOG_DEBUG_COMPILED
+#define LOG_DEBUG(module, message) LOG(Debug, module, message)
+#define LOG_DEBUG_ENABLED(module) Debug::isEnabled(Debug::Level::Debug, Debug::Module::module)
+#else
+#define LOG_DEBUG(module, message) do {} while (0)
+#define LOG_DEBUG_ENABLED(module) false
+#endif
+
+#define LOG_INFO(module, message) LOG(Info, module, message)
+#define LOG_WARNING(module, message) LOG(Warning, module, message)
+#define LOG_ERROR(module, message) LOG(Error, module, message)
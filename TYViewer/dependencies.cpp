@@ -0,0 +1,160 @@
+#include "dependencies.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+
+#include "config.h"
+#include "debug.h"
+
+#define DEPENDENCY_SHARED_TEXTURES 10
+
+bool Dependencies::isRequested(int argc, char* argv[])
+{
+	for (int i = 1; i < argc; i++)
+	{
+		if (std::string(argv[i]) == "--deps")
+			return true;
+	}
+	return false;
+}
+
+bool Dependencies::parseArguments(int argc, char* argv[], DependencyOptions& options)
+{
+	for (int i = 1; i < argc; i++)
+	{
+		std::string argument = argv[i];
+		bool hasValue = i + 1 < argc;
+
+		if (argument == "--deps")
+		{
+			// The mode itself, takes no value.
+		}
+		else if (argument == "--trace" && hasValue)
+		{
+			// Handled before the index is built.
+			i++;
+		}
+		else if (argument == "--archive" && hasValue)
+		{
+			options.archive = argv[++i];
+		}
+		else if (argument == "--model" && hasValue)
+		{
+			options.model = argv[++i];
+		}
+		else if (argument == "--texture" && hasValue)
+		{
+			options.texture = argv[++i];
+		}
+		else if (argument == "--missing")
+		{
+			options.missing = true;
+		}
+		else if (argument == "--rebuild")
+		{
+			options.rebuild = true;
+		}
+		else if (argument == "--threads" && hasValue)
+		{
+			int threads = std::atoi(argv[++i]);
+			if (threads <= 0)
+				return false;
+			options.threads = static_cast<unsigned int>(threads);
+		}
+		else
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void Dependencies::printUsage()
+{
+	std::cout <<
+		"Usage: TYViewer --deps [options]" << std::endl <<
+		"  --archive <path>     Archive to index (default: config.cfg)" << std::endl <<
+		"  --model <name>       List the textures a model uses" << std::endl <<
+		"  --texture <name>     List the models using a texture" << std::endl <<
+		"  --missing            List textures models use that the archive lacks" << std::endl <<
+		"  --rebuild            Scan every model instead of reusing <archive>.deps" << std::endl <<
+		"  --threads <n>        Scanning threads (default: one per core)" << std::endl <<
+		"  --trace <file>       Record a Chrome trace of the run" << std::endl;
+}
+
+Dependencies::Dependencies(const DependencyOptions& options) :
+	options(options)
+{}
+
+int Dependencies::run()
+{
+	std::string path = options.archive.empty() ? Config::archive : options.archive;
+	if (path.empty())
+	{
+		LOG_ERROR(General, "No archive specified, use --archive or config.cfg");
+		return -1;
+	}
+
+	if (!archive.load(path))
+	{
+		LOG_ERROR(General, "Failed to load archive: " + path);
+		return -1;
+	}
+
+	std::string indexPath = DependencyIndex::getPath(path);
+	if (!options.rebuild)
+		index.load(indexPath);
+
+	// Broken models are counted in the summary, a warning each would bury it.
+	Debug::setLevel(Debug::Level::Error);
+	index.build(archive, options.threads);
+
+	// Nothing to save when every model was reused.
+	if (index.isModified() && !index.save(indexPath))
+		LOG_WARNING(General, "Failed to save dependency index: " + indexPath);
+
+	if (!options.model.empty())
+	{
+		for (auto& texture : index.getTextures(options.model))
+			std::cout << texture << std::endl;
+	}
+
+	if (!options.texture.empty())
+	{
+		for (auto& model : index.getModels(options.texture))
+			std::cout << model << std::endl;
+	}
+
+	if (options.missing)
+	{
+		for (auto& texture : index.getMissingTextures())
+			std::cout << texture << std::endl;
+	}
+
+	if (options.model.empty() && options.texture.empty() && !options.missing)
+		printSummary();
+
+	return 0;
+}
+
+void Dependencies::printSummary()
+{
+	const DependencyStats& stats = index.getStats();
+
+	printf("%zu models, %zu textures (%zu missing from the archive)\n",
+		index.getModelCount(), index.getTextureCount(), index.getMissingTextures().size());
+	printf("Scanned %zu models, reused %zu, %zu could not be read, in %.1f ms\n",
+		stats.scanned, stats.reused, stats.failed, stats.milliseconds);
+
+	auto shared = index.getSharedTextures(DEPENDENCY_SHARED_TEXTURES);
+	if (shared.empty())
+		return;
+
+	printf("Most shared textures:\n");
+	for (auto& texture : shared)
+	{
+		printf("  %5zu  %s\n", texture.second, texture.first.c_str());
+	}
+}
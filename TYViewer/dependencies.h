@@ -0,0 +1,47 @@
+#pragma once
+
+#include <string>
+
+#include "loader/archive.h"
+#include "loader/dependencyindex.h"
+
+struct DependencyOptions
+{
+	std::string archive;
+
+	// Textures this model uses.
+	std::string model;
+	// Models using this texture.
+	std::string texture;
+
+	bool missing = false;
+
+	// Scans every model again instead of reusing the saved index.
+	bool rebuild = false;
+
+	// Scanning threads, 0 uses every core.
+	unsigned int threads = 0;
+};
+
+// Answers which textures a model uses and which models a texture affects, from the
+// DependencyIndex saved next to the archive. Models changed since it was saved are rescanned.
+// Usage: TYViewer --deps [options]
+class Dependencies
+{
+public:
+	static bool isRequested(int argc, char* argv[]);
+	static bool parseArguments(int argc, char* argv[], DependencyOptions& options);
+	static void printUsage();
+
+	Dependencies(const DependencyOptions& options);
+
+	int run();
+
+private:
+	void printSummary();
+
+	DependencyOptions options;
+
+	Archive archive;
+	DependencyIndex index;
+};
@@ -0,0 +1,328 @@
+#include "exporter.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <future>
+#include <iostream>
+#include <algorithm>
+#include <filesystem>
+
+#include <SOIL2/SOIL2.h>
+
+#include "exporter/gltf.h"
+#include "exporter/obj.h"
+
+#include "loader/modelbuilder.h"
+
+#include "util/trace.h"
+
+#include "config.h"
+#include "debug.h"
+#include "util/timing.h"
+#include "util/stringext.h"
+
+#define EXPORT_TEXTURE_DIRECTORY "textures"
+
+static std::string removeExtension(const std::string& name)
+{
+	return name.substr(0, name.find_last_of('.'));
+}
+
+bool BatchExporter::isRequested(int argc, char* argv[])
+{
+	for (int i = 1; i < argc; i++)
+	{
+		if (std::string(argv[i]) == "--export")
+			return true;
+	}
+	return false;
+}
+
+bool BatchExporter::parseArguments(int argc, char* argv[], ExportOptions& options)
+{
+	for (int i = 1; i < argc; i++)
+	{
+		std::string argument = argv[i];
+		bool hasValue = i + 1 < argc;
+
+		if (argument == "--export" && hasValue)
+		{
+			options.output = argv[++i];
+		}
+		else if (argument == "--trace" && hasValue)
+		{
+			// Handled before the export starts.
+			i++;
+		}
+		else if (argument == "--models" && hasValue)
+		{
+			splitList(argv[++i], options.models);
+		}
+		else if (argument == "--archive" && hasValue)
+		{
+			options.archive = argv[++i];
+		}
+		else if (argument == "--filter" && hasValue)
+		{
+			options.filter = argv[++i];
+		}
+		else if (argument == "--format" && hasValue)
+		{
+			std::string format = argv[++i];
+			if (format != "gltf" && format != "obj" && format != "both")
+				return false;
+
+			options.gltf = format != "obj";
+			options.obj = format != "gltf";
+		}
+		else if (argument == "--threads" && hasValue)
+		{
+			int threads = std::atoi(argv[++i]);
+			if (threads <= 0)
+				return false;
+			options.threads = static_cast<unsigned int>(threads);
+		}
+		else if (argument == "--no-textures")
+		{
+			options.textures = false;
+		}
+		else
+		{
+			return false;
+		}
+	}
+
+	return !options.output.empty();
+}
+
+void BatchExporter::printUsage()
+{
+	std::cout <<
+		"Usage: TYViewer --export <directory> [options]" << std::endl <<
+		"  --models <a,b,...>   Models to export (default: every model in the archive)" << std::endl <<
+		"  --archive <path>     Archive to export from (default: config.cfg)" << std::endl <<
+		"  --filter <text>      Only export models whose name contains <text>" << std::endl <<
+		"  --format <format>    gltf, obj or both (default: gltf)" << std::endl <<
+		"  --threads <n>        Worker threads (default: one per core)" << std::endl <<
+		"  --no-textures        Export geometry only" << std::endl <<
+		"  --trace <file>       Record a Chrome trace of the export" << std::endl;
+}
+
+BatchExporter::BatchExporter(const ExportOptions& options) :
+	options(options),
+	threads(options.threads),
+	convertedTextures(0)
+{}
+
+int BatchExporter::run()
+{
+	if (options.archive.empty())
+		options.archive = Config::archive;
+
+	if (options.archive.empty())
+	{
+		LOG_ERROR(General, "No archive specified, use --archive or config.cfg");
+		return -1;
+	}
+
+	if (!archive.load(options.archive))
+	{
+		LOG_ERROR(General, "Failed to load archive: " + options.archive);
+		return -1;
+	}
+
+	std::vector<std::string> names = ModelBatch::getModelNames(archive, options.models, options.filter);
+
+	if (names.empty())
+	{
+		LOG_ERROR(General, "No models to export from " + options.archive);
+		return -1;
+	}
+
+	std::error_code error;
+	std::filesystem::create_directories(std::filesystem::path(options.output) / EXPORT_TEXTURE_DIRECTORY, error);
+	if (error)
+	{
+		LOG_ERROR(General, "Failed to create output directory: " + options.output);
+		return -1;
+	}
+
+	// Failures end up in the summary with their reason.
+	Debug::setLevel(Debug::Level::Error);
+
+	threads = ModelBatch::getThreadCount(options.threads, names.size());
+
+	printf("Exporting %zu models from %s to %s on %u threads\n", names.size(), options.archive.c_str(), options.output.c_str(), threads);
+	fflush(stdout);
+
+	std::vector<ExportResult> results(names.size());
+	double wall = ModelBatch::parallelFor(names.size(), threads, "Export", [&](size_t i)
+	{
+		exportModel(names[i], results[i]);
+	});
+
+	print(results, wall);
+
+	return ModelBatch::countFailed(results) > 0 ? 1 : 0;
+}
+
+void BatchExporter::exportModel(const std::string& name, ExportResult& result)
+{
+	TRACE_ZONE_DETAIL("BatchExporter::exportModel", name);
+
+	result.name = name;
+
+	auto start = std::chrono::high_resolution_clock::now();
+
+	ModelBatch::guard(result, [&]()
+	{
+		ModelData model;
+		if (!ModelBuilder::build(archive, name, model))
+		{
+			result.reason = model.error.empty() ? "build failed" : model.error;
+			return;
+		}
+
+		if (!ModelBuilder::validate(model, result.reason))
+			return;
+
+		result.vertices = model.vertices.size();
+		result.triangles = model.indices.size() / 3;
+
+		if (result.triangles == 0)
+		{
+			result.status = BatchStatus::Empty;
+			return;
+		}
+
+		std::vector<std::string> textures(model.meshes.size());
+		if (options.textures)
+		{
+			for (size_t i = 0; i < model.meshes.size(); i++)
+			{
+				if (!model.meshes[i].texture.empty())
+					textures[i] = getTexture(model.meshes[i].texture, result.bytes);
+			}
+		}
+
+		std::string path = (std::filesystem::path(options.output) / removeExtension(name)).string();
+		size_t bytes = 0;
+
+		if (options.gltf)
+		{
+			if (!GltfExporter::write(model, textures, path, bytes))
+			{
+				result.reason = "failed to write " + path + ".gltf";
+				return;
+			}
+			result.bytes += bytes;
+		}
+
+		if (options.obj)
+		{
+			if (!ObjExporter::write(model, textures, path, bytes))
+			{
+				result.reason = "failed to write " + path + ".obj";
+				return;
+			}
+			result.bytes += bytes;
+		}
+
+		result.status = BatchStatus::Ok;
+	});
+
+	result.milliseconds = millisecondsSince(start);
+}
+
+std::string BatchExporter::getTexture(const std::string& texture, size_t& bytes)
+{
+	File file;
+	if (!archive.getFile(texture + ".dds", file))
+		return std::string();
+
+	std::promise<bool> conversion;
+	std::shared_future<bool> converted;
+	bool claimed = false;
+
+	{
+		std::lock_guard<std::mutex> lock(textureMutex);
+		auto it = textureConversions.find(texture);
+		if (it == textureConversions.end())
+		{
+			converted = conversion.get_future().share();
+			textureConversions.emplace(texture, converted);
+			claimed = true;
+		}
+		else
+		{
+			converted = it->second;
+		}
+	}
+
+	std::string relative = std::string(EXPORT_TEXTURE_DIRECTORY) + "/" + texture + ".png";
+
+	// Converted outside the lock, models referencing it meanwhile wait for the result.
+	if (claimed)
+	{
+		bool saved = convertTexture(texture, (std::filesystem::path(options.output) / relative).string(), bytes);
+		if (saved)
+			convertedTextures++;
+		else
+			LOG_ERROR(Content, "Failed to export texture: '" + texture + "' !");
+
+		conversion.set_value(saved);
+	}
+
+	return converted.get() ? relative : std::string();
+}
+
+bool BatchExporter::convertTexture(const std::string& texture, const std::string& path, size_t& bytes) const
+{
+	TRACE_ZONE_DETAIL("BatchExporter::convertTexture", texture);
+
+	std::vector<char> data;
+	if (!archive.getFileData(texture + ".dds", data) || data.empty())
+		return false;
+
+	int width = 0;
+	int height = 0;
+	int channels = 0;
+	unsigned char* pixels = SOIL_load_image_from_memory(reinterpret_cast<unsigned char*>(data.data()), static_cast<int>(data.size()), &width, &height, &channels, SOIL_LOAD_RGBA);
+	if (pixels == nullptr)
+		return false;
+
+	bool saved = SOIL_save_image(path.c_str(), SOIL_SAVE_TYPE_PNG, width, height, 4, pixels) != 0;
+	SOIL_free_image_data(pixels);
+
+	if (saved)
+	{
+		std::error_code error;
+		uintmax_t size = std::filesystem::file_size(path, error);
+		if (!error)
+			bytes += static_cast<size_t>(size);
+	}
+
+	return saved;
+}
+
+void BatchExporter::print(const std::vector<ExportResult>& results, double wallMilliseconds) const
+{
+	double cpu = 0.0;
+	size_t triangles = 0;
+	size_t bytes = 0;
+
+	for (auto& result : results)
+	{
+		cpu += result.milliseconds;
+		triangles += result.triangles;
+		bytes += result.bytes;
+	}
+
+	ModelBatch::printResults(results);
+	printf("%zu triangles, %zu textures, %.1f MB written\n", triangles, convertedTextures.load(), bytes / (1024.0 * 1024.0));
+	ModelBatch::printTiming(wallMilliseconds, cpu, threads);
+	fflush(stdout);
+}
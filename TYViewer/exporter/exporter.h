@@ -0,0 +1,79 @@
+#pragma once
+
+#include <atomic>
+#include <mutex>
+#include <future>
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+#include "loader/archive.h"
+#include "loader/modeldata.h"
+#include "loader/modelbatch.h"
+
+struct ExportOptions
+{
+	std::string output;
+
+	// Every .mdl in the archive if empty.
+	std::vector<std::string> models;
+
+	std::string archive;
+
+	// Only models whose name contains this.
+	std::string filter;
+
+	bool gltf = true;
+	bool obj = false;
+
+	// Geometry only, no materials and no converted textures.
+	bool textures = true;
+
+	// 0 uses every core.
+	unsigned int threads = 0;
+};
+
+struct ExportResult : BatchResult
+{
+	size_t vertices = 0;
+	size_t triangles = 0;
+
+	// Written for this model, shared textures count towards the model that converted them.
+	size_t bytes = 0;
+
+	double milliseconds = 0.0;
+};
+
+// Converts models of an archive to glTF 2.0 and/or OBJ, one model per worker thread.
+// Textures are converted to PNG once into '<output>/textures' and referenced by every model using them.
+// Usage: TYViewer --export <directory> [options]
+class BatchExporter
+{
+public:
+	static bool isRequested(int argc, char* argv[]);
+	static bool parseArguments(int argc, char* argv[], ExportOptions& options);
+	static void printUsage();
+
+	BatchExporter(const ExportOptions& options);
+
+	int run();
+
+private:
+	void exportModel(const std::string& name, ExportResult& result);
+
+	// Path of the PNG relative to the output directory, empty if the archive doesn't have the texture or it failed to convert.
+	std::string getTexture(const std::string& texture, size_t& bytes);
+	bool convertTexture(const std::string& texture, const std::string& path, size_t& bytes) const;
+
+	void print(const std::vector<ExportResult>& results, double wallMilliseconds) const;
+
+	ExportOptions options;
+
+	Archive archive;
+	unsigned int threads;
+
+	// Whether each texture converted, the first model to use a texture converts it.
+	std::unordered_map<std::string, std::shared_future<bool>> textureConversions;
+	std::mutex textureMutex;
+	std::atomic<size_t> convertedTextures;
+};
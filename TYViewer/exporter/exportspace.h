@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cmath>
+#include <algorithm>
+
+#include "graphics/vertex.h"
+
+// The viewer displays models left-handed by flipping z, glTF and OBJ are right-handed.
+// Flipping z mirrors the model, so triangles swap their second and third index to keep their facing.
+
+inline void toExportPosition(const Vertex& vertex, float out[3])
+{
+	out[0] = vertex.position.x;
+	out[1] = vertex.position.y;
+	out[2] = -vertex.position.z;
+}
+
+// Unit length as glTF requires, up for vertices without a normal.
+inline void toExportNormal(const Vertex& vertex, float out[3])
+{
+	float x = vertex.normal.x;
+	float y = vertex.normal.y;
+	float z = -vertex.normal.z;
+
+	float length = std::sqrt(x * x + y * y + z * z);
+	if (!(length > 0.000001f))
+	{
+		out[0] = 0.0f;
+		out[1] = 1.0f;
+		out[2] = 0.0f;
+		return;
+	}
+
+	out[0] = x / length;
+	out[1] = y / length;
+	out[2] = z / length;
+}
+
+inline float toExportColour(float channel)
+{
+	return std::min(std::max(channel, 0.0f), 1.0f);
+}
@@ -0,0 +1,248 @@
+#include "gltf.h"
+
+#include <cfloat>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+
+#include "exporter/exportspace.h"
+
+#include "util/json.h"
+#include "util/stringext.h"
+#include "util/textwriter.h"
+
+#define GLTF_ARRAY_BUFFER 34962
+#define GLTF_ELEMENT_ARRAY_BUFFER 34963
+
+#define GLTF_FLOAT 5126
+#define GLTF_UNSIGNED_INT 5125
+
+// Attributes are stored one after another, not interleaved, so every bufferView is tightly packed.
+enum GltfView
+{
+	GLTF_VIEW_POSITION,
+	GLTF_VIEW_NORMAL,
+	GLTF_VIEW_TEXCOORD,
+	GLTF_VIEW_COLOUR,
+	GLTF_VIEW_INDICES,
+	GLTF_VIEW_COUNT
+};
+
+static const size_t viewElementSize[GLTF_VIEW_COUNT] = { 12, 12, 8, 16, 4 };
+
+static void append(std::vector<char>& buffer, const float* values, size_t count)
+{
+	size_t offset = buffer.size();
+	buffer.resize(offset + count * sizeof(float));
+	std::memcpy(&buffer[offset], values, count * sizeof(float));
+}
+
+bool GltfExporter::write(const ModelData& model, const std::vector<std::string>& textures, const std::string& path, size_t& bytes)
+{
+	bytes = 0;
+
+	std::vector<size_t> primitives;
+	for (size_t i = 0; i < model.meshes.size(); i++)
+	{
+		if (model.meshes[i].indexCount > 0 && model.meshes[i].vertexCount > 0)
+			primitives.push_back(i);
+	}
+
+	// A mesh needs at least one primitive and buffer views can't be empty.
+	if (primitives.empty())
+		return false;
+
+	size_t vertexCount = model.vertices.size();
+	size_t indexCount = model.indices.size();
+
+	size_t viewOffset[GLTF_VIEW_COUNT];
+	size_t viewLength[GLTF_VIEW_COUNT];
+	size_t offset = 0;
+	for (int view = 0; view < GLTF_VIEW_COUNT; view++)
+	{
+		viewOffset[view] = offset;
+		viewLength[view] = (view == GLTF_VIEW_INDICES ? indexCount : vertexCount) * viewElementSize[view];
+		offset += viewLength[view];
+	}
+
+	std::vector<char> buffer;
+	buffer.reserve(offset);
+
+	float values[4];
+	for (auto& vertex : model.vertices)
+	{
+		toExportPosition(vertex, values);
+		append(buffer, values, 3);
+	}
+	for (auto& vertex : model.vertices)
+	{
+		toExportNormal(vertex, values);
+		append(buffer, values, 3);
+	}
+	for (auto& vertex : model.vertices)
+	{
+		// glTF puts the texture origin at the top left, the viewer loads textures flipped with the origin at the bottom left.
+		values[0] = vertex.texcoord.x;
+		values[1] = 1.0f - vertex.texcoord.y;
+		append(buffer, values, 2);
+	}
+	for (auto& vertex : model.vertices)
+	{
+		values[0] = toExportColour(vertex.colour.x);
+		values[1] = toExportColour(vertex.colour.y);
+		values[2] = toExportColour(vertex.colour.z);
+		values[3] = toExportColour(vertex.colour.w);
+		append(buffer, values, 4);
+	}
+
+	size_t indicesOffset = buffer.size();
+	buffer.resize(indicesOffset + indexCount * sizeof(uint32_t));
+	uint32_t* indices = reinterpret_cast<uint32_t*>(&buffer[indicesOffset]);
+	for (size_t i = 0; i + 2 < indexCount; i += 3)
+	{
+		indices[i] = model.indices[i];
+		indices[i + 1] = model.indices[i + 2];
+		indices[i + 2] = model.indices[i + 1];
+	}
+
+	std::string binName = getFileName(path) + ".bin";
+
+	TextWriter bin;
+	if (!bin.open(path + ".bin"))
+		return false;
+	bin.write(buffer.data(), buffer.size());
+	if (!bin.close())
+		return false;
+
+	// Every distinct texture becomes an image, a texture and a material.
+	std::vector<std::string> images;
+	std::vector<int> materials(model.meshes.size(), -1);
+	for (size_t i = 0; i < model.meshes.size() && i < textures.size(); i++)
+	{
+		if (textures[i].empty())
+			continue;
+
+		auto it = std::find(images.begin(), images.end(), textures[i]);
+		materials[i] = static_cast<int>(it - images.begin());
+		if (it == images.end())
+			images.push_back(textures[i]);
+	}
+
+	TextWriter json;
+	if (!json.open(path + ".gltf"))
+		return false;
+
+	json << "{\n";
+	json << "\t\"asset\": { \"version\": \"2.0\", \"generator\": \"TYViewer\" },\n";
+	json << "\t\"scene\": 0,\n";
+	json << "\t\"scenes\": [ { \"nodes\": [ 0 ] } ],\n";
+
+	json << "\t\"nodes\": [ { \"name\": \"" << Json::escape(model.name) << "\", \"mesh\": 0 } ],\n";
+
+	json << "\t\"buffers\": [ { \"uri\": \"" << Json::escape(binName) << "\", \"byteLength\": " << buffer.size() << " } ],\n";
+
+	json << "\t\"bufferViews\": [\n";
+	for (int view = 0; view < GLTF_VIEW_COUNT; view++)
+	{
+		json << "\t\t{ \"buffer\": 0, \"byteOffset\": " << viewOffset[view] << ", \"byteLength\": " << viewLength[view];
+		json << ", \"target\": " << (view == GLTF_VIEW_INDICES ? GLTF_ELEMENT_ARRAY_BUFFER : GLTF_ARRAY_BUFFER) << " }";
+		json << (view + 1 < GLTF_VIEW_COUNT ? ",\n" : "\n");
+	}
+	json << "\t],\n";
+
+	// Five accessors per primitive: position, normal, texcoord, colour and indices.
+	json << "\t\"accessors\": [\n";
+	for (size_t p = 0; p < primitives.size(); p++)
+	{
+		const MeshRange& range = model.meshes[primitives[p]];
+
+		float min[3] = { FLT_MAX, FLT_MAX, FLT_MAX };
+		float max[3] = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+		for (size_t v = range.vertexOffset; v < range.vertexOffset + range.vertexCount; v++)
+		{
+			toExportPosition(model.vertices[v], values);
+			for (int axis = 0; axis < 3; axis++)
+			{
+				min[axis] = std::min(min[axis], values[axis]);
+				max[axis] = std::max(max[axis], values[axis]);
+			}
+		}
+
+		const char* types[GLTF_VIEW_COUNT] = { "VEC3", "VEC3", "VEC2", "VEC4", "SCALAR" };
+		for (int view = 0; view < GLTF_VIEW_COUNT; view++)
+		{
+			bool isIndices = view == GLTF_VIEW_INDICES;
+			size_t first = isIndices ? range.indexOffset : range.vertexOffset;
+			size_t count = isIndices ? range.indexCount : range.vertexCount;
+
+			json << "\t\t{ \"bufferView\": " << view << ", \"byteOffset\": " << first * viewElementSize[view];
+			json << ", \"componentType\": " << (isIndices ? GLTF_UNSIGNED_INT : GLTF_FLOAT);
+			json << ", \"count\": " << count << ", \"type\": \"" << types[view] << "\"";
+
+			if (view == GLTF_VIEW_POSITION)
+			{
+				json << ", \"min\": [ " << min[0] << ", " << min[1] << ", " << min[2] << " ]";
+				json << ", \"max\": [ " << max[0] << ", " << max[1] << ", " << max[2] << " ]";
+			}
+
+			json << " }" << (p + 1 < primitives.size() || view + 1 < GLTF_VIEW_COUNT ? ",\n" : "\n");
+		}
+	}
+	json << "\t],\n";
+
+	json << "\t\"meshes\": [ { \"name\": \"" << Json::escape(model.name) << "\", \"primitives\": [\n";
+	for (size_t p = 0; p < primitives.size(); p++)
+	{
+		size_t accessor = p * GLTF_VIEW_COUNT;
+
+		json << "\t\t{ \"attributes\": { \"POSITION\": " << accessor + GLTF_VIEW_POSITION;
+		json << ", \"NORMAL\": " << accessor + GLTF_VIEW_NORMAL;
+		json << ", \"TEXCOORD_0\": " << accessor + GLTF_VIEW_TEXCOORD;
+		json << ", \"COLOR_0\": " << accessor + GLTF_VIEW_COLOUR << " }";
+		json << ", \"indices\": " << accessor + GLTF_VIEW_INDICES;
+		if (materials[primitives[p]] >= 0)
+			json << ", \"material\": " << materials[primitives[p]];
+		json << " }" << (p + 1 < primitives.size() ? ",\n" : "\n");
+	}
+	json << "\t] } ]";
+
+	if (!images.empty())
+	{
+		json << ",\n\t\"samplers\": [ { \"wrapS\": 10497, \"wrapT\": 10497 } ],\n";
+
+		json << "\t\"images\": [\n";
+		for (size_t i = 0; i < images.size(); i++)
+		{
+			json << "\t\t{ \"uri\": \"" << Json::escape(images[i]) << "\" }" << (i + 1 < images.size() ? ",\n" : "\n");
+		}
+		json << "\t],\n";
+
+		json << "\t\"textures\": [\n";
+		for (size_t i = 0; i < images.size(); i++)
+		{
+			json << "\t\t{ \"sampler\": 0, \"source\": " << i << " }" << (i + 1 < images.size() ? ",\n" : "\n");
+		}
+		json << "\t],\n";
+
+		// Unlit in the game, a rough non-metal comes closest.
+		json << "\t\"materials\": [\n";
+		for (size_t i = 0; i < images.size(); i++)
+		{
+			std::string name = getFileName(images[i]);
+			name = name.substr(0, name.find_last_of('.'));
+
+			json << "\t\t{ \"name\": \"" << Json::escape(name) << "\", \"pbrMetallicRoughness\": { \"baseColorTexture\": { \"index\": " << i << " }";
+			json << ", \"metallicFactor\": 0, \"roughnessFactor\": 1 } }" << (i + 1 < images.size() ? ",\n" : "\n");
+		}
+		json << "\t]";
+	}
+
+	json << "\n}\n";
+
+	size_t jsonBytes = json.getSize();
+	if (!json.close())
+		return false;
+
+	bytes = buffer.size() + jsonBytes;
+	return true;
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "loader/modeldata.h"
+
+// Writes a model as glTF 2.0, '<path>.gltf' with all geometry in '<path>.bin'.
+// One primitive per mesh range, each texture becomes one material.
+class GltfExporter
+{
+public:
+	// 'textures' holds an image URI relative to the .gltf for every mesh range, empty for untextured ones.
+	// 'bytes' receives the size of both files.
+	static bool write(const ModelData& model, const std::vector<std::string>& textures, const std::string& path, size_t& bytes);
+};
@@ -0,0 +1,101 @@
+#include "obj.h"
+
+#include <algorithm>
+
+#include "exporter/exportspace.h"
+
+#include "util/stringext.h"
+#include "util/textwriter.h"
+
+static std::string getMaterialName(const std::string& texture)
+{
+	std::string name = getFileName(texture);
+	name = name.substr(0, name.find_last_of('.'));
+
+	// Material names end at the first whitespace.
+	std::replace_if(name.begin(), name.end(), [](char c) { return c == ' ' || c == '\t'; }, '_');
+	return name;
+}
+
+bool ObjExporter::write(const ModelData& model, const std::vector<std::string>& textures, const std::string& path, size_t& bytes)
+{
+	bytes = 0;
+
+	std::vector<std::string> images;
+	for (size_t i = 0; i < model.meshes.size() && i < textures.size(); i++)
+	{
+		if (!textures[i].empty() && std::find(images.begin(), images.end(), textures[i]) == images.end())
+			images.push_back(textures[i]);
+	}
+
+	std::string mtlName = getFileName(path) + ".mtl";
+
+	if (!images.empty())
+	{
+		TextWriter mtl;
+		if (!mtl.open(path + ".mtl"))
+			return false;
+
+		for (auto& image : images)
+		{
+			mtl << "newmtl " << getMaterialName(image) << "\n";
+			mtl << "Kd 1 1 1\n";
+			mtl << "map_Kd " << image << "\n\n";
+		}
+
+		bytes += mtl.getSize();
+		if (!mtl.close())
+			return false;
+	}
+
+	TextWriter obj;
+	if (!obj.open(path + ".obj"))
+		return false;
+
+	if (!images.empty())
+		obj << "mtllib " << mtlName << "\n";
+	obj << "o " << model.name << "\n";
+
+	float values[3];
+	for (auto& vertex : model.vertices)
+	{
+		toExportPosition(vertex, values);
+		obj << "v " << values[0] << ' ' << values[1] << ' ' << values[2] << '\n';
+	}
+	// Same bottom left texture origin as the viewer.
+	for (auto& vertex : model.vertices)
+	{
+		obj << "vt " << vertex.texcoord.x << ' ' << vertex.texcoord.y << '\n';
+	}
+	for (auto& vertex : model.vertices)
+	{
+		toExportNormal(vertex, values);
+		obj << "vn " << values[0] << ' ' << values[1] << ' ' << values[2] << '\n';
+	}
+
+	// Positions, texcoords and normals share one index, OBJ counts from 1 across the whole file.
+	for (size_t i = 0; i < model.meshes.size(); i++)
+	{
+		const MeshRange& range = model.meshes[i];
+		if (range.indexCount == 0)
+			continue;
+
+		obj << "g mesh_" << i << '\n';
+		if (i < textures.size() && !textures[i].empty())
+			obj << "usemtl " << getMaterialName(textures[i]) << '\n';
+
+		size_t base = range.vertexOffset + 1;
+		size_t end = range.indexOffset + range.indexCount;
+		for (size_t j = range.indexOffset; j + 2 < end; j += 3)
+		{
+			size_t a = base + model.indices[j];
+			size_t b = base + model.indices[j + 2];
+			size_t c = base + model.indices[j + 1];
+
+			obj << "f " << a << '/' << a << '/' << a << ' ' << b << '/' << b << '/' << b << ' ' << c << '/' << c << '/' << c << '\n';
+		}
+	}
+
+	bytes += obj.getSize();
+	return obj.close();
+}
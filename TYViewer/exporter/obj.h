@@ -0,0 +1,16 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "loader/modeldata.h"
+
+// Writes a model as Wavefront OBJ, '<path>.obj' and its materials in '<path>.mtl'.
+// One group per mesh range, vertex colours are not part of the format and are dropped.
+class ObjExporter
+{
+public:
+	// 'textures' holds an image path relative to the .mtl for every mesh range, empty for untextured ones.
+	// 'bytes' receives the size of both files.
+	static bool write(const ModelData& model, const std::vector<std::string>& textures, const std::string& path, size_t& bytes);
+};
@@ -0,0 +1,126 @@
+#include "bonepalette.h"
+
+#include <glad/glad.h>
+
+#include "util/trace.h"
+
+#include "renderstats.h"
+
+BonePaletteBuffer::BonePaletteBuffer() :
+	rows(),
+	buffer(0),
+	texture(0),
+	capacity(0)
+{}
+
+BonePaletteBuffer::~BonePaletteBuffer()
+{
+	terminate();
+}
+
+void BonePaletteBuffer::initialize()
+{
+	if (buffer != 0)
+		return;
+
+	glGenBuffers(1, &buffer);
+	glGenTextures(1, &texture);
+
+	// The texture only names the buffer, it stays attached when upload() reallocates the storage.
+	glBindBuffer(GL_TEXTURE_BUFFER, buffer);
+	glBindTexture(GL_TEXTURE_BUFFER, texture);
+	glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, buffer);
+
+	glBindTexture(GL_TEXTURE_BUFFER, 0);
+	glBindBuffer(GL_TEXTURE_BUFFER, 0);
+}
+
+void BonePaletteBuffer::terminate()
+{
+	if (buffer == 0)
+		return;
+
+	glDeleteTextures(1, &texture);
+	glDeleteBuffers(1, &buffer);
+
+	buffer = 0;
+	texture = 0;
+	capacity = 0;
+}
+
+void BonePaletteBuffer::clear()
+{
+	rows.clear();
+}
+
+int BonePaletteBuffer::add(const BoneMatrix* palette, size_t count)
+{
+	int first = static_cast<int>(getBoneCount());
+
+	size_t offset = rows.size();
+	rows.resize(offset + count * BONE_PALETTE_TEXELS * 4);
+
+	// Transposed, the fourth row of every matrix is 0 0 0 1 and is not stored.
+	float* row = rows.data() + offset;
+	for (size_t bone = 0; bone < count; bone++)
+	{
+		const float (&m)[4][4] = palette[bone].columns;
+		for (int i = 0; i < BONE_PALETTE_TEXELS; i++)
+		{
+			*row++ = m[0][i];
+			*row++ = m[1][i];
+			*row++ = m[2][i];
+			*row++ = m[3][i];
+		}
+	}
+
+	return first;
+}
+
+void BonePaletteBuffer::upload()
+{
+	TRACE_ZONE("BonePaletteBuffer::upload");
+
+	if (buffer == 0 || rows.empty())
+		return;
+
+	size_t bytes = getUploadBytes();
+
+	glBindBuffer(GL_TEXTURE_BUFFER, buffer);
+	if (bytes > capacity)
+	{
+		glBufferData(GL_TEXTURE_BUFFER, bytes, rows.data(), GL_STREAM_DRAW);
+		capacity = bytes;
+	}
+	else
+	{
+		// Orphaned, so the driver need not wait for last frame's draws still reading the old contents.
+		glBufferData(GL_TEXTURE_BUFFER, capacity, nullptr, GL_STREAM_DRAW);
+		glBufferSubData(GL_TEXTURE_BUFFER, 0, bytes, rows.data());
+	}
+	glBindBuffer(GL_TEXTURE_BUFFER, 0);
+}
+
+void BonePaletteBuffer::bind() const
+{
+	glActiveTexture(GL_TEXTURE0 + BONE_PALETTE_TEXTURE_UNIT);
+	glBindTexture(GL_TEXTURE_BUFFER, texture);
+	glActiveTexture(GL_TEXTURE0);
+
+	RenderStats::countStateChange();
+}
+
+size_t BonePaletteBuffer::getBoneCount() const
+{
+	return rows.size() / (BONE_PALETTE_TEXELS * 4);
+}
+
+size_t BonePaletteBuffer::getUploadBytes() const
+{
+	return rows.size() * sizeof(float);
+}
+
+size_t BonePaletteBuffer::getGpuBytes() const
+{
+	return capacity;
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <vector>
+
+#include "animation/skinning.h"
+
+// Texture unit the skinned shader reads the palette from, unit 0 is the diffuse texture.
+#define BONE_PALETTE_TEXTURE_UNIT 1
+
+// RGBA32F texels per bone, the rows of its matrix without the constant 0 0 0 1.
+#define BONE_PALETTE_TEXELS 3
+
+// Every skinned model's bone matrices of a frame in one texture buffer, uploaded once and read by
+// Shader::createSkinned() with texelFetch. Unlike a uniform block, its size is not capped at 16KB
+// and no range has to be rebound between models, each one only sets its first bone.
+class BonePaletteBuffer
+{
+public:
+	BonePaletteBuffer();
+	~BonePaletteBuffer();
+
+	// Needs a current OpenGL context.
+	void initialize();
+	void terminate();
+
+	// Starts a new frame, the bones added since the last upload() are dropped.
+	void clear();
+	// Copies 'count' matrices, returns the index of the first for the "paletteOffset" uniform.
+	int add(const BoneMatrix* palette, size_t count);
+	// Replaces the buffer's contents with the bones added this frame.
+	void upload();
+
+	void bind() const;
+
+	size_t getBoneCount() const;
+	// Uploaded per frame.
+	size_t getUploadBytes() const;
+	// The buffer's storage, grown to the largest frame so far.
+	size_t getGpuBytes() const;
+
+private:
+	// Three rows of each matrix, BONE_PALETTE_TEXELS * 4 floats per bone.
+	std::vector<float> rows;
+
+	unsigned int buffer;
+	unsigned int texture;
+
+	size_t capacity;
+};
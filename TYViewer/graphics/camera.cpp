@@ -108,6 +108,15 @@ void Camera::localTranslate(const glm::vec3& t)
 	updateViewMatrix();
 }
 
+void Camera::orbit(const glm::vec3& target, float distance, float yaw, float pitch)
+{
+	rotation = glm::vec3(yaw, pitch, 0.0f);
+	updateViewMatrix();
+
+	position = target - localForward * distance;
+	updateViewMatrix();
+}
+
 
 void Camera::updateProjectionMatrix()
 {
@@ -38,6 +38,9 @@ public:
 	void localRotate(const glm::vec3& r);
 	void localTranslate(const glm::vec3& t);
 
+	// Places the camera 'distance' away from 'target', looking at it.
+	void orbit(const glm::vec3& target, float distance, float yaw, float pitch);
+
 private:
 	void updateProjectionMatrix();
 	void updateViewMatrix();
@@ -0,0 +1,394 @@
+#include "capture.h"
+
+#include <cstring>
+#include <algorithm>
+
+#include "SOIL2/SOIL2.h"
+
+#include "debug.h"
+#include "util/trace.h"
+
+#ifdef _WIN32
+#define popen _popen
+#define pclose _pclose
+// Frames are binary, the Windows pipe would otherwise translate line endings.
+#define PIPE_WRITE_MODE "wb"
+#else
+// glibc rejects "b" with EINVAL.
+#define PIPE_WRITE_MODE "w"
+#endif
+
+static std::string replaceAll(std::string s, const std::string& from, const std::string& to)
+{
+	size_t position = 0;
+	while ((position = s.find(from, position)) != std::string::npos)
+	{
+		s.replace(position, from.size(), to);
+		position += to.size();
+	}
+	return s;
+}
+
+FrameCapture::FrameCapture() :
+	submitted(0),
+	collected(0),
+	sequenceFrame(0),
+	sequenceLength(0),
+	sequenceWidth(0),
+	sequenceHeight(0),
+	encoder(nullptr),
+	running(false),
+	encoding(0)
+{}
+
+FrameCapture::~FrameCapture()
+{
+	terminate();
+}
+
+void FrameCapture::initialize()
+{
+	for (auto& slot : slots)
+	{
+		glGenBuffers(1, &slot.pbo);
+	}
+
+	running = true;
+	worker = std::thread(&FrameCapture::work, this);
+}
+
+void FrameCapture::terminate()
+{
+	if (!running)
+		return;
+
+	// Drain whatever is still in flight so nothing requested is lost.
+	while (collected != submitted)
+	{
+		collect(true);
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		running = false;
+	}
+	wake.notify_one();
+	worker.join();
+
+	if (encoder != nullptr)
+	{
+		pclose(encoder);
+		encoder = nullptr;
+	}
+
+	for (auto& slot : slots)
+	{
+		glDeleteBuffers(1, &slot.pbo);
+		slot.pbo = 0;
+	}
+}
+
+void FrameCapture::requestScreenshot(const std::string& path)
+{
+	screenshotPath = path;
+}
+
+bool FrameCapture::startSequence(const std::string& prefix, unsigned int frameCount, const std::string& command)
+{
+	if (isRecording())
+	{
+		LOG_WARNING(Render, "Capture: A sequence is already being recorded");
+		return false;
+	}
+
+	sequencePrefix = prefix;
+	sequenceFrame = 0;
+	sequenceLength = frameCount;
+	sequenceWidth = 0;
+	sequenceHeight = 0;
+	encoderCommand = command;
+
+	LOG_INFO(Render, "Capture: Recording " + std::to_string(frameCount) + " frames");
+	return true;
+}
+
+bool FrameCapture::isRecording() const
+{
+	return sequenceFrame < sequenceLength;
+}
+
+unsigned int FrameCapture::getSequenceFrame() const
+{
+	return sequenceFrame;
+}
+
+unsigned int FrameCapture::getSequenceLength() const
+{
+	return sequenceLength;
+}
+
+void FrameCapture::captureFrame(int width, int height)
+{
+	if (!running)
+		return;
+
+	// Pick up frames the GPU finished since last time.
+	collect(false);
+
+	bool recording = isRecording();
+	if (screenshotPath.empty() && !recording)
+		return;
+
+	if (recording && sequenceFrame == 0)
+	{
+		sequenceWidth = width;
+		sequenceHeight = height;
+
+		if (!encoderCommand.empty())
+		{
+			// Opened here rather than on the worker so a bad command fails the sequence immediately.
+			std::string command = replaceAll(encoderCommand, "{width}", std::to_string(width));
+			command = replaceAll(command, "{height}", std::to_string(height));
+
+			encoder = popen(command.c_str(), PIPE_WRITE_MODE);
+			if (encoder == nullptr)
+			{
+				LOG_ERROR(Render, "Capture: Failed to start encoder: " + command);
+				sequenceLength = 0;
+				recording = false;
+			}
+		}
+	}
+	else if (recording && (width != sequenceWidth || height != sequenceHeight))
+	{
+		LOG_WARNING(Render, "Capture: Framebuffer size changed, stopping sequence");
+		finishSequence();
+		recording = false;
+	}
+
+	// The sequence just failed or stopped, unless a screenshot was asked for there is nothing to read back.
+	if (!recording && screenshotPath.empty())
+		return;
+
+	// Every buffer still in flight, wait for the oldest one rather than dropping a frame.
+	if (submitted - collected == FRAME_CAPTURE_BUFFER_COUNT)
+	{
+		collect(true);
+	}
+
+	Slot& slot = slots[submitted % FRAME_CAPTURE_BUFFER_COUNT];
+	slot.width = width;
+	slot.height = height;
+
+	if (recording)
+	{
+		if (encoder != nullptr)
+		{
+			slot.target = Target::SequencePipe;
+			slot.path.clear();
+		}
+		else
+		{
+			char number[16];
+			snprintf(number, sizeof(number), "_%04u.png", sequenceFrame);
+
+			slot.target = Target::SequenceImage;
+			slot.path = sequencePrefix + number;
+		}
+		sequenceFrame++;
+	}
+	else
+	{
+		slot.target = Target::Screenshot;
+		slot.path = screenshotPath;
+		screenshotPath.clear();
+	}
+
+	size_t size = static_cast<size_t>(width) * static_cast<size_t>(height) * 4;
+
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.pbo);
+	if (slot.capacity != size)
+	{
+		glBufferData(GL_PIXEL_PACK_BUFFER, size, nullptr, GL_STREAM_READ);
+		slot.capacity = size;
+	}
+
+	glPixelStorei(GL_PACK_ALIGNMENT, 4);
+	glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, 0);
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+	slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	submitted++;
+
+	if (recording && !isRecording())
+	{
+		LOG_INFO(Render, "Capture: Sequence finished");
+		finishSequence();
+	}
+}
+
+void FrameCapture::finishSequence()
+{
+	// Flush the remaining frames before closing the pipe.
+	while (collected != submitted)
+	{
+		collect(true);
+	}
+
+	sequenceLength = 0;
+	sequenceFrame = 0;
+
+	if (encoder != nullptr)
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		// The worker may still be writing the last frame it took.
+		idle.wait(lock, [this]() { return jobs.empty() && encoding == 0; });
+
+		pclose(encoder);
+		encoder = nullptr;
+	}
+}
+
+void FrameCapture::collect(bool wait)
+{
+	while (collected != submitted)
+	{
+		Slot& slot = slots[collected % FRAME_CAPTURE_BUFFER_COUNT];
+
+		GLenum status = glClientWaitSync(slot.fence, wait ? GL_SYNC_FLUSH_COMMANDS_BIT : 0, wait ? GL_TIMEOUT_IGNORED : 0);
+		if (status == GL_TIMEOUT_EXPIRED)
+			return;
+
+		glDeleteSync(slot.fence);
+		slot.fence = nullptr;
+
+		size_t size = static_cast<size_t>(slot.width) * static_cast<size_t>(slot.height) * 4;
+
+		Job job;
+		job.pixels = acquirePixels(size);
+		job.width = slot.width;
+		job.height = slot.height;
+		job.target = slot.target;
+		job.path = slot.path;
+
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.pbo);
+		const void* mapped = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, size, GL_MAP_READ_BIT);
+		if (mapped != nullptr)
+		{
+			memcpy(job.pixels.data(), mapped, size);
+			glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+		}
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+		collected++;
+
+		if (mapped == nullptr)
+		{
+			LOG_ERROR(Render, "Capture: Failed to map pixel buffer");
+			releasePixels(job.pixels);
+			continue;
+		}
+
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			idle.wait(lock, [this]() { return jobs.size() < FRAME_CAPTURE_MAX_JOBS; });
+			jobs.push_back(std::move(job));
+		}
+		wake.notify_one();
+
+		// Only the oldest frame is worth blocking for.
+		wait = false;
+	}
+}
+
+void FrameCapture::work()
+{
+	Trace::setThreadName("Capture");
+
+	for (;;)
+	{
+		Job job;
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			wake.wait(lock, [this]() { return !jobs.empty() || !running; });
+
+			if (jobs.empty())
+				return;
+
+			job = std::move(jobs.front());
+			jobs.pop_front();
+			encoding++;
+		}
+
+		encode(job);
+
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			pool.push_back(std::move(job.pixels));
+			encoding--;
+		}
+		idle.notify_all();
+	}
+}
+
+void FrameCapture::encode(Job& job)
+{
+	TRACE_ZONE("FrameCapture::encode");
+
+	// OpenGL rows start at the bottom, images start at the top.
+	const size_t stride = static_cast<size_t>(job.width) * 4;
+	for (int y = 0; y < job.height / 2; y++)
+	{
+		unsigned char* a = &job.pixels[y * stride];
+		unsigned char* b = &job.pixels[(job.height - 1 - y) * stride];
+		for (size_t x = 0; x < stride; x++)
+		{
+			std::swap(a[x], b[x]);
+		}
+	}
+
+	if (job.target == Target::SequencePipe)
+	{
+		if (encoder != nullptr && fwrite(job.pixels.data(), 1, job.pixels.size(), encoder) != job.pixels.size())
+		{
+			LOG_ERROR(Render, "Capture: Failed to write frame to encoder");
+		}
+		return;
+	}
+
+	// The framebuffer alpha is whatever blending left behind, keep images opaque.
+	for (size_t i = 3; i < job.pixels.size(); i += 4)
+	{
+		job.pixels[i] = 255;
+	}
+
+	if (SOIL_save_image(job.path.c_str(), SOIL_SAVE_TYPE_PNG, job.width, job.height, 4, job.pixels.data()) == 0)
+	{
+		LOG_ERROR(Render, "Capture: Failed to save " + job.path);
+	}
+	else if (job.target == Target::Screenshot)
+	{
+		LOG_INFO(Render, "Capture: Saved " + job.path);
+	}
+}
+
+std::vector<unsigned char> FrameCapture::acquirePixels(size_t size)
+{
+	std::vector<unsigned char> pixels;
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		if (!pool.empty())
+		{
+			pixels = std::move(pool.back());
+			pool.pop_back();
+		}
+	}
+	pixels.resize(size);
+	return pixels;
+}
+
+void FrameCapture::releasePixels(std::vector<unsigned char>& pixels)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	pool.push_back(std::move(pixels));
+}
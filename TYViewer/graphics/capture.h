@@ -0,0 +1,117 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <cstdio>
+
+#include <glad/glad.h>
+
+// Number of pixel buffers frames rotate through.
+// A frame is only mapped once the GPU has finished writing it, which
+// usually takes a frame or two, so three keeps readback from ever stalling.
+#define FRAME_CAPTURE_BUFFER_COUNT 3
+
+// Frames waiting for the worker at most, a slow encoder then holds up rendering rather than memory growing.
+#define FRAME_CAPTURE_MAX_JOBS 8
+
+// Reads back the framebuffer through a ring of pixel buffer objects and
+// hands the pixels to a worker thread which writes PNGs or pipes raw RGBA
+// frames to an encoder process.
+class FrameCapture
+{
+public:
+	FrameCapture();
+	~FrameCapture();
+
+	void initialize();
+	void terminate();
+
+	// Saves the next frame as a PNG.
+	void requestScreenshot(const std::string& path);
+
+	// Captures the next 'frameCount' frames.
+	// If 'encoderCommand' is empty every frame is written as '<prefix>_0000.png',
+	// otherwise raw RGBA frames are piped to the command's standard input.
+	// "{width}" and "{height}" in the command are replaced with the frame size.
+	bool startSequence(const std::string& prefix, unsigned int frameCount, const std::string& encoderCommand = "");
+
+	bool isRecording() const;
+	unsigned int getSequenceFrame() const;
+	unsigned int getSequenceLength() const;
+
+	// Call after everything has been drawn, before swapping buffers.
+	void captureFrame(int width, int height);
+
+private:
+	enum class Target
+	{
+		Screenshot,
+		SequenceImage,
+		SequencePipe
+	};
+
+	struct Slot
+	{
+		unsigned int pbo = 0;
+		size_t capacity = 0;
+
+		GLsync fence = nullptr;
+
+		int width = 0;
+		int height = 0;
+
+		Target target = Target::Screenshot;
+		std::string path;
+	};
+
+	struct Job
+	{
+		std::vector<unsigned char> pixels;
+		int width;
+		int height;
+
+		Target target;
+		std::string path;
+	};
+
+	// Maps every finished buffer in submission order, optionally waiting for the oldest.
+	void collect(bool wait);
+	void finishSequence();
+
+	void work();
+	void encode(Job& job);
+
+	std::vector<unsigned char> acquirePixels(size_t size);
+	void releasePixels(std::vector<unsigned char>& pixels);
+
+	Slot slots[FRAME_CAPTURE_BUFFER_COUNT];
+	unsigned int submitted;
+	unsigned int collected;
+
+	std::string screenshotPath;
+
+	std::string sequencePrefix;
+	unsigned int sequenceFrame;
+	unsigned int sequenceLength;
+	int sequenceWidth;
+	int sequenceHeight;
+	std::string encoderCommand;
+
+	// Only touched by the worker thread once the sequence is running.
+	FILE* encoder;
+
+	std::thread worker;
+	bool running;
+
+	std::mutex mutex;
+	std::condition_variable wake;
+	std::condition_variable idle;
+	std::deque<Job> jobs;
+	// Jobs the worker has taken and not finished, 0 or 1.
+	unsigned int encoding;
+	std::vector<std::vector<unsigned char>> pool;
+};
@@ -0,0 +1,96 @@
+#include "collisionbuffer.h"
+
+#include <glad/glad.h>
+
+#include "util/trace.h"
+
+#include "renderstats.h"
+
+CollisionBuffer::CollisionBuffer() :
+	vao(0),
+	vbo(0),
+	ebo(0),
+	vertexCount(0),
+	indexCount(0)
+{}
+
+CollisionBuffer::~CollisionBuffer()
+{
+	if (vao == 0)
+		return;
+
+	glDeleteVertexArrays(1, &vao);
+	glDeleteBuffers(1, &vbo);
+	glDeleteBuffers(1, &ebo);
+}
+
+void CollisionBuffer::setup(const CollisionMesh& collision)
+{
+	TRACE_ZONE("CollisionBuffer::setup");
+
+	if (vao != 0 || collision.empty())
+		return;
+
+	vertexCount = collision.positions.size();
+	indexCount = collision.indices.size();
+
+	glGenVertexArrays(1, &vao);
+	glGenBuffers(1, &vbo);
+	glGenBuffers(1, &ebo);
+
+	glBindVertexArray(vao);
+
+	glBindBuffer(GL_ARRAY_BUFFER, vbo);
+	glBufferData(GL_ARRAY_BUFFER, vertexCount * sizeof(glm::vec3), collision.positions.data(), GL_STATIC_DRAW);
+
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, indexCount * sizeof(unsigned int), collision.indices.data(), GL_STATIC_DRAW);
+
+	// Only the position is stored, w is filled in as 1.
+	glEnableVertexAttribArray(0);
+	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(glm::vec3), (const void*)0);
+
+	glBindVertexArray(0);
+}
+
+void CollisionBuffer::draw(Shader& shader, const glm::mat4& modelMatrix, const glm::vec4& colour) const
+{
+	if (vao == 0)
+		return;
+
+	shader.bind();
+	shader.setUniformMat4("modelMatrix", modelMatrix);
+
+	// Disabled attributes read the current generic value, the colour is the same for every vertex.
+	glVertexAttrib4f(2, colour.x, colour.y, colour.z, colour.w);
+
+	// Pulled forward so it does not z-fight with the render meshes it usually lies on.
+	glEnable(GL_POLYGON_OFFSET_FILL);
+	glPolygonOffset(-1.0f, -1.0f);
+	glDepthMask(GL_FALSE);
+
+	glBindVertexArray(vao);
+	RenderStats::countStateChange();
+
+	glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(indexCount), GL_UNSIGNED_INT, nullptr);
+	RenderStats::countDraw(indexCount / 3);
+
+	glBindVertexArray(0);
+
+	glDepthMask(GL_TRUE);
+	glDisable(GL_POLYGON_OFFSET_FILL);
+	glVertexAttrib4f(2, 1.0f, 1.0f, 1.0f, 1.0f);
+}
+
+size_t CollisionBuffer::getTriangleCount() const
+{
+	return indexCount / 3;
+}
+
+size_t CollisionBuffer::getGpuBytes() const
+{
+	if (vao == 0)
+		return 0;
+
+	return vertexCount * sizeof(glm::vec3) + indexCount * sizeof(unsigned int);
+}
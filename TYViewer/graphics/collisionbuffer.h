@@ -0,0 +1,31 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include "shader.h"
+
+#include "loader/modeldata.h"
+
+// A model's merged collision mesh on the GPU, drawn as one translucent overlay.
+// Positions only, the shader's other attributes take the constant values draw() sets.
+class CollisionBuffer
+{
+public:
+	CollisionBuffer();
+	~CollisionBuffer();
+
+	// Uploads the positions and indices, needs a current OpenGL context. Does nothing for an empty mesh.
+	void setup(const CollisionMesh& collision);
+
+	// One draw call, depth tested but not written so the model stays visible through it.
+	void draw(Shader& shader, const glm::mat4& modelMatrix, const glm::vec4& colour) const;
+
+	size_t getTriangleCount() const;
+	size_t getGpuBytes() const;
+
+private:
+	unsigned int vao, vbo, ebo;
+
+	size_t vertexCount;
+	size_t indexCount;
+};
@@ -0,0 +1,189 @@
+#include "context.h"
+
+#include <cstdlib>
+
+#include <glad/glad.h>
+
+#if OFFSCREEN_CONTEXT_EGL
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#endif
+
+#include "debug.h"
+
+OffscreenContext::OffscreenContext() :
+	backend(),
+	display(nullptr),
+	context(nullptr),
+	window(nullptr)
+{}
+
+OffscreenContext::~OffscreenContext()
+{
+	destroy();
+}
+
+bool OffscreenContext::create(bool software)
+{
+	if (software)
+	{
+		// Must be set before the driver is loaded.
+#ifdef _WIN32
+		_putenv_s("LIBGL_ALWAYS_SOFTWARE", "1");
+#else
+		setenv("LIBGL_ALWAYS_SOFTWARE", "1", 1);
+#endif
+	}
+
+	if (createEGL() || createGLFW())
+	{
+		LOG_INFO(Render, "Offscreen context: " + backend + ", " + reinterpret_cast<const char*>(glGetString(GL_RENDERER)));
+		return true;
+	}
+
+	LOG_ERROR(Render, "Failed to create an offscreen OpenGL 3.3 context");
+	return false;
+}
+
+void OffscreenContext::destroy()
+{
+#if OFFSCREEN_CONTEXT_EGL
+	if (display != nullptr)
+	{
+		eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+		if (context != nullptr)
+		{
+			eglDestroyContext(display, context);
+		}
+		eglTerminate(display);
+	}
+#endif
+	display = nullptr;
+	context = nullptr;
+
+	if (window != nullptr)
+	{
+		glfwDestroyWindow(window);
+		glfwTerminate();
+		window = nullptr;
+	}
+}
+
+const std::string& OffscreenContext::getBackend() const
+{
+	return backend;
+}
+
+bool OffscreenContext::createEGL()
+{
+#if OFFSCREEN_CONTEXT_EGL
+	EGLDisplay eglDisplay = EGL_NO_DISPLAY;
+
+	// Prefer the surfaceless platform, it needs neither X11 nor a DRM device.
+	PFNEGLGETPLATFORMDISPLAYEXTPROC getPlatformDisplay = (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+	if (getPlatformDisplay != nullptr)
+	{
+		eglDisplay = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+	}
+	if (eglDisplay == EGL_NO_DISPLAY)
+	{
+		eglDisplay = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+	}
+
+	EGLint major, minor;
+	if (eglDisplay == EGL_NO_DISPLAY || !eglInitialize(eglDisplay, &major, &minor))
+	{
+		LOG_DEBUG(Render, "EGL: No display available");
+		return false;
+	}
+	display = eglDisplay;
+
+	if (!eglBindAPI(EGL_OPENGL_API))
+	{
+		LOG_DEBUG(Render, "EGL: Desktop OpenGL not supported");
+		destroy();
+		return false;
+	}
+
+	const EGLint configAttributes[] =
+	{
+		EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+		EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+		EGL_NONE
+	};
+
+	// Surfaceless contexts do not need a matching config.
+	EGLConfig config = nullptr;
+	EGLint configCount = 0;
+	eglChooseConfig(eglDisplay, configAttributes, &config, 1, &configCount);
+
+	const EGLint contextAttributes[] =
+	{
+		EGL_CONTEXT_MAJOR_VERSION, 3,
+		EGL_CONTEXT_MINOR_VERSION, 3,
+		EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+		EGL_NONE
+	};
+
+	context = eglCreateContext(eglDisplay, configCount > 0 ? config : nullptr, EGL_NO_CONTEXT, contextAttributes);
+	if (context == EGL_NO_CONTEXT)
+	{
+		context = nullptr;
+		LOG_DEBUG(Render, "EGL: Failed to create OpenGL 3.3 core context");
+		destroy();
+		return false;
+	}
+
+	if (!eglMakeCurrent(eglDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE, context))
+	{
+		LOG_DEBUG(Render, "EGL: Surfaceless contexts not supported");
+		destroy();
+		return false;
+	}
+
+	if (!gladLoadGLLoader((GLADloadproc)eglGetProcAddress))
+	{
+		LOG_DEBUG(Render, "EGL: Failed to load OpenGL functions");
+		destroy();
+		return false;
+	}
+
+	backend = "EGL " + std::to_string(major) + "." + std::to_string(minor);
+	return true;
+#else
+	return false;
+#endif
+}
+
+bool OffscreenContext::createGLFW()
+{
+	if (!glfwInit())
+	{
+		LOG_DEBUG(Render, "GLFW: Failed to initialize");
+		return false;
+	}
+
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+	glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+
+	window = glfwCreateWindow(1, 1, "TYViewer", NULL, NULL);
+	if (window == nullptr)
+	{
+		LOG_DEBUG(Render, "GLFW: Failed to create hidden window");
+		glfwTerminate();
+		return false;
+	}
+
+	glfwMakeContextCurrent(window);
+	if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
+	{
+		LOG_DEBUG(Render, "GLFW: Failed to load OpenGL functions");
+		destroy();
+		return false;
+	}
+
+	backend = "GLFW hidden window";
+	return true;
+}
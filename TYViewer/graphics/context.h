@@ -0,0 +1,38 @@
+#pragma once
+
+#include <string>
+
+#include <GLFW/glfw3.h>
+
+// EGL lets Linux create a context with no display server at all,
+// other platforms fall back to an invisible GLFW window.
+#if defined(__linux__)
+#define OFFSCREEN_CONTEXT_EGL 1
+#else
+#define OFFSCREEN_CONTEXT_EGL 0
+#endif
+
+// OpenGL 3.3 core context without a visible window, render into a Framebuffer.
+class OffscreenContext
+{
+public:
+	OffscreenContext();
+	~OffscreenContext();
+
+	// 'software' requests Mesa's software rasterizer (llvmpipe).
+	bool create(bool software = false);
+	void destroy();
+
+	const std::string& getBackend() const;
+
+private:
+	bool createEGL();
+	bool createGLFW();
+
+	std::string backend;
+
+	void* display;
+	void* context;
+
+	GLFWwindow* window;
+};
@@ -5,5 +5,7 @@
 class Drawable
 {
 public:
+	virtual ~Drawable() = default;
+
 	virtual void draw(Shader& shader) const = 0;
 };
\ No newline at end of file
@@ -0,0 +1,121 @@
+#include "framebuffer.h"
+
+#include <cstring>
+
+#include <glad/glad.h>
+
+#include "debug.h"
+
+Framebuffer::Framebuffer() :
+	fbo(0),
+	colour(0),
+	depth(0),
+	width(0),
+	height(0)
+{}
+
+Framebuffer::~Framebuffer()
+{
+	destroy();
+}
+
+bool Framebuffer::create(int width, int height)
+{
+	destroy();
+
+	this->width = width;
+	this->height = height;
+
+	glGenTextures(1, &colour);
+	glBindTexture(GL_TEXTURE_2D, colour);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	glBindTexture(GL_TEXTURE_2D, 0);
+
+	glGenRenderbuffers(1, &depth);
+	glBindRenderbuffer(GL_RENDERBUFFER, depth);
+	glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height);
+	glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+	glGenFramebuffers(1, &fbo);
+	glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, colour, 0);
+	glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, depth);
+
+	GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+	if (status != GL_FRAMEBUFFER_COMPLETE)
+	{
+		LOG_ERROR(Render, "Framebuffer incomplete, status " + std::to_string(status));
+		destroy();
+		return false;
+	}
+
+	return true;
+}
+
+void Framebuffer::destroy()
+{
+	if (fbo != 0)
+	{
+		glDeleteFramebuffers(1, &fbo);
+		glDeleteTextures(1, &colour);
+		glDeleteRenderbuffers(1, &depth);
+	}
+
+	fbo = 0;
+	colour = 0;
+	depth = 0;
+}
+
+void Framebuffer::bind() const
+{
+	glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+	glViewport(0, 0, width, height);
+}
+
+void Framebuffer::unbind() const
+{
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+void Framebuffer::read(std::vector<unsigned char>& pixels) const
+{
+	const size_t stride = static_cast<size_t>(width) * 4;
+	pixels.resize(stride * height);
+
+	glBindFramebuffer(GL_READ_FRAMEBUFFER, fbo);
+	glPixelStorei(GL_PACK_ALIGNMENT, 4);
+	glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+	glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+
+	// OpenGL rows start at the bottom.
+	std::vector<unsigned char> row(stride);
+	for (int y = 0; y < height / 2; y++)
+	{
+		unsigned char* a = &pixels[y * stride];
+		unsigned char* b = &pixels[(height - 1 - y) * stride];
+		memcpy(row.data(), a, stride);
+		memcpy(a, b, stride);
+		memcpy(b, row.data(), stride);
+	}
+}
+
+int Framebuffer::getWidth() const
+{
+	return width;
+}
+
+int Framebuffer::getHeight() const
+{
+	return height;
+}
+
+unsigned int Framebuffer::getTexture() const
+{
+	return colour;
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <vector>
+
+// Offscreen render target with an RGBA8 colour texture and a depth buffer.
+class Framebuffer
+{
+public:
+	Framebuffer();
+	~Framebuffer();
+
+	bool create(int width, int height);
+	void destroy();
+
+	void bind() const;
+	void unbind() const;
+
+	// Reads the colour attachment, rows ordered top to bottom.
+	void read(std::vector<unsigned char>& pixels) const;
+
+	int getWidth() const;
+	int getHeight() const;
+	unsigned int getTexture() const;
+
+private:
+	unsigned int fbo;
+	unsigned int colour;
+	unsigned int depth;
+
+	int width;
+	int height;
+};
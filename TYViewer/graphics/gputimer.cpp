@@ -0,0 +1,121 @@
+#include "gputimer.h"
+
+#include <glad/glad.h>
+
+GpuTimer::GpuTimer() :
+	queries(),
+	pending(),
+	results(),
+	frame(0),
+	active(-1),
+	initialized(false)
+{}
+
+GpuTimer::~GpuTimer()
+{
+	terminate();
+}
+
+void GpuTimer::initialize()
+{
+	for (auto& set : queries)
+	{
+		glGenQueries(static_cast<int>(GpuPass::Count), set);
+	}
+	initialized = true;
+}
+
+void GpuTimer::terminate()
+{
+	if (!initialized)
+		return;
+
+	for (auto& set : queries)
+	{
+		glDeleteQueries(static_cast<int>(GpuPass::Count), set);
+	}
+	initialized = false;
+}
+
+void GpuTimer::beginFrame()
+{
+	if (!initialized)
+		return;
+
+	end();
+	frame++;
+
+	unsigned int index = frame % GPU_TIMER_FRAMES;
+	for (int pass = 0; pass < static_cast<int>(GpuPass::Count); pass++)
+	{
+		if (!pending[index][pass])
+			continue;
+
+		GLint available = 0;
+		glGetQueryObjectiv(queries[index][pass], GL_QUERY_RESULT_AVAILABLE, &available);
+		if (!available)
+			continue;
+
+		GLuint64 nanoseconds = 0;
+		glGetQueryObjectui64v(queries[index][pass], GL_QUERY_RESULT, &nanoseconds);
+
+		results[pass] = static_cast<double>(nanoseconds) / 1000000.0;
+		pending[index][pass] = false;
+	}
+}
+
+void GpuTimer::begin(GpuPass pass)
+{
+	if (!initialized)
+		return;
+
+	end();
+
+	unsigned int index = frame % GPU_TIMER_FRAMES;
+	int slot = static_cast<int>(pass);
+
+	// Still waiting on the GPU, skip this pass rather than stall.
+	if (pending[index][slot])
+		return;
+
+	glBeginQuery(GL_TIME_ELAPSED, queries[index][slot]);
+	pending[index][slot] = true;
+	active = slot;
+}
+
+void GpuTimer::end()
+{
+	if (active < 0)
+		return;
+
+	glEndQuery(GL_TIME_ELAPSED);
+	active = -1;
+}
+
+double GpuTimer::getMilliseconds(GpuPass pass) const
+{
+	return results[static_cast<int>(pass)];
+}
+
+double GpuTimer::getTotalMilliseconds() const
+{
+	double total = 0.0;
+	for (double result : results)
+	{
+		total += result;
+	}
+	return total;
+}
+
+const char* GpuTimer::getName(GpuPass pass)
+{
+	switch (pass)
+	{
+	case GpuPass::Models:	return "Models";
+	case GpuPass::Grid:		return "Grid";
+	case GpuPass::Overlays:	return "Overlays";
+	case GpuPass::Text:		return "Text";
+	case GpuPass::Thumbnails:	return "Thumbnails";
+	default:				return "";
+	}
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+// Queries are read back this many frames after being issued, so the CPU never waits on them.
+#define GPU_TIMER_FRAMES 2
+
+enum class GpuPass
+{
+	Models,
+	Grid,
+	Overlays,
+	Text,
+	Thumbnails,
+	Count
+};
+
+// GL_TIME_ELAPSED queries around the render passes of a frame.
+// Passes cannot nest, begin() ends whichever pass is still running.
+class GpuTimer
+{
+public:
+	GpuTimer();
+	~GpuTimer();
+
+	void initialize();
+	void terminate();
+
+	// Collects finished results, call at the start of a frame.
+	void beginFrame();
+
+	void begin(GpuPass pass);
+	void end();
+
+	// Most recent result, in milliseconds.
+	double getMilliseconds(GpuPass pass) const;
+	double getTotalMilliseconds() const;
+
+	static const char* getName(GpuPass pass);
+
+private:
+	unsigned int queries[GPU_TIMER_FRAMES][static_cast<int>(GpuPass::Count)];
+	bool pending[GPU_TIMER_FRAMES][static_cast<int>(GpuPass::Count)];
+
+	double results[static_cast<int>(GpuPass::Count)];
+
+	unsigned int frame;
+	int active;
+	bool initialized;
+};
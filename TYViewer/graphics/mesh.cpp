@@ -3,6 +3,10 @@
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
 
+#include "util/trace.h"
+
+#include "renderstats.h"
+
 Mesh::Mesh() :
 	Drawable(),
 	Transformable(glm::vec3(0, 0, 0)),
@@ -16,17 +20,18 @@ Mesh::Mesh() :
 
 Mesh::Mesh(const std::vector<Vertex>& vertices, const std::vector<unsigned int>& indices, Texture* texture) :
 	Drawable(),
-	Transformable({ 0.0f, 0.0f, 0.0f }),
+	Transformable(glm::vec3(0.0f, 0.0f, 0.0f)),
 	m_vertices(vertices), m_indices(indices), m_texture(texture),
 	vao(0),
 	vbo(0),
 	ebo(0)
-{
-	setup();
-}
+{}
 
 Mesh::~Mesh()
 {
+	if (vao == 0)
+		return;
+
 	glDeleteVertexArrays(1, &vao);
 	glDeleteBuffers(1, &vbo);
 	glDeleteBuffers(1, &ebo);
@@ -34,6 +39,11 @@ Mesh::~Mesh()
 
 void Mesh::setup()
 {
+	TRACE_ZONE("Mesh::setup");
+
+	if (vao != 0 || m_vertices.empty() || m_indices.empty())
+		return;
+
 	glGenVertexArrays(1, &vao);
 	glGenBuffers(1, &vbo);
 	glGenBuffers(1, &ebo);
@@ -64,14 +74,100 @@ void Mesh::setup()
 	glBindVertexArray(0);
 }
 
+void Mesh::update(const std::vector<Vertex>& vertices, const std::vector<unsigned int>& indices)
+{
+	m_vertices = vertices;
+	m_indices = indices;
+
+	if (vao == 0)
+	{
+		setup();
+		return;
+	}
+
+	glBindVertexArray(vao);
+
+	glBindBuffer(GL_ARRAY_BUFFER, vbo);
+	glBufferData(GL_ARRAY_BUFFER, m_vertices.size() * sizeof(Vertex), m_vertices.data(), GL_DYNAMIC_DRAW);
+
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, m_indices.size() * sizeof(unsigned int), m_indices.data(), GL_DYNAMIC_DRAW);
+
+	glBindVertexArray(0);
+}
+
 void Mesh::draw(Shader& shader) const
 {
+	draw(shader, getMatrix());
+}
+
+void Mesh::draw(Shader& shader, const glm::mat4& modelMatrix) const
+{
+	draw(shader, modelMatrix, vao);
+}
+
+void Mesh::draw(Shader& shader, const glm::mat4& modelMatrix, unsigned int vertexArray) const
+{
+	if (vao == 0 || vertexArray == 0)
+		return;
+
 	shader.bind();
 	m_texture->bind();
 
-	shader.setUniformMat4("modelMatrix", getMatrix());
+	shader.setUniformMat4("modelMatrix", modelMatrix);
 
-	glBindVertexArray(vao);
+	glBindVertexArray(vertexArray);
+	RenderStats::countStateChange();
 
 	glDrawElements(GL_TRIANGLES, m_indices.size(), GL_UNSIGNED_INT, nullptr);
+	RenderStats::countDraw(m_indices.size() / 3);
 }
+
+
+size_t Mesh::getVertexCount() const
+{
+	return m_vertices.size();
+}
+
+size_t Mesh::getIndexCount() const
+{
+	return m_indices.size();
+}
+
+Texture* Mesh::getTexture() const
+{
+	return m_texture;
+}
+
+const std::vector<Vertex>& Mesh::getVertices() const
+{
+	return m_vertices;
+}
+
+const std::vector<unsigned int>& Mesh::getIndices() const
+{
+	return m_indices;
+}
+
+unsigned int Mesh::getVertexBuffer() const
+{
+	return vbo;
+}
+
+unsigned int Mesh::getIndexBuffer() const
+{
+	return ebo;
+}
+
+size_t Mesh::getCpuBytes() const
+{
+	return m_vertices.capacity() * sizeof(Vertex) + m_indices.capacity() * sizeof(unsigned int);
+}
+
+size_t Mesh::getGpuBytes() const
+{
+	if (vao == 0)
+		return 0;
+
+	return m_vertices.size() * sizeof(Vertex) + m_indices.size() * sizeof(unsigned int);
+}
\ No newline at end of file
@@ -16,11 +16,35 @@ public:
 	Mesh(const std::vector<Vertex>& vertices, const std::vector<unsigned int>& indices, Texture* texture);
 	~Mesh();
 
+	// Uploads the vertices and indices, needs a current OpenGL context.
+	void setup();
+
+	// Replaces the contents, reusing the existing buffers.
+	void update(const std::vector<Vertex>& vertices, const std::vector<unsigned int>& indices);
+
 	virtual void draw(Shader& shader) const override;
+	void draw(Shader& shader, const glm::mat4& modelMatrix) const;
+	// Draws the indices and texture through another vertex array, one sharing this mesh's buffers.
+	void draw(Shader& shader, const glm::mat4& modelMatrix, unsigned int vertexArray) const;
 
-private:
-	void setup();
+	size_t getVertexCount() const;
+	size_t getIndexCount() const;
 
+	Texture* getTexture() const;
+
+	// The copies kept after upload.
+	const std::vector<Vertex>& getVertices() const;
+	const std::vector<unsigned int>& getIndices() const;
+
+	// 0 until setup().
+	unsigned int getVertexBuffer() const;
+	unsigned int getIndexBuffer() const;
+
+	// The vertex and index copies kept after upload, and the buffers they were uploaded to.
+	size_t getCpuBytes() const;
+	size_t getGpuBytes() const;
+
+private:
 	unsigned int vao, vbo, ebo;
 
 	std::vector<Vertex> m_vertices;
@@ -0,0 +1,220 @@
+#include "overlay.h"
+
+#include <cstdio>
+#include <algorithm>
+
+#include <glad/glad.h>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "util/allocation.h"
+
+#define OVERLAY_MARGIN 8.0f
+#define OVERLAY_TEXT_SCALE 0.6f
+#define OVERLAY_HISTOGRAM_WIDTH 40
+
+// Upper bound of each histogram bucket in milliseconds, the last one is open.
+static const float histogramBounds[OVERLAY_HISTOGRAM_BUCKETS - 1] = { 8.0f, 12.0f, 17.0f, 25.0f, 34.0f };
+
+PerformanceOverlay::PerformanceOverlay() :
+	font(nullptr),
+	lines(),
+	cpuTimes(),
+	frameTimes(),
+	sampleCount(0),
+	sampleIndex(0),
+	sinceRefresh(OVERLAY_REFRESH_INTERVAL),
+	gpuTimes(),
+	gpuTotal(0.0),
+	frameAllocations(0),
+	frameAllocationBytes(0),
+	maxFrameAllocations(0),
+	arenaUsed(0),
+	arenaCapacity(0),
+	arenaGrowCount(0)
+{}
+
+PerformanceOverlay::~PerformanceOverlay()
+{
+	for (auto& line : lines)
+	{
+		delete line;
+	}
+}
+
+void PerformanceOverlay::initialize(Font* font)
+{
+	this->font = font;
+	if (font == nullptr)
+		return;
+
+	for (auto& line : lines)
+	{
+		line = new Text("", font, glm::vec3(0.0f));
+		line->setScale(glm::vec3(OVERLAY_TEXT_SCALE, OVERLAY_TEXT_SCALE, 1.0f));
+	}
+}
+
+void PerformanceOverlay::addFrame(float cpuMilliseconds, float frameMilliseconds, const GpuTimer& timer, const RenderStats::Frame& frame)
+{
+	cpuTimes[sampleIndex] = cpuMilliseconds;
+	frameTimes[sampleIndex] = frameMilliseconds;
+	sampleIndex = (sampleIndex + 1) % OVERLAY_FRAME_HISTORY;
+	sampleCount = std::min(sampleCount + 1, (unsigned int)OVERLAY_FRAME_HISTORY);
+
+	for (int pass = 0; pass < static_cast<int>(GpuPass::Count); pass++)
+	{
+		gpuTimes[pass] = timer.getMilliseconds(static_cast<GpuPass>(pass));
+	}
+	gpuTotal = timer.getTotalMilliseconds();
+	stats = frame;
+
+	sinceRefresh += frameMilliseconds / 1000.0f;
+}
+
+void PerformanceOverlay::addAllocations(size_t count, size_t bytes)
+{
+	frameAllocations = count;
+	frameAllocationBytes = bytes;
+	maxFrameAllocations = std::max(maxFrameAllocations, count);
+}
+
+void PerformanceOverlay::setFrameArena(size_t used, size_t capacity, size_t growCount)
+{
+	arenaUsed = used;
+	arenaCapacity = capacity;
+	arenaGrowCount = growCount;
+}
+
+void PerformanceOverlay::setMemory(const MemoryUsage& usage)
+{
+	memory = usage;
+}
+
+void PerformanceOverlay::refresh()
+{
+	if (sampleCount == 0)
+		return;
+
+	float cpuAverage = 0.0f;
+	float frameAverage = 0.0f;
+	float frameMin = frameTimes[0];
+	float frameMax = frameTimes[0];
+	unsigned int histogram[OVERLAY_HISTOGRAM_BUCKETS] = {};
+
+	for (unsigned int i = 0; i < sampleCount; i++)
+	{
+		cpuAverage += cpuTimes[i];
+		frameAverage += frameTimes[i];
+		frameMin = std::min(frameMin, frameTimes[i]);
+		frameMax = std::max(frameMax, frameTimes[i]);
+
+		unsigned int bucket = 0;
+		while (bucket < OVERLAY_HISTOGRAM_BUCKETS - 1 && frameTimes[i] >= histogramBounds[bucket])
+		{
+			bucket++;
+		}
+		histogram[bucket]++;
+	}
+	cpuAverage /= sampleCount;
+	frameAverage /= sampleCount;
+
+	// Waiting on the swap is neither CPU nor GPU work.
+	const char* bound =
+		frameAverage > std::max(cpuAverage, (float)gpuTotal) * 1.5f ? "vsync" :
+		gpuTotal > cpuAverage ? "GPU" :
+		"CPU";
+
+	char line[128];
+	unsigned int index = 0;
+
+	snprintf(line, sizeof(line), "FPS %.1f  Frame %.2f ms  Min %.2f  Max %.2f", frameAverage > 0.0f ? 1000.0f / frameAverage : 0.0f, frameAverage, frameMin, frameMax);
+	lines[index++]->setText(line);
+
+	snprintf(line, sizeof(line), "CPU %.2f ms  GPU %.2f ms  Bound by %s", cpuAverage, gpuTotal, bound);
+	lines[index++]->setText(line);
+
+	snprintf(line, sizeof(line), "GPU  %s %.2f  %s %.2f  %s %.2f  %s %.2f  %s %.2f",
+		GpuTimer::getName(GpuPass::Models), gpuTimes[static_cast<int>(GpuPass::Models)],
+		GpuTimer::getName(GpuPass::Grid), gpuTimes[static_cast<int>(GpuPass::Grid)],
+		GpuTimer::getName(GpuPass::Overlays), gpuTimes[static_cast<int>(GpuPass::Overlays)],
+		GpuTimer::getName(GpuPass::Text), gpuTimes[static_cast<int>(GpuPass::Text)],
+		GpuTimer::getName(GpuPass::Thumbnails), gpuTimes[static_cast<int>(GpuPass::Thumbnails)]);
+	lines[index++]->setText(line);
+
+	snprintf(line, sizeof(line), "Draws %zu  Triangles %zu  Lines %zu  State changes %zu", stats.drawCalls, stats.triangles, stats.lines, stats.stateChanges);
+	lines[index++]->setText(line);
+
+	if (Allocation::isCounting())
+		snprintf(line, sizeof(line), "Heap %zu allocations  %zu bytes  Max %zu per frame", frameAllocations, frameAllocationBytes, maxFrameAllocations);
+	else
+		snprintf(line, sizeof(line), "Heap not tracked (ALLOCATION_TRACKING)");
+	lines[index++]->setText(line);
+	maxFrameAllocations = 0;
+
+	snprintf(line, sizeof(line), "Frame arena %.1f / %.1f KB  Grown %zu times", arenaUsed / 1024.0f, arenaCapacity / 1024.0f, arenaGrowCount);
+	lines[index++]->setText(line);
+
+	const float megabyte = 1024.0f * 1024.0f;
+
+	snprintf(line, sizeof(line), "Memory CPU %.1f MB  GPU %.1f MB  Buffers %.1f  Textures %.1f (%zu)",
+		memory.getCpuBytes() / megabyte, memory.getGpuBytes() / megabyte, memory.gpuBuffers / megabyte, memory.gpuTextures / megabyte, memory.textures);
+	lines[index++]->setText(line);
+
+	snprintf(line, sizeof(line), "Mesh copies %.1f MB (freeable after upload)  Largest load %.1f MB",
+		memory.cpuRetained / megabyte, memory.cpuTransient / megabyte);
+	lines[index++]->setText(line);
+
+	snprintf(line, sizeof(line), "Frame times, last %u frames", sampleCount);
+	lines[index++]->setText(line);
+
+	for (unsigned int bucket = 0; bucket < OVERLAY_HISTOGRAM_BUCKETS; bucket++)
+	{
+		int length = 0;
+		if (bucket < OVERLAY_HISTOGRAM_BUCKETS - 1)
+			length = snprintf(line, sizeof(line), "< %2.0f ms  ", histogramBounds[bucket]);
+		else
+			length = snprintf(line, sizeof(line), "> %2.0f ms  ", histogramBounds[bucket - 1]);
+
+		int bar = static_cast<int>(histogram[bucket] * OVERLAY_HISTOGRAM_WIDTH / sampleCount);
+		if (histogram[bucket] > 0 && bar == 0)
+			bar = 1;
+
+		for (int i = 0; i < bar; i++)
+		{
+			line[length++] = '|';
+		}
+		snprintf(line + length, sizeof(line) - length, " %u", histogram[bucket]);
+
+		lines[index++]->setText(line);
+	}
+}
+
+void PerformanceOverlay::draw(Shader& shader, int width, int height)
+{
+	if (font == nullptr)
+		return;
+
+	if (sinceRefresh >= OVERLAY_REFRESH_INTERVAL)
+	{
+		refresh();
+		sinceRefresh = 0.0f;
+	}
+
+	// Pixel coordinates, origin at the top left, y pointing up like the glyph quads.
+	glm::mat4 projection = glm::ortho(0.0f, (float)width, -(float)height, 0.0f, -1.0f, 1.0f);
+
+	glDisable(GL_DEPTH_TEST);
+
+	shader.bind();
+	shader.setUniformMat4("VPMatrix", projection);
+
+	// Text positions are scaled along with the glyphs.
+	float lineHeight = font->getLineHeight();
+	for (unsigned int i = 0; i < OVERLAY_LINE_COUNT; i++)
+	{
+		lines[i]->setPosition(glm::vec3(OVERLAY_MARGIN / OVERLAY_TEXT_SCALE, -(OVERLAY_MARGIN / OVERLAY_TEXT_SCALE + lineHeight * i), 0.0f));
+		lines[i]->draw(shader);
+	}
+
+	glEnable(GL_DEPTH_TEST);
+}
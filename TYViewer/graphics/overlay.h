@@ -0,0 +1,67 @@
+#pragma once
+
+#include "text.h"
+#include "gputimer.h"
+#include "renderstats.h"
+
+#include "util/font.h"
+
+#include "model.h"
+
+#define OVERLAY_FRAME_HISTORY 240
+#define OVERLAY_HISTOGRAM_BUCKETS 6
+#define OVERLAY_LINE_COUNT (9 + OVERLAY_HISTOGRAM_BUCKETS)
+
+// Seconds between text updates, rebuilding every frame would be unreadable.
+#define OVERLAY_REFRESH_INTERVAL 0.25f
+
+// Frame timings, GPU pass timings and render counters drawn as screen-space text.
+class PerformanceOverlay
+{
+public:
+	PerformanceOverlay();
+	~PerformanceOverlay();
+
+	void initialize(Font* font);
+
+	// 'cpuMilliseconds' is the time spent building the frame, 'frameMilliseconds' includes waiting on the swap.
+	void addFrame(float cpuMilliseconds, float frameMilliseconds, const GpuTimer& timer, const RenderStats::Frame& stats);
+
+	// Heap allocations of the last frame, only known with ALLOCATION_TRACKING.
+	void addAllocations(size_t count, size_t bytes);
+
+	// Renderer frame arena usage and how often it had to grow.
+	void setFrameArena(size_t used, size_t capacity, size_t growCount);
+
+	// Totals of every loaded asset.
+	void setMemory(const MemoryUsage& usage);
+
+	void draw(Shader& shader, int width, int height);
+
+private:
+	void refresh();
+
+	Font* font;
+	Text* lines[OVERLAY_LINE_COUNT];
+
+	float cpuTimes[OVERLAY_FRAME_HISTORY];
+	float frameTimes[OVERLAY_FRAME_HISTORY];
+	unsigned int sampleCount;
+	unsigned int sampleIndex;
+
+	float sinceRefresh;
+
+	double gpuTimes[static_cast<int>(GpuPass::Count)];
+	double gpuTotal;
+	RenderStats::Frame stats;
+
+	size_t frameAllocations;
+	size_t frameAllocationBytes;
+	size_t maxFrameAllocations;
+
+	size_t arenaUsed;
+	size_t arenaCapacity;
+	size_t arenaGrowCount;
+
+	MemoryUsage memory;
+};
@@ -0,0 +1,687 @@
+#include "rasterizer.h"
+
+#include <cmath>
+#include <algorithm>
+
+#include <SOIL2/SOIL2.h>
+
+#include "util/trace.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define RASTERIZER_SSE 1
+#else
+#define RASTERIZER_SSE 0
+#endif
+
+// Triangles with less screen area (in pixels, doubled) are dropped.
+#define RASTERIZER_MIN_AREA 1e-6f
+
+static inline uint32_t packTexel(const unsigned char* rgba)
+{
+	return rgba[0] | (rgba[1] << 8) | (rgba[2] << 16) | (static_cast<uint32_t>(rgba[3]) << 24);
+}
+
+static inline glm::vec4 unpackTexel(uint32_t texel)
+{
+	const float scale = 1.0f / 255.0f;
+	return glm::vec4((texel & 0xFF) * scale, ((texel >> 8) & 0xFF) * scale, ((texel >> 16) & 0xFF) * scale, (texel >> 24) * scale);
+}
+
+static inline int wrap(int value, int size)
+{
+	value %= size;
+	return value < 0 ? value + size : value;
+}
+
+bool SoftwareTexture::load(const std::vector<char>& data)
+{
+	levels.clear();
+	if (data.empty())
+		return false;
+
+	int width = 0;
+	int height = 0;
+	int channels = 0;
+	unsigned char* pixels = SOIL_load_image_from_memory(reinterpret_cast<const unsigned char*>(data.data()), static_cast<int>(data.size()), &width, &height, &channels, SOIL_LOAD_RGBA);
+	if (pixels == nullptr || width <= 0 || height <= 0)
+	{
+		if (pixels != nullptr)
+			SOIL_free_image_data(pixels);
+		return false;
+	}
+
+	levels.emplace_back();
+	levels[0].width = width;
+	levels[0].height = height;
+	levels[0].texels.resize(static_cast<size_t>(width) * height);
+	for (size_t i = 0; i < levels[0].texels.size(); i++)
+	{
+		levels[0].texels[i] = packTexel(&pixels[i * 4]);
+	}
+	SOIL_free_image_data(pixels);
+
+	// Each level averages 2x2 texels of the one above, odd sizes repeat their last row or column.
+	while (levels.back().width > 1 || levels.back().height > 1)
+	{
+		const Level& source = levels.back();
+
+		Level level;
+		level.width = std::max(1, source.width / 2);
+		level.height = std::max(1, source.height / 2);
+		level.texels.resize(static_cast<size_t>(level.width) * level.height);
+
+		for (int y = 0; y < level.height; y++)
+		{
+			int y0 = std::min(y * 2, source.height - 1);
+			int y1 = std::min(y * 2 + 1, source.height - 1);
+
+			for (int x = 0; x < level.width; x++)
+			{
+				int x0 = std::min(x * 2, source.width - 1);
+				int x1 = std::min(x * 2 + 1, source.width - 1);
+
+				uint32_t texels[4] =
+				{
+					source.texels[y0 * source.width + x0],
+					source.texels[y0 * source.width + x1],
+					source.texels[y1 * source.width + x0],
+					source.texels[y1 * source.width + x1]
+				};
+
+				uint32_t average = 0;
+				for (int channel = 0; channel < 32; channel += 8)
+				{
+					uint32_t sum = 2;
+					for (uint32_t texel : texels)
+					{
+						sum += (texel >> channel) & 0xFF;
+					}
+					average |= (sum / 4) << channel;
+				}
+				level.texels[y * level.width + x] = average;
+			}
+		}
+
+		levels.push_back(std::move(level));
+	}
+
+	return true;
+}
+
+const SoftwareTexture::Level& SoftwareTexture::getLevel(int level) const
+{
+	return levels[level];
+}
+
+int SoftwareTexture::getLevels() const
+{
+	return static_cast<int>(levels.size());
+}
+
+size_t SoftwareTexture::getBytes() const
+{
+	size_t bytes = sizeof(SoftwareTexture);
+	for (auto& level : levels)
+	{
+		bytes += level.texels.capacity() * sizeof(uint32_t);
+	}
+	return bytes;
+}
+
+SoftwareRasterizer::SoftwareRasterizer(int width, int height, unsigned int threads) :
+	width(width),
+	height(height),
+	tilesX((width + RASTERIZER_TILE_SIZE - 1) / RASTERIZER_TILE_SIZE),
+	tilesY((height + RASTERIZER_TILE_SIZE - 1) / RASTERIZER_TILE_SIZE),
+	// Padded so 4 wide loads at the end of the last row stay inside.
+	colour(static_cast<size_t>(width) * height * 4, 0.0f),
+	depth(static_cast<size_t>(width) * height + 4, 1.0f),
+	clearColour(0.0f, 0.0f, 0.0f, 1.0f),
+	pendingClear(true),
+	bins(static_cast<size_t>(tilesX) * tilesY),
+	generation(0),
+	busy(0),
+	stopping(false),
+	nextTile(0)
+{
+	if (threads == 0)
+		threads = std::max(1u, std::thread::hardware_concurrency());
+
+	// The thread calling finish() works too.
+	for (unsigned int i = 1; i < threads; i++)
+	{
+		workers.emplace_back(&SoftwareRasterizer::workerLoop, this);
+	}
+}
+
+SoftwareRasterizer::~SoftwareRasterizer()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+	}
+	wake.notify_all();
+
+	for (auto& thread : workers)
+	{
+		thread.join();
+	}
+}
+
+void SoftwareRasterizer::clear(const glm::vec4& colour)
+{
+	clearColour = colour;
+	pendingClear = true;
+
+	triangles.clear();
+	for (auto& bin : bins)
+	{
+		bin.clear();
+	}
+
+	stats = RasterizerStats();
+}
+
+void SoftwareRasterizer::draw(const Vertex* vertices, size_t vertexCount, const unsigned int* indices, size_t indexCount,
+	const SoftwareTexture* texture, const glm::mat4& matrix, const glm::vec4& tint)
+{
+	TRACE_ZONE("SoftwareRasterizer::draw");
+
+	clipVertices.resize(vertexCount);
+	for (size_t i = 0; i < vertexCount; i++)
+	{
+		glm::vec4 position = vertices[i].position;
+		position.w = 1.0f;
+
+		clipVertices[i].position = matrix * position;
+		clipVertices[i].texcoord = vertices[i].texcoord;
+	}
+
+	for (size_t i = 0; i + 2 < indexCount; i += 3)
+	{
+		stats.triangles++;
+
+		if (indices[i] >= vertexCount || indices[i + 1] >= vertexCount || indices[i + 2] >= vertexCount)
+		{
+			stats.culled++;
+			continue;
+		}
+
+		ClipVertex triangle[3] = { clipVertices[indices[i]], clipVertices[indices[i + 1]], clipVertices[indices[i + 2]] };
+		clipTriangle(triangle, texture, tint);
+	}
+}
+
+void SoftwareRasterizer::clipTriangle(const ClipVertex* vertices, const SoftwareTexture* texture, const glm::vec4& tint)
+{
+	// Entirely outside one of the frustum planes.
+	for (int axis = 0; axis < 3; axis++)
+	{
+		bool outsideMin = axis < 2;
+		bool outsideMax = true;
+		for (int i = 0; i < 3; i++)
+		{
+			const glm::vec4& p = vertices[i].position;
+			outsideMin &= p[axis] < -p.w;
+			outsideMax &= p[axis] > p.w;
+		}
+
+		if (outsideMin || outsideMax)
+		{
+			stats.culled++;
+			return;
+		}
+	}
+
+	float distance[3];
+	bool inside = true;
+	for (int i = 0; i < 3; i++)
+	{
+		distance[i] = vertices[i].position.z + vertices[i].position.w;
+		inside &= distance[i] >= 0.0f;
+	}
+
+	if (inside)
+	{
+		setupTriangle(vertices[0], vertices[1], vertices[2], texture, tint);
+		return;
+	}
+
+	// Crosses the near plane, what is left of the triangle is a triangle or a quad.
+	ClipVertex polygon[4];
+	int count = 0;
+	for (int i = 0; i < 3; i++)
+	{
+		int j = (i + 1) % 3;
+
+		if (distance[i] >= 0.0f)
+			polygon[count++] = vertices[i];
+
+		if ((distance[i] >= 0.0f) != (distance[j] >= 0.0f))
+		{
+			float t = distance[i] / (distance[i] - distance[j]);
+			polygon[count].position = vertices[i].position + (vertices[j].position - vertices[i].position) * t;
+			polygon[count].texcoord = vertices[i].texcoord + (vertices[j].texcoord - vertices[i].texcoord) * t;
+			count++;
+		}
+	}
+
+	if (count < 3)
+	{
+		stats.culled++;
+		return;
+	}
+
+	setupTriangle(polygon[0], polygon[1], polygon[2], texture, tint);
+	if (count == 4)
+	{
+		stats.clipped++;
+		setupTriangle(polygon[0], polygon[2], polygon[3], texture, tint);
+	}
+}
+
+void SoftwareRasterizer::setupTriangle(const ClipVertex& a, const ClipVertex& b, const ClipVertex& c, const SoftwareTexture* texture, const glm::vec4& tint)
+{
+	const ClipVertex* vertices[3] = { &a, &b, &c };
+
+	float x[3];
+	float y[3];
+	float z[3];
+	float w[3];
+	for (int i = 0; i < 3; i++)
+	{
+		const glm::vec4& p = vertices[i]->position;
+		if (!(p.w > 0.0f))
+		{
+			stats.culled++;
+			return;
+		}
+
+		w[i] = 1.0f / p.w;
+		x[i] = (p.x * w[i] * 0.5f + 0.5f) * width;
+		y[i] = (0.5f - p.y * w[i] * 0.5f) * height;
+		z[i] = p.z * w[i] * 0.5f + 0.5f;
+	}
+
+	float area = (x[1] - x[0]) * (y[2] - y[0]) - (x[2] - x[0]) * (y[1] - y[0]);
+	if (!(std::fabs(area) > RASTERIZER_MIN_AREA))
+	{
+		stats.culled++;
+		return;
+	}
+
+	// Pixel centres inside the bounds, clamped in float first so huge coordinates can't overflow.
+	float minX = std::max(std::min({ x[0], x[1], x[2] }) - 0.5f, 0.0f);
+	float minY = std::max(std::min({ y[0], y[1], y[2] }) - 0.5f, 0.0f);
+	float maxX = std::min(std::max({ x[0], x[1], x[2] }) - 0.5f, static_cast<float>(width - 1));
+	float maxY = std::min(std::max({ y[0], y[1], y[2] }) - 0.5f, static_cast<float>(height - 1));
+
+	Triangle triangle;
+	triangle.minX = static_cast<int>(std::ceil(minX));
+	triangle.minY = static_cast<int>(std::ceil(minY));
+	triangle.maxX = static_cast<int>(std::floor(maxX));
+	triangle.maxY = static_cast<int>(std::floor(maxY));
+
+	if (triangle.minX > triangle.maxX || triangle.minY > triangle.maxY)
+	{
+		stats.culled++;
+		return;
+	}
+
+	// Both windings are drawn, like the viewer which doesn't cull.
+	float sign = area > 0.0f ? 1.0f : -1.0f;
+	for (int edge = 0; edge < 3; edge++)
+	{
+		int i = edge;
+		int j = (edge + 1) % 3;
+
+		triangle.edgeA[edge] = (y[i] - y[j]) * sign;
+		triangle.edgeB[edge] = (x[j] - x[i]) * sign;
+		triangle.edgeC[edge] = (x[i] * y[j] - y[i] * x[j]) * sign;
+		triangle.inclusive[edge] = triangle.edgeA[edge] > 0.0f || (triangle.edgeA[edge] == 0.0f && triangle.edgeB[edge] > 0.0f);
+	}
+
+	auto makePlane = [&](float v0, float v1, float v2)
+	{
+		Plane plane;
+		plane.dx = ((v1 - v0) * (y[2] - y[0]) - (v2 - v0) * (y[1] - y[0])) / area;
+		plane.dy = ((v2 - v0) * (x[1] - x[0]) - (v1 - v0) * (x[2] - x[0])) / area;
+		plane.c = v0 - plane.dx * x[0] - plane.dy * y[0];
+		return plane;
+	};
+
+	// Attributes divided by w interpolate linearly on screen, divided back per pixel.
+	triangle.depth = makePlane(z[0], z[1], z[2]);
+	triangle.inverseW = makePlane(w[0], w[1], w[2]);
+	triangle.u = makePlane(a.texcoord.x * w[0], b.texcoord.x * w[1], c.texcoord.x * w[2]);
+	triangle.v = makePlane(a.texcoord.y * w[0], b.texcoord.y * w[1], c.texcoord.y * w[2]);
+
+	triangle.texture = texture;
+	triangle.tint = tint;
+	triangle.level = 0;
+
+	// One mip level per triangle, picked by texels per pixel. Close enough for thumbnails.
+	if (texture != nullptr)
+	{
+		const SoftwareTexture::Level& top = texture->getLevel(0);
+		float uvArea = (b.texcoord.x - a.texcoord.x) * (c.texcoord.y - a.texcoord.y) - (c.texcoord.x - a.texcoord.x) * (b.texcoord.y - a.texcoord.y);
+		float texels = std::fabs(uvArea) * top.width * top.height;
+
+		if (texels > 0.0f)
+		{
+			float lod = 0.5f * std::log2(texels / std::fabs(area));
+			triangle.level = std::min(std::max(static_cast<int>(std::floor(lod + 0.5f)), 0), texture->getLevels() - 1);
+		}
+	}
+
+	uint32_t index = static_cast<uint32_t>(triangles.size());
+	triangles.push_back(triangle);
+
+	for (int tileY = triangle.minY / RASTERIZER_TILE_SIZE; tileY <= triangle.maxY / RASTERIZER_TILE_SIZE; tileY++)
+	{
+		for (int tileX = triangle.minX / RASTERIZER_TILE_SIZE; tileX <= triangle.maxX / RASTERIZER_TILE_SIZE; tileX++)
+		{
+			bins[tileY * tilesX + tileX].push_back(index);
+			stats.binned++;
+		}
+	}
+}
+
+void SoftwareRasterizer::finish()
+{
+	TRACE_ZONE("SoftwareRasterizer::finish");
+
+	nextTile = 0;
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		generation++;
+		busy = static_cast<unsigned int>(workers.size());
+	}
+	wake.notify_all();
+
+	rasterizeTiles();
+
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		done.wait(lock, [this]() { return busy == 0; });
+	}
+
+	// Keeps the capacity, later images don't allocate.
+	triangles.clear();
+	for (auto& bin : bins)
+	{
+		bin.clear();
+	}
+	pendingClear = false;
+}
+
+void SoftwareRasterizer::workerLoop()
+{
+	Trace::setThreadName("Rasterizer");
+
+	unsigned int seen = 0;
+	while (true)
+	{
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			wake.wait(lock, [&]() { return stopping || generation != seen; });
+			if (stopping)
+				return;
+			seen = generation;
+		}
+
+		rasterizeTiles();
+
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			if (--busy == 0)
+				done.notify_one();
+		}
+	}
+}
+
+void SoftwareRasterizer::rasterizeTiles()
+{
+	for (size_t tile = nextTile++; tile < bins.size(); tile = nextTile++)
+	{
+		rasterizeTile(tile);
+	}
+}
+
+void SoftwareRasterizer::rasterizeTile(size_t tile)
+{
+	const std::vector<uint32_t>& bin = bins[tile];
+	if (bin.empty() && !pendingClear)
+		return;
+
+	int tileX = static_cast<int>(tile % tilesX) * RASTERIZER_TILE_SIZE;
+	int tileY = static_cast<int>(tile / tilesX) * RASTERIZER_TILE_SIZE;
+	int tileEndX = std::min(tileX + RASTERIZER_TILE_SIZE, width) - 1;
+	int tileEndY = std::min(tileY + RASTERIZER_TILE_SIZE, height) - 1;
+
+	if (pendingClear)
+	{
+		for (int y = tileY; y <= tileEndY; y++)
+		{
+			for (int x = tileX; x <= tileEndX; x++)
+			{
+				size_t pixel = static_cast<size_t>(y) * width + x;
+				colour[pixel * 4 + 0] = clearColour.x;
+				colour[pixel * 4 + 1] = clearColour.y;
+				colour[pixel * 4 + 2] = clearColour.z;
+				colour[pixel * 4 + 3] = clearColour.w;
+				depth[pixel] = 1.0f;
+			}
+		}
+	}
+
+	// In the order they were drawn, blending depends on it.
+	for (uint32_t index : bin)
+	{
+		rasterizeTriangle(triangles[index], tileX, tileY, tileEndX, tileEndY);
+	}
+}
+
+void SoftwareRasterizer::rasterizeTriangle(const Triangle& triangle, int tileX, int tileY, int tileEndX, int tileEndY)
+{
+	int minX = std::max(triangle.minX, tileX);
+	int minY = std::max(triangle.minY, tileY);
+	int maxX = std::min(triangle.maxX, tileEndX);
+	int maxY = std::min(triangle.maxY, tileEndY);
+
+	// Groups of 4 start at multiples of 4, tiles are aligned to them.
+	int startX = minX & ~3;
+
+	// Edge values are computed the same way in every triangle, A * x + (B * y + C), so the two
+	// triangles of a shared edge get exactly opposite values and the fill rule leaves no gaps.
+#if RASTERIZER_SSE
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 centres = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+
+	__m128 edgeA[3];
+	for (int edge = 0; edge < 3; edge++)
+	{
+		edgeA[edge] = _mm_set1_ps(triangle.edgeA[edge]);
+	}
+	const __m128 depthDx = _mm_set1_ps(triangle.depth.dx);
+
+	for (int y = minY; y <= maxY; y++)
+	{
+		float centreY = y + 0.5f;
+
+		__m128 rowEdge[3];
+		for (int edge = 0; edge < 3; edge++)
+		{
+			rowEdge[edge] = _mm_set1_ps(triangle.edgeB[edge] * centreY + triangle.edgeC[edge]);
+		}
+		__m128 rowDepth = _mm_set1_ps(triangle.depth.dy * centreY + triangle.depth.c);
+
+		float* depthRow = &depth[static_cast<size_t>(y) * width];
+
+		for (int x = startX; x <= maxX; x += 4)
+		{
+			// Lanes left of the bounds or right of them.
+			int mask = 0xF;
+			if (x < minX)
+				mask &= 0xF << (minX - x);
+			if (x + 3 > maxX)
+				mask &= 0xF >> (x + 3 - maxX);
+
+			__m128 centreX = _mm_add_ps(_mm_set1_ps(static_cast<float>(x)), centres);
+
+			for (int edge = 0; edge < 3 && mask != 0; edge++)
+			{
+				__m128 value = _mm_add_ps(_mm_mul_ps(edgeA[edge], centreX), rowEdge[edge]);
+				__m128 inside = triangle.inclusive[edge] ? _mm_cmpge_ps(value, zero) : _mm_cmpgt_ps(value, zero);
+				mask &= _mm_movemask_ps(inside);
+			}
+
+			if (mask == 0)
+				continue;
+
+			__m128 z = _mm_add_ps(_mm_mul_ps(depthDx, centreX), rowDepth);
+			mask &= _mm_movemask_ps(_mm_cmplt_ps(z, _mm_loadu_ps(depthRow + x)));
+
+			if (mask == 0)
+				continue;
+
+			float depths[4];
+			_mm_storeu_ps(depths, z);
+			for (int lane = 0; lane < 4; lane++)
+			{
+				if (mask & (1 << lane))
+					shade(triangle, x + lane, y, depths[lane]);
+			}
+		}
+	}
+#else
+	for (int y = minY; y <= maxY; y++)
+	{
+		float centreY = y + 0.5f;
+
+		float rowEdge[3];
+		for (int edge = 0; edge < 3; edge++)
+		{
+			rowEdge[edge] = triangle.edgeB[edge] * centreY + triangle.edgeC[edge];
+		}
+		float rowDepth = triangle.depth.dy * centreY + triangle.depth.c;
+
+		float* depthRow = &depth[static_cast<size_t>(y) * width];
+
+		for (int x = minX; x <= maxX; x++)
+		{
+			float centreX = x + 0.5f;
+
+			bool inside = true;
+			for (int edge = 0; edge < 3 && inside; edge++)
+			{
+				float value = triangle.edgeA[edge] * centreX + rowEdge[edge];
+				inside = triangle.inclusive[edge] ? value >= 0.0f : value > 0.0f;
+			}
+
+			if (!inside)
+				continue;
+
+			float z = triangle.depth.dx * centreX + rowDepth;
+			if (z < depthRow[x])
+				shade(triangle, x, y, z);
+		}
+	}
+#endif
+}
+
+void SoftwareRasterizer::shade(const Triangle& triangle, int x, int y, float z)
+{
+	float centreX = x + 0.5f;
+	float centreY = y + 0.5f;
+
+	float w = 1.0f / (triangle.inverseW.dx * centreX + triangle.inverseW.dy * centreY + triangle.inverseW.c);
+	float u = (triangle.u.dx * centreX + triangle.u.dy * centreY + triangle.u.c) * w;
+	float v = (triangle.v.dx * centreX + triangle.v.dy * centreY + triangle.v.c) * w;
+
+	glm::vec4 source = sample(triangle.texture, triangle.level, u, v) * triangle.tint;
+
+	// Fully transparent texels would only write depth and hide what is drawn behind them later.
+	if (source.w <= 0.0f)
+		return;
+
+	size_t pixel = static_cast<size_t>(y) * width + x;
+	float* destination = &colour[pixel * 4];
+	for (int channel = 0; channel < 4; channel++)
+	{
+		destination[channel] = source[channel] * source.w + destination[channel] * (1.0f - source.w);
+	}
+	depth[pixel] = z;
+}
+
+glm::vec4 SoftwareRasterizer::sample(const SoftwareTexture* texture, int level, float u, float v)
+{
+	if (texture == nullptr)
+		return glm::vec4(1.0f);
+
+	const SoftwareTexture::Level& image = texture->getLevel(level);
+
+	// Repeat, wrapped before scaling so large coordinates keep their precision.
+	u -= std::floor(u);
+	v -= std::floor(v);
+
+	// Texture coordinates start at the bottom, like the textures the viewer loads flipped.
+	float x = u * image.width - 0.5f;
+	float y = (1.0f - v) * image.height - 0.5f;
+
+	float left = std::floor(x);
+	float above = std::floor(y);
+	float fx = x - left;
+	float fy = y - above;
+
+	int x0 = wrap(static_cast<int>(left), image.width);
+	int y0 = wrap(static_cast<int>(above), image.height);
+	int x1 = wrap(x0 + 1, image.width);
+	int y1 = wrap(y0 + 1, image.height);
+
+	glm::vec4 a = unpackTexel(image.texels[y0 * image.width + x0]);
+	glm::vec4 b = unpackTexel(image.texels[y0 * image.width + x1]);
+	glm::vec4 c = unpackTexel(image.texels[y1 * image.width + x0]);
+	glm::vec4 d = unpackTexel(image.texels[y1 * image.width + x1]);
+
+	glm::vec4 top = a + (b - a) * fx;
+	glm::vec4 bottom = c + (d - c) * fx;
+	return top + (bottom - top) * fy;
+}
+
+void SoftwareRasterizer::read(std::vector<unsigned char>& pixels) const
+{
+	size_t count = static_cast<size_t>(width) * height;
+	pixels.resize(count * 4);
+
+	for (size_t i = 0; i < count; i++)
+	{
+		for (int channel = 0; channel < 3; channel++)
+		{
+			float value = std::min(std::max(colour[i * 4 + channel], 0.0f), 1.0f);
+			pixels[i * 4 + channel] = static_cast<unsigned char>(value * 255.0f + 0.5f);
+		}
+		pixels[i * 4 + 3] = 255;
+	}
+}
+
+int SoftwareRasterizer::getWidth() const
+{
+	return width;
+}
+
+int SoftwareRasterizer::getHeight() const
+{
+	return height;
+}
+
+unsigned int SoftwareRasterizer::getThreads() const
+{
+	return static_cast<unsigned int>(workers.size()) + 1;
+}
+
+const RasterizerStats& SoftwareRasterizer::getStats() const
+{
+	return stats;
+}
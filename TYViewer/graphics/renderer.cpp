@@ -1,37 +1,92 @@
 #include "renderer.h"
 
-#include "vertex.h"
+#include <new>
+
+#include "renderstats.h"
 
 #define _USE_MATH_DEFINES
 #include <math.h>
 
-Renderer::Renderer()
+Renderer::Renderer() :
+	frameAllocator(),
+	vao(0),
+	vbo(0),
+	ebo(0)
 {}
 
+Renderer::~Renderer()
+{
+	glDeleteVertexArrays(1, &vao);
+	glDeleteBuffers(1, &vbo);
+	glDeleteBuffers(1, &ebo);
+}
+
 void Renderer::initialize()
 {
 	glEnable(GL_DEPTH_TEST);
 
 	glEnable(GL_BLEND);
 	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+	glGenVertexArrays(1, &vao);
+	glGenBuffers(1, &vbo);
+	glGenBuffers(1, &ebo);
+
+	glBindVertexArray(vao);
+
+	glBindBuffer(GL_ARRAY_BUFFER, vbo);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
+
+	glEnableVertexAttribArray(0);
+	glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, sizeof(Vertex), (const void*)offsetof(Vertex, position));
+
+	glEnableVertexAttribArray(1);
+	glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(Vertex), (const void*)offsetof(Vertex, normal));
+
+	glEnableVertexAttribArray(2);
+	glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, sizeof(Vertex), (const void*)offsetof(Vertex, colour));
+
+	glEnableVertexAttribArray(3);
+	glVertexAttribPointer(3, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (const void*)offsetof(Vertex, texcoord));
+
+	glEnableVertexAttribArray(4);
+	glVertexAttribPointer(4, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (const void*)offsetof(Vertex, skin));
+
+	glBindVertexArray(0);
 }
 
-void Renderer::drawHollowBox(const glm::vec3& min, const glm::vec3& max, const glm::vec4& colour)
+void Renderer::beginFrame()
 {
-	std::vector<Vertex> vertices =
-	{
-		Vertex(glm::vec4(min.x,			min.y, min.z,			1), colour),
-		Vertex(glm::vec4(min.x,			min.y, min.z + max.z,	1), colour),
-		Vertex(glm::vec4(min.x + max.x, min.y, min.z + max.z,	1), colour),
-		Vertex(glm::vec4(min.x + max.x, min.y, min.z,			1), colour),
-											
-		Vertex(glm::vec4(min.x,			min.y + max.y, min.z,			1), colour),
-		Vertex(glm::vec4(min.x,			min.y + max.y, min.z + max.z,	1), colour),
-		Vertex(glm::vec4(min.x + max.x, min.y + max.y, min.z + max.z,	1), colour),
-		Vertex(glm::vec4(min.x + max.x, min.y + max.y, min.z,			1), colour)
-	};
+	frameAllocator.beginFrame();
+}
+
+FrameAllocator& Renderer::getFrameAllocator()
+{
+	return frameAllocator;
+}
+
+void Renderer::drawImmediate(GLenum mode, const Vertex* vertices, size_t vertexCount, const unsigned int* indices, size_t indexCount)
+{
+	glBindVertexArray(vao);
+
+	// Orphan the previous contents so the driver doesn't wait on draws still using them.
+	glBindBuffer(GL_ARRAY_BUFFER, vbo);
+	glBufferData(GL_ARRAY_BUFFER, vertexCount * sizeof(Vertex), vertices, GL_STREAM_DRAW);
 
-	std::vector<unsigned int> indices =
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, indexCount * sizeof(unsigned int), indices, GL_STREAM_DRAW);
+
+	glDrawElements(mode, static_cast<GLsizei>(indexCount), GL_UNSIGNED_INT, 0);
+
+	glBindVertexArray(0);
+
+	RenderStats::countStateChange();
+	RenderStats::countDraw(mode == GL_TRIANGLES ? indexCount / 3 : 0, mode == GL_LINES ? indexCount / 2 : 0);
+}
+
+void Renderer::drawHollowBox(const glm::vec3& min, const glm::vec3& max, const glm::vec4& colour)
+{
+	static const unsigned int indices[24] =
 	{
 		0, 1,
 		1, 2,
@@ -49,122 +104,84 @@ void Renderer::drawHollowBox(const glm::vec3& min, const glm::vec3& max, const g
 		7, 4
 	};
 
-	unsigned int vao, vbo, ebo;
+	Vertex* vertices = frameAllocator.allocate<Vertex>(8);
 
-	glGenVertexArrays(1, &vao);
-	glGenBuffers(1, &vbo);
-	glGenBuffers(1, &ebo);
+	new (&vertices[0]) Vertex(glm::vec4(min.x,			min.y, min.z,			1), colour);
+	new (&vertices[1]) Vertex(glm::vec4(min.x,			min.y, min.z + max.z,	1), colour);
+	new (&vertices[2]) Vertex(glm::vec4(min.x + max.x,	min.y, min.z + max.z,	1), colour);
+	new (&vertices[3]) Vertex(glm::vec4(min.x + max.x,	min.y, min.z,			1), colour);
 
-	glBindVertexArray(vao);
-
-	glBindBuffer(GL_ARRAY_BUFFER, vbo);
-	glBufferData(GL_ARRAY_BUFFER, 8 * sizeof(Vertex), &vertices[0], GL_STATIC_DRAW);
+	new (&vertices[4]) Vertex(glm::vec4(min.x,			min.y + max.y, min.z,			1), colour);
+	new (&vertices[5]) Vertex(glm::vec4(min.x,			min.y + max.y, min.z + max.z,	1), colour);
+	new (&vertices[6]) Vertex(glm::vec4(min.x + max.x,	min.y + max.y, min.z + max.z,	1), colour);
+	new (&vertices[7]) Vertex(glm::vec4(min.x + max.x,	min.y + max.y, min.z,			1), colour);
 
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, 24 * sizeof(unsigned int), &indices[0], GL_STATIC_DRAW);
-
-	glEnableVertexAttribArray(0);
-	glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, sizeof(Vertex), (const void*)offsetof(Vertex, position));
-
-	glEnableVertexAttribArray(1);
-	glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(Vertex), (const void*)offsetof(Vertex, normal));
-
-	glEnableVertexAttribArray(2);
-	glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, sizeof(Vertex), (const void*)offsetof(Vertex, colour));
+	drawImmediate(GL_LINES, vertices, 8, indices, 24);
+}
 
-	glEnableVertexAttribArray(3);
-	glVertexAttribPointer(3, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (const void*)offsetof(Vertex, texcoord));
+void Renderer::drawTriangle(const glm::vec3& a, const glm::vec3& b, const glm::vec3& c, const glm::vec4& colour)
+{
+	static const unsigned int indices[6] =
+	{
+		0, 1,
+		1, 2,
+		2, 0
+	};
 
-	glEnableVertexAttribArray(4);
-	glVertexAttribPointer(4, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (const void*)offsetof(Vertex, skin));
+	Vertex* vertices = frameAllocator.allocate<Vertex>(3);
 
-	glDrawElements(GL_LINES, 24, GL_UNSIGNED_INT, 0);
+	new (&vertices[0]) Vertex(glm::vec4(a, 1), colour);
+	new (&vertices[1]) Vertex(glm::vec4(b, 1), colour);
+	new (&vertices[2]) Vertex(glm::vec4(c, 1), colour);
 
-	glDeleteVertexArrays(1, &vao);
-	glDeleteBuffers(1, &vbo);
-	glDeleteBuffers(1, &ebo);
+	drawImmediate(GL_LINES, vertices, 3, indices, 6);
 }
 
 void Renderer::drawSphere(const glm::vec3& p, float r, const glm::vec4& colour, int quality)
 {
-	std::vector<Vertex> vertices;
-	std::vector<unsigned int> indices;
+	const unsigned int vertexCount = quality * 3;
+
+	Vertex* vertices = frameAllocator.allocate<Vertex>(vertexCount);
+	unsigned int* indices = frameAllocator.allocate<unsigned int>(vertexCount * 2);
 
-	for (unsigned int i = 0; i < quality * 3; i++)
+	for (unsigned int i = 0; i < vertexCount; i++)
 	{
 		float f = ((float)(i % quality) / (float)quality) * M_PI * 2;
 
-		//vertices.push_back({ glm::vec3(std::cos(f), std::sin(f), 0.0f) * r, colour });
-
 		if (i < quality)
-			vertices.push_back(Vertex(
+			new (&vertices[i]) Vertex(
 				glm::vec4(
 					p.x + std::cos(f) * r, 
 					p.y + std::sin(f) * r, 
 					p.z + 0.0f, 
 					1.0f), 
-				colour));
+				colour);
 		else if (i >= quality && i < quality * 2)
-			vertices.push_back(Vertex(
+			new (&vertices[i]) Vertex(
 				glm::vec4(
 					p.x + std::cos(f) * r, 
 					p.y + 0.0f, 
 					p.z + std::sin(f) * r, 
 					1.0f), 
-				colour));
+				colour);
 		else
-			vertices.push_back(Vertex(
+			new (&vertices[i]) Vertex(
 				glm::vec4(
 					p.x + 0.0f, 
 					p.y + std::cos(f) * r, 
 					p.z + std::sin(f) * r, 
 					1.0f), 
-				colour));
+				colour);
 
 
-		indices.push_back(i);
+		indices[i * 2] = i;
 		if ((i + 1) % quality == 0)
-			indices.push_back((i + 1) - quality);
+			indices[i * 2 + 1] = (i + 1) - quality;
 		else
-			indices.push_back(i + 1);
+			indices[i * 2 + 1] = i + 1;
 	}
 
-
-	unsigned int vao, vbo, ebo;
-
-	glGenVertexArrays(1, &vao);
-	glGenBuffers(1, &vbo);
-	glGenBuffers(1, &ebo);
-
-	glBindVertexArray(vao);
-
-	glBindBuffer(GL_ARRAY_BUFFER, vbo);
-	glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(Vertex), &vertices[0], GL_STATIC_DRAW);
-
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), &indices[0], GL_STATIC_DRAW);
-
-	glEnableVertexAttribArray(0);
-	glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, sizeof(Vertex), (const void*)offsetof(Vertex, position));
-
-	glEnableVertexAttribArray(1);
-	glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(Vertex), (const void*)offsetof(Vertex, normal));
-
-	glEnableVertexAttribArray(2);
-	glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, sizeof(Vertex), (const void*)offsetof(Vertex, colour));
-
-	glEnableVertexAttribArray(3);
-	glVertexAttribPointer(3, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (const void*)offsetof(Vertex, texcoord));
-
-	glEnableVertexAttribArray(4);
-	glVertexAttribPointer(4, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (const void*)offsetof(Vertex, skin));
-
-	glDrawElements(GL_LINES, indices.size(), GL_UNSIGNED_INT, 0);
-
-
-	glDeleteVertexArrays(1, &vao);
-	glDeleteBuffers(1, &vbo);
-	glDeleteBuffers(1, &ebo);
+	drawImmediate(GL_LINES, vertices, vertexCount, indices, vertexCount * 2);
 }
 
 void Renderer::clear(const glm::vec4& colour)
@@ -4,18 +4,37 @@
 #include <GLFW/glfw3.h>
 
 #include "drawable.h"
+#include "vertex.h"
+
+#include "util/framealloc.h"
 
 class Renderer
 {
 public:
 	Renderer();
+	~Renderer();
 
 	void initialize();
 
+	// Resets the transient per-frame memory, call once before drawing anything.
+	void beginFrame();
+
 	void drawHollowBox(const glm::vec3& min, const glm::vec3& max, const glm::vec4& colour);
 	void drawSphere(const glm::vec3& p, float r, const glm::vec4& colour, int quality = 16);
+	// Outline only.
+	void drawTriangle(const glm::vec3& a, const glm::vec3& b, const glm::vec3& c, const glm::vec4& colour);
 
 	void clear(const glm::vec4& colour = glm::vec4(0.2f, 0.2f, 0.2f, 1.0f));
 	void draw(const Drawable& drawable, Shader& shader);
 	void render(GLFWwindow* window);
-};
\ No newline at end of file
+
+	FrameAllocator& getFrameAllocator();
+
+private:
+	// Streams transient geometry through one shared set of buffers.
+	void drawImmediate(GLenum mode, const Vertex* vertices, size_t vertexCount, const unsigned int* indices, size_t indexCount);
+
+	FrameAllocator frameAllocator;
+
+	unsigned int vao, vbo, ebo;
+};
@@ -0,0 +1,20 @@
+#include "renderstats.h"
+
+RenderStats::Frame RenderStats::current;
+RenderStats::Frame RenderStats::last;
+
+void RenderStats::endFrame()
+{
+	last = current;
+	current = Frame();
+}
+
+const RenderStats::Frame& RenderStats::getCurrentFrame()
+{
+	return current;
+}
+
+const RenderStats::Frame& RenderStats::getLastFrame()
+{
+	return last;
+}
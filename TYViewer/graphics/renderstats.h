@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstddef>
+
+// Per-frame counters of the work submitted to OpenGL.
+// Only touched from the render thread.
+class RenderStats
+{
+public:
+	struct Frame
+	{
+		size_t drawCalls = 0;
+		size_t triangles = 0;
+		size_t lines = 0;
+
+		// Program, texture and vertex array binds.
+		size_t stateChanges = 0;
+	};
+
+	static inline void countDraw(size_t triangles, size_t lines = 0)
+	{
+		current.drawCalls++;
+		current.triangles += triangles;
+		current.lines += lines;
+	}
+	static inline void countStateChange()
+	{
+		current.stateChanges++;
+	}
+
+	// Call once per frame, makes the finished frame available through getLastFrame().
+	static void endFrame();
+
+	static const Frame& getCurrentFrame();
+	static const Frame& getLastFrame();
+
+private:
+	static Frame current;
+	static Frame last;
+};
@@ -14,6 +14,9 @@
 
 #include "util/parser.h"
 
+#include "renderstats.h"
+#include "util/trace.h"
+
 #include "application.h"
 
 Shader::Shader(std::ifstream& stream, const std::unordered_map<std::string, int>& properties)
@@ -41,6 +44,8 @@ Shader::~Shader()
 
 unsigned int Shader::create(const std::string& vertexShader, const std::string& fragmentShader)
 {
+	TRACE_ZONE("Shader::create");
+
 	unsigned int program = glCreateProgram();
 	unsigned int vs = compile(GL_VERTEX_SHADER, vertexShader);
 	unsigned int fs = compile(GL_FRAGMENT_SHADER, fragmentShader);
@@ -83,6 +88,7 @@ unsigned Shader::compile(unsigned int type, const std::string& source)
 void Shader::bind() const
 {
 	glUseProgram(m_id);
+	RenderStats::countStateChange();
 }
 void Shader::unbind() const
 {
@@ -114,6 +120,28 @@ int Shader::getUniformLocation(const std::string& name)
 	return location;
 }
 
+// Basic fragment shader with texture support, shared by the built-in variants.
+static const std::string defaultFragmentShader = R"(
+	#version 330 core
+	in vec4 v_colour;
+	in vec2 v_texcoord;
+
+	uniform sampler2D diffuseTexture;
+	uniform vec4 tintColour;
+
+	out vec4 color;
+
+	void main()
+	{
+		vec4 texColor = texture(diffuseTexture, v_texcoord);
+		color = texColor * v_colour * tintColour;
+		if (color.a <= 0.01)
+		{
+			discard;
+		}
+	}
+)";
+
 Shader* Shader::createDefault()
 {
 	// Basic vertex shader
@@ -139,27 +167,58 @@ Shader* Shader::createDefault()
 		}
 	)";
 
-	// Basic fragment shader with texture support
-	const std::string fragmentShader = R"(
+	return new Shader(vertexShader, defaultFragmentShader);
+}
+
+Shader* Shader::createSkinned()
+{
+	// The default vertex shader with two bone skinning, bones are read from a BonePaletteBuffer.
+	const std::string vertexShader = R"(
 		#version 330 core
-		in vec4 v_colour;
-		in vec2 v_texcoord;
+		layout(location = 0) in vec4 position;
+		layout(location = 1) in vec4 normal;
+		layout(location = 2) in vec4 colour;
+		layout(location = 3) in vec2 texcoord;
+		layout(location = 4) in vec3 skin;
+
+		uniform mat4 VPMatrix;
+		uniform mat4 modelMatrix;
 
-		uniform sampler2D diffuseTexture;
-		uniform vec4 tintColour;
+		uniform samplerBuffer bonePalette;
+		uniform int paletteOffset;
+		uniform int boneCount;
+
+		out vec4 v_colour;
+		out vec2 v_texcoord;
 
-		out vec4 color;
+		// First of the bone's BONE_PALETTE_TEXELS rows, out of range indices use the first bone as on the CPU.
+		int boneTexel(float index)
+		{
+			int bone = int(index);
+			if (bone < 0 || bone >= boneCount)
+				bone = 0;
+			return (paletteOffset + bone) * 3;
+		}
 
 		void main()
 		{
-			vec4 texColor = texture(diffuseTexture, v_texcoord);
-			color = texColor * v_colour * tintColour;
-			if (color.a <= 0.01)
-			{
-				discard;
-			}
+			float weight = clamp(skin.x, 0.0, 1.0);
+			int a = boneTexel(skin.y);
+			int b = boneTexel(skin.z);
+
+			// Rows of the blended matrix, each gives one coordinate of the skinned position.
+			vec4 row0 = mix(texelFetch(bonePalette, b), texelFetch(bonePalette, a), weight);
+			vec4 row1 = mix(texelFetch(bonePalette, b + 1), texelFetch(bonePalette, a + 1), weight);
+			vec4 row2 = mix(texelFetch(bonePalette, b + 2), texelFetch(bonePalette, a + 2), weight);
+
+			vec4 local = vec4(position.xyz, 1.0);
+			vec4 skinned = vec4(dot(row0, local), dot(row1, local), dot(row2, local), 1.0);
+
+			gl_Position = VPMatrix * modelMatrix * skinned;
+			v_colour = colour;
+			v_texcoord = texcoord;
 		}
 	)";
 
-	return new Shader(vertexShader, fragmentShader);
+	return new Shader(vertexShader, defaultFragmentShader);
 }
@@ -31,6 +31,10 @@ public:
 	void setUniformMat4(const std::string& name, glm::mat4 mat);
 
 	static Shader* createDefault();
+	// createDefault() skinned on the GPU: "bonePalette" is a BonePaletteBuffer, "paletteOffset" the model's
+	// first bone in it and "boneCount" its palette size. Static models keep the default shader.
+	// Only --bench-skin draws with it, the viewer has no decoded animations to play yet.
+	static Shader* createSkinned();
 
 private:
 	unsigned int m_id;
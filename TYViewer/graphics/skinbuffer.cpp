@@ -0,0 +1,112 @@
+#include "skinbuffer.h"
+
+#include <cstddef>
+
+#include <glad/glad.h>
+
+#include "util/trace.h"
+
+SkinnedVertexBuffer::SkinnedVertexBuffer() :
+	buffer(0),
+	vertexArrays(),
+	vertexCount(0)
+{}
+
+SkinnedVertexBuffer::~SkinnedVertexBuffer()
+{
+	if (buffer == 0)
+		return;
+
+	glDeleteVertexArrays(static_cast<GLsizei>(vertexArrays.size()), vertexArrays.data());
+	glDeleteBuffers(1, &buffer);
+}
+
+void SkinnedVertexBuffer::setup(const Model& model)
+{
+	if (buffer != 0)
+		return;
+
+	const std::vector<Mesh*>& meshes = model.getMeshes();
+
+	for (auto& mesh : meshes)
+	{
+		vertexCount += mesh->getVertexCount();
+	}
+
+	glGenBuffers(1, &buffer);
+	glBindBuffer(GL_ARRAY_BUFFER, buffer);
+	glBufferData(GL_ARRAY_BUFFER, vertexCount * sizeof(SkinnedVertex), nullptr, GL_STREAM_DRAW);
+
+	vertexArrays.resize(meshes.size());
+	glGenVertexArrays(static_cast<GLsizei>(vertexArrays.size()), vertexArrays.data());
+
+	size_t first = 0;
+	for (size_t i = 0; i < meshes.size(); i++)
+	{
+		const Mesh& mesh = *meshes[i];
+
+		glBindVertexArray(vertexArrays[i]);
+
+		// Positions and normals from the skinned stream, at this mesh's place in it.
+		glBindBuffer(GL_ARRAY_BUFFER, buffer);
+
+		glEnableVertexAttribArray(0);
+		glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, sizeof(SkinnedVertex), (const void*)(first * sizeof(SkinnedVertex) + offsetof(SkinnedVertex, position)));
+
+		glEnableVertexAttribArray(1);
+		glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(SkinnedVertex), (const void*)(first * sizeof(SkinnedVertex) + offsetof(SkinnedVertex, normal)));
+
+		// The rest from the mesh, which never changes. The skin is not needed any more.
+		glBindBuffer(GL_ARRAY_BUFFER, mesh.getVertexBuffer());
+
+		glEnableVertexAttribArray(2);
+		glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, sizeof(Vertex), (const void*)offsetof(Vertex, colour));
+
+		glEnableVertexAttribArray(3);
+		glVertexAttribPointer(3, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (const void*)offsetof(Vertex, texcoord));
+
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh.getIndexBuffer());
+
+		first += mesh.getVertexCount();
+	}
+
+	glBindVertexArray(0);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void SkinnedVertexBuffer::upload(const std::vector<SkinnedVertex>& vertices)
+{
+	TRACE_ZONE("SkinnedVertexBuffer::upload");
+
+	if (buffer == 0 || vertices.size() != vertexCount)
+		return;
+
+	// Orphaned, so the driver need not wait for last frame's draws still reading the old vertices.
+	glBindBuffer(GL_ARRAY_BUFFER, buffer);
+	glBufferData(GL_ARRAY_BUFFER, getUploadBytes(), nullptr, GL_STREAM_DRAW);
+	glBufferSubData(GL_ARRAY_BUFFER, 0, getUploadBytes(), vertices.data());
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void SkinnedVertexBuffer::draw(const Model& model, Shader& shader, const glm::mat4& modelMatrix) const
+{
+	const std::vector<Mesh*>& meshes = model.getMeshes();
+	for (size_t i = 0; i < meshes.size() && i < vertexArrays.size(); i++)
+	{
+		meshes[i]->draw(shader, modelMatrix * meshes[i]->getMatrix(), vertexArrays[i]);
+	}
+}
+
+size_t SkinnedVertexBuffer::getUploadBytes() const
+{
+	return vertexCount * sizeof(SkinnedVertex);
+}
+
+void SkinnedVertexBuffer::gatherVertices(const Model& model, std::vector<Vertex>& vertices)
+{
+	vertices.clear();
+	for (auto& mesh : model.getMeshes())
+	{
+		vertices.insert(vertices.end(), mesh->getVertices().begin(), mesh->getVertices().end());
+	}
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <vector>
+
+#include "model.h"
+
+#include "animation/skinning.h"
+
+// One actor skinned on the CPU: its skinned positions and normals streamed into a buffer of its own,
+// drawn with the colours, texture coordinates and indices of the model's meshes.
+class SkinnedVertexBuffer
+{
+public:
+	SkinnedVertexBuffer();
+	~SkinnedVertexBuffer();
+
+	SkinnedVertexBuffer(const SkinnedVertexBuffer&) = delete;
+	SkinnedVertexBuffer& operator=(const SkinnedVertexBuffer&) = delete;
+
+	// Needs a current OpenGL context and 'model' set up, one vertex array per mesh.
+	void setup(const Model& model);
+	// The vertices of a SkinnedModel built from gatherVertices() of the same model.
+	void upload(const std::vector<SkinnedVertex>& vertices);
+
+	// Same as Model::draw, with a shader that takes no skin, like Shader::createDefault().
+	void draw(const Model& model, Shader& shader, const glm::mat4& modelMatrix) const;
+
+	// Per upload().
+	size_t getUploadBytes() const;
+
+	// Every mesh's vertices in draw order, as upload() expects them skinned.
+	static void gatherVertices(const Model& model, std::vector<Vertex>& vertices);
+
+private:
+	unsigned int buffer;
+	std::vector<unsigned int> vertexArrays;
+
+	size_t vertexCount;
+};
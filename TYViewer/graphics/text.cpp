@@ -11,10 +11,21 @@ Text::Text(const std::string& text, Font* font, const glm::vec3& position) :
 	generate();
 }
 
+Text::~Text()
+{
+	delete mesh;
+}
+
+void Text::setText(const char* text)
+{
+	this->text.assign(text);
+	generate();
+}
+
 void Text::generate()
 {
-	std::vector<Vertex> vertices;
-	std::vector<unsigned int> indices;
+	vertices.clear();
+	indices.clear();
 
 	float xPos = 0;
 	float yPos = 0;
@@ -59,16 +70,21 @@ void Text::generate()
 		}
 	}
 
-	mesh = new Mesh(vertices, indices, font->getTexture());
+	if (mesh == NULL)
+	{
+		mesh = new Mesh(vertices, indices, font->getTexture());
+		mesh->setup();
+	}
+	else
+	{
+		mesh->update(vertices, indices);
+	}
 }
 
 void Text::draw(Shader& shader) const
 {
-	shader.bind();
-	shader.setUniformMat4("modelMatrix", Transformable::getMatrix());
-
 	if (mesh)
 	{
-		mesh->draw(shader);
+		mesh->draw(shader, Transformable::getMatrix());
 	}
 }
@@ -12,6 +12,10 @@ class Text : public Drawable, public Transformable
 {
 public:
 	Text(const std::string& text, Font* font, const glm::vec3& position);
+	~Text();
+
+	// Rebuilds the mesh, reusing its memory when the text is no longer than before.
+	void setText(const char* text);
 
 	void generate();
 
@@ -22,4 +26,7 @@ private:
 	Font* font;
 
 	Mesh* mesh;
+
+	std::vector<Vertex> vertices;
+	std::vector<unsigned int> indices;
 };
\ No newline at end of file
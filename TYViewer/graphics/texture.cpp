@@ -3,13 +3,63 @@
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
 
+#include "renderstats.h"
+
 #define TEXTURE_DEFAULT_ID 1
 
+// Enough for a 32768 texel wide texture, levels past the last mip report a width of 0.
+#define TEXTURE_MAX_LEVELS 16
+
+// Nominal size, drivers may pad RGB to four bytes.
+static size_t getBytesPerTexel(GLint format)
+{
+	switch (format)
+	{
+	case GL_R8:			return 1;
+	case GL_RG8:		return 2;
+	case GL_RGB:
+	case GL_RGB8:		return 3;
+	case GL_RGBA16F:	return 8;
+	case GL_RGBA32F:	return 16;
+	default:			return 4;
+	}
+}
+
 Texture::Texture(unsigned int id)
-	: id(id)
+	: id(id),
+	gpuBytes(0),
+	levels(0)
 {
 	glBindTexture(GL_TEXTURE_2D, id);
 
+	for (GLint level = 0; level < TEXTURE_MAX_LEVELS; level++)
+	{
+		GLint width = 0;
+		GLint height = 0;
+		glGetTexLevelParameteriv(GL_TEXTURE_2D, level, GL_TEXTURE_WIDTH, &width);
+		glGetTexLevelParameteriv(GL_TEXTURE_2D, level, GL_TEXTURE_HEIGHT, &height);
+		if (width == 0 || height == 0)
+			break;
+
+		GLint compressed = GL_FALSE;
+		glGetTexLevelParameteriv(GL_TEXTURE_2D, level, GL_TEXTURE_COMPRESSED, &compressed);
+
+		if (compressed == GL_TRUE)
+		{
+			GLint size = 0;
+			glGetTexLevelParameteriv(GL_TEXTURE_2D, level, GL_TEXTURE_COMPRESSED_IMAGE_SIZE, &size);
+			gpuBytes += static_cast<size_t>(size);
+		}
+		else
+		{
+			GLint format = 0;
+			glGetTexLevelParameteriv(GL_TEXTURE_2D, level, GL_TEXTURE_INTERNAL_FORMAT, &format);
+			gpuBytes += static_cast<size_t>(width) * height * getBytesPerTexel(format);
+		}
+
+		levels++;
+	}
+
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
@@ -27,8 +77,19 @@ void Texture::bind(unsigned int slot) const
 {
 	glActiveTexture(GL_TEXTURE0 + slot);
 	glBindTexture(GL_TEXTURE_2D, id);
+	RenderStats::countStateChange();
 }
 void Texture::unbind() const
 {
 	glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+size_t Texture::getGpuBytes() const
+{
+	return gpuBytes;
+}
+
+unsigned int Texture::getLevels() const
+{
+	return levels;
 }
\ No newline at end of file
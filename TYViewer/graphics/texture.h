@@ -10,6 +10,13 @@ public:
 
 	void bind(unsigned int slot = 0) const;
 	void unbind() const;
+
+	// Every mip level, as reported by the driver when the texture was created.
+	size_t getGpuBytes() const;
+	unsigned int getLevels() const;
 private:
 	unsigned int id;
+
+	size_t gpuBytes;
+	unsigned int levels;
 };
\ No newline at end of file
@@ -3,6 +3,8 @@
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
 
+#include "graphics/renderstats.h"
+
 
 
 Grid::Grid(const glm::vec2& size, float gridNodeSize, const glm::vec4& colour) :
@@ -90,7 +92,9 @@ void Grid::setup()
 void Grid::draw(Shader& shader) const
 {
 	glBindVertexArray(vao);
+	RenderStats::countStateChange();
 
 	shader.bind();
 	glDrawElements(GL_LINES, indices.size(), GL_UNSIGNED_INT, 0);
+	RenderStats::countDraw(0, indices.size() / 2);
 }
@@ -0,0 +1,356 @@
+#include "headless.h"
+
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+
+#include "config.h"
+
+#include "util/allocation.h"
+#include "util/timing.h"
+#include "util/json.h"
+
+// Camera pitch for rendered images, in degrees.
+#define HEADLESS_CAMERA_PITCH -20.0f
+#define HEADLESS_CAMERA_YAW 120.0f
+
+static void writeMemory(std::ostream& stream, const MemoryUsage& usage)
+{
+	stream << "{ \"cpuRetained\": " << usage.cpuRetained << ", ";
+	stream << "\"cpuOther\": " << usage.cpuOther << ", ";
+	stream << "\"cpuTransient\": " << usage.cpuTransient << ", ";
+	stream << "\"gpuBuffers\": " << usage.gpuBuffers << ", ";
+	stream << "\"gpuTextures\": " << usage.gpuTextures << ", ";
+	stream << "\"textures\": " << usage.textures << " }";
+}
+
+bool Headless::isRequested(int argc, char* argv[])
+{
+	for (int i = 1; i < argc; i++)
+	{
+		if (std::string(argv[i]) == "--headless")
+			return true;
+	}
+	return false;
+}
+
+bool Headless::parseArguments(int argc, char* argv[], HeadlessOptions& options)
+{
+	for (int i = 1; i < argc; i++)
+	{
+		std::string argument = argv[i];
+		bool hasValue = i + 1 < argc;
+
+		if (argument == "--headless")
+		{
+			continue;
+		}
+		else if (argument == "--trace" && hasValue)
+		{
+			// Handled before headless mode starts.
+			i++;
+		}
+		else if (argument == "--archive" && hasValue)
+		{
+			options.archive = argv[++i];
+		}
+		else if (argument == "--output" && hasValue)
+		{
+			options.output = argv[++i];
+		}
+		else if (argument == "--stats" && hasValue)
+		{
+			options.stats = argv[++i];
+		}
+		else if (argument == "--size" && hasValue)
+		{
+			std::string size = argv[++i];
+			size_t x = size.find('x');
+			if (x == std::string::npos)
+				return false;
+
+			options.width = std::atoi(size.substr(0, x).c_str());
+			options.height = std::atoi(size.substr(x + 1).c_str());
+			if (options.width <= 0 || options.height <= 0)
+				return false;
+		}
+		else if (argument == "--no-images")
+		{
+			options.images = false;
+		}
+		else if (argument == "--software")
+		{
+			options.software = true;
+		}
+		else if (argument == "--assert-no-frame-allocations")
+		{
+			options.assertNoFrameAllocations = true;
+		}
+		else if (argument.size() > 2 && argument.compare(0, 2, "--") == 0)
+		{
+			return false;
+		}
+		else
+		{
+			options.models.push_back(argument);
+		}
+	}
+
+	return !options.models.empty();
+}
+
+void Headless::printUsage()
+{
+	std::cout <<
+		"Usage: TYViewer --headless [options] <model> [<model> ...]" << std::endl <<
+		"  --archive <path>   Archive to load models from (default: config.cfg)" << std::endl <<
+		"  --output <dir>     Directory images are written to (default: .)" << std::endl <<
+		"  --stats <file>     Write per-model statistics as JSON" << std::endl <<
+		"  --size <w>x<h>     Image size (default: 512x512)" << std::endl <<
+		"  --no-images        Only load models and collect statistics" << std::endl <<
+		"  --software         Use Mesa's software rasterizer" << std::endl <<
+		"  --assert-no-frame-allocations" << std::endl <<
+		"                     Fail models whose frames allocate (allocation tracking builds)" << std::endl <<
+		"  --trace <file>     Record a Chrome trace of the run" << std::endl;
+}
+
+Headless::Headless(const HeadlessOptions& options) :
+	options(options),
+	context(),
+	renderer(),
+	framebuffer(),
+	camera(glm::vec3(0.0f), glm::vec3(90.0f, 0.0f, 0.0f), 70.0f, (float)options.width / (float)options.height, 0.2f, 30000.0f),
+	content(),
+	shader(nullptr)
+{}
+
+int Headless::run()
+{
+	if (!initialize())
+		return -1;
+
+	results = std::vector<HeadlessResult>(options.models.size());
+	int failures = 0;
+
+	for (size_t i = 0; i < options.models.size(); i++)
+	{
+		process(options.models[i], results[i]);
+		if (!results[i].loaded || (options.assertNoFrameAllocations && results[i].frameAllocations > 0))
+			failures++;
+	}
+
+	if (!options.stats.empty() && !writeStats(results))
+	{
+		LOG_ERROR(General, "Failed to write statistics: " + options.stats);
+		return -1;
+	}
+
+	LOG_INFO(General, "Processed " + std::to_string(results.size()) + " models, " + std::to_string(failures) + " failed");
+	Allocation::report();
+
+	return failures == 0 ? 0 : 1;
+}
+
+const std::vector<HeadlessResult>& Headless::getResults() const
+{
+	return results;
+}
+
+bool Headless::initialize()
+{
+	std::string archive = options.archive.empty() ? Config::archive : options.archive;
+	if (archive.empty())
+	{
+		LOG_ERROR(General, "No archive specified, use --archive or config.cfg");
+		return false;
+	}
+
+	if (options.assertNoFrameAllocations && !Allocation::isCounting())
+	{
+		LOG_WARNING(General, "Built without ALLOCATION_TRACKING, frame allocations are not checked");
+	}
+
+	if (!context.create(options.software))
+		return false;
+
+	renderer.initialize();
+
+	if (!framebuffer.create(options.width, options.height))
+		return false;
+
+	content.initialize();
+	if (!content.loadRKV(archive))
+	{
+		LOG_ERROR(General, "Failed to load archive: " + archive);
+		return false;
+	}
+
+	shader = content.load<Shader>("standard.shader");
+	if (shader == nullptr)
+	{
+		LOG_ERROR(General, "Failed to load shader: standard.shader");
+		return false;
+	}
+	shader->bind();
+	shader->setUniform4f("tintColour", glm::vec4(1, 1, 1, 1));
+	shader->setUniform1i("diffuseTexture", 0);
+
+	return true;
+}
+
+void Headless::process(const std::string& name, HeadlessResult& result)
+{
+	TRACE_ZONE_DETAIL("Headless::process", name);
+
+	result.name = name;
+
+	AllocationStats before = Allocation::getTotal();
+
+	auto start = std::chrono::high_resolution_clock::now();
+	Model* model = content.load<Model>(name);
+	result.loadMilliseconds = millisecondsSince(start);
+
+	AllocationStats after = Allocation::getTotal();
+	result.loadAllocations = after.count - before.count;
+	result.loadBytes = after.bytes - before.bytes;
+
+	if (model == nullptr)
+	{
+		LOG_ERROR(General, "Failed to load model: " + name);
+		return;
+	}
+	result.loaded = true;
+
+	for (auto& mesh : model->getMeshes())
+	{
+		result.meshes++;
+		result.vertices += mesh->getVertexCount();
+		result.triangles += mesh->getIndexCount() / 3;
+	}
+	result.memory = model->getMemoryUsage();
+	result.boundsCorner = model->bounds_crn;
+	result.boundsSize = model->bounds_size;
+
+	if (!options.images && !options.assertNoFrameAllocations)
+		return;
+
+	start = std::chrono::high_resolution_clock::now();
+	render(*model);
+	glFinish();
+	result.renderMilliseconds = millisecondsSince(start);
+
+	// The first frame may still create state, later ones should leave the heap alone.
+	if (Allocation::isCounting())
+	{
+		before = Allocation::getTotal();
+		render(*model);
+		after = Allocation::getTotal();
+
+		result.frameAllocations = after.count - before.count;
+		result.frameBytes = after.bytes - before.bytes;
+
+		if (options.assertNoFrameAllocations && result.frameAllocations > 0)
+		{
+			LOG_ERROR(General, name + " made " + std::to_string(result.frameAllocations) + " heap allocations in a frame (expected 0)");
+		}
+	}
+
+	if (!options.images)
+		return;
+
+	framebuffer.read(pixels);
+
+	// The framebuffer alpha is whatever blending left behind.
+	for (size_t i = 3; i < pixels.size(); i += 4)
+	{
+		pixels[i] = 255;
+	}
+
+	std::string image = name.substr(0, name.find_last_of('.')) + ".png";
+	std::string path = options.output + "/" + image;
+	if (SOIL_save_image(path.c_str(), SOIL_SAVE_TYPE_PNG, options.width, options.height, 4, pixels.data()) == 0)
+	{
+		LOG_ERROR(General, "Failed to save image: " + path);
+		return;
+	}
+	result.image = image;
+
+	LOG_INFO(General, name + " -> " + path);
+}
+
+void Headless::render(Model& model)
+{
+	ALLOCATION_SCOPE(Frame);
+
+	glm::vec3 center = model.bounds_crn + model.bounds_size / 2.0f;
+	center.z = -center.z;
+
+	float radius = glm::length(model.bounds_size) / 2.0f;
+	if (radius <= 0.0f)
+		radius = 100.0f;
+
+	float distance = radius / std::sin(glm::radians(camera.getFieldOfView() / 2.0f));
+	camera.orbit(center, distance, HEADLESS_CAMERA_YAW, HEADLESS_CAMERA_PITCH);
+
+	framebuffer.bind();
+
+	renderer.beginFrame();
+	renderer.clear(glm::vec4(Config::backgroundR, Config::backgroundG, Config::backgroundB, 1.0f));
+
+	// Display as a left-handed coordinate system.
+	glm::mat4 view = camera.getViewMatrix();
+	view = glm::scale(view, glm::vec3(1.0f, 1.0f, -1.0f));
+
+	shader->bind();
+	shader->setUniformMat4("VPMatrix", camera.getProjectionMatrix() * view);
+
+	renderer.draw(model, *shader);
+
+	framebuffer.unbind();
+}
+
+bool Headless::writeStats(const std::vector<HeadlessResult>& results) const
+{
+	std::ofstream stream(options.stats, std::ios::out | std::ios::trunc);
+	if (stream.fail())
+		return false;
+
+	stream << std::fixed << std::setprecision(3);
+	stream << "{" << std::endl;
+	stream << "\t\"renderer\": \"" << Json::escape(reinterpret_cast<const char*>(glGetString(GL_RENDERER))) << "\"," << std::endl;
+	stream << "\t\"backend\": \"" << Json::escape(context.getBackend()) << "\"," << std::endl;
+	stream << "\t\"memory\": ";
+	writeMemory(stream, content.getMemoryUsage());
+	stream << "," << std::endl;
+	stream << "\t\"models\": [" << std::endl;
+
+	for (size_t i = 0; i < results.size(); i++)
+	{
+		const HeadlessResult& result = results[i];
+
+		stream << "\t\t{ ";
+		stream << "\"name\": \"" << Json::escape(result.name) << "\", ";
+		stream << "\"loaded\": " << (result.loaded ? "true" : "false") << ", ";
+		stream << "\"loadMs\": " << result.loadMilliseconds << ", ";
+		stream << "\"renderMs\": " << result.renderMilliseconds << ", ";
+		stream << "\"meshes\": " << result.meshes << ", ";
+		stream << "\"vertices\": " << result.vertices << ", ";
+		stream << "\"triangles\": " << result.triangles << ", ";
+		stream << "\"loadAllocations\": " << result.loadAllocations << ", ";
+		stream << "\"loadBytes\": " << result.loadBytes << ", ";
+		stream << "\"frameAllocations\": " << result.frameAllocations << ", ";
+		stream << "\"frameBytes\": " << result.frameBytes << ", ";
+		stream << "\"memory\": ";
+		writeMemory(stream, result.memory);
+		stream << ", ";
+		stream << "\"boundsCorner\": [" << result.boundsCorner.x << ", " << result.boundsCorner.y << ", " << result.boundsCorner.z << "], ";
+		stream << "\"boundsSize\": [" << result.boundsSize.x << ", " << result.boundsSize.y << ", " << result.boundsSize.z << "], ";
+		stream << "\"image\": \"" << Json::escape(result.image) << "\" }";
+		stream << (i + 1 < results.size() ? "," : "") << std::endl;
+	}
+
+	stream << "\t]" << std::endl;
+	stream << "}" << std::endl;
+
+	return !stream.fail();
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "content.h"
+
+#include "graphics/camera.h"
+#include "graphics/renderer.h"
+#include "graphics/context.h"
+#include "graphics/framebuffer.h"
+
+struct HeadlessOptions
+{
+	std::vector<std::string> models;
+
+	std::string archive;
+	std::string output = ".";
+	std::string stats;
+
+	int width = 512;
+	int height = 512;
+
+	bool images = true;
+	bool software = false;
+
+	// Fail models whose second frame touches the heap, needs ALLOCATION_TRACKING.
+	bool assertNoFrameAllocations = false;
+};
+
+struct HeadlessResult
+{
+	std::string name;
+	bool loaded = false;
+
+	double loadMilliseconds = 0.0;
+	double renderMilliseconds = 0.0;
+
+	size_t meshes = 0;
+	size_t vertices = 0;
+	size_t triangles = 0;
+
+	// Heap use of loading, and of a frame after the first one.
+	size_t loadAllocations = 0;
+	size_t loadBytes = 0;
+	size_t frameAllocations = 0;
+	size_t frameBytes = 0;
+
+	MemoryUsage memory;
+
+	glm::vec3 boundsCorner;
+	glm::vec3 boundsSize;
+
+	std::string image;
+};
+
+// Renders models into an offscreen framebuffer without a window.
+// Usage: TYViewer --headless [options] <model> [<model> ...]
+class Headless
+{
+public:
+	static bool isRequested(int argc, char* argv[]);
+	static bool parseArguments(int argc, char* argv[], HeadlessOptions& options);
+	static void printUsage();
+
+	Headless(const HeadlessOptions& options);
+
+	int run();
+
+	// Per-model results of the last run().
+	const std::vector<HeadlessResult>& getResults() const;
+
+private:
+	bool initialize();
+
+	void process(const std::string& name, HeadlessResult& result);
+	void render(Model& model);
+
+	bool writeStats(const std::vector<HeadlessResult>& results) const;
+
+	HeadlessOptions options;
+
+	// Declared first so every GL object below is released while the context still exists.
+	OffscreenContext context;
+
+	Renderer renderer;
+	Framebuffer framebuffer;
+	Camera camera;
+
+	Content content;
+	Shader* shader;
+
+	std::vector<unsigned char> pixels;
+
+	std::vector<HeadlessResult> results;
+};
@@ -1,5 +1,7 @@
 #include "keyboard.h"
 
+#include <cstddef>
+
 Keyboard* Keyboard::instance = NULL;
 
 void Keyboard::initialize(GLFWwindow* window)
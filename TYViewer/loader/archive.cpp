@@ -5,17 +5,22 @@
 
 #include "util/bitconverter.h"
 #include "util/stringext.h"
+#include "util/trace.h"
+#include "util/allocation.h"
 
 #include "debug.h"
 
 bool Archive::load(const std::string& path)
 {
+	TRACE_ZONE_DETAIL("Archive::load", path);
+	ALLOCATION_SCOPE(Archive);
+
 	this->path = path;
 
 	std::ifstream stream(path, std::ios::binary | std::ios::ate);
 	if (stream.fail())
 	{
-		Debug::log("ERROR: Failed to open archive file: " + path);
+		LOG_ERROR(Archive, "Failed to open archive file: " + path);
 		stream.close();
 		return false;
 	}
@@ -24,7 +29,7 @@ bool Archive::load(const std::string& path)
 
 	if (size == 0)
 	{
-		Debug::log("ERROR: Archive file is empty: " + path);
+		LOG_ERROR(Archive, "Archive file is empty: " + path);
 		return false;
 	}
 
@@ -33,48 +38,48 @@ bool Archive::load(const std::string& path)
 	switch (version)
 	{
 	case Archive::RKV1:
-		Debug::log("Identified archive as RKV1 format");
+		LOG_INFO(Archive, "Identified archive as RKV1 format");
 		loadAsRKV1();
-		Debug::log("Loaded " + std::to_string(files.size()) + " files from RKV1 archive");
+		indexNames();
+		LOG_INFO(Archive, "Loaded " + std::to_string(files.size()) + " files from RKV1 archive");
 		return true;
 		break;
 	case Archive::RKV2:
-		Debug::log("Identified archive as RKV2 format");
+		LOG_INFO(Archive, "Identified archive as RKV2 format");
 		loadAsRKV2();
-		Debug::log("Loaded " + std::to_string(files.size()) + " files from RKV2 archive");
+		indexNames();
+		LOG_INFO(Archive, "Loaded " + std::to_string(files.size()) + " files from RKV2 archive");
 		return true;
 		break;
 	case Archive::UNKNOWN:
-		Debug::log("ERROR: File isn't a recognized TY archive format: " + path);
+		LOG_ERROR(Archive, "File isn't a recognized TY archive format: " + path);
 		break;
 	}
 
 	return false;
 }
 
-bool Archive::getFile(const std::string& name, File& file)
+bool Archive::getFile(const std::string& name, File& file) const
 {
 	std::string key = name;
 	std::transform(key.begin(), key.end(), key.begin(), ::tolower);
 
-	if (files.find(key) != files.end())
+	auto it = files.find(key);
+	if (it != files.end())
 	{
-		file = files[key];
+		file = it->second;
 		return true;
 	}
 	return false;
 }
 
-bool Archive::getFileData(const std::string& name, std::vector<char>& data)
+bool Archive::getFileData(const std::string& name, std::vector<char>& data) const
 {
-	std::string key = name;
-	std::transform(key.begin(), key.end(), key.begin(), ::tolower);
+	TRACE_ZONE_DETAIL("Archive::getFileData", name);
+	ALLOCATION_SCOPE(Archive);
 
 	File file;
-	if (files.find(key) != files.end())
-	{
-		file = files[key];
-	}
+	getFile(name, file);
 
 	// File found!
 	if (file.size != 0)
@@ -93,9 +98,44 @@ bool Archive::getFileData(const std::string& name, std::vector<char>& data)
 	return false;
 }
 
+std::vector<std::string> Archive::getFileNames(const std::string& extension) const
+{
+	const std::vector<uint32_t>& entries = nameIndex.getEntries(extension);
+
+	std::vector<std::string> names;
+	names.reserve(entries.size());
+	for (uint32_t entry : entries)
+	{
+		names.push_back(nameIndex.getName(entry));
+	}
+	return names;
+}
+
+size_t Archive::getFileCount() const
+{
+	return files.size();
+}
+
+const NameIndex& Archive::getNameIndex() const
+{
+	return nameIndex;
+}
+
+void Archive::indexNames()
+{
+	std::vector<std::string> names;
+	names.reserve(files.size());
+	for (auto& entry : files)
+	{
+		names.push_back(entry.second.name);
+	}
+
+	nameIndex.build(names);
+}
+
 void Archive::identify()
 {
-	std::ifstream stream(path, std::ios::binary | std::ios::beg);
+	std::ifstream stream(path, std::ios::binary);
 
 	std::vector<char> ext(4);
 	stream.read(&ext[0], 4);
@@ -198,7 +238,7 @@ void Archive::loadAsRKV2()
 		// DUMMY3 at offset 4 - not used
 		uint32_t size = from_bytes<uint32_t>(entry.data(), 8);
 		uint32_t offset = from_bytes<uint32_t>(entry.data(), 12);
-		// CRC at offset 16 - not used
+		uint32_t crc = from_bytes<uint32_t>(entry.data(), 16);
 
 		// Read file name from NAME_OFF + nameoff
 		uint32_t name_pos = name_off + nameoff;
@@ -216,6 +256,7 @@ void Archive::loadAsRKV2()
 		file.size = size;
 		file.offset = offset;
 		file.date = 0; // RKV2 doesn't store date
+		file.crc = crc;
 
 		std::string key = file.name;
 		std::transform(key.begin(), key.end(), key.begin(), ::tolower);
@@ -1,10 +1,13 @@
 #pragma once
 
 #include <string>
+#include <vector>
 #include <unordered_map>
 
 #include <algorithm>
 
+#include "loader/nameindex.h"
+
 struct File
 {
 	std::string name = "";
@@ -12,6 +15,8 @@ struct File
 	std::int64_t size = 0;
 	std::int32_t offset = 0;
 	std::int64_t date = 0;
+	// Only stored by RKV2 archives, 0 otherwise.
+	std::uint32_t crc = 0;
 
 	inline bool matches(const std::string& s) const
 	{
@@ -44,8 +49,17 @@ public:
 
 	bool load(const std::string& path);
 
-	bool getFile(const std::string& name, File& file);
-	bool getFileData(const std::string& name, std::vector<char>& data);
+	// Lookups only read the table and open their own stream, so any number
+	// of threads may call these at once.
+	bool getFile(const std::string& name, File& file) const;
+	bool getFileData(const std::string& name, std::vector<char>& data) const;
+
+	// Names of every file with the given extension (lower case, without the dot), or of every file if empty. Sorted.
+	std::vector<std::string> getFileNames(const std::string& extension) const;
+	size_t getFileCount() const;
+
+	// Built on load, for searching the names.
+	const NameIndex& getNameIndex() const;
 
 	std::string path;
 private:
@@ -54,6 +68,8 @@ private:
 	void loadAsRKV1();
 	void loadAsRKV2();
 
+	void indexNames();
+
 
 	
 	int version;
@@ -61,4 +77,6 @@ private:
 	unsigned long size;
 
 	std::unordered_map<std::string, File> files;
+
+	NameIndex nameIndex;
 };
\ No newline at end of file
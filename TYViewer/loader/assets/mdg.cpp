@@ -2,6 +2,7 @@
 
 #include "util/bitconverter.h"
 #include "util/stringext.h"
+#include "util/trace.h"
 #include "debug.h"
 
 #include <algorithm>
@@ -10,13 +11,32 @@
 #include <set>
 #include <unordered_set>
 
+// Whether the strip descriptors of a PC mesh add up to its vertices, with or without
+// the one or two degenerate vertices joining each strip to the next.
+static bool stripCountsMatch(const std::vector<uint16_t>& stripVertexCounts, size_t totalVertices)
+{
+	if (stripVertexCounts.empty())
+		return false;
+
+	size_t stripSum = 0;
+	for (auto count : stripVertexCounts)
+	{
+		stripSum += count;
+	}
+
+	const size_t joins = stripVertexCounts.size() - 1;
+	return stripSum == totalVertices || stripSum + joins * 2 == totalVertices || stripSum + joins == totalVertices;
+}
+
 // ============================================================================
 // TY 2 MDG Loading (using MDL3 metadata)
 // ============================================================================
 
 bool mdg::loadWithMDL3Metadata(const char* buffer, size_t size, const mdl2::MDL3Metadata& mdl3Metadata, const char* mdlBuffer, size_t mdlOffset)
 {
-	Debug::log("MDG: Loading with MDL3 metadata using ObjectLookupTable approach");
+	TRACE_ZONE("mdg::loadWithMDL3Metadata");
+
+	LOG_DEBUG(MDG, "Loading with MDL3 metadata using ObjectLookupTable approach");
 	meshes.clear();
 
 	// Parse MDG using ObjectLookupTable (based on reference converter)
@@ -25,8 +45,9 @@ bool mdg::loadWithMDL3Metadata(const char* buffer, size_t size, const mdl2::MDL3
 
 bool mdg::parseMDGWithObjectLookupTable(const char* buffer, size_t size, const mdl2::MDL3Metadata& mdl3Metadata, const char* mdlBuffer, size_t mdlOffset)
 {
-	Debug::log("MDG: Parsing using ObjectLookupTable");
+	LOG_DEBUG(MDG, "Parsing using ObjectLookupTable");
 	meshes.clear();
+	collisionMeshes.clear();
 
 	// First check if this is a PS2 or PC MDG file by searching for the PS2 pattern
 	bool isPS2Format = false;
@@ -37,24 +58,24 @@ bool mdg::parseMDGWithObjectLookupTable(const char* buffer, size_t size, const m
 			buffer[searchPos + 2] == 0x02 && buffer[searchPos + 3] == 0x6C)
 		{
 			isPS2Format = true;
-			Debug::log("MDG: Detected PS2 format (found VIF packet marker)");
+			LOG_DEBUG(MDG, "Detected PS2 format (found VIF packet marker)");
 			break;
 		}
 	}
 
 	if (!isPS2Format)
 	{
-		Debug::log("MDG: No PS2 markers found, assuming PC format");
+		LOG_DEBUG(MDG, "No PS2 markers found, assuming PC format");
 		// Try PC parser first
 		bool pcSuccess = parseMDGPC(buffer, size, mdl3Metadata, mdlBuffer, mdlOffset);
 		if (!pcSuccess || meshes.empty()) {
-			Debug::log("MDG: PC parser failed, trying fallback pattern-based parser");
+			LOG_WARNING(MDG, "PC parser failed, trying fallback pattern-based parser");
 			return load(buffer, size);  // Fallback to generic parser
 		}
 		return pcSuccess;
 	}
 
-	Debug::log("MDG: Parsing PS2 format");
+	LOG_DEBUG(MDG, "Parsing PS2 format");
 
 	// Generate anim node lists (needed for bone index remapping)
 	std::vector<std::vector<uint8_t>> animNodeLists;
@@ -94,7 +115,7 @@ bool mdg::parseMDGWithObjectLookupTable(const char* buffer, size_t size, const m
 			{
 				if (meshRef < 0 || (size_t)meshRef >= size)
 				{
-					Debug::log("MDG: Invalid mesh reference: " + std::to_string(meshRef));
+					LOG_WARNING(MDG, "Invalid mesh reference: " + std::to_string(meshRef));
 					break;
 				}
 
@@ -124,7 +145,7 @@ bool mdg::parseMDGWithObjectLookupTable(const char* buffer, size_t size, const m
 					
 					if (patternPos == SIZE_MAX)
 					{
-						Debug::log("MDG: Could not find PS2 strip pattern for strip " + std::to_string(si));
+						LOG_WARNING(MDG, "Could not find PS2 strip pattern for strip " + std::to_string(si));
 						break;
 					}
 
@@ -150,7 +171,7 @@ bool mdg::parseMDGWithObjectLookupTable(const char* buffer, size_t size, const m
 					std::vector<mdl2::Vertex> vertices;
 					if (!parseStrip(buffer, size, currentOffset, vertexCount, vertices, animNodeListIndex, animNodeLists))
 					{
-						Debug::log("MDG: Failed to parse PS2 strip " + std::to_string(si));
+						LOG_WARNING(MDG, "Failed to parse PS2 strip " + std::to_string(si));
 						break;
 					}
 
@@ -175,10 +196,20 @@ bool mdg::parseMDGWithObjectLookupTable(const char* buffer, size_t size, const m
 		}
 	}
 
-	Debug::log("MDG: Parsed " + std::to_string(meshes.size()) + " meshes (PS2 format)");
+	LOG_DEBUG(MDG, "Parsed " + std::to_string(meshes.size()) + " meshes (PS2 format)");
 	return !meshes.empty();
 }
 
+// Strips refer to bones through their mesh's anim node list, vertices store the node itself.
+static uint16_t getNodeIndex(uint16_t listIndex, uint16_t animNodeListIndex, const std::vector<std::vector<uint8_t>>& animNodeLists)
+{
+	if (animNodeListIndex < animNodeLists.size() && listIndex < animNodeLists[animNodeListIndex].size())
+	{
+		return animNodeLists[animNodeListIndex][listIndex];
+	}
+	return listIndex;
+}
+
 bool mdg::parseStrip(const char* buffer, size_t size, size_t& offset, uint8_t vertexCount, std::vector<mdl2::Vertex>& vertices, uint16_t animNodeListIndex, const std::vector<std::vector<uint8_t>>& animNodeLists)
 {
 	vertices.resize(vertexCount);
@@ -187,7 +218,7 @@ bool mdg::parseStrip(const char* buffer, size_t size, size_t& offset, uint8_t ve
 	// Reference: sr.Read(strip.floatData, 0, 0xC * strip.VertexCount);
 	if (offset + (vertexCount * 12) > size)
 	{
-		Debug::log("MDG: Not enough space for positions");
+		LOG_DEBUG(MDG, "Not enough space for positions");
 		return false;
 	}
 
@@ -202,7 +233,7 @@ bool mdg::parseStrip(const char* buffer, size_t size, size_t& offset, uint8_t ve
 	// Skip 2 bytes (matches reference: sr.Seek(0x2, SeekOrigin.Current))
 	if (offset + 2 > size)
 	{
-		Debug::log("MDG: Not enough space after positions");
+		LOG_DEBUG(MDG, "Not enough space after positions");
 		return false;
 	}
 	offset += 2;
@@ -211,7 +242,7 @@ bool mdg::parseStrip(const char* buffer, size_t size, size_t& offset, uint8_t ve
 	// Reference: sr.Read(buffer, 0, 2); then checks buffer[1]
 	if (offset + 2 > size)
 	{
-		Debug::log("MDG: Not enough space for format marker");
+		LOG_DEBUG(MDG, "Not enough space for format marker");
 		return false;
 	}
 	
@@ -229,7 +260,7 @@ bool mdg::parseStrip(const char* buffer, size_t size, size_t& offset, uint8_t ve
 		// Reference: for(int i = 0; i < strip.VertexCount; i++) sr.Read(strip.charData, i * 0x4, 0x3);
 		if (offset + (vertexCount * 3) > size)
 		{
-			Debug::log("MDG: Not enough space for charData (format 6A)");
+			LOG_DEBUG(MDG, "Not enough space for charData (format 6A)");
 			return false;
 		}
 
@@ -251,7 +282,7 @@ bool mdg::parseStrip(const char* buffer, size_t size, size_t& offset, uint8_t ve
 		// Reference: for (int i = 0; i < strip.VertexCount; i++) sr.Read(strip.shortData, i * 8, 0x4);
 		if (offset + (vertexCount * 4) > size)
 		{
-			Debug::log("MDG: Not enough space for shortData (format 6A)");
+			LOG_DEBUG(MDG, "Not enough space for shortData (format 6A)");
 			return false;
 		}
 		
@@ -276,7 +307,7 @@ bool mdg::parseStrip(const char* buffer, size_t size, size_t& offset, uint8_t ve
 		// Reference: for (int i = 0; i < strip.VertexCount; i++) sr.Read(strip.shortData, i * 0x8, 0x4);
 		if (offset + (vertexCount * 4) > size)
 		{
-			Debug::log("MDG: Not enough space for shortData (format 65)");
+			LOG_DEBUG(MDG, "Not enough space for shortData (format 65)");
 			return false;
 		}
 		
@@ -304,7 +335,7 @@ bool mdg::parseStrip(const char* buffer, size_t size, size_t& offset, uint8_t ve
 		// Reference: for (int i = 0; i < strip.VertexCount; i++) { sr.Read(strip.charData, i * 0x4, 0x3); ... }
 		if (offset + (vertexCount * 4) > size)
 		{
-			Debug::log("MDG: Not enough space for charData");
+			LOG_DEBUG(MDG, "Not enough space for charData");
 			return false;
 		}
 		
@@ -315,29 +346,9 @@ bool mdg::parseStrip(const char* buffer, size_t size, size_t& offset, uint8_t ve
 			vertices[i].normal[1] = byte_to_single(buffer, offset + (i * 4) + 1);
 			vertices[i].normal[2] = byte_to_single(buffer, offset + (i * 4) + 2);
 			
-			// Read bone index (4th byte)
-			uint8_t boneIndex = from_bytes<uint8_t>(buffer, offset + (i * 4) + 3);
-			boneIndex = boneIndex >> 1; // Extract bone index
-			
-			// Remap bone index if animNodeListIndex is valid
-			if (animNodeListIndex != 0xFFFF && animNodeListIndex < animNodeLists.size())
-			{
-				auto& animNodeList = animNodeLists[animNodeListIndex];
-				if (boneIndex < animNodeList.size())
-				{
-					boneIndex = (animNodeList[boneIndex] + 1) << 1;
-				}
-				else
-				{
-					boneIndex = boneIndex << 1;
-				}
-			}
-			else
-			{
-				boneIndex = boneIndex << 1;
-			}
-			
-			vertices[i].skin[1] = (float)boneIndex;
+			// First bone in the upper 7 bits of the 4th byte
+			uint16_t boneIndex = from_bytes<uint8_t>(buffer, offset + (i * 4) + 3) >> 1;
+			vertices[i].skin[1] = (float)getNodeIndex(boneIndex, animNodeListIndex, animNodeLists);
 		}
 		offset += vertexCount * 4;
 		
@@ -348,7 +359,7 @@ bool mdg::parseStrip(const char* buffer, size_t size, size_t& offset, uint8_t ve
 		// Reference: for(int i = 0; i < strip.VertexCount; i++) { sr.Read(strip.shortData, i * 8, 0x6); ... }
 		if (offset + (vertexCount * 8) > size)
 		{
-			Debug::log("MDG: Not enough space for shortData");
+			LOG_DEBUG(MDG, "Not enough space for shortData");
 			return false;
 		}
 		
@@ -360,29 +371,9 @@ bool mdg::parseStrip(const char* buffer, size_t size, size_t& offset, uint8_t ve
 			vertices[i].texcoord[0] = u / 4096.0f;
 			vertices[i].texcoord[1] = std::abs((v / 4096.0f) - 1.0f);
 			
-			// Read bone index (last 2 bytes)
-			uint16_t boneIndexShort = from_bytes<uint16_t>(buffer, offset + (i * 8) + 6);
-			uint16_t boneIndex = boneIndexShort >> 2; // Extract bone index
-			
-			// Remap bone index if animNodeListIndex is valid
-			if (animNodeListIndex != 0xFFFF && animNodeListIndex < animNodeLists.size())
-			{
-				auto& animNodeList = animNodeLists[animNodeListIndex];
-				if (boneIndex < animNodeList.size())
-				{
-					boneIndex = (animNodeList[boneIndex] + 1) << 2;
-				}
-				else
-				{
-					boneIndex = boneIndex << 2;
-				}
-			}
-			else
-			{
-				boneIndex = boneIndex << 2;
-			}
-			
-			vertices[i].skin[2] = (float)boneIndex;
+			// Second bone in the upper 14 bits of the last 2 bytes
+			uint16_t boneIndex = from_bytes<uint16_t>(buffer, offset + (i * 8) + 6) >> 2;
+			vertices[i].skin[2] = (float)getNodeIndex(boneIndex, animNodeListIndex, animNodeLists);
 		}
 		offset += vertexCount * 8;
 	}
@@ -391,7 +382,7 @@ bool mdg::parseStrip(const char* buffer, size_t size, size_t& offset, uint8_t ve
 	// Reference: sr.Seek(0x4, SeekOrigin.Current);
 	if (offset + 4 > size)
 	{
-		Debug::log("MDG: Not enough space for 4-byte skip before colors");
+		LOG_DEBUG(MDG, "Not enough space for 4-byte skip before colors");
 		return false;
 	}
 	offset += 4;
@@ -400,7 +391,7 @@ bool mdg::parseStrip(const char* buffer, size_t size, size_t& offset, uint8_t ve
 	// Reference: sr.Read(strip.byteData, 0, 0x4 * strip.VertexCount);
 	if (offset + (vertexCount * 4) > size)
 	{
-		Debug::log("MDG: Not enough space for colors");
+		LOG_DEBUG(MDG, "Not enough space for colors");
 		return false;
 	}
 
@@ -430,7 +421,9 @@ struct PCStripDescriptor {
 
 bool mdg::parseMDGPC(const char* buffer, size_t size, const mdl2::MDL3Metadata& mdl3Metadata, const char* mdlBuffer, size_t mdlOffset)
 {
-	Debug::log("MDG: Parsing PC MDG format");
+	TRACE_ZONE("mdg::parseMDGPC");
+
+	LOG_DEBUG(MDG, "Parsing PC MDG format");
 	meshes.clear();
 	
 	// Find where vertex data actually starts (after all mesh headers)
@@ -507,13 +500,13 @@ bool mdg::parseMDGPC(const char* buffer, size_t size, const mdl2::MDL3Metadata&
 		
 		if (validCount >= 4) {
 			globalVertexDataStart = searchOffset;
-			Debug::log("MDG PC: Found global vertex data block starting at offset " + std::to_string(globalVertexDataStart));
+			LOG_DEBUG(MDG, "MDG PC: Found global vertex data block starting at offset " + std::to_string(globalVertexDataStart));
 			break;
 		}
 	}
 	
 	if (globalVertexDataStart == 0) {
-		Debug::log("MDG PC: Could not find global vertex data block");
+		LOG_WARNING(MDG, "MDG PC: Could not find global vertex data block");
 		return false;
 	}
 	
@@ -546,7 +539,7 @@ bool mdg::parseMDGPC(const char* buffer, size_t size, const mdl2::MDL3Metadata&
 			{
 				if (meshRef < 0 || (size_t)meshRef >= size)
 				{
-					Debug::log("MDG PC: Invalid mesh reference: " + std::to_string(meshRef));
+					LOG_WARNING(MDG, "MDG PC: Invalid mesh reference: " + std::to_string(meshRef));
 					break;
 				}
 
@@ -566,30 +559,33 @@ bool mdg::parseMDGPC(const char* buffer, size_t size, const mdl2::MDL3Metadata&
 						uint16_t vertCount = static_cast<uint16_t>(descriptor & 0xFF);
 						stripVertexCounts.push_back(vertCount);
 					}
-					std::string stripCountsLog = "MDG PC: Strip vertex counts (low byte) = [";
-					for (size_t i = 0; i < stripVertexCounts.size(); i++)
+					if (LOG_DEBUG_ENABLED(MDG))
 					{
-						stripCountsLog += std::to_string(stripVertexCounts[i]);
-						if (i + 1 < stripVertexCounts.size())
+						std::string stripCountsLog = "MDG PC: Strip vertex counts (low byte) = [";
+						for (size_t i = 0; i < stripVertexCounts.size(); i++)
 						{
-							stripCountsLog += ", ";
+							stripCountsLog += std::to_string(stripVertexCounts[i]);
+							if (i + 1 < stripVertexCounts.size())
+							{
+								stripCountsLog += ", ";
+							}
 						}
+						stripCountsLog += "]";
+						LOG_DEBUG(MDG, stripCountsLog);
 					}
-					stripCountsLog += "]";
-					Debug::log(stripCountsLog);
 				}
 				
 				// Strip descriptors exist but are not reliable for vertex counts in PC format.
 
 				if (stripCount > 1000)
 				{
-					Debug::log("MDG PC: Invalid strip count: " + std::to_string(stripCount));
+					LOG_WARNING(MDG, "MDG PC: Invalid strip count: " + std::to_string(stripCount));
 					break;
 				}
 				
 				size_t totalVertices = static_cast<size_t>(baseVertexCount) + static_cast<size_t>(duplicateVertexCount);
 
-				Debug::log("MDG PC: Parsing mesh at offset " + std::to_string(meshRef) + 
+				LOG_DEBUG(MDG, "MDG PC: Parsing mesh at offset " + std::to_string(meshRef) + 
 					" with " + std::to_string(stripCount) + " strips (base=" + std::to_string(baseVertexCount) + 
 					", dup=" + std::to_string(duplicateVertexCount) + ", texture=" + std::to_string(ti) + 
 					", component=" + std::to_string(ci) + ")");
@@ -605,12 +601,12 @@ bool mdg::parseMDGPC(const char* buffer, size_t size, const mdl2::MDL3Metadata&
 				}
 
 				if (totalVertices == 0) {
-					Debug::log("MDG PC: Mesh has 0 total vertices, skipping");
+					LOG_DEBUG(MDG, "MDG PC: Mesh has 0 total vertices, skipping");
 					meshRef = nextMesh;
 					continue;
 				}
 				
-				Debug::log("MDG PC: Total vertices expected: " + std::to_string(totalVertices));
+				LOG_DEBUG(MDG, "MDG PC: Total vertices expected: " + std::to_string(totalVertices));
 				
 				// Use current position in sequential vertex data block
 				size_t vertexDataOffset = currentVertexDataOffset;
@@ -620,33 +616,59 @@ bool mdg::parseMDGPC(const char* buffer, size_t size, const mdl2::MDL3Metadata&
 				
 				// Verify we have enough data
 				if (vertexDataOffset + expectedDataSize > size) {
-					Debug::log("MDG PC: Not enough data at offset " + std::to_string(vertexDataOffset) + 
+					LOG_DEBUG(MDG, "MDG PC: Not enough data at offset " + std::to_string(vertexDataOffset) + 
 						" (need " + std::to_string(expectedDataSize) + " bytes, have " + std::to_string(size - vertexDataOffset) + ")");
 					meshRef = nextMesh;
 					continue;
 				}
 
+				// Collision meshes share the vertex layout, only their positions are kept.
+				// Unlike render meshes, box-like ones are real collision and are not skipped.
 				if (isCollisionTexture)
 				{
-					Debug::log("MDG PC: Skipping collision material mesh");
 					currentVertexDataOffset = vertexDataOffset + expectedDataSize;
+
+					if (totalVertices >= 3)
+					{
+						CollisionMeshData collisionMesh;
+						collisionMesh.positions.resize(totalVertices);
+						for (size_t i = 0; i < totalVertices; i++)
+						{
+							size_t vertexOffset = vertexDataOffset + (i * VERTEX_STRIDE);
+							collisionMesh.positions[i][0] = from_bytes<float>(buffer, vertexOffset + 12);
+							collisionMesh.positions[i][1] = from_bytes<float>(buffer, vertexOffset + 16);
+							collisionMesh.positions[i][2] = from_bytes<float>(buffer, vertexOffset + 20);
+						}
+
+						if (stripCountsMatch(stripVertexCounts, totalVertices))
+						{
+							collisionMesh.stripVertexCounts = stripVertexCounts;
+						}
+						collisionMesh.componentIndex = ci;
+
+						LOG_DEBUG(MDG, "MDG PC: Parsed collision material mesh with " + std::to_string(totalVertices) + " vertices");
+						collisionMeshes.push_back(std::move(collisionMesh));
+					}
+
 					meshRef = nextMesh;
 					continue;
 				}
 
-				Debug::log("MDG PC: UV format = Float2@+4");
+				LOG_DEBUG(MDG, "MDG PC: UV format = Float2@+4");
 				
 				// Log first vertex for debugging (position is at +12)
-				float u = from_bytes<float>(buffer, vertexDataOffset + 4);
-				float v = from_bytes<float>(buffer, vertexDataOffset + 8);
-				v = 1.0f - v;
-				float x = from_bytes<float>(buffer, vertexDataOffset + 12);
-				float y = from_bytes<float>(buffer, vertexDataOffset + 16);
-				float z = from_bytes<float>(buffer, vertexDataOffset + 20);
-				Debug::log("MDG PC: Reading vertex data at offset " + std::to_string(vertexDataOffset) + 
-					" (" + std::to_string(expectedDataSize) + " bytes needed)");
-				Debug::log("MDG PC: First vertex UV: (" + std::to_string(u) + ", " + std::to_string(v) + ")");
-				Debug::log("MDG PC: First vertex Pos: (" + std::to_string(x) + ", " + std::to_string(y) + ", " + std::to_string(z) + ")");
+				if (LOG_DEBUG_ENABLED(MDG))
+				{
+					LOG_DEBUG(MDG, "MDG PC: Reading vertex data at offset " + std::to_string(vertexDataOffset) + 
+						" (" + std::to_string(expectedDataSize) + " bytes needed)");
+					LOG_DEBUG(MDG, "MDG PC: First vertex UV: (" +
+						std::to_string(from_bytes<float>(buffer, vertexDataOffset + 4)) + ", " +
+						std::to_string(1.0f - from_bytes<float>(buffer, vertexDataOffset + 8)) + ")");
+					LOG_DEBUG(MDG, "MDG PC: First vertex Pos: (" +
+						std::to_string(from_bytes<float>(buffer, vertexDataOffset + 12)) + ", " +
+						std::to_string(from_bytes<float>(buffer, vertexDataOffset + 16)) + ", " +
+						std::to_string(from_bytes<float>(buffer, vertexDataOffset + 20)) + ")");
+				}
 
 				// PC Format: Interleaved vertex data with 48-byte stride
 				// Layout per vertex:
@@ -664,7 +686,7 @@ bool mdg::parseMDGPC(const char* buffer, size_t size, const mdl2::MDL3Metadata&
 				size_t requiredSize = totalVertices * VERTEX_STRIDE;
 				
 				if (currentOffset + requiredSize > size) {
-					Debug::log("MDG PC: Not enough data for vertices (need " + 
+					LOG_DEBUG(MDG, "MDG PC: Not enough data for vertices (need " + 
 						std::to_string(requiredSize) + " bytes, have " + std::to_string(size - currentOffset) + ")");
 					meshRef = nextMesh;
 					continue;
@@ -736,7 +758,7 @@ bool mdg::parseMDGPC(const char* buffer, size_t size, const mdl2::MDL3Metadata&
 				bool useShiftedUvs = (adjacentPairs > 0 && matchesShift1 > matchesShift0);
 				if (useShiftedUvs)
 				{
-					Debug::log("MDG PC: Using +1 UV shift based on duplicate matches");
+					LOG_DEBUG(MDG, "MDG PC: Using +1 UV shift based on duplicate matches");
 				}
 
 				for (size_t i = 0; i < totalVertices; i++)
@@ -751,7 +773,7 @@ bool mdg::parseMDGPC(const char* buffer, size_t size, const mdl2::MDL3Metadata&
 				}
 				currentOffset += totalVertices * VERTEX_STRIDE;
 				
-				Debug::log("MDG PC: Parsed " + std::to_string(totalVertices) + " vertices (ended at offset " + std::to_string(currentOffset) + ")");
+				LOG_DEBUG(MDG, "MDG PC: Parsed " + std::to_string(totalVertices) + " vertices (ended at offset " + std::to_string(currentOffset) + ")");
 				
 				// Advance the global vertex data pointer for next mesh
 				currentVertexDataOffset = currentOffset;
@@ -766,18 +788,17 @@ bool mdg::parseMDGPC(const char* buffer, size_t size, const mdl2::MDL3Metadata&
 					}
 				}
 				
-				float nonZeroPercent = (float)nonZeroCount / (float)totalVertices * 100.0f;
-				Debug::log("MDG PC: Non-zero vertices: " + std::to_string(nonZeroCount) + "/" + std::to_string(totalVertices) + 
-					" (" + std::to_string((int)nonZeroPercent) + "%)");
+				LOG_DEBUG(MDG, "MDG PC: Non-zero vertices: " + std::to_string(nonZeroCount) + "/" + std::to_string(totalVertices) + 
+					" (" + std::to_string((int)((float)nonZeroCount / (float)totalVertices * 100.0f)) + "%)");
 				
 				if (nonZeroCount < 3) {
-					Debug::log("MDG PC: ERROR - All or most vertices are at origin, skipping mesh (data invalid or wrong offset)");
+					LOG_WARNING(MDG, "MDG PC: All or most vertices are at origin, skipping mesh (data invalid or wrong offset)");
 					meshRef = nextMesh;
 					continue;
 				}
 				
 				if (totalVertices < 3) {
-					Debug::log("MDG PC: Mesh has fewer than 3 vertices, skipping");
+					LOG_DEBUG(MDG, "MDG PC: Mesh has fewer than 3 vertices, skipping");
 					meshRef = nextMesh;
 					continue;
 				}
@@ -809,7 +830,7 @@ bool mdg::parseMDGPC(const char* buffer, size_t size, const mdl2::MDL3Metadata&
 
 				if (boxLike)
 				{
-					Debug::log("MDG PC: Skipping box-like mesh (likely bounds)");
+					LOG_DEBUG(MDG, "MDG PC: Skipping box-like mesh (likely bounds)");
 					meshRef = nextMesh;
 					continue;
 				}
@@ -820,27 +841,14 @@ bool mdg::parseMDGPC(const char* buffer, size_t size, const mdl2::MDL3Metadata&
 				meshData.vertices = allVertices;
 				if (!stripVertexCounts.empty())
 				{
-					size_t stripSum = 0;
-					for (auto count : stripVertexCounts)
-					{
-						stripSum += count;
-					}
-					const size_t stripCount = stripVertexCounts.size();
-					const size_t stripDegenerate2Sum = stripSum + (stripCount > 0 ? (stripCount - 1) * 2 : 0);
-					const size_t stripDegenerate1Sum = stripSum + (stripCount > 0 ? (stripCount - 1) : 0);
-					const bool countsIncludeDegenerates = (stripSum == totalVertices);
-					const bool countsExcludeDegenerates2 = (stripDegenerate2Sum == totalVertices);
-					const bool countsExcludeDegenerates1 = (!countsExcludeDegenerates2 && stripDegenerate1Sum == totalVertices);
-
-					Debug::log("MDG PC: Strip vertex count sum=" + std::to_string(stripSum) + " totalVertices=" + std::to_string(totalVertices));
-					if (countsIncludeDegenerates || countsExcludeDegenerates2 || countsExcludeDegenerates1)
+					if (stripCountsMatch(stripVertexCounts, totalVertices))
 					{
 						meshData.stripVertexCounts = stripVertexCounts;
-						Debug::log("MDG PC: Using per-strip index generation (counts align)");
+						LOG_DEBUG(MDG, "MDG PC: Using per-strip index generation (counts align)");
 					}
 					else
 					{
-						Debug::log("MDG PC: Strip counts don't align, using single strip");
+						LOG_DEBUG(MDG, "MDG PC: Strip counts don't align, using single strip");
 					}
 				}
 				meshData.textureIndex = ti;
@@ -853,7 +861,7 @@ bool mdg::parseMDGPC(const char* buffer, size_t size, const mdl2::MDL3Metadata&
 		}
 	}
 
-	Debug::log("MDG PC: Parsed " + std::to_string(meshes.size()) + " meshes");
+	LOG_DEBUG(MDG, "MDG PC: Parsed " + std::to_string(meshes.size()) + " meshes");
 	return !meshes.empty();
 }
 
@@ -870,11 +878,12 @@ bool mdg::parseStripPC(const char* buffer, size_t size, size_t& offset, uint8_t
 	vertices.clear();
 	vertices.resize(vertexCount);
 
-	size_t startOffset = offset;
+	// Only read by the debug log at the end.
+	[[maybe_unused]] size_t startOffset = offset;
 	
 	// Read positions (always 12 bytes per vertex)
 	if (offset + (vertexCount * 12) > size) {
-		Debug::log("MDG PC: Not enough data for positions");
+		LOG_DEBUG(MDG, "MDG PC: Not enough data for positions");
 		return false;
 	}
 	
@@ -887,7 +896,7 @@ bool mdg::parseStripPC(const char* buffer, size_t size, size_t& offset, uint8_t
 	
 	// Read UVs (8 bytes per vertex - 2 floats)
 	if (offset + (vertexCount * 8) > size) {
-		Debug::log("MDG PC: Not enough data for UVs");
+		LOG_DEBUG(MDG, "MDG PC: Not enough data for UVs");
 		return false;
 	}
 	
@@ -900,7 +909,7 @@ bool mdg::parseStripPC(const char* buffer, size_t size, size_t& offset, uint8_t
 	
 	// Read normals (12 bytes per vertex - 3 floats)
 	if (offset + (vertexCount * 12) > size) {
-		Debug::log("MDG PC: Not enough data for normals");
+		LOG_DEBUG(MDG, "MDG PC: Not enough data for normals");
 		return false;
 	}
 	
@@ -913,7 +922,7 @@ bool mdg::parseStripPC(const char* buffer, size_t size, size_t& offset, uint8_t
 	
 	// Read colors (4 bytes per vertex - RGBA)
 	if (offset + (vertexCount * 4) > size) {
-		Debug::log("MDG PC: Not enough data for colors");
+		LOG_DEBUG(MDG, "MDG PC: Not enough data for colors");
 		return false;
 	}
 	
@@ -932,7 +941,7 @@ bool mdg::parseStripPC(const char* buffer, size_t size, size_t& offset, uint8_t
 		vertices[i].skin[2] = 0.0f;
 	}
 	
-	Debug::log("MDG PC: Parsed strip with " + std::to_string(vertexCount) + 
+	LOG_DEBUG(MDG, "MDG PC: Parsed strip with " + std::to_string(vertexCount) + 
 		" vertices (total bytes: " + std::to_string(offset - startOffset) + ")");
 	
 	return true;
@@ -944,13 +953,15 @@ bool mdg::parseStripPC(const char* buffer, size_t size, size_t& offset, uint8_t
 
 bool mdg::load(const char* buffer, size_t size)
 {
+	TRACE_ZONE("mdg::load");
+
 	if (buffer == nullptr || size == 0)
 	{
-		Debug::log("MDG: Invalid buffer or size");
+		LOG_WARNING(MDG, "Invalid buffer or size");
 		return false;
 	}
 
-	Debug::log("MDG: Attempting fallback pattern-based parsing (non-TY2 format)");
+	LOG_DEBUG(MDG, "Attempting fallback pattern-based parsing (non-TY2 format)");
 	meshes.clear();
 
 	// Pattern to find: \x00\x80\x02\x6C
@@ -959,11 +970,11 @@ bool mdg::load(const char* buffer, size_t size)
 
 	if (positions.empty())
 	{
-		Debug::log("MDG: No mesh patterns found in file");
+		LOG_DEBUG(MDG, "No mesh patterns found in file");
 		return false;
 	}
 
-	Debug::log("MDG: Found " + std::to_string(positions.size()) + " pattern(s)");
+	LOG_DEBUG(MDG, "Found " + std::to_string(positions.size()) + " pattern(s)");
 
 	// Basic parsing for fallback format (simplified)
 	for (size_t i = 0; i < positions.size(); i++)
@@ -1070,7 +1081,7 @@ bool mdg::load(const char* buffer, size_t size)
 		meshes.push_back(meshData);
 	}
 
-	Debug::log("MDG: Fallback parsing complete, found " + std::to_string(meshes.size()) + " mesh(es)");
+	LOG_DEBUG(MDG, "Fallback parsing complete, found " + std::to_string(meshes.size()) + " mesh(es)");
 	return !meshes.empty();
 }
 
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <array>
 #include <string>
 #include <vector>
 
@@ -16,12 +17,22 @@ public:
 		uint32_t componentIndex; // Component index from MDL3
 	};
 
+	// Mesh with a "CM_" collision material, strips of positions only.
+	struct CollisionMeshData
+	{
+		std::vector<std::array<float, 3>> positions;
+		std::vector<uint16_t> stripVertexCounts;
+		uint32_t componentIndex;
+	};
+
 public:
 	bool load(const char* buffer, size_t size);
 	bool loadWithMDL3Metadata(const char* buffer, size_t size, const mdl2::MDL3Metadata& mdl3Metadata, const char* mdlBuffer, size_t mdlOffset);
 
 public:
 	std::vector<MeshData> meshes;
+	// Only found by the PC parser, kept apart from 'meshes' as they are never drawn with a texture.
+	std::vector<CollisionMeshData> collisionMeshes;
 
 private:
 	bool parseMDGWithObjectLookupTable(const char* buffer, size_t size, const mdl2::MDL3Metadata& mdl3Metadata, const char* mdlBuffer, size_t mdlOffset);
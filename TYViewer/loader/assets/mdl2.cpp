@@ -2,6 +2,7 @@
 
 #include "util/bitconverter.h"
 #include "util/stringext.h"
+#include "util/trace.h"
 #include "debug.h"
 
 #include <iostream>
@@ -9,6 +10,8 @@
 
 bool mdl2::load(const char* buffer, size_t offset)
 {
+	TRACE_ZONE("mdl2::load");
+
 	isMDL3Format = false; // TY 1 format
 	
 	if (from_bytes<uint32_t>(buffer, 0) != 843859021)
@@ -48,6 +51,8 @@ bool mdl2::load(const char* buffer, size_t offset)
 
 bool mdl2::loadTY2(const char* buffer, size_t offset)
 {
+	TRACE_ZONE("mdl2::loadTY2");
+
 	// First try MDL3 format (newer TY 2 structure)
 	if (loadTY2MDL3(buffer, offset))
 	{
@@ -57,14 +62,13 @@ bool mdl2::loadTY2(const char* buffer, size_t offset)
 	// Fallback: TY 2 format with same structure as TY 1 but different signature
 	try
 	{
-		Debug::log("loadTY2: Reading header values...");
+		LOG_DEBUG(MDL, "loadTY2: Reading header values...");
 		// Read header values
-		unsigned int frag_count = from_bytes<uint16_t>(buffer, 4);
 		unsigned int subobject_count = from_bytes<uint16_t>(buffer, 6);
 		unsigned int collider_count = from_bytes<uint16_t>(buffer, 8);
 		unsigned int bone_count = from_bytes<uint16_t>(buffer, 10);
 
-		Debug::log("loadTY2: Header - frag:" + std::to_string(frag_count) + 
+		LOG_DEBUG(MDL, "loadTY2: Header - frag:" + std::to_string(from_bytes<uint16_t>(buffer, 4)) + 
 			" subobj:" + std::to_string(subobject_count) + 
 			" collider:" + std::to_string(collider_count) + 
 			" bone:" + std::to_string(bone_count));
@@ -72,18 +76,16 @@ bool mdl2::loadTY2(const char* buffer, size_t offset)
 		// Validate reasonable values
 		if (subobject_count > 1000 || collider_count > 1000 || bone_count > 1000)
 		{
-			Debug::log("loadTY2: Failed validation - counts too high");
+			LOG_WARNING(MDL, "loadTY2: Failed validation - counts too high");
 			return false;
 		}
 
-		Debug::log("loadTY2: Reading offsets...");
+		LOG_DEBUG(MDL, "loadTY2: Reading offsets...");
 		size_t subobject_offset = from_bytes<uint32_t>(buffer, 12);
-		size_t collider_offset = from_bytes<uint32_t>(buffer, 16);
-		size_t bone_offset = from_bytes<uint32_t>(buffer, 20);
 
-		Debug::log("loadTY2: Offsets - subobj:" + std::to_string(subobject_offset) + 
-			" collider:" + std::to_string(collider_offset) + 
-			" bone:" + std::to_string(bone_offset));
+		LOG_DEBUG(MDL, "loadTY2: Offsets - subobj:" + std::to_string(subobject_offset) + 
+			" collider:" + std::to_string(from_bytes<uint32_t>(buffer, 16)) + 
+			" bone:" + std::to_string(from_bytes<uint32_t>(buffer, 20)));
 
 		// For TY 2, if offsets look invalid (too large), the structure might be different
 		// Since TY 2 uses .mdg for mesh data, we can skip parsing subobjects if offsets are invalid
@@ -91,12 +93,12 @@ bool mdl2::loadTY2(const char* buffer, size_t offset)
 		bool skipSubobjectParsing = false;
 		if (subobject_offset > 10000 || (subobject_offset == 0 && subobject_count > 0))
 		{
-			Debug::log("loadTY2: Warning - subobject_offset looks invalid (" + std::to_string(subobject_offset) + "), skipping subobject parsing");
-			Debug::log("loadTY2: TY 2 format may have different structure - will use MDG data only");
+			LOG_WARNING(MDL, "loadTY2: Warning - subobject_offset looks invalid (" + std::to_string(subobject_offset) + "), skipping subobject parsing");
+			LOG_DEBUG(MDL, "loadTY2: TY 2 format may have different structure - will use MDG data only");
 			skipSubobjectParsing = true;
 		}
 
-		Debug::log("loadTY2: Reading bounds...");
+		LOG_DEBUG(MDL, "loadTY2: Reading bounds...");
 		bounds =
 		{
 			from_bytes<float>(buffer, offset + 32),	from_bytes<float>(buffer, offset + 36),	from_bytes<float>(buffer, offset + 40),
@@ -104,7 +106,7 @@ bool mdl2::loadTY2(const char* buffer, size_t offset)
 			from_bytes<float>(buffer, offset + 64), from_bytes<float>(buffer, offset + 68), from_bytes<float>(buffer, offset + 72)
 		};
 
-		Debug::log("loadTY2: Reading name...");
+		LOG_DEBUG(MDL, "loadTY2: Reading name...");
 		uint32_t name_offset = from_bytes<uint32_t>(buffer, 68);
 		if (name_offset > 0 && name_offset < 1000000) // Reasonable limit
 		{
@@ -117,11 +119,11 @@ bool mdl2::loadTY2(const char* buffer, size_t offset)
 
 		if (!skipSubobjectParsing)
 		{
-			Debug::log("loadTY2: Parsing " + std::to_string(subobject_count) + " subobjects...");
+			LOG_DEBUG(MDL, "loadTY2: Parsing " + std::to_string(subobject_count) + " subobjects...");
 			subobjects = std::vector<Subobject>(subobject_count);
 			for (unsigned int i = 0; i < subobject_count; i++)
 			{
-				Debug::log("loadTY2: Parsing subobject " + std::to_string(i) + " at offset " + std::to_string(offset + subobject_offset));
+				LOG_DEBUG(MDL, "loadTY2: Parsing subobject " + std::to_string(i) + " at offset " + std::to_string(offset + subobject_offset));
 				try
 				{
 					subobjects[i] = parse_subobject(buffer, offset + subobject_offset);
@@ -129,7 +131,7 @@ bool mdl2::loadTY2(const char* buffer, size_t offset)
 				}
 				catch (...)
 				{
-					Debug::log("loadTY2: Failed to parse subobject " + std::to_string(i) + ", creating empty subobject");
+					LOG_WARNING(MDL, "loadTY2: Failed to parse subobject " + std::to_string(i) + ", creating empty subobject");
 					// Create empty subobject
 					subobjects[i] = { {0,0,0,0,0,0,0,0,0}, "", "", 0, {} };
 					subobject_offset += 80;
@@ -139,7 +141,7 @@ bool mdl2::loadTY2(const char* buffer, size_t offset)
 		else
 		{
 			// Create empty subobjects - we'll use MDG data directly
-			Debug::log("loadTY2: Creating " + std::to_string(subobject_count) + " empty subobjects (will use MDG data)");
+			LOG_DEBUG(MDL, "loadTY2: Creating " + std::to_string(subobject_count) + " empty subobjects (will use MDG data)");
 			subobjects = std::vector<Subobject>(subobject_count);
 			for (unsigned int i = 0; i < subobject_count; i++)
 			{
@@ -147,26 +149,28 @@ bool mdl2::loadTY2(const char* buffer, size_t offset)
 			}
 		}
 
-		Debug::log("loadTY2: Successfully loaded TY 2 MDL");
+		LOG_DEBUG(MDL, "loadTY2: Successfully loaded TY 2 MDL");
 		return true;
 	}
 	catch (const std::exception& e)
 	{
-		Debug::log("loadTY2: Exception caught: " + std::string(e.what()));
+		LOG_ERROR(MDL, "loadTY2: Exception caught: " + std::string(e.what()));
 		return false;
 	}
 	catch (...)
 	{
-		Debug::log("loadTY2: Unknown exception caught");
+		LOG_ERROR(MDL, "loadTY2: Unknown exception caught");
 		return false;
 	}
 }
 
 bool mdl2::loadTY2MDL3(const char* buffer, size_t offset)
 {
+	TRACE_ZONE("mdl2::loadTY2MDL3");
+
 	try
 	{
-		Debug::log("loadTY2MDL3: Attempting to parse MDL3 format...");
+		LOG_DEBUG(MDL, "loadTY2MDL3: Attempting to parse MDL3 format...");
 		
 		// Read MDL3 header structure (based on reference converter)
 		mdl3Metadata.ComponentCount = from_bytes<uint16_t>(buffer, offset + 0x4);
@@ -180,11 +184,11 @@ bool mdl2::loadTY2MDL3(const char* buffer, size_t offset)
 		if (mdl3Metadata.ComponentCount > 1000 || mdl3Metadata.TextureCount > 1000 || 
 			mdl3Metadata.AnimNodeCount > 1000 || mdl3Metadata.RefPointCount > 1000)
 		{
-			Debug::log("loadTY2MDL3: Failed validation - counts too high");
+			LOG_WARNING(MDL, "loadTY2MDL3: Failed validation - counts too high");
 			return false;
 		}
 
-		Debug::log("loadTY2MDL3: ComponentCount=" + std::to_string(mdl3Metadata.ComponentCount) +
+		LOG_DEBUG(MDL, "loadTY2MDL3: ComponentCount=" + std::to_string(mdl3Metadata.ComponentCount) +
 			" TextureCount=" + std::to_string(mdl3Metadata.TextureCount) +
 			" AnimNodeCount=" + std::to_string(mdl3Metadata.AnimNodeCount) +
 			" RefPointCount=" + std::to_string(mdl3Metadata.RefPointCount) +
@@ -207,7 +211,7 @@ bool mdl2::loadTY2MDL3(const char* buffer, size_t offset)
 		mdl3Metadata.AnimNodeListsOffset = from_bytes<uint32_t>(buffer, offset + 0x64);
 		mdl3Metadata.ObjectLookupTable = from_bytes<uint32_t>(buffer, offset + 0x68);
 
-		Debug::log("loadTY2MDL3: ObjectLookupTable=" + std::to_string(mdl3Metadata.ObjectLookupTable) +
+		LOG_DEBUG(MDL, "loadTY2MDL3: ObjectLookupTable=" + std::to_string(mdl3Metadata.ObjectLookupTable) +
 			" TextureListOffset=" + std::to_string(mdl3Metadata.TextureListOffset));
 
 		// Read texture names
@@ -217,7 +221,7 @@ bool mdl2::loadTY2MDL3(const char* buffer, size_t offset)
 			uint32_t textureNameOffset = from_bytes<uint32_t>(buffer, offset + mdl3Metadata.TextureListOffset + (ti * 4));
 			std::string textureName = nts(buffer, offset + textureNameOffset);
 			mdl3Metadata.TextureNames.push_back(textureName);
-			Debug::log("loadTY2MDL3: Texture[" + std::to_string(ti) + "]=" + textureName);
+			LOG_DEBUG(MDL, "loadTY2MDL3: Texture[" + std::to_string(ti) + "]=" + textureName);
 		}
 
 		// Read string table offset from component descriptions
@@ -254,17 +258,17 @@ bool mdl2::loadTY2MDL3(const char* buffer, size_t offset)
 		}
 
 		isMDL3Format = true;
-		Debug::log("loadTY2MDL3: Successfully parsed MDL3 format");
+		LOG_DEBUG(MDL, "loadTY2MDL3: Successfully parsed MDL3 format");
 		return true;
 	}
 	catch (const std::exception& e)
 	{
-		Debug::log("loadTY2MDL3: Exception caught: " + std::string(e.what()));
+		LOG_ERROR(MDL, "loadTY2MDL3: Exception caught: " + std::string(e.what()));
 		return false;
 	}
 	catch (...)
 	{
-		Debug::log("loadTY2MDL3: Unknown exception caught");
+		LOG_ERROR(MDL, "loadTY2MDL3: Unknown exception caught");
 		return false;
 	}
 }
@@ -275,7 +279,7 @@ mdl2::Subobject mdl2::parse_subobject(const char* buffer, size_t offset)
 	// Note: This is a minimal check; full validation would require buffer size
 	if (offset > 1000000) // Sanity check - offset way too large
 	{
-		Debug::log("parse_subobject: Offset too large: " + std::to_string(offset));
+		LOG_WARNING(MDL, "parse_subobject: Offset too large: " + std::to_string(offset));
 		throw std::runtime_error("Invalid subobject offset");
 	}
 
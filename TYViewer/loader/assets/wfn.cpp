@@ -1,9 +1,12 @@
 #include "wfn.h"
 
 #include "util/bitconverter.h"
+#include "util/trace.h"
 
 void WFN::load(const std::vector<char>& data)
 {
+	TRACE_ZONE("WFN::load");
+
 	characterCount		= from_bytes<uint32_t>(&data[0], 0);
 	spaceWidth			= from_bytes<float>(&data[0], 12);
 	firstCharacter		= (int)from_bytes<float>(&data[0], 36);
@@ -0,0 +1,431 @@
+#include "dependencyindex.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <cstdlib>
+#include <fstream>
+#include <algorithm>
+#include <stdexcept>
+
+#include "loader/modelbuilder.h"
+
+#include "util/textwriter.h"
+#include "util/trace.h"
+
+#include "debug.h"
+#include "util/timing.h"
+
+// Bumped whenever the file layout or what is read from a model changes, older files are rebuilt.
+#define DEPENDENCY_INDEX_HEADER "TYViewer dependencies 1"
+#define DEPENDENCY_INDEX_EXTENSION ".deps"
+
+#define DEPENDENCY_FLAG_TY2 1
+#define DEPENDENCY_FLAG_PARSED 2
+
+static std::string toLower(const std::string& text)
+{
+	std::string lower = text;
+	std::transform(lower.begin(), lower.end(), lower.begin(), ::tolower);
+	return lower;
+}
+
+// Models refer to textures without the extension, their entries are '<texture>.dds'.
+static std::string getTextureKey(const std::string& texture)
+{
+	std::string key = toLower(texture);
+	if (key.size() > 4 && key.compare(key.size() - 4, 4, ".dds") == 0)
+		key.resize(key.size() - 4);
+	return key;
+}
+
+static void splitFields(const std::string& line, std::vector<std::string>& fields)
+{
+	fields.clear();
+
+	size_t start = 0;
+	while (start <= line.size())
+	{
+		size_t end = line.find('\t', start);
+		if (end == std::string::npos)
+			end = line.size();
+
+		fields.push_back(line.substr(start, end - start));
+		start = end + 1;
+	}
+}
+
+DependencyIndex::DependencyIndex() :
+	modified(false)
+{}
+
+std::string DependencyIndex::getPath(const std::string& archivePath)
+{
+	return archivePath + DEPENDENCY_INDEX_EXTENSION;
+}
+
+bool DependencyIndex::load(const std::string& path)
+{
+	TRACE_ZONE_DETAIL("DependencyIndex::load", path);
+
+	std::ifstream stream(path);
+	if (stream.fail())
+		return false;
+
+	std::string line;
+	if (!std::getline(stream, line) || line != DEPENDENCY_INDEX_HEADER)
+	{
+		LOG_INFO(Archive, "Dependency index " + path + " is from another version, rebuilding it");
+		return false;
+	}
+
+	entries.clear();
+
+	// One model per line: name, size, offset, crc, date, flags, then its textures, tab separated.
+	std::vector<std::string> fields;
+	while (std::getline(stream, line))
+	{
+		splitFields(line, fields);
+		if (fields.size() < 6 || fields[0].empty())
+		{
+			LOG_WARNING(Archive, "Dependency index " + path + " is damaged, rebuilding it");
+			entries.clear();
+			return false;
+		}
+
+		DependencyEntry entry;
+		entry.model = fields[0];
+		entry.size = std::strtoll(fields[1].c_str(), nullptr, 10);
+		entry.offset = static_cast<std::int32_t>(std::strtol(fields[2].c_str(), nullptr, 10));
+		entry.crc = static_cast<std::uint32_t>(std::strtoul(fields[3].c_str(), nullptr, 10));
+		entry.date = std::strtoll(fields[4].c_str(), nullptr, 10);
+
+		int flags = std::atoi(fields[5].c_str());
+		entry.isTY2 = (flags & DEPENDENCY_FLAG_TY2) != 0;
+		entry.parsed = (flags & DEPENDENCY_FLAG_PARSED) != 0;
+
+		entry.textures.assign(fields.begin() + 6, fields.end());
+		entries.push_back(std::move(entry));
+	}
+
+	return true;
+}
+
+bool DependencyIndex::save(const std::string& path) const
+{
+	TRACE_ZONE_DETAIL("DependencyIndex::save", path);
+
+	TextWriter writer;
+	if (!writer.open(path))
+		return false;
+
+	writer << DEPENDENCY_INDEX_HEADER << '\n';
+
+	for (auto& entry : entries)
+	{
+		int flags = (entry.isTY2 ? DEPENDENCY_FLAG_TY2 : 0) | (entry.parsed ? DEPENDENCY_FLAG_PARSED : 0);
+
+		writer << entry.model << '\t' << entry.size << '\t' << entry.offset << '\t' << entry.crc << '\t' << entry.date << '\t' << flags;
+		for (auto& texture : entry.textures)
+		{
+			writer << '\t' << texture;
+		}
+		writer << '\n';
+	}
+
+	return writer.close();
+}
+
+void DependencyIndex::build(const Archive& archive, unsigned int threads)
+{
+	TRACE_ZONE("DependencyIndex::build");
+
+	auto start = std::chrono::high_resolution_clock::now();
+
+	stats = DependencyStats();
+
+	std::unordered_map<std::string, size_t> previous;
+	for (size_t i = 0; i < entries.size(); i++)
+	{
+		previous[toLower(entries[i].model)] = i;
+	}
+
+	std::vector<std::string> names = archive.getFileNames("mdl");
+	std::vector<DependencyEntry> current(names.size());
+	std::vector<size_t> pending;
+
+	for (size_t i = 0; i < names.size(); i++)
+	{
+		DependencyEntry& entry = current[i];
+		entry.model = names[i];
+
+		File file;
+		archive.getFile(names[i], file);
+		entry.size = file.size;
+		entry.offset = file.offset;
+		entry.crc = file.crc;
+		entry.date = file.date;
+
+		File mdg;
+		entry.isTY2 = archive.getFile(ModelBuilder::getMDGName(names[i]), mdg);
+
+		auto it = previous.find(toLower(names[i]));
+		if (it != previous.end())
+		{
+			DependencyEntry& old = entries[it->second];
+			if (old.size == entry.size && old.offset == entry.offset && old.crc == entry.crc && old.date == entry.date && old.isTY2 == entry.isTY2)
+			{
+				entry.parsed = old.parsed;
+				entry.textures = std::move(old.textures);
+				stats.reused++;
+				continue;
+			}
+		}
+
+		pending.push_back(i);
+	}
+
+	modified = !pending.empty() || stats.reused != entries.size();
+
+	if (threads == 0)
+		threads = std::max(1u, std::thread::hardware_concurrency());
+	threads = std::max(1u, std::min(threads, static_cast<unsigned int>(pending.size())));
+
+	std::atomic<size_t> next(0);
+
+	auto worker = [&]()
+	{
+		for (size_t i = next++; i < pending.size(); i = next++)
+		{
+			scan(archive, current[pending[i]]);
+		}
+	};
+
+	std::vector<std::thread> workers;
+	for (unsigned int i = 1; i < threads; i++)
+	{
+		workers.emplace_back([&]()
+		{
+			Trace::setThreadName("Dependencies");
+			worker();
+		});
+	}
+	worker();
+
+	for (auto& thread : workers)
+	{
+		thread.join();
+	}
+
+	stats.scanned = pending.size();
+	for (size_t i : pending)
+	{
+		if (!current[i].parsed)
+			stats.failed++;
+	}
+
+	entries = std::move(current);
+	link(archive);
+
+	stats.milliseconds = millisecondsSince(start);
+}
+
+std::vector<std::string> DependencyIndex::getTextures(const std::string& model) const
+{
+	std::vector<std::string> names;
+
+	int64_t id = findModel(model);
+	if (id < 0)
+		return names;
+
+	for (uint32_t i = modelOffsets[id]; i < modelOffsets[id + 1]; i++)
+	{
+		names.push_back(textures[modelTextures[i]]);
+	}
+
+	std::sort(names.begin(), names.end());
+	return names;
+}
+
+std::vector<std::string> DependencyIndex::getModels(const std::string& texture) const
+{
+	std::vector<std::string> names;
+
+	int64_t id = findTexture(texture);
+	if (id < 0)
+		return names;
+
+	// Model ids follow name order, so these are sorted already.
+	for (uint32_t i = textureOffsets[id]; i < textureOffsets[id + 1]; i++)
+	{
+		names.push_back(entries[textureModels[i]].model);
+	}
+	return names;
+}
+
+size_t DependencyIndex::getUseCount(const std::string& texture) const
+{
+	int64_t id = findTexture(texture);
+	if (id < 0)
+		return 0;
+	return textureOffsets[id + 1] - textureOffsets[id];
+}
+
+std::vector<std::string> DependencyIndex::getMissingTextures() const
+{
+	std::vector<std::string> names;
+	for (size_t i = 0; i < textures.size(); i++)
+	{
+		if (!textureExists[i])
+			names.push_back(textures[i]);
+	}
+
+	std::sort(names.begin(), names.end());
+	return names;
+}
+
+std::vector<std::pair<std::string, size_t>> DependencyIndex::getSharedTextures(size_t limit) const
+{
+	std::vector<std::pair<std::string, size_t>> shared;
+	for (size_t i = 0; i < textures.size(); i++)
+	{
+		shared.push_back({ textures[i], textureOffsets[i + 1] - textureOffsets[i] });
+	}
+
+	auto more = [](const std::pair<std::string, size_t>& a, const std::pair<std::string, size_t>& b)
+	{
+		if (a.second != b.second)
+			return a.second > b.second;
+		return a.first < b.first;
+	};
+
+	limit = std::min(limit, shared.size());
+	std::partial_sort(shared.begin(), shared.begin() + limit, shared.end(), more);
+	shared.resize(limit);
+	return shared;
+}
+
+size_t DependencyIndex::getModelCount() const
+{
+	return entries.size();
+}
+
+size_t DependencyIndex::getTextureCount() const
+{
+	return textures.size();
+}
+
+const std::vector<DependencyEntry>& DependencyIndex::getEntries() const
+{
+	return entries;
+}
+
+const DependencyStats& DependencyIndex::getStats() const
+{
+	return stats;
+}
+
+bool DependencyIndex::isModified() const
+{
+	return modified;
+}
+
+void DependencyIndex::scan(const Archive& archive, DependencyEntry& entry)
+{
+	TRACE_ZONE_DETAIL("DependencyIndex::scan", entry.model);
+
+	entry.parsed = false;
+	entry.textures.clear();
+
+	try
+	{
+		std::vector<char> data;
+		if (archive.getFileData(entry.model, data))
+			entry.parsed = ModelBuilder::readTextures(entry.model, data, entry.isTY2, entry.textures);
+	}
+	catch (const std::exception& e)
+	{
+		LOG_WARNING(Archive, "Failed to read textures of " + entry.model + ": " + e.what());
+		entry.parsed = false;
+		entry.textures.clear();
+	}
+}
+
+void DependencyIndex::link(const Archive& archive)
+{
+	TRACE_ZONE("DependencyIndex::link");
+
+	modelIds.clear();
+	textures.clear();
+	textureIds.clear();
+	textureExists.clear();
+	modelOffsets.clear();
+	modelTextures.clear();
+
+	modelOffsets.push_back(0);
+
+	for (size_t i = 0; i < entries.size(); i++)
+	{
+		modelIds[toLower(entries[i].model)] = static_cast<uint32_t>(i);
+
+		size_t first = modelTextures.size();
+		for (auto& texture : entries[i].textures)
+		{
+			std::string key = getTextureKey(texture);
+
+			auto it = textureIds.find(key);
+			if (it == textureIds.end())
+			{
+				it = textureIds.emplace(key, static_cast<uint32_t>(textures.size())).first;
+				textures.push_back(texture);
+
+				File file;
+				textureExists.push_back(archive.getFile(key + ".dds", file));
+			}
+
+			// Spellings differing only in case are the same texture.
+			if (std::find(modelTextures.begin() + first, modelTextures.end(), it->second) == modelTextures.end())
+				modelTextures.push_back(it->second);
+		}
+
+		modelOffsets.push_back(static_cast<uint32_t>(modelTextures.size()));
+	}
+
+	// Counting sort into the other direction, models stay in ascending order per texture.
+	textureOffsets.assign(textures.size() + 1, 0);
+	for (uint32_t texture : modelTextures)
+	{
+		textureOffsets[texture + 1]++;
+	}
+	for (size_t i = 1; i < textureOffsets.size(); i++)
+	{
+		textureOffsets[i] += textureOffsets[i - 1];
+	}
+
+	std::vector<uint32_t> cursors(textureOffsets.begin(), textureOffsets.end() - 1);
+	textureModels.resize(modelTextures.size());
+
+	for (size_t model = 0; model < entries.size(); model++)
+	{
+		for (uint32_t i = modelOffsets[model]; i < modelOffsets[model + 1]; i++)
+		{
+			textureModels[cursors[modelTextures[i]]++] = static_cast<uint32_t>(model);
+		}
+	}
+}
+
+int64_t DependencyIndex::findModel(const std::string& model) const
+{
+	auto it = modelIds.find(toLower(model));
+	if (it == modelIds.end())
+		return -1;
+	return it->second;
+}
+
+int64_t DependencyIndex::findTexture(const std::string& texture) const
+{
+	auto it = textureIds.find(getTextureKey(texture));
+	if (it == textureIds.end())
+		return -1;
+	return it->second;
+}
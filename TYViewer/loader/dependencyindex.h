@@ -0,0 +1,101 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <unordered_map>
+
+#include "loader/archive.h"
+
+// What a model's texture list was read from. A model whose entry still matches is not read again.
+struct DependencyEntry
+{
+	std::string model;
+
+	std::int64_t size = 0;
+	std::int32_t offset = 0;
+	std::uint32_t crc = 0;
+	std::int64_t date = 0;
+	bool isTY2 = false;
+
+	// False if the .mdl could not be parsed, it then has no textures.
+	bool parsed = false;
+
+	// As the model spells them, without ".dds".
+	std::vector<std::string> textures;
+};
+
+struct DependencyStats
+{
+	size_t scanned = 0;
+	size_t reused = 0;
+	size_t failed = 0;
+	double milliseconds = 0.0;
+};
+
+// Which textures each model uses and which models use each texture, from the .mdl material
+// and MDL3 texture lists. Kept next to the archive in '<archive>.deps' and only rescanned
+// for models whose entries changed.
+class DependencyIndex
+{
+public:
+	DependencyIndex();
+
+	static std::string getPath(const std::string& archivePath);
+
+	// Reads a saved index, its entries are reused by the next build() where they still match.
+	bool load(const std::string& path);
+	bool save(const std::string& path) const;
+
+	// Scans every .mdl that load() had no matching entry for, 'threads' 0 uses every core.
+	void build(const Archive& archive, unsigned int threads = 0);
+
+	// Names are case insensitive, textures with or without ".dds". Empty if unknown.
+	std::vector<std::string> getTextures(const std::string& model) const;
+	std::vector<std::string> getModels(const std::string& texture) const;
+
+	// Models sharing 'texture', without listing them.
+	size_t getUseCount(const std::string& texture) const;
+
+	// Referenced by a model but not in the archive.
+	std::vector<std::string> getMissingTextures() const;
+	// Textures by the number of models using them, most first.
+	std::vector<std::pair<std::string, size_t>> getSharedTextures(size_t limit) const;
+
+	size_t getModelCount() const;
+	size_t getTextureCount() const;
+
+	const std::vector<DependencyEntry>& getEntries() const;
+	const DependencyStats& getStats() const;
+
+	// True when build() scanned anything or dropped models the archive no longer has.
+	bool isModified() const;
+
+private:
+	static void scan(const Archive& archive, DependencyEntry& entry);
+
+	// Numbers models and textures and fills both directions from 'entries'.
+	void link(const Archive& archive);
+
+	// -1 if unknown.
+	int64_t findModel(const std::string& model) const;
+	int64_t findTexture(const std::string& texture) const;
+
+	// Sorted by model name.
+	std::vector<DependencyEntry> entries;
+	std::unordered_map<std::string, uint32_t> modelIds;
+
+	std::vector<std::string> textures;
+	std::unordered_map<std::string, uint32_t> textureIds;
+	std::vector<bool> textureExists;
+
+	// Texture ids of model i at modelTextures[modelOffsets[i]] up to modelOffsets[i + 1],
+	// and model ids of texture i likewise.
+	std::vector<uint32_t> modelOffsets;
+	std::vector<uint32_t> modelTextures;
+	std::vector<uint32_t> textureOffsets;
+	std::vector<uint32_t> textureModels;
+
+	DependencyStats stats;
+	bool modified;
+};
@@ -0,0 +1,90 @@
+#include "modelbatch.h"
+
+#include <cstdio>
+#include <atomic>
+#include <thread>
+#include <algorithm>
+
+#include "util/trace.h"
+#include "util/timing.h"
+
+static const char* statusNames[] = { "ok", "empty", "failed" };
+
+std::vector<std::string> ModelBatch::getModelNames(const Archive& archive, const std::vector<std::string>& models, const std::string& filter)
+{
+	std::vector<std::string> names;
+	for (auto& name : models.empty() ? archive.getFileNames("mdl") : models)
+	{
+		if (name.find(filter) != std::string::npos)
+			names.push_back(name);
+	}
+	return names;
+}
+
+unsigned int ModelBatch::getThreadCount(unsigned int requested, size_t models)
+{
+	unsigned int threads = requested == 0 ? std::max(1u, std::thread::hardware_concurrency()) : requested;
+	return static_cast<unsigned int>(std::max<size_t>(1, std::min<size_t>(threads, models)));
+}
+
+double ModelBatch::parallelFor(size_t count, unsigned int threads, const char* threadName, const std::function<void(size_t)>& function)
+{
+	std::atomic<size_t> next(0);
+
+	auto worker = [&]()
+	{
+		for (size_t i = next++; i < count; i = next++)
+		{
+			function(i);
+		}
+	};
+
+	auto start = std::chrono::high_resolution_clock::now();
+
+	std::vector<std::thread> workers;
+	for (unsigned int i = 1; i < threads; i++)
+	{
+		workers.emplace_back([&]()
+		{
+			Trace::setThreadName(threadName);
+			worker();
+		});
+	}
+	worker();
+
+	for (auto& thread : workers)
+	{
+		thread.join();
+	}
+
+	return millisecondsSince(start);
+}
+
+void ModelBatch::guard(BatchResult& result, const std::function<void()>& function)
+{
+	try
+	{
+		function();
+	}
+	catch (const std::exception& e)
+	{
+		result.status = BatchStatus::Failed;
+		result.reason = std::string("exception: ") + e.what();
+	}
+	catch (...)
+	{
+		result.status = BatchStatus::Failed;
+		result.reason = "unknown exception";
+	}
+}
+
+const char* ModelBatch::getStatusName(BatchStatus status)
+{
+	return statusNames[static_cast<int>(status)];
+}
+
+void ModelBatch::printTiming(double wallMilliseconds, double cpuMilliseconds, unsigned int threads)
+{
+	printf("%.1f ms wall, %.1f ms summed over %u threads (%.1fx)\n", wallMilliseconds, cpuMilliseconds, threads,
+		wallMilliseconds > 0.0 ? cpuMilliseconds / wallMilliseconds : 0.0);
+}
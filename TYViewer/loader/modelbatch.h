@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <functional>
+
+#include "loader/archive.h"
+
+enum class BatchStatus
+{
+	Ok,
+	// Built without geometry.
+	Empty,
+	Failed
+};
+
+// What a batch run records for every model, extended by each run.
+struct BatchResult
+{
+	std::string name;
+
+	// Failed until the model gets through.
+	BatchStatus status = BatchStatus::Failed;
+	std::string reason;
+};
+
+// Runs work over many models of an archive on every core and summarizes the results,
+// shared by --sweep and --export.
+class ModelBatch
+{
+public:
+	// 'models', or every .mdl in the archive when empty, keeping those whose name contains 'filter'.
+	static std::vector<std::string> getModelNames(const Archive& archive, const std::vector<std::string>& models, const std::string& filter);
+
+	// 'requested', or one per core for 0, never more than there are models.
+	static unsigned int getThreadCount(unsigned int requested, size_t models);
+
+	// Calls 'function' with every index below 'count' on 'threads' threads, the caller being one of them.
+	// Returns the wall time in milliseconds.
+	static double parallelFor(size_t count, unsigned int threads, const char* threadName, const std::function<void(size_t)>& function);
+
+	// Calls 'function', an exception fails the result with its message as the reason.
+	static void guard(BatchResult& result, const std::function<void()>& function);
+
+	static const char* getStatusName(BatchStatus status);
+
+	template<typename Result>
+	static size_t countFailed(const std::vector<Result>& results);
+
+	// Lists the failed models with their reasons, then how many ended in each status.
+	template<typename Result>
+	static void printResults(const std::vector<Result>& results);
+
+	// Wall time against the time summed over every model.
+	static void printTiming(double wallMilliseconds, double cpuMilliseconds, unsigned int threads);
+};
+
+#include "modelbatch.inl"
@@ -0,0 +1,37 @@
+template<typename Result>
+size_t ModelBatch::countFailed(const std::vector<Result>& results)
+{
+	size_t failed = 0;
+	for (auto& result : results)
+	{
+		failed += result.status == BatchStatus::Failed;
+	}
+	return failed;
+}
+
+template<typename Result>
+void ModelBatch::printResults(const std::vector<Result>& results)
+{
+	size_t ok = 0;
+	size_t empty = 0;
+	size_t failed = 0;
+
+	for (auto& result : results)
+	{
+		ok += result.status == BatchStatus::Ok;
+		empty += result.status == BatchStatus::Empty;
+		failed += result.status == BatchStatus::Failed;
+	}
+
+	if (failed > 0)
+	{
+		printf("\nFailed:\n");
+		for (auto& result : results)
+		{
+			if (result.status == BatchStatus::Failed)
+				printf("  %-40s %s\n", result.name.c_str(), result.reason.c_str());
+		}
+	}
+
+	printf("\n%zu ok, %zu empty, %zu failed\n", ok, empty, failed);
+}
@@ -0,0 +1,719 @@
+#include "modelbuilder.h"
+
+#include <cmath>
+#include <chrono>
+#include <cstring>
+#include <algorithm>
+#include <unordered_map>
+
+#include "util/bitconverter.h"
+#include "util/trace.h"
+#include "util/allocation.h"
+
+#include "debug.h"
+#include "util/timing.h"
+
+static inline bool isSamePosition(const Vertex& a, const Vertex& b)
+{
+	return std::abs(a.position.x - b.position.x) < 0.00001f &&
+		std::abs(a.position.y - b.position.y) < 0.00001f &&
+		std::abs(a.position.z - b.position.z) < 0.00001f;
+}
+
+static inline bool isSameUv(const Vertex& a, const Vertex& b)
+{
+	return std::abs(a.texcoord.x - b.texcoord.x) < 0.00001f &&
+		std::abs(a.texcoord.y - b.texcoord.y) < 0.00001f;
+}
+
+// First four bytes of an MDL file, for reporting files that fail to parse.
+static inline uint32_t readSignature(const std::vector<char>& mdlData)
+{
+	return mdlData.size() >= 4 ? from_bytes<uint32_t>(mdlData.data(), 0) : 0;
+}
+
+// Exact bit pattern of a position, -0 folded into 0, for welding the corners collision strips share.
+struct PositionKey
+{
+	uint32_t bits[3];
+
+	inline bool operator==(const PositionKey& other) const
+	{
+		return bits[0] == other.bits[0] && bits[1] == other.bits[1] && bits[2] == other.bits[2];
+	}
+};
+
+struct PositionKeyHash
+{
+	inline size_t operator()(const PositionKey& key) const
+	{
+		size_t hash = key.bits[0];
+		hash = hash * 0x9E3779B1u ^ key.bits[1];
+		hash = hash * 0x9E3779B1u ^ key.bits[2];
+		return hash;
+	}
+};
+
+static inline PositionKey makePositionKey(const glm::vec3& position)
+{
+	PositionKey key;
+	for (int i = 0; i < 3; i++)
+	{
+		float value = position[i] + 0.0f;
+		std::memcpy(&key.bits[i], &value, sizeof(float));
+	}
+	return key;
+}
+
+static inline Vertex convertVertex(const mdl2::Vertex& vertex)
+{
+	return
+	{
+		glm::vec4(vertex.position[0], vertex.position[1], vertex.position[2], 1.0f),
+		glm::vec4(vertex.normal[0], vertex.normal[1], vertex.normal[2], 1.0f),
+		glm::vec4(vertex.colour[0], vertex.colour[1], vertex.colour[2], vertex.colour[3]),
+		glm::vec2(vertex.texcoord[0], vertex.texcoord[1]),
+		glm::vec3(vertex.skin[0], vertex.skin[1], vertex.skin[2])
+	};
+}
+
+bool ModelBuilder::build(const std::string& name, const std::vector<char>& mdlData, const std::vector<char>* mdgData, ModelData& model)
+{
+	TRACE_ZONE_DETAIL("ModelBuilder::build", name);
+	ALLOCATION_SCOPE(Content);
+
+	model = ModelData();
+	model.name = name;
+	model.isTY2 = mdgData != nullptr;
+
+	auto start = std::chrono::high_resolution_clock::now();
+
+	mdl2 mdl;
+	if (!parse(name, mdlData, model.isTY2, mdl))
+	{
+		model.error = "MDL parse failed (signature " + std::to_string(readSignature(mdlData)) + ")";
+		return false;
+	}
+
+	model.timings.parse = millisecondsSince(start);
+
+	if (mdl.subobjects.empty())
+	{
+		LOG_WARNING(Content, "MDL file has no subobjects: " + name);
+	}
+
+	bool built = model.isTY2 ?
+		buildTY2(name, mdl, mdlData, *mdgData, model) :
+		buildTY1(mdl, model);
+
+	if (!built)
+		return false;
+
+	buildHeader(mdl, mdlData, model);
+
+	// buildTY2 adds the .mdg parse to the parse stage.
+	model.timings.build = millisecondsSince(start) - model.timings.parse;
+
+	return true;
+}
+
+bool ModelBuilder::build(const Archive& archive, const std::string& name, ModelData& model)
+{
+	auto start = std::chrono::high_resolution_clock::now();
+
+	std::vector<char> mdlData;
+	if (!archive.getFileData(name, mdlData))
+	{
+		LOG_WARNING(Content, "Model file not found in archive: " + name);
+		model = ModelData();
+		model.name = name;
+		model.error = "MDL could not be read";
+		return false;
+	}
+
+	std::vector<char> mdgData;
+	bool isTY2 = archive.getFileData(getMDGName(name), mdgData);
+
+	double read = millisecondsSince(start);
+
+	bool built = build(name, mdlData, isTY2 ? &mdgData : nullptr, model);
+
+	model.timings.read = read;
+	model.fileBytes = mdlData.size() + mdgData.size();
+	return built;
+}
+
+std::string ModelBuilder::getMDGName(const std::string& name)
+{
+	return name.substr(0, name.find_last_of('.')) + ".mdg";
+}
+
+bool ModelBuilder::readTextures(const std::string& name, const std::vector<char>& mdlData, bool isTY2, std::vector<std::string>& textures)
+{
+	TRACE_ZONE_DETAIL("ModelBuilder::readTextures", name);
+
+	textures.clear();
+
+	mdl2 mdl;
+	if (!parse(name, mdlData, isTY2, mdl))
+		return false;
+
+	// The same names buildTY1 and buildTY2 give the mesh ranges.
+	if (mdl.isMDL3Format)
+	{
+		textures = mdl.mdl3Metadata.TextureNames;
+	}
+	else if (!isTY2)
+	{
+		for (auto& subobj : mdl.subobjects)
+		{
+			for (auto& mesh : subobj.meshes)
+			{
+				textures.push_back(mesh.material);
+			}
+		}
+	}
+
+	textures.erase(std::remove(textures.begin(), textures.end(), std::string()), textures.end());
+	std::sort(textures.begin(), textures.end());
+	textures.erase(std::unique(textures.begin(), textures.end()), textures.end());
+	return true;
+}
+
+bool ModelBuilder::parse(const std::string& name, const std::vector<char>& mdlData, bool isTY2, mdl2& mdl)
+{
+	ALLOCATION_SCOPE(MDL);
+
+	bool loaded = false;
+
+	if (isTY2)
+	{
+		// Try TY 2 format first (relaxed signature check)
+		LOG_DEBUG(Content, "Attempting to load as TY 2 format...");
+		LOG_DEBUG(Content, "MDL file size: " + std::to_string(mdlData.size()) + " bytes");
+		try
+		{
+			loaded = mdl.loadTY2(mdlData.data(), 0);
+			if (loaded)
+			{
+				LOG_DEBUG(Content, "Successfully loaded TY 2 MDL file");
+			}
+			else
+			{
+				LOG_WARNING(Content, "TY 2 format failed, trying TY 1 format...");
+				loaded = mdl.load(mdlData.data(), 0);
+			}
+		}
+		catch (const std::exception& e)
+		{
+			LOG_ERROR(Content, "Exception in loadTY2: " + std::string(e.what()));
+			loaded = false;
+		}
+		catch (...)
+		{
+			LOG_ERROR(Content, "Unknown exception in loadTY2");
+			loaded = false;
+		}
+	}
+	else
+	{
+		// Try TY 1 format
+		loaded = mdl.load(mdlData.data(), 0);
+	}
+
+	if (!loaded)
+	{
+		LOG_WARNING(Content, "Failed to parse MDL file (invalid format or signature): " + name);
+		LOG_DEBUG(Content, "MDL signature: " + std::to_string(readSignature(mdlData)) + " (expected TY 1: " + std::to_string(843859021) + ")");
+		return false;
+	}
+
+	return true;
+}
+
+bool ModelBuilder::buildTY1(const mdl2& mdl, ModelData& model)
+{
+	LOG_DEBUG(Content, "Detected TY 1 format (no MDG file found), using embedded vertex data");
+
+	// TY 1 format: Use embedded vertex data from .mdl file
+	for (size_t i = 0; i < mdl.subobjects.size(); i++)
+	{
+		for (auto& mesh : mdl.subobjects[i].meshes)
+		{
+			MeshRange range;
+			range.vertexOffset = model.vertices.size();
+			range.indexOffset = model.indices.size();
+			range.texture = mesh.material;
+			range.component = static_cast<uint32_t>(i);
+
+			unsigned int triangleIndex = 0;
+			for (auto& segment : mesh.segments)
+			{
+				for (auto& vertex : segment.vertices)
+				{
+					model.vertices.push_back(convertVertex(vertex));
+				}
+
+				if (segment.vertices.size() >= 3)
+				{
+					for (size_t i = 0; i < segment.vertices.size() - 2; i++)
+					{
+						model.indices.push_back(0 + triangleIndex);
+						model.indices.push_back(2 + triangleIndex);
+						model.indices.push_back(1 + triangleIndex);
+
+						triangleIndex++;
+					}
+					triangleIndex += 2;
+				}
+				else
+				{
+					triangleIndex += static_cast<unsigned int>(segment.vertices.size());
+				}
+			}
+
+			range.vertexCount = model.vertices.size() - range.vertexOffset;
+			range.indexCount = model.indices.size() - range.indexOffset;
+			model.strips.triangles += range.indexCount / 3;
+
+			model.meshes.push_back(range);
+		}
+	}
+
+	return true;
+}
+
+bool ModelBuilder::buildTY2(const std::string& name, const mdl2& mdl, const std::vector<char>& mdlData, const std::vector<char>& mdgData, ModelData& model)
+{
+	LOG_DEBUG(Content, "Detected TY 2 format, loading MDG file: " + getMDGName(name));
+
+	// TY 2 format: Load mesh data from .mdg file
+	mdg mdgParser;
+	bool mdgLoaded = false;
+
+	auto start = std::chrono::high_resolution_clock::now();
+
+	{
+		ALLOCATION_SCOPE(MDG);
+
+		// Try loading with MDL3 metadata if available
+		if (mdl.isMDL3Format)
+		{
+			LOG_DEBUG(Content, "Using MDL3 metadata to parse MDG file");
+			mdgLoaded = mdgParser.loadWithMDL3Metadata(mdgData.data(), mdgData.size(), mdl.mdl3Metadata, mdlData.data(), 0);
+		}
+		else
+		{
+			// Fallback to generic MDG parsing
+			mdgLoaded = mdgParser.load(mdgData.data(), mdgData.size());
+		}
+	}
+
+	model.timings.parse += millisecondsSince(start);
+
+	if (!mdgLoaded)
+	{
+		LOG_WARNING(Content, "Failed to parse MDG file (no valid mesh data found): " + getMDGName(name));
+		model.error = "MDG parse failed (no valid mesh data)";
+		return false;
+	}
+
+	LOG_DEBUG(Content, "Successfully loaded MDG file with " + std::to_string(mdgParser.meshes.size()) + " meshes");
+	if (mdl.isMDL3Format)
+	{
+		// MDG meshes are already organized by texture/component
+		LOG_DEBUG(Content, "Using MDG meshes with MDL3 metadata");
+	}
+	else
+	{
+		LOG_DEBUG(Content, "Using MDG meshes without MDL3 metadata (fallback)");
+	}
+
+	size_t vertexTotal = 0;
+	for (auto& mdgMesh : mdgParser.meshes)
+	{
+		vertexTotal += mdgMesh.vertices.size();
+	}
+	model.vertices.reserve(vertexTotal);
+	model.indices.reserve(vertexTotal * 3);
+	model.meshes.reserve(mdgParser.meshes.size());
+
+	for (auto& mdgMesh : mdgParser.meshes)
+	{
+		MeshRange range;
+		range.vertexOffset = model.vertices.size();
+		range.vertexCount = mdgMesh.vertices.size();
+		range.indexOffset = model.indices.size();
+		range.component = mdgMesh.componentIndex;
+
+		for (auto& vertex : mdgMesh.vertices)
+		{
+			model.vertices.push_back(convertVertex(vertex));
+		}
+
+		// Generate triangle strip indices with degenerate handling
+		StripStats stats;
+		buildStripIndices(model.vertices.data() + range.vertexOffset, range.vertexCount, mdgMesh.stripVertexCounts, model.indices, stats);
+
+		LOG_DEBUG(Content, "MDG PC: Degenerate triangles skipped: " + std::to_string(stats.degenerate) +
+			" of " + std::to_string(stats.triangles) +
+			" (uv mismatch: " + std::to_string(stats.uvMismatch) +
+			", strip breaks: " + std::to_string(stats.stripBreaks) + ")");
+
+		model.strips.triangles += stats.triangles;
+		model.strips.degenerate += stats.degenerate;
+		model.strips.uvMismatch += stats.uvMismatch;
+		model.strips.stripBreaks += stats.stripBreaks;
+		model.strips.derivedMeshes += stats.derivedMeshes;
+
+		range.indexCount = model.indices.size() - range.indexOffset;
+
+		// Without MDL3 metadata there is no material info, the default texture is used.
+		if (mdl.isMDL3Format && mdgMesh.textureIndex < mdl.mdl3Metadata.TextureNames.size())
+		{
+			range.texture = mdl.mdl3Metadata.TextureNames[mdgMesh.textureIndex];
+		}
+
+		model.meshes.push_back(range);
+	}
+
+	buildCollision(mdgParser, model);
+
+	return true;
+}
+
+void ModelBuilder::buildCollision(const mdg& mdgParser, ModelData& model)
+{
+	TRACE_ZONE("ModelBuilder::buildCollision");
+
+	if (mdgParser.collisionMeshes.empty())
+		return;
+
+	CollisionMesh& collision = model.collision;
+
+	size_t vertexTotal = 0;
+	for (auto& mdgMesh : mdgParser.collisionMeshes)
+	{
+		vertexTotal += mdgMesh.positions.size();
+	}
+	collision.positions.reserve(vertexTotal);
+	collision.indices.reserve(vertexTotal * 3);
+
+	std::unordered_map<PositionKey, unsigned int, PositionKeyHash> welded;
+	welded.reserve(vertexTotal);
+
+	// Strips are cut the way render meshes are, then every corner is welded into the merged mesh.
+	std::vector<Vertex> vertices;
+	std::vector<unsigned int> remap;
+	std::vector<unsigned int> indices;
+	size_t degenerate = 0;
+
+	for (auto& mdgMesh : mdgParser.collisionMeshes)
+	{
+		vertices.clear();
+		remap.resize(mdgMesh.positions.size());
+
+		for (size_t i = 0; i < mdgMesh.positions.size(); i++)
+		{
+			glm::vec3 position(mdgMesh.positions[i][0], mdgMesh.positions[i][1], mdgMesh.positions[i][2]);
+			vertices.push_back(Vertex(glm::vec4(position, 1.0f)));
+
+			auto inserted = welded.emplace(makePositionKey(position), static_cast<unsigned int>(collision.positions.size()));
+			if (inserted.second)
+			{
+				collision.positions.push_back(position);
+			}
+			remap[i] = inserted.first->second;
+		}
+
+		// Not added to model.strips, those describe the render meshes.
+		StripStats stats;
+		indices.clear();
+		buildStripIndices(vertices.data(), vertices.size(), mdgMesh.stripVertexCounts, indices, stats);
+
+		// Strip connectors are only needed to draw a strip, a triangle list drops them.
+		for (size_t i = 0; i + 2 < indices.size(); i += 3)
+		{
+			unsigned int a = remap[indices[i]];
+			unsigned int b = remap[indices[i + 1]];
+			unsigned int c = remap[indices[i + 2]];
+			if (a == b || b == c || a == c)
+			{
+				degenerate++;
+				continue;
+			}
+
+			collision.indices.push_back(a);
+			collision.indices.push_back(b);
+			collision.indices.push_back(c);
+		}
+	}
+
+	collision.positions.shrink_to_fit();
+	collision.indices.shrink_to_fit();
+
+	LOG_DEBUG(Content, "MDG PC: Merged " + std::to_string(mdgParser.collisionMeshes.size()) + " collision meshes into " +
+		std::to_string(collision.positions.size()) + " positions and " + std::to_string(collision.indices.size() / 3) +
+		" triangles (" + std::to_string(degenerate) + " degenerate dropped)");
+}
+
+void ModelBuilder::buildHeader(const mdl2& mdl, const std::vector<char>& mdlData, ModelData& model)
+{
+	model.boundsCorner = glm::vec3(mdl.bounds.x, mdl.bounds.y, mdl.bounds.z);
+	model.boundsSize = glm::vec3(mdl.bounds.sx, mdl.bounds.sy, mdl.bounds.sz);
+
+	if (mdlData.size() < 24)
+		return;
+
+	unsigned int collider_count = from_bytes<uint16_t>(mdlData.data(), 8);
+	unsigned int bone_count = from_bytes<uint16_t>(mdlData.data(), 10);
+	size_t collider_offset = from_bytes<uint32_t>(mdlData.data(), 16);
+	size_t bone_offset = from_bytes<uint32_t>(mdlData.data(), 20);
+
+	// Parse colliders
+	for (unsigned int i = 0; i < collider_count; i++)
+	{
+		size_t offset = collider_offset + (i * 32);
+		if (offset + 32 <= mdlData.size())
+		{
+			glm::vec3 position(
+				from_bytes<float>(mdlData.data(), offset),
+				from_bytes<float>(mdlData.data(), offset + 4),
+				from_bytes<float>(mdlData.data(), offset + 8));
+
+			float size = from_bytes<float>(mdlData.data(), offset + 12);
+
+			model.colliders.push_back({ position, size });
+		}
+	}
+
+	// Parse bones
+	for (unsigned int i = 0; i < bone_count; i++)
+	{
+		size_t offset = bone_offset + (i * 16);
+		if (offset + 16 <= mdlData.size())
+		{
+			model.bones.push_back(
+				{
+					glm::vec3(
+						from_bytes<float>(mdlData.data(), offset),
+						from_bytes<float>(mdlData.data(), offset + 4),
+						from_bytes<float>(mdlData.data(), offset + 8)
+					)
+				}
+			);
+		}
+	}
+
+	// Parse subobject bounds
+	for (auto& subobj : mdl.subobjects)
+	{
+		model.bounds.push_back({
+			glm::vec3(subobj.bounds.x, subobj.bounds.y, subobj.bounds.z),
+			glm::vec3(subobj.bounds.sx, subobj.bounds.sy, subobj.bounds.sz)
+		});
+		model.components.push_back(subobj.name);
+	}
+}
+
+std::vector<std::pair<size_t, size_t>> ModelBuilder::deriveStripRanges(const Vertex* vertices, size_t count)
+{
+	std::vector<std::pair<size_t, size_t>> ranges;
+
+	size_t startIndex = 0;
+	size_t i = 0;
+	while (i + 1 < count)
+	{
+		if (isSamePosition(vertices[i], vertices[i + 1]))
+		{
+			if (i + 1 > startIndex)
+			{
+				ranges.push_back({ startIndex, (i - startIndex) + 1 });
+			}
+
+			// If we have two duplicate pairs back-to-back, treat them as one connector.
+			if (i + 3 < count && isSamePosition(vertices[i + 2], vertices[i + 3]))
+			{
+				startIndex = i + 2;
+				if (startIndex + 1 < count && isSamePosition(vertices[startIndex], vertices[startIndex + 1]))
+				{
+					startIndex += 1;
+				}
+				i = startIndex;
+				continue;
+			}
+
+			startIndex = i + 1;
+			i = startIndex;
+			continue;
+		}
+		i++;
+	}
+
+	if (startIndex < count)
+	{
+		ranges.push_back({ startIndex, count - startIndex });
+	}
+
+	return ranges;
+}
+
+void ModelBuilder::appendStripIndices(const Vertex* vertices, size_t vertexCount, size_t startIndex, size_t count, std::vector<unsigned int>& indices, StripStats& stats)
+{
+	if (count < 3 || startIndex + count > vertexCount)
+	{
+		return;
+	}
+
+	stats.triangles += (count - 2);
+	for (size_t i = 0; i + 2 < count; i++)
+	{
+		unsigned int i0 = static_cast<unsigned int>(startIndex + i);
+		unsigned int i1 = static_cast<unsigned int>(startIndex + i + 1);
+		unsigned int i2 = static_cast<unsigned int>(startIndex + i + 2);
+
+		// Degenerate triangles (strip connectors) are kept, only counted
+		bool deg01 = isSamePosition(vertices[i0], vertices[i1]);
+		bool deg12 = isSamePosition(vertices[i1], vertices[i2]);
+		bool deg02 = isSamePosition(vertices[i0], vertices[i2]);
+		if (deg01 || deg12 || deg02)
+		{
+			stats.degenerate++;
+			if ((deg01 && !isSameUv(vertices[i0], vertices[i1])) ||
+				(deg12 && !isSameUv(vertices[i1], vertices[i2])) ||
+				(deg02 && !isSameUv(vertices[i0], vertices[i2])))
+			{
+				stats.uvMismatch++;
+				stats.stripBreaks++;
+			}
+		}
+
+		if ((i & 1) == 0)
+		{
+			indices.push_back(i0);
+			indices.push_back(i1);
+			indices.push_back(i2);
+		}
+		else
+		{
+			indices.push_back(i1);
+			indices.push_back(i0);
+			indices.push_back(i2);
+		}
+	}
+}
+
+void ModelBuilder::buildStripIndices(const Vertex* vertices, size_t vertexCount, const std::vector<uint16_t>& stripVertexCounts, std::vector<unsigned int>& indices, StripStats& stats)
+{
+	TRACE_ZONE("ModelBuilder::buildStripIndices");
+
+	if (!stripVertexCounts.empty())
+	{
+		size_t stripSum = 0;
+		for (auto stripVertexCount : stripVertexCounts)
+		{
+			stripSum += stripVertexCount;
+		}
+
+		// Strip counts either include the connector vertices between strips or leave out one or two per strip.
+		const size_t stripCount = stripVertexCounts.size();
+		const size_t stripDegenerate2Sum = stripSum + (stripCount - 1) * 2;
+		const size_t stripDegenerate1Sum = stripSum + (stripCount - 1);
+		const bool countsIncludeDegenerates = (stripSum == vertexCount);
+		const bool countsExcludeDegenerates2 = (stripDegenerate2Sum == vertexCount);
+		const bool countsExcludeDegenerates1 = (!countsExcludeDegenerates2 && stripDegenerate1Sum == vertexCount);
+		const bool countsAlign = countsIncludeDegenerates || countsExcludeDegenerates2 || countsExcludeDegenerates1;
+
+		if (countsAlign)
+		{
+			size_t startIndex = 0;
+			for (auto stripVertexCount : stripVertexCounts)
+			{
+				if (stripVertexCount >= 3)
+				{
+					appendStripIndices(vertices, vertexCount, startIndex, stripVertexCount, indices, stats);
+				}
+
+				if (countsExcludeDegenerates2)
+				{
+					startIndex += stripVertexCount + 2;
+				}
+				else if (countsExcludeDegenerates1)
+				{
+					startIndex += stripVertexCount + 1;
+				}
+				else
+				{
+					startIndex += stripVertexCount;
+				}
+			}
+			return;
+		}
+	}
+
+	auto ranges = deriveStripRanges(vertices, vertexCount);
+	if (ranges.empty())
+	{
+		// Mismatching counts without connectors keep the old behaviour of walking the counts.
+		if (!stripVertexCounts.empty())
+		{
+			size_t startIndex = 0;
+			for (auto stripVertexCount : stripVertexCounts)
+			{
+				if (stripVertexCount >= 3)
+				{
+					appendStripIndices(vertices, vertexCount, startIndex, stripVertexCount, indices, stats);
+				}
+				startIndex += stripVertexCount;
+			}
+		}
+		else
+		{
+			appendStripIndices(vertices, vertexCount, 0, vertexCount, indices, stats);
+		}
+		return;
+	}
+
+	for (const auto& range : ranges)
+	{
+		if (range.second >= 3)
+		{
+			appendStripIndices(vertices, vertexCount, range.first, range.second, indices, stats);
+		}
+	}
+	stats.derivedMeshes++;
+	LOG_DEBUG(Content, "MDG PC: Derived strips from degenerate connectors");
+}
+
+bool ModelBuilder::validate(const ModelData& model, std::string& reason)
+{
+	for (size_t i = 0; i < model.meshes.size(); i++)
+	{
+		const MeshRange& range = model.meshes[i];
+
+		if (range.vertexOffset + range.vertexCount > model.vertices.size() ||
+			range.indexOffset + range.indexCount > model.indices.size())
+		{
+			reason = "mesh " + std::to_string(i) + " range outside the buffers";
+			return false;
+		}
+
+		if (range.indexCount % 3 != 0)
+		{
+			reason = "mesh " + std::to_string(i) + " has a partial triangle";
+			return false;
+		}
+
+		for (size_t j = range.indexOffset; j < range.indexOffset + range.indexCount; j++)
+		{
+			if (model.indices[j] >= range.vertexCount)
+			{
+				reason = "mesh " + std::to_string(i) + " index " + std::to_string(model.indices[j]) +
+					" out of range (" + std::to_string(range.vertexCount) + " vertices)";
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <utility>
+
+#include "loader/modeldata.h"
+#include "loader/archive.h"
+
+#include "loader/assets/mdl2.h"
+#include "loader/assets/mdg.h"
+
+// Decodes .mdl (and .mdg) files into ModelData on the CPU only,
+// safe to use without an OpenGL context and from worker threads.
+class ModelBuilder
+{
+public:
+	// 'mdgData' is null for TY 1 models, their geometry is stored in the .mdl.
+	static bool build(const std::string& name, const std::vector<char>& mdlData, const std::vector<char>* mdgData, ModelData& model);
+	// Reads the .mdl and, for TY 2 models, the .mdg next to it. Sets model.timings.read and model.fileBytes.
+	static bool build(const Archive& archive, const std::string& name, ModelData& model);
+
+	// The .mdg a TY 2 model keeps its geometry in.
+	static std::string getMDGName(const std::string& name);
+
+	// Texture names the model refers to, without building its geometry or reading the .mdg. Sorted, no duplicates.
+	static bool readTextures(const std::string& name, const std::vector<char>& mdlData, bool isTY2, std::vector<std::string>& textures);
+
+	// Splits a strip list at duplicated connector vertices, returns { start, count } pairs.
+	static std::vector<std::pair<size_t, size_t>> deriveStripRanges(const Vertex* vertices, size_t count);
+
+	// Appends one strip as a triangle list, alternating winding.
+	static void appendStripIndices(const Vertex* vertices, size_t vertexCount, size_t startIndex, size_t count, std::vector<unsigned int>& indices, StripStats& stats);
+
+	// Converts a mesh made of consecutive strips to a triangle list.
+	static void buildStripIndices(const Vertex* vertices, size_t vertexCount, const std::vector<uint16_t>& stripVertexCounts, std::vector<unsigned int>& indices, StripStats& stats);
+
+	// Checks that every mesh range and index of a built model stays inside the buffers.
+	static bool validate(const ModelData& model, std::string& reason);
+
+private:
+	static bool parse(const std::string& name, const std::vector<char>& mdlData, bool isTY2, mdl2& mdl);
+
+	static bool buildTY1(const mdl2& mdl, ModelData& model);
+	static bool buildTY2(const std::string& name, const mdl2& mdl, const std::vector<char>& mdlData, const std::vector<char>& mdgData, ModelData& model);
+
+	// Merges the "CM_" meshes the .mdg parser kept into model.collision.
+	static void buildCollision(const mdg& mdgParser, ModelData& model);
+
+	// Colliders, bones and bounds, the same for TY 1 and TY 2.
+	static void buildHeader(const mdl2& mdl, const std::vector<char>& mdlData, ModelData& model);
+};
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+#include "graphics/vertex.h"
+
+struct Collider 
+{
+	glm::vec3 position;
+	float size;
+};
+
+struct Bounds
+{
+	glm::vec3 corner;
+	glm::vec3 size;
+};
+
+struct Bone
+{
+	glm::vec3 defaultPosition;
+};
+
+// Counters gathered while converting triangle strips to triangle lists.
+struct StripStats
+{
+	size_t triangles = 0;
+	size_t degenerate = 0;
+	size_t uvMismatch = 0;
+	size_t stripBreaks = 0;
+
+	// Meshes whose strip counts did not match and were split at connectors instead.
+	size_t derivedMeshes = 0;
+};
+
+// Part of a model drawn with one texture.
+struct MeshRange
+{
+	size_t vertexOffset = 0;
+	size_t vertexCount = 0;
+
+	size_t indexOffset = 0;
+	size_t indexCount = 0;
+
+	// Without extension, empty if the model does not name one.
+	std::string texture;
+	// The MDL subobject it belongs to, componentIndex of TY 2 MDG meshes.
+	uint32_t component = 0;
+};
+
+// Every "CM_" collision mesh of a model merged into one, positions only.
+// Corners shared by strips and meshes are stored once, indices form a triangle list.
+struct CollisionMesh
+{
+	std::vector<glm::vec3> positions;
+	std::vector<unsigned int> indices;
+
+	inline bool empty() const
+	{
+		return indices.empty();
+	}
+	inline size_t getHeapBytes() const
+	{
+		return positions.capacity() * sizeof(glm::vec3) + indices.capacity() * sizeof(unsigned int);
+	}
+};
+
+// Milliseconds spent in each stage of Content::load<Model>.
+struct LoadTimings
+{
+	double read = 0.0;
+	double parse = 0.0;
+	double build = 0.0;
+	double upload = 0.0;
+};
+
+// Decoded model, independent of any GPU resources.
+// Produced by ModelBuilder, turned into a Model by Content.
+struct ModelData
+{
+	std::string name;
+	bool isTY2 = false;
+
+	// Indices are relative to the vertexOffset of the range they belong to.
+	std::vector<Vertex> vertices;
+	std::vector<unsigned int> indices;
+	std::vector<MeshRange> meshes;
+
+	glm::vec3 boundsCorner = glm::vec3(0.0f);
+	glm::vec3 boundsSize = glm::vec3(0.0f);
+
+	std::vector<Collider> colliders;
+	std::vector<Bounds> bounds;
+	std::vector<Bone> bones;
+
+	// Subobject names, by MeshRange::component. Empty where the MDL has none.
+	std::vector<std::string> components;
+
+	// Not part of 'meshes', only TY 2 models have any.
+	CollisionMesh collision;
+
+	StripStats strips;
+
+	// Filled as the model passes through ModelBuilder and Content.
+	LoadTimings timings;
+	// Size of the .mdl and .mdg read, when built from an archive.
+	size_t fileBytes = 0;
+
+	// Why ModelBuilder::build failed, empty on success.
+	std::string error;
+
+	// Heap held by the decoded data. Capacity rather than size, memory reserved and unused is held all the same.
+	inline size_t getHeapBytes() const
+	{
+		return sizeof(ModelData) +
+			vertices.capacity() * sizeof(Vertex) +
+			indices.capacity() * sizeof(unsigned int) +
+			meshes.capacity() * sizeof(MeshRange) +
+			colliders.capacity() * sizeof(Collider) +
+			bounds.capacity() * sizeof(Bounds) +
+			bones.capacity() * sizeof(Bone) +
+			components.capacity() * sizeof(std::string) +
+			collision.getHeapBytes();
+	}
+};
@@ -0,0 +1,450 @@
+#include "nameindex.h"
+
+#include <cctype>
+#include <algorithm>
+
+#include "util/trace.h"
+
+// Each kind of match gets its own band of scores, so a substring always beats a subsequence.
+#define NAME_SCORE_SUBSTRING 5000
+#define NAME_SCORE_SUBSEQUENCE 3000
+#define NAME_SCORE_SIMILAR 1000
+#define NAME_SCORE_RANGE 999
+
+static uint32_t makeTrigram(const char* text)
+{
+	return
+		(static_cast<uint32_t>(static_cast<unsigned char>(text[0])) << 16) |
+		(static_cast<uint32_t>(static_cast<unsigned char>(text[1])) << 8) |
+		static_cast<uint32_t>(static_cast<unsigned char>(text[2]));
+}
+
+// Bit per character class in 'text', a name can only hold the query if it has all of the query's bits.
+static uint64_t makeMask(const std::string& text)
+{
+	uint64_t mask = 0;
+	for (char c : text)
+	{
+		unsigned char u = static_cast<unsigned char>(c);
+		if (u >= 'a' && u <= 'z')
+			mask |= 1ull << (u - 'a');
+		else if (u >= '0' && u <= '9')
+			mask |= 1ull << (26 + u - '0');
+		else
+			mask |= 1ull << (36 + u % 28);
+	}
+	return mask;
+}
+
+static std::string toLower(const std::string& text)
+{
+	std::string lower = text;
+	std::transform(lower.begin(), lower.end(), lower.begin(), ::tolower);
+	return lower;
+}
+
+static int band(int base, int score)
+{
+	return base + std::max(-NAME_SCORE_RANGE, std::min(NAME_SCORE_RANGE, score));
+}
+
+NameIndex::NameIndex()
+{}
+
+void NameIndex::build(const std::vector<std::string>& names)
+{
+	TRACE_ZONE("NameIndex::build");
+
+	clear();
+
+	this->names = names;
+	std::sort(this->names.begin(), this->names.end());
+	this->names.erase(std::unique(this->names.begin(), this->names.end()), this->names.end());
+
+	uint32_t count = static_cast<uint32_t>(this->names.size());
+
+	lowerNames.reserve(count);
+	masks.reserve(count);
+	extensions.reserve(count);
+	all.reserve(count);
+
+	size_t trigramTotal = 0;
+	for (uint32_t entry = 0; entry < count; entry++)
+	{
+		std::string lower = toLower(this->names[entry]);
+		lowerNames.push_back(lower);
+		masks.push_back(makeMask(lower));
+
+		size_t dot = lower.find_last_of('.');
+		std::string extension = dot == std::string::npos ? std::string() : lower.substr(dot + 1);
+
+		auto it = extensionIds.find(extension);
+		if (it == extensionIds.end())
+		{
+			it = extensionIds.emplace(extension, static_cast<uint32_t>(buckets.size())).first;
+			buckets.emplace_back();
+		}
+
+		extensions.push_back(it->second);
+		buckets[it->second].push_back(entry);
+		all.push_back(entry);
+
+		if (lower.size() >= 3)
+			trigramTotal += lower.size() - 2;
+	}
+
+	// Sorting (trigram, entry) pairs groups them into posting lists that are already ascending.
+	std::vector<uint64_t> pairs;
+	pairs.reserve(trigramTotal);
+
+	for (uint32_t entry = 0; entry < count; entry++)
+	{
+		const std::string& lower = lowerNames[entry];
+		for (size_t i = 0; i + 3 <= lower.size(); i++)
+		{
+			pairs.push_back((static_cast<uint64_t>(makeTrigram(&lower[i])) << 32) | entry);
+		}
+	}
+
+	std::sort(pairs.begin(), pairs.end());
+	pairs.erase(std::unique(pairs.begin(), pairs.end()), pairs.end());
+
+	postings.reserve(pairs.size());
+
+	for (uint64_t pair : pairs)
+	{
+		uint32_t trigram = static_cast<uint32_t>(pair >> 32);
+		uint32_t entry = static_cast<uint32_t>(pair);
+
+		if (trigrams.empty() || trigrams.back() != trigram)
+		{
+			trigrams.push_back(trigram);
+			offsets.push_back(static_cast<uint32_t>(postings.size()));
+		}
+
+		postings.push_back(entry);
+	}
+	offsets.push_back(static_cast<uint32_t>(postings.size()));
+}
+
+void NameIndex::clear()
+{
+	names.clear();
+	lowerNames.clear();
+	masks.clear();
+	extensions.clear();
+	extensionIds.clear();
+	buckets.clear();
+	all.clear();
+	trigrams.clear();
+	offsets.clear();
+	postings.clear();
+}
+
+std::vector<NameMatch> NameIndex::search(const NameQuery& query) const
+{
+	TRACE_ZONE_DETAIL("NameIndex::search", query.text);
+
+	std::vector<NameMatch> matches;
+
+	const std::vector<uint32_t>& scope = getEntries(query.extension);
+	if (scope.empty() || query.limit == 0)
+		return matches;
+
+	std::vector<std::string> terms;
+	{
+		std::string lower = toLower(query.text);
+
+		size_t start = 0;
+		while (start < lower.size())
+		{
+			size_t end = lower.find(' ', start);
+			if (end == std::string::npos)
+				end = lower.size();
+
+			if (end > start)
+				terms.push_back(lower.substr(start, end - start));
+			start = end + 1;
+		}
+	}
+
+	// Nothing typed yet, the picker shows the first names.
+	if (terms.empty())
+	{
+		for (size_t i = 0; i < scope.size() && i < query.limit; i++)
+		{
+			matches.push_back({ scope[i], 0, NameMatchKind::Substring });
+		}
+		return matches;
+	}
+
+	// The longest word has the fewest entries holding all its trigrams, the rest are checked per candidate.
+	size_t longest = 0;
+	for (size_t i = 1; i < terms.size(); i++)
+	{
+		if (terms[i].size() > terms[longest].size())
+			longest = i;
+	}
+
+	std::vector<uint32_t> candidates;
+	const std::vector<uint32_t>* pool = &scope;
+	if (terms[longest].size() >= 3)
+	{
+		getCandidates(terms[longest], candidates);
+		pool = &candidates;
+	}
+
+	// Candidates come from every extension.
+	bool filter = pool == &candidates && !query.extension.empty();
+	uint32_t extension = filter ? extensionIds.at(toLower(query.extension)) : 0;
+
+	std::string text;
+	for (auto& term : terms)
+		text += term;
+	uint64_t mask = makeMask(text);
+
+	for (uint32_t entry : *pool)
+	{
+		if ((masks[entry] & mask) != mask || (filter && extensions[entry] != extension))
+			continue;
+
+		int score = scoreSubstring(entry, terms);
+		if (score >= 0)
+			matches.push_back({ entry, score, NameMatchKind::Substring });
+	}
+
+	if (query.fuzzy && matches.size() < query.limit)
+	{
+		std::vector<unsigned char> matched(names.size(), 0);
+		for (auto& match : matches)
+			matched[match.entry] = 1;
+
+		for (uint32_t entry : scope)
+		{
+			if (matched[entry] || (masks[entry] & mask) != mask)
+				continue;
+
+			int score = scoreSubsequence(entry, text);
+			if (score >= 0)
+			{
+				matches.push_back({ entry, score, NameMatchKind::Subsequence });
+				matched[entry] = 1;
+			}
+		}
+
+		// Needs two trigrams at least, one shared trigram says nothing.
+		if (text.size() >= 4)
+		{
+			std::vector<uint32_t> queryTrigrams;
+			for (size_t i = 0; i + 3 <= text.size(); i++)
+				queryTrigrams.push_back(makeTrigram(&text[i]));
+
+			std::sort(queryTrigrams.begin(), queryTrigrams.end());
+			queryTrigrams.erase(std::unique(queryTrigrams.begin(), queryTrigrams.end()), queryTrigrams.end());
+
+			std::vector<uint16_t> shared(names.size(), 0);
+			for (uint32_t trigram : queryTrigrams)
+			{
+				size_t count;
+				const uint32_t* entries = getPostings(trigram, count);
+				for (size_t i = 0; i < count; i++)
+					shared[entries[i]]++;
+			}
+
+			size_t threshold = std::max<size_t>(2, (queryTrigrams.size() + 1) / 2);
+
+			for (uint32_t entry : scope)
+			{
+				if (matched[entry] || shared[entry] < threshold)
+					continue;
+
+				int similarity = static_cast<int>(900 * shared[entry] / queryTrigrams.size());
+				int score = band(NAME_SCORE_SIMILAR, similarity - static_cast<int>(std::min<size_t>(names[entry].size(), 99)));
+				matches.push_back({ entry, score, NameMatchKind::Similar });
+			}
+		}
+	}
+
+	auto better = [](const NameMatch& a, const NameMatch& b)
+	{
+		if (a.score != b.score)
+			return a.score > b.score;
+		return a.entry < b.entry;
+	};
+
+	if (matches.size() > query.limit)
+	{
+		std::partial_sort(matches.begin(), matches.begin() + query.limit, matches.end(), better);
+		matches.resize(query.limit);
+	}
+	else
+	{
+		std::sort(matches.begin(), matches.end(), better);
+	}
+
+	return matches;
+}
+
+const std::string& NameIndex::getName(uint32_t entry) const
+{
+	return names[entry];
+}
+
+size_t NameIndex::getCount() const
+{
+	return names.size();
+}
+
+const std::vector<uint32_t>& NameIndex::getEntries(const std::string& extension) const
+{
+	static const std::vector<uint32_t> none;
+
+	if (extension.empty())
+		return all;
+
+	auto it = extensionIds.find(toLower(extension));
+	if (it == extensionIds.end())
+		return none;
+	return buckets[it->second];
+}
+
+size_t NameIndex::getHeapBytes() const
+{
+	size_t bytes = 0;
+	for (size_t i = 0; i < names.size(); i++)
+		bytes += names[i].capacity() + lowerNames[i].capacity() + 2 * sizeof(std::string);
+
+	for (auto& bucket : buckets)
+		bytes += bucket.capacity() * sizeof(uint32_t);
+
+	bytes += masks.capacity() * sizeof(uint64_t);
+	bytes += (extensions.capacity() + all.capacity() + trigrams.capacity() + offsets.capacity() + postings.capacity()) * sizeof(uint32_t);
+	return bytes;
+}
+
+void NameIndex::getCandidates(const std::string& term, std::vector<uint32_t>& candidates) const
+{
+	candidates.clear();
+
+	std::vector<std::pair<const uint32_t*, size_t>> lists;
+	for (size_t i = 0; i + 3 <= term.size(); i++)
+	{
+		size_t count;
+		const uint32_t* entries = getPostings(makeTrigram(&term[i]), count);
+
+		// A trigram nothing has, nothing can match.
+		if (count == 0)
+			return;
+		lists.push_back({ entries, count });
+	}
+
+	std::sort(lists.begin(), lists.end(), [](const std::pair<const uint32_t*, size_t>& a, const std::pair<const uint32_t*, size_t>& b)
+	{
+		return a.second < b.second;
+	});
+
+	candidates.assign(lists[0].first, lists[0].first + lists[0].second);
+
+	std::vector<uint32_t> intersection;
+	for (size_t i = 1; i < lists.size() && !candidates.empty(); i++)
+	{
+		intersection.clear();
+		std::set_intersection(candidates.begin(), candidates.end(), lists[i].first, lists[i].first + lists[i].second, std::back_inserter(intersection));
+		candidates.swap(intersection);
+	}
+}
+
+const uint32_t* NameIndex::getPostings(uint32_t trigram, size_t& count) const
+{
+	auto it = std::lower_bound(trigrams.begin(), trigrams.end(), trigram);
+	if (it == trigrams.end() || *it != trigram)
+	{
+		count = 0;
+		return nullptr;
+	}
+
+	size_t index = it - trigrams.begin();
+	count = offsets[index + 1] - offsets[index];
+	return postings.data() + offsets[index];
+}
+
+int NameIndex::scoreSubstring(uint32_t entry, const std::vector<std::string>& terms) const
+{
+	const std::string& lower = lowerNames[entry];
+
+	int score = 0;
+	for (auto& term : terms)
+	{
+		size_t position = lower.find(term);
+		if (position == std::string::npos)
+			return -1;
+
+		if (position == 0)
+			score += 200;
+		else if (isWordStart(entry, position))
+			score += 100;
+
+		score -= static_cast<int>(std::min<size_t>(position, 50));
+	}
+
+	// The whole name short of its extension typed out.
+	size_t stem = std::min(lower.find_last_of('.'), lower.size());
+	if (terms.size() == 1 && (terms[0].size() == stem || terms[0].size() == lower.size()) && lower.compare(0, terms[0].size(), terms[0]) == 0)
+		score += 500;
+
+	// Shorter names leave less unmatched.
+	score -= static_cast<int>(std::min<size_t>(lower.size(), 200));
+
+	return band(NAME_SCORE_SUBSTRING, score);
+}
+
+int NameIndex::scoreSubsequence(uint32_t entry, const std::string& text) const
+{
+	const std::string& lower = lowerNames[entry];
+
+	int score = 0;
+	size_t matched = 0;
+	size_t last = std::string::npos;
+
+	for (size_t i = 0; i < lower.size() && matched < text.size(); i++)
+	{
+		if (lower[i] != text[matched])
+			continue;
+
+		score += 10;
+		if (isWordStart(entry, i))
+			score += 20;
+
+		if (last == std::string::npos)
+			score -= static_cast<int>(std::min<size_t>(i, 30));
+		else if (i == last + 1)
+			score += 15;
+		else
+			score -= static_cast<int>(std::min<size_t>(i - last - 1, 10));
+
+		last = i;
+		matched++;
+	}
+
+	if (matched < text.size())
+		return -1;
+
+	score -= static_cast<int>(std::min<size_t>(lower.size(), 200)) / 2;
+	return band(NAME_SCORE_SUBSEQUENCE, score);
+}
+
+bool NameIndex::isWordStart(uint32_t entry, size_t position) const
+{
+	if (position == 0)
+		return true;
+
+	unsigned char previous = static_cast<unsigned char>(names[entry][position - 1]);
+	unsigned char current = static_cast<unsigned char>(names[entry][position]);
+
+	// P0486_B1FlowerPot: after separators, at CamelCase humps and where digits start or stop.
+	if (previous == '_' || previous == '-' || previous == ' ' || previous == '.' || previous == '/' || previous == '\\')
+		return true;
+	if (std::islower(previous) && std::isupper(current))
+		return true;
+	return (std::isdigit(previous) != 0) != (std::isdigit(current) != 0) && std::isalnum(current);
+}
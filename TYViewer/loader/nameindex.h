@@ -0,0 +1,87 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <unordered_map>
+
+enum class NameMatchKind
+{
+	// Every word of the query appears in the name as typed.
+	Substring,
+	// The query's letters appear in the name in order, e.g. "flwpot" for FlowerPot.
+	Subsequence,
+	// Most of the query's trigrams appear in the name, catches typos.
+	Similar
+};
+
+struct NameMatch
+{
+	uint32_t entry;
+	int score;
+	NameMatchKind kind;
+};
+
+struct NameQuery
+{
+	// Case insensitive, words separated by spaces must all match.
+	std::string text;
+
+	// Only entries with this extension (lower case, without the dot) if not empty.
+	std::string extension;
+
+	size_t limit = 20;
+
+	// Also rank subsequence and similar matches when substrings don't fill the limit.
+	bool fuzzy = true;
+};
+
+// Trigram index over the entry names of an archive, for finding assets as the user types.
+// Read only once built, any number of threads may search at once.
+class NameIndex
+{
+public:
+	NameIndex();
+
+	void build(const std::vector<std::string>& names);
+	void clear();
+
+	// Best first, equal scores by name.
+	std::vector<NameMatch> search(const NameQuery& query) const;
+
+	// Entries are numbered in name order.
+	const std::string& getName(uint32_t entry) const;
+	size_t getCount() const;
+
+	// Entries with 'extension', every entry if empty. Ascending, so sorted by name as well.
+	const std::vector<uint32_t>& getEntries(const std::string& extension) const;
+
+	size_t getHeapBytes() const;
+
+private:
+	// Entries holding every trigram of 'term', which is at least 3 characters long.
+	void getCandidates(const std::string& term, std::vector<uint32_t>& candidates) const;
+	const uint32_t* getPostings(uint32_t trigram, size_t& count) const;
+
+	int scoreSubstring(uint32_t entry, const std::vector<std::string>& terms) const;
+	int scoreSubsequence(uint32_t entry, const std::string& text) const;
+
+	bool isWordStart(uint32_t entry, size_t position) const;
+
+	std::vector<std::string> names;
+	std::vector<std::string> lowerNames;
+	// Characters each name holds, rejects most names before they are scanned.
+	std::vector<uint64_t> masks;
+
+	// Extension of each entry, indexing 'buckets'.
+	std::vector<uint32_t> extensions;
+	std::unordered_map<std::string, uint32_t> extensionIds;
+	std::vector<std::vector<uint32_t>> buckets;
+	std::vector<uint32_t> all;
+
+	// Sorted distinct trigrams, each with the ascending entries containing it at
+	// postings[offsets[i]] up to postings[offsets[i + 1]].
+	std::vector<uint32_t> trigrams;
+	std::vector<uint32_t> offsets;
+	std::vector<uint32_t> postings;
+};
@@ -5,6 +5,22 @@
 #include <GLFW/glfw3.h>
 
 #include "application.h"
+#include "headless.h"
+#include "thumbnails.h"
+#include "search.h"
+#include "dependencies.h"
+#include "bench/benchmark.h"
+#include "bench/loadbench.h"
+#include "bench/synthetic.h"
+#include "bench/regression.h"
+#include "bench/sweep.h"
+#include "bench/flythrough.h"
+#include "bench/pickbench.h"
+#include "bench/animbench.h"
+#include "bench/skinbench.h"
+#include "exporter/exporter.h"
+#include "server/assetserver.h"
+#include "server/query.h"
 #include "config.h"
 #include "debug.h"
 
@@ -15,13 +31,111 @@ void onWindowResized(GLFWwindow* window, int width, int height)
 	application->resize(width, height);
 }
 
+// What a command line mode needs set up before it runs.
+enum class ModeSetup
+{
+	None,		// Arguments cover everything.
+	Config,		// Config for the archive path etc., optional when given as arguments.
+	Logging,	// Config and its log filter.
+	Quiet		// Config, logging warnings and errors only.
+};
+
+// Modes without a static run() are constructed from their options.
+template<typename Mode, typename Options>
+static int runInstance(const Options& options)
+{
+	return Mode(options).run();
+}
+
+template<typename Mode, typename Options, ModeSetup Setup, int (*Run)(const Options&) = runInstance<Mode, Options>>
+static int runMode(int argc, char* argv[])
+{
+	Options options;
+	if (!Mode::parseArguments(argc, argv, options))
+	{
+		Mode::printUsage();
+		return -1;
+	}
+
+	if (Setup != ModeSetup::None)
+	{
+		Config::load(Application::APPLICATION_PATH + "config.cfg");
+	}
+
+	if (Setup == ModeSetup::Logging)
+	{
+		Debug::setFilter(Config::logFilter);
+	}
+	else if (Setup == ModeSetup::Quiet)
+	{
+		Debug::setLevel(Debug::Level::Warning);
+	}
+
+	int result = Run(options);
+
+	if (Trace::isEnabled())
+	{
+		Trace::stop(Application::TRACE_PATH);
+	}
+
+	Debug::shutdown();
+	return result;
+}
+
+struct CommandLineMode
+{
+	bool (*isRequested)(int argc, char* argv[]);
+	int (*run)(int argc, char* argv[]);
+};
+
 int main(int argc, char* argv[])
 {
-	Debug::log("TYViewer starting...");
-	
+	Trace::setThreadName("Main");
+
+	// Started before anything else so the trace covers startup and loading.
+	for (int i = 1; i + 1 < argc; i++)
+	{
+		if (std::string(argv[i]) == "--trace")
+		{
+			Application::TRACE_PATH = argv[i + 1];
+			Trace::start();
+		}
+	}
+
+	LOG_INFO(General, "TYViewer starting...");
+
+	static const CommandLineMode MODES[] =
+	{
+		{ SyntheticAssets::isRequested, runMode<SyntheticAssets, SyntheticCorpusOptions, ModeSetup::None, SyntheticAssets::run> },
+		{ Regression::isRequested, runMode<Regression, RegressionOptions, ModeSetup::Config> },
+		{ ArchiveSweep::isRequested, runMode<ArchiveSweep, SweepOptions, ModeSetup::Config> },
+		{ BatchExporter::isRequested, runMode<BatchExporter, ExportOptions, ModeSetup::Config> },
+		{ Benchmark::isRequested, runMode<Benchmark, BenchmarkSettings, ModeSetup::None, Benchmark::run> },
+		{ LoadBenchmark::isRequested, runMode<LoadBenchmark, LoadBenchmarkOptions, ModeSetup::Logging> },
+		{ FlythroughBenchmark::isRequested, runMode<FlythroughBenchmark, FlythroughOptions, ModeSetup::Logging> },
+		{ PickBenchmark::isRequested, runMode<PickBenchmark, PickBenchmarkOptions, ModeSetup::Logging> },
+		{ AnimationBenchmark::isRequested, runMode<AnimationBenchmark, AnimationBenchmarkOptions, ModeSetup::Logging> },
+		{ SkinningBenchmark::isRequested, runMode<SkinningBenchmark, SkinningBenchmarkOptions, ModeSetup::Logging> },
+		{ Thumbnails::isRequested, runMode<Thumbnails, ThumbnailOptions, ModeSetup::Config> },
+		{ NameSearch::isRequested, runMode<NameSearch, SearchOptions, ModeSetup::Quiet> },
+		{ Dependencies::isRequested, runMode<Dependencies, DependencyOptions, ModeSetup::Quiet> },
+		{ AssetServer::isRequested, runMode<AssetServer, AssetServerOptions, ModeSetup::Logging> },
+		{ AssetQuery::isRequested, runMode<AssetQuery, QueryOptions, ModeSetup::None> },
+		{ Headless::isRequested, runMode<Headless, HeadlessOptions, ModeSetup::Logging> },
+	};
+
+	for (const CommandLineMode& mode : MODES)
+	{
+		if (mode.isRequested(argc, argv))
+		{
+			return mode.run(argc, argv);
+		}
+	}
+
 	if (!Config::load(Application::APPLICATION_PATH + "config.cfg"))
 	{
-		Debug::log("Config file not found, creating default config");
+		LOG_WARNING(General, "Config file not found, creating default config");
+		Debug::flush();
 		std::cout << "Failed to load config file." << std::endl <<
 			"A config file will now be created where you can enter which model to load." << std::endl <<
 			"Please relaunch after!" << std::endl << std::endl;
@@ -44,6 +158,8 @@ int main(int argc, char* argv[])
 		return -1;
 	}
 
+	Debug::setFilter(Config::logFilter);
+
 	GLFWwindow* window;
 
 	if (!glfwInit())
@@ -52,7 +168,7 @@ int main(int argc, char* argv[])
 		return -1;
 	}
 
-	Debug::log("Initializing GLFW...");
+	LOG_INFO(Render, "Initializing GLFW...");
 	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
 	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
 	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
@@ -60,32 +176,32 @@ int main(int argc, char* argv[])
 	window = glfwCreateWindow(Config::windowResolutionX, Config::windowResolutionY, "TYViewer", NULL, NULL);
 	if (!window)
 	{
-		Debug::log("[FATAL] Failed to create GLFWwindow!");
+		LOG_ERROR(Render, "[FATAL] Failed to create GLFWwindow!");
 		std::cout << "[FATAL] Failed to create GLFWwindow!" << std::endl;
 		glfwTerminate();
 		return -1;
 	}
 
-	Debug::log("Initializing OpenGL context...");
+	LOG_INFO(Render, "Initializing OpenGL context...");
 	glfwMakeContextCurrent(window);
 	gladLoadGL();
 
 	if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
 	{
-		Debug::log("[FATAL] Failed to initialize GLAD!");
+		LOG_ERROR(Render, "[FATAL] Failed to initialize GLAD!");
 		std::cout << "[FATAL] Failed to initialize GLAD!" << std::endl;
 		glfwTerminate();
 		return -1;
 	}
 
-	Debug::log("OpenGL initialized successfully");
+	LOG_INFO(Render, "OpenGL initialized successfully");
 	glfwSetWindowSizeCallback(window, onWindowResized);
 
-	Debug::log("Creating application instance...");
+	LOG_INFO(General, "Creating application instance...");
 	application = new Application(window);
-	Debug::log("Initializing application...");
+	LOG_INFO(General, "Initializing application...");
 	application->initialize();
-	Debug::log("Starting main loop...");
+	LOG_INFO(General, "Starting main loop...");
 	application->run();
 
 	return 0;
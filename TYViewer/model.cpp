@@ -19,3 +19,69 @@ void Model::draw(Shader& shader) const
 		mesh->draw(shader);
 	}
 }
+
+void Model::draw(Shader& shader, const glm::mat4& modelMatrix) const
+{
+	for (auto& mesh : meshes)
+	{
+		mesh->draw(shader, modelMatrix * mesh->getMatrix());
+	}
+}
+
+void Model::drawCollision(Shader& shader, const glm::mat4& modelMatrix, const glm::vec4& colour) const
+{
+	collisionBuffer.draw(shader, modelMatrix, colour);
+}
+
+void Model::setup()
+{
+	for (auto& mesh : meshes)
+	{
+		mesh->setup();
+	}
+
+	collisionBuffer.setup(collision);
+}
+
+const std::vector<Mesh*>& Model::getMeshes() const
+{
+	return meshes;
+}
+
+MemoryUsage Model::getMemoryUsage() const
+{
+	MemoryUsage usage;
+	usage.cpuTransient = loadBytes;
+	usage.cpuOther = sizeof(Model) +
+		meshes.capacity() * sizeof(Mesh*) +
+		colliders.capacity() * sizeof(Collider) +
+		bounds.capacity() * sizeof(Bounds) +
+		bones.capacity() * sizeof(Bone) +
+		ranges.capacity() * sizeof(MeshRange) +
+		components.capacity() * sizeof(std::string) +
+		collision.getHeapBytes();
+	usage.gpuBuffers = collisionBuffer.getGpuBytes();
+
+	for (size_t i = 0; i < meshes.size(); i++)
+	{
+		usage.cpuRetained += meshes[i]->getCpuBytes();
+		usage.cpuOther += sizeof(Mesh);
+		usage.gpuBuffers += meshes[i]->getGpuBytes();
+
+		// Meshes often share a texture, count each once. Linear, this runs every frame and must not allocate.
+		Texture* texture = meshes[i]->getTexture();
+		bool counted = texture == nullptr;
+		for (size_t j = 0; j < i && !counted; j++)
+		{
+			counted = meshes[j]->getTexture() == texture;
+		}
+
+		if (!counted)
+		{
+			usage.gpuTextures += texture->getGpuBytes();
+			usage.textures++;
+		}
+	}
+
+	return usage;
+}
\ No newline at end of file
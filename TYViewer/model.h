@@ -6,22 +6,33 @@
 #include "graphics/transformable.h"
 
 #include "graphics/mesh.h"
+#include "graphics/collisionbuffer.h"
 
-struct Collider 
-{
-	glm::vec3 position;
-	float size;
-};
+#include "loader/modeldata.h"
 
-struct Bounds
+// Bytes held by loaded assets.
+struct MemoryUsage
 {
-	glm::vec3 corner;
-	glm::vec3 size;
-};
+	// Vertex and index copies meshes keep after upload, what dropping them would save.
+	size_t cpuRetained = 0;
+	// Mesh objects, colliders, collision layer, bounds and bones.
+	size_t cpuOther = 0;
+	// Decoded ModelData while loading, freed once the model is built.
+	size_t cpuTransient = 0;
 
-struct Bone
-{
-	glm::vec3 defaultPosition;
+	size_t gpuBuffers = 0;
+	// Including mips. Textures shared between models count for each of them.
+	size_t gpuTextures = 0;
+	size_t textures = 0;
+
+	inline size_t getCpuBytes() const
+	{
+		return cpuRetained + cpuOther;
+	}
+	inline size_t getGpuBytes() const
+	{
+		return gpuBuffers + gpuTextures;
+	}
 };
 
 class Model : public Drawable
@@ -31,6 +42,18 @@ public:
 	~Model();
 
 	virtual void draw(Shader& shader) const override;
+	// Draws the model placed by 'modelMatrix', on top of each mesh's own transform.
+	void draw(Shader& shader, const glm::mat4& modelMatrix) const;
+
+	// The "CM_" collision layer in one draw call, placed like draw(). Nothing for models without one.
+	void drawCollision(Shader& shader, const glm::mat4& modelMatrix, const glm::vec4& colour) const;
+
+	// Creates the GPU resources of every mesh and of the collision layer.
+	void setup();
+
+	const std::vector<Mesh*>& getMeshes() const;
+
+	MemoryUsage getMemoryUsage() const;
 
 	glm::vec3 bounds_crn;
 	glm::vec3 bounds_size;
@@ -38,7 +61,20 @@ public:
 	std::vector<Collider> colliders;
 	std::vector<Bounds> bounds;
 	std::vector<Bone> bones;
+	// Kept after upload for ray and sphere queries, see Picker::addCollision.
+	CollisionMesh collision;
+
+	// One per mesh, for the texture and component it was built from. Offsets are into that ModelData.
+	std::vector<MeshRange> ranges;
+	// Subobject names, by MeshRange::component.
+	std::vector<std::string> components;
+
+	LoadTimings loadTimings;
+
+	// ModelData::getHeapBytes of the data this model was built from.
+	size_t loadBytes = 0;
 
 private:
 	std::vector<Mesh*> meshes;
+	CollisionBuffer collisionBuffer;
 };
\ No newline at end of file
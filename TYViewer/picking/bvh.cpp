@@ -0,0 +1,650 @@
+#include "bvh.h"
+
+#include <cmath>
+
+#include "util/trace.h"
+
+// Cost of visiting a node, relative to intersecting one group of primitives.
+#define BVH_NODE_COST 1.0f
+
+// Triangles seen nearly edge on are missed rather than hit with a huge error.
+#define BVH_DETERMINANT_EPSILON 1e-12f
+
+// Smaller direction components are rounded up to this, 0 would make box tests 0 * infinity.
+#define BVH_MIN_DIRECTION 1e-20f
+
+// A primitive's box, moved along while nodes are split rather than looked up through an index.
+struct BuildPrimitive
+{
+	glm::vec3 min;
+	glm::vec3 max;
+	glm::vec3 centroid;
+	uint32_t index;
+};
+
+// A node still to split.
+struct BuildTask
+{
+	uint32_t node;
+	uint32_t depth;
+	glm::vec3 centroidMin;
+	glm::vec3 centroidMax;
+};
+
+struct Bin
+{
+	glm::vec3 min = glm::vec3(FLT_MAX);
+	glm::vec3 max = glm::vec3(-FLT_MAX);
+	uint32_t count = 0;
+};
+
+// Half the surface area, 0 for an empty box.
+static inline float getArea(const glm::vec3& min, const glm::vec3& max)
+{
+	glm::vec3 size = max - min;
+	if (size.x < 0.0f || size.y < 0.0f || size.z < 0.0f)
+		return 0.0f;
+
+	return size.x * size.y + size.y * size.z + size.z * size.x;
+}
+
+static inline float getGroups(uint32_t count, uint32_t width)
+{
+	return static_cast<float>((count + width - 1) / width);
+}
+
+RayBoxTest::RayBoxTest(const Ray& ray)
+{
+	glm::vec3 direction = ray.direction;
+	for (int i = 0; i < 3; i++)
+	{
+		if (std::abs(direction[i]) < BVH_MIN_DIRECTION)
+			direction[i] = direction[i] < 0.0f ? -BVH_MIN_DIRECTION : BVH_MIN_DIRECTION;
+	}
+
+#if BVH_SSE
+	origin = _mm_setr_ps(ray.origin.x, ray.origin.y, ray.origin.z, 0.0f);
+	inverse = _mm_setr_ps(1.0f / direction.x, 1.0f / direction.y, 1.0f / direction.z, 0.0f);
+#else
+	origin = ray.origin;
+	inverse = 1.0f / direction;
+#endif
+}
+
+void BVH::build(const glm::vec3* mins, const glm::vec3* maxs, size_t count, uint32_t width,
+	std::vector<BVHNode>& nodes, std::vector<uint32_t>& order)
+{
+	nodes.clear();
+	order.clear();
+
+	if (count == 0)
+		return;
+
+	// Sorted in place as nodes are split, leaves end up with their primitives next to each other.
+	std::vector<BuildPrimitive> primitives(count);
+	for (size_t i = 0; i < count; i++)
+	{
+		primitives[i].min = mins[i];
+		primitives[i].max = maxs[i];
+		primitives[i].centroid = (mins[i] + maxs[i]) * 0.5f;
+		primitives[i].index = static_cast<uint32_t>(i);
+	}
+
+	// Box of a node, and of the centroids in it to bin them by.
+	auto fit = [&](BVHNode& node, BuildTask& task)
+	{
+		node.min = glm::vec3(FLT_MAX);
+		node.max = glm::vec3(-FLT_MAX);
+		task.centroidMin = glm::vec3(FLT_MAX);
+		task.centroidMax = glm::vec3(-FLT_MAX);
+
+		for (uint32_t i = node.first; i < node.first + node.count; i++)
+		{
+			node.min = glm::min(node.min, primitives[i].min);
+			node.max = glm::max(node.max, primitives[i].max);
+			task.centroidMin = glm::min(task.centroidMin, primitives[i].centroid);
+			task.centroidMax = glm::max(task.centroidMax, primitives[i].centroid);
+		}
+	};
+
+	// A binary tree with one primitive per leaf at most has 2n - 1 nodes, no reallocation past this.
+	nodes.reserve(count * 2);
+
+	BVHNode root;
+	root.first = 0;
+	root.count = static_cast<uint32_t>(count);
+
+	BuildTask task;
+	task.node = 0;
+	task.depth = 0;
+	fit(root, task);
+	nodes.push_back(root);
+
+	std::vector<BuildTask> pending;
+	pending.push_back(task);
+
+	while (!pending.empty())
+	{
+		task = pending.back();
+		pending.pop_back();
+
+		uint32_t first = nodes[task.node].first;
+		uint32_t contained = nodes[task.node].count;
+		if (contained <= 1 || task.depth + 1 >= BVH_MAX_DEPTH)
+			continue;
+
+		// Every axis is binned in the same pass, flat ones are skipped.
+		glm::vec3 scale(0.0f);
+		for (int axis = 0; axis < 3; axis++)
+		{
+			float extent = task.centroidMax[axis] - task.centroidMin[axis];
+			if (extent > 0.0f)
+				scale[axis] = BVH_BINS / extent;
+		}
+
+		Bin bins[3][BVH_BINS];
+		for (uint32_t i = first; i < first + contained; i++)
+		{
+			const BuildPrimitive& primitive = primitives[i];
+			for (int axis = 0; axis < 3; axis++)
+			{
+				if (scale[axis] == 0.0f)
+					continue;
+
+				int bin = std::min(BVH_BINS - 1, static_cast<int>((primitive.centroid[axis] - task.centroidMin[axis]) * scale[axis]));
+				bins[axis][bin].count++;
+				bins[axis][bin].min = glm::min(bins[axis][bin].min, primitive.min);
+				bins[axis][bin].max = glm::max(bins[axis][bin].max, primitive.max);
+			}
+		}
+
+		// The split is after bin 'bestSplit' of 'bestAxis'.
+		float bestCost = FLT_MAX;
+		int bestAxis = -1;
+		int bestSplit = 0;
+
+		for (int axis = 0; axis < 3; axis++)
+		{
+			if (scale[axis] == 0.0f)
+				continue;
+
+			// Everything right of each split, swept from the right.
+			float rightAreas[BVH_BINS - 1];
+			uint32_t rightCounts[BVH_BINS - 1];
+
+			Bin right;
+			for (int split = BVH_BINS - 2; split >= 0; split--)
+			{
+				const Bin& bin = bins[axis][split + 1];
+				right.count += bin.count;
+				right.min = glm::min(right.min, bin.min);
+				right.max = glm::max(right.max, bin.max);
+
+				rightAreas[split] = getArea(right.min, right.max);
+				rightCounts[split] = right.count;
+			}
+
+			Bin left;
+			for (int split = 0; split < BVH_BINS - 1; split++)
+			{
+				const Bin& bin = bins[axis][split];
+				left.count += bin.count;
+				left.min = glm::min(left.min, bin.min);
+				left.max = glm::max(left.max, bin.max);
+
+				if (left.count == 0 || rightCounts[split] == 0)
+					continue;
+
+				float cost = getArea(left.min, left.max) * getGroups(left.count, width) +
+					rightAreas[split] * getGroups(rightCounts[split], width);
+
+				if (cost < bestCost)
+				{
+					bestCost = cost;
+					bestAxis = axis;
+					bestSplit = split;
+				}
+			}
+		}
+
+		float area = getArea(nodes[task.node].min, nodes[task.node].max);
+		float leafCost = area * getGroups(contained, width);
+		float splitCost = area * BVH_NODE_COST + bestCost;
+
+		uint32_t middle;
+		if (bestAxis >= 0 && (splitCost < leafCost || contained > BVH_MAX_LEAF))
+		{
+			int axis = bestAxis;
+			int split = bestSplit;
+			float start = task.centroidMin[axis];
+			float binScale = scale[axis];
+
+			// Binned exactly as above, so the halves have the counts the cost was computed from.
+			auto end = std::partition(primitives.begin() + first, primitives.begin() + first + contained, [&](const BuildPrimitive& primitive)
+			{
+				return std::min(BVH_BINS - 1, static_cast<int>((primitive.centroid[axis] - start) * binScale)) <= split;
+			});
+			middle = static_cast<uint32_t>(end - primitives.begin());
+		}
+		else if (contained > BVH_MAX_LEAF)
+		{
+			// Every centroid in the same place, any halves are as good as the next.
+			middle = first + contained / 2;
+		}
+		else
+		{
+			continue;
+		}
+
+		uint32_t children = static_cast<uint32_t>(nodes.size());
+
+		BVHNode left;
+		left.first = first;
+		left.count = middle - first;
+
+		BuildTask leftTask;
+		leftTask.node = children;
+		leftTask.depth = task.depth + 1;
+		fit(left, leftTask);
+
+		BVHNode right;
+		right.first = middle;
+		right.count = first + contained - middle;
+
+		BuildTask rightTask;
+		rightTask.node = children + 1;
+		rightTask.depth = task.depth + 1;
+		fit(right, rightTask);
+
+		nodes.push_back(left);
+		nodes.push_back(right);
+
+		nodes[task.node].first = children;
+		nodes[task.node].count = 0;
+
+		pending.push_back(leftTask);
+		pending.push_back(rightTask);
+	}
+
+	nodes.shrink_to_fit();
+
+	order.resize(count);
+	for (size_t i = 0; i < count; i++)
+	{
+		order[i] = primitives[i].index;
+	}
+}
+
+TriangleBVH::TriangleBVH() :
+	min(FLT_MAX),
+	max(-FLT_MAX),
+	built(false)
+{}
+
+static inline glm::vec3 getPosition(const Vertex& vertex)
+{
+	return glm::vec3(vertex.position);
+}
+
+static inline glm::vec3 getPosition(const glm::vec3& position)
+{
+	return position;
+}
+
+// Closest point of triangle 'a' 'b' 'c' to 'point', by the region of the triangle it is in.
+static glm::vec3 closestPointOnTriangle(const glm::vec3& point, const glm::vec3& a, const glm::vec3& b, const glm::vec3& c)
+{
+	glm::vec3 ab = b - a;
+	glm::vec3 ac = c - a;
+
+	glm::vec3 ap = point - a;
+	float d1 = glm::dot(ab, ap);
+	float d2 = glm::dot(ac, ap);
+	if (d1 <= 0.0f && d2 <= 0.0f)
+		return a;
+
+	glm::vec3 bp = point - b;
+	float d3 = glm::dot(ab, bp);
+	float d4 = glm::dot(ac, bp);
+	if (d3 >= 0.0f && d4 <= d3)
+		return b;
+
+	float vc = d1 * d4 - d3 * d2;
+	if (vc <= 0.0f && d1 >= 0.0f && d3 <= 0.0f)
+		return a + ab * (d1 / (d1 - d3));
+
+	glm::vec3 cp = point - c;
+	float d5 = glm::dot(ab, cp);
+	float d6 = glm::dot(ac, cp);
+	if (d6 >= 0.0f && d5 <= d6)
+		return c;
+
+	float vb = d5 * d2 - d1 * d6;
+	if (vb <= 0.0f && d2 >= 0.0f && d6 <= 0.0f)
+		return a + ac * (d2 / (d2 - d6));
+
+	float va = d3 * d6 - d5 * d4;
+	if (va <= 0.0f && (d4 - d3) >= 0.0f && (d5 - d6) >= 0.0f)
+		return b + (c - b) * ((d4 - d3) / ((d4 - d3) + (d5 - d6)));
+
+	// Inside the face, degenerate triangles never get here.
+	float denominator = 1.0f / (va + vb + vc);
+	return a + ab * (vb * denominator) + ac * (vc * denominator);
+}
+
+void TriangleBVH::setTriangles(const Vertex* vertices, size_t vertexCount, const unsigned int* indices, size_t indexCount)
+{
+	copyTriangles(vertices, vertexCount, indices, indexCount);
+}
+
+void TriangleBVH::setTriangles(const glm::vec3* positions, size_t vertexCount, const unsigned int* indices, size_t indexCount)
+{
+	copyTriangles(positions, vertexCount, indices, indexCount);
+}
+
+template<typename Position>
+void TriangleBVH::copyTriangles(const Position* vertices, size_t vertexCount, const unsigned int* indices, size_t indexCount)
+{
+	size_t triangles = indexCount / 3;
+
+	corners.assign(triangles * 3, glm::vec3(0.0f));
+	skipped.assign(triangles, false);
+
+	min = glm::vec3(FLT_MAX);
+	max = glm::vec3(-FLT_MAX);
+
+	nodes.clear();
+	packets.clear();
+	built = false;
+
+	for (size_t i = 0; i < triangles; i++)
+	{
+		const unsigned int* triangle = &indices[i * 3];
+		if (triangle[0] >= vertexCount || triangle[1] >= vertexCount || triangle[2] >= vertexCount)
+		{
+			skipped[i] = true;
+			continue;
+		}
+
+		for (int corner = 0; corner < 3; corner++)
+		{
+			glm::vec3 position = getPosition(vertices[triangle[corner]]);
+			corners[i * 3 + corner] = position;
+
+			min = glm::min(min, position);
+			max = glm::max(max, position);
+		}
+	}
+}
+
+void TriangleBVH::build()
+{
+	TRACE_ZONE("TriangleBVH::build");
+
+	// The triangles that were kept, by their index list position.
+	std::vector<uint32_t> triangles;
+	std::vector<glm::vec3> mins;
+	std::vector<glm::vec3> maxs;
+
+	triangles.reserve(skipped.size());
+	mins.reserve(skipped.size());
+	maxs.reserve(skipped.size());
+
+	for (size_t i = 0; i < skipped.size(); i++)
+	{
+		if (skipped[i])
+			continue;
+
+		const glm::vec3* triangle = &corners[i * 3];
+		triangles.push_back(static_cast<uint32_t>(i));
+		mins.push_back(glm::min(glm::min(triangle[0], triangle[1]), triangle[2]));
+		maxs.push_back(glm::max(glm::max(triangle[0], triangle[1]), triangle[2]));
+	}
+
+	std::vector<uint32_t> order;
+	BVH::build(mins.data(), maxs.data(), triangles.size(), BVH_PACKET_SIZE, nodes, order);
+
+	// Leaves are moved from ranges of 'order' to ranges of packets, 'count' stays in triangles.
+	packets.clear();
+	packets.reserve((triangles.size() + BVH_PACKET_SIZE - 1) / BVH_PACKET_SIZE + nodes.size() / 2);
+
+	for (auto& node : nodes)
+	{
+		if (node.count == 0)
+			continue;
+
+		uint32_t first = static_cast<uint32_t>(packets.size());
+		for (uint32_t i = 0; i < node.count; i += BVH_PACKET_SIZE)
+		{
+			Packet packet = {};
+			for (int lane = 0; lane < BVH_PACKET_SIZE; lane++)
+			{
+				packet.triangle[lane] = UINT32_MAX;
+				if (i + lane >= node.count)
+					continue;
+
+				uint32_t triangle = triangles[order[node.first + i + lane]];
+				const glm::vec3* corner = &corners[triangle * 3];
+				glm::vec3 e1 = corner[1] - corner[0];
+				glm::vec3 e2 = corner[2] - corner[0];
+
+				for (int axis = 0; axis < 3; axis++)
+				{
+					packet.v0[axis][lane] = corner[0][axis];
+					packet.e1[axis][lane] = e1[axis];
+					packet.e2[axis][lane] = e2[axis];
+				}
+				packet.triangle[lane] = triangle;
+			}
+			packets.push_back(packet);
+		}
+
+		node.first = first;
+	}
+
+	built = true;
+}
+
+bool TriangleBVH::isBuilt() const
+{
+	return built;
+}
+
+bool TriangleBVH::intersect(const Ray& ray, RayHit& hit) const
+{
+	float start = hit.distance;
+
+	BVH::traverse(nodes, ray, hit.distance, [this, &ray, &hit](const BVHNode& leaf, float&)
+	{
+		uint32_t end = leaf.first + (leaf.count + BVH_PACKET_SIZE - 1) / BVH_PACKET_SIZE;
+		for (uint32_t i = leaf.first; i < end; i++)
+		{
+			intersectPacket(packets[i], ray, hit);
+		}
+	});
+
+	return hit.distance < start;
+}
+
+bool TriangleBVH::overlap(const glm::vec3& center, float radius, std::vector<SphereHit>& hits) const
+{
+	size_t start = hits.size();
+
+	BVH::query(nodes, center, radius, [this, &center, radius, &hits](const BVHNode& leaf)
+	{
+		uint32_t end = leaf.first + (leaf.count + BVH_PACKET_SIZE - 1) / BVH_PACKET_SIZE;
+		for (uint32_t i = leaf.first; i < end; i++)
+		{
+			for (int lane = 0; lane < BVH_PACKET_SIZE; lane++)
+			{
+				uint32_t triangle = packets[i].triangle[lane];
+				if (triangle == UINT32_MAX)
+					continue;
+
+				const glm::vec3* corner = &corners[static_cast<size_t>(triangle) * 3];
+				glm::vec3 closest = closestPointOnTriangle(center, corner[0], corner[1], corner[2]);
+
+				float distance = glm::length(closest - center);
+				if (distance > radius)
+					continue;
+
+				SphereHit hit;
+				hit.triangle = triangle;
+				hit.position = closest;
+				hit.distance = distance;
+				hits.push_back(hit);
+			}
+		}
+	});
+
+	return hits.size() > start;
+}
+
+void TriangleBVH::intersectPacket(const Packet& packet, const Ray& ray, RayHit& hit) const
+{
+	// Moller-Trumbore, one triangle per lane.
+#if BVH_SSE
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 one = _mm_set1_ps(1.0f);
+	const __m128 sign = _mm_set1_ps(-0.0f);
+
+	__m128 dx = _mm_set1_ps(ray.direction.x);
+	__m128 dy = _mm_set1_ps(ray.direction.y);
+	__m128 dz = _mm_set1_ps(ray.direction.z);
+
+	__m128 e1x = _mm_load_ps(packet.e1[0]);
+	__m128 e1y = _mm_load_ps(packet.e1[1]);
+	__m128 e1z = _mm_load_ps(packet.e1[2]);
+	__m128 e2x = _mm_load_ps(packet.e2[0]);
+	__m128 e2y = _mm_load_ps(packet.e2[1]);
+	__m128 e2z = _mm_load_ps(packet.e2[2]);
+
+	// p = d x e2
+	__m128 px = _mm_sub_ps(_mm_mul_ps(dy, e2z), _mm_mul_ps(dz, e2y));
+	__m128 py = _mm_sub_ps(_mm_mul_ps(dz, e2x), _mm_mul_ps(dx, e2z));
+	__m128 pz = _mm_sub_ps(_mm_mul_ps(dx, e2y), _mm_mul_ps(dy, e2x));
+
+	__m128 determinant = _mm_add_ps(_mm_add_ps(_mm_mul_ps(e1x, px), _mm_mul_ps(e1y, py)), _mm_mul_ps(e1z, pz));
+	__m128 valid = _mm_cmpgt_ps(_mm_andnot_ps(sign, determinant), _mm_set1_ps(BVH_DETERMINANT_EPSILON));
+	if (_mm_movemask_ps(valid) == 0)
+		return;
+
+	__m128 inverse = _mm_div_ps(one, determinant);
+
+	// s = o - v0
+	__m128 sx = _mm_sub_ps(_mm_set1_ps(ray.origin.x), _mm_load_ps(packet.v0[0]));
+	__m128 sy = _mm_sub_ps(_mm_set1_ps(ray.origin.y), _mm_load_ps(packet.v0[1]));
+	__m128 sz = _mm_sub_ps(_mm_set1_ps(ray.origin.z), _mm_load_ps(packet.v0[2]));
+
+	__m128 u = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(sx, px), _mm_mul_ps(sy, py)), _mm_mul_ps(sz, pz)), inverse);
+
+	// q = s x e1
+	__m128 qx = _mm_sub_ps(_mm_mul_ps(sy, e1z), _mm_mul_ps(sz, e1y));
+	__m128 qy = _mm_sub_ps(_mm_mul_ps(sz, e1x), _mm_mul_ps(sx, e1z));
+	__m128 qz = _mm_sub_ps(_mm_mul_ps(sx, e1y), _mm_mul_ps(sy, e1x));
+
+	__m128 v = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, qx), _mm_mul_ps(dy, qy)), _mm_mul_ps(dz, qz)), inverse);
+	__m128 t = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(e2x, qx), _mm_mul_ps(e2y, qy)), _mm_mul_ps(e2z, qz)), inverse);
+
+	valid = _mm_and_ps(valid, _mm_cmpge_ps(u, zero));
+	valid = _mm_and_ps(valid, _mm_cmpge_ps(v, zero));
+	valid = _mm_and_ps(valid, _mm_cmple_ps(_mm_add_ps(u, v), one));
+	valid = _mm_and_ps(valid, _mm_cmpgt_ps(t, zero));
+	valid = _mm_and_ps(valid, _mm_cmplt_ps(t, _mm_set1_ps(hit.distance)));
+
+	int mask = _mm_movemask_ps(valid);
+	if (mask == 0)
+		return;
+
+	float distances[BVH_PACKET_SIZE];
+	float us[BVH_PACKET_SIZE];
+	float vs[BVH_PACKET_SIZE];
+	_mm_storeu_ps(distances, t);
+	_mm_storeu_ps(us, u);
+	_mm_storeu_ps(vs, v);
+
+	for (int lane = 0; lane < BVH_PACKET_SIZE; lane++)
+	{
+		if ((mask & (1 << lane)) && distances[lane] < hit.distance)
+		{
+			hit.distance = distances[lane];
+			hit.triangle = packet.triangle[lane];
+			hit.u = us[lane];
+			hit.v = vs[lane];
+		}
+	}
+#else
+	for (int lane = 0; lane < BVH_PACKET_SIZE; lane++)
+	{
+		glm::vec3 e1(packet.e1[0][lane], packet.e1[1][lane], packet.e1[2][lane]);
+		glm::vec3 e2(packet.e2[0][lane], packet.e2[1][lane], packet.e2[2][lane]);
+
+		glm::vec3 p = glm::cross(ray.direction, e2);
+		float determinant = glm::dot(e1, p);
+		if (std::abs(determinant) <= BVH_DETERMINANT_EPSILON)
+			continue;
+
+		float inverse = 1.0f / determinant;
+
+		glm::vec3 s = ray.origin - glm::vec3(packet.v0[0][lane], packet.v0[1][lane], packet.v0[2][lane]);
+		float u = glm::dot(s, p) * inverse;
+		if (u < 0.0f || u > 1.0f)
+			continue;
+
+		glm::vec3 q = glm::cross(s, e1);
+		float v = glm::dot(ray.direction, q) * inverse;
+		if (v < 0.0f || u + v > 1.0f)
+			continue;
+
+		float t = glm::dot(e2, q) * inverse;
+		if (t > 0.0f && t < hit.distance)
+		{
+			hit.distance = t;
+			hit.triangle = packet.triangle[lane];
+			hit.u = u;
+			hit.v = v;
+		}
+	}
+#endif
+}
+
+bool TriangleBVH::getTriangle(uint32_t index, glm::vec3 corners[3]) const
+{
+	if (index >= skipped.size() || skipped[index])
+		return false;
+
+	for (int corner = 0; corner < 3; corner++)
+	{
+		corners[corner] = this->corners[static_cast<size_t>(index) * 3 + corner];
+	}
+	return true;
+}
+
+const glm::vec3& TriangleBVH::getMin() const
+{
+	return min;
+}
+
+const glm::vec3& TriangleBVH::getMax() const
+{
+	return max;
+}
+
+size_t TriangleBVH::getTriangleCount() const
+{
+	return skipped.size();
+}
+
+size_t TriangleBVH::getNodeCount() const
+{
+	return nodes.size();
+}
+
+size_t TriangleBVH::getBytes() const
+{
+	return sizeof(TriangleBVH) +
+		corners.capacity() * sizeof(glm::vec3) +
+		skipped.capacity() / 8 +
+		nodes.capacity() * sizeof(BVHNode) +
+		packets.capacity() * sizeof(Packet);
+}
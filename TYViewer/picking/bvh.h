@@ -0,0 +1,174 @@
+#pragma once
+
+#include <cfloat>
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+
+#include <glm/glm.hpp>
+
+#include "graphics/vertex.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define BVH_SSE 1
+#else
+#define BVH_SSE 0
+#endif
+
+// Split candidates per axis.
+#define BVH_BINS 12
+
+// Leaves past this are split even where the heuristic would stop, unless the depth limit is reached.
+#define BVH_MAX_LEAF 16
+// Bounds the traversal stack, nodes this deep become leaves.
+#define BVH_MAX_DEPTH 64
+
+// Triangles intersected at once, 4 lanes of SSE.
+#define BVH_PACKET_SIZE 4
+
+struct Ray
+{
+	glm::vec3 origin;
+	// Distances along the ray are in multiples of this.
+	glm::vec3 direction;
+};
+
+// 32 bytes, the two children of a node are next to each other and fill one cache line.
+struct BVHNode
+{
+	glm::vec3 min;
+	// Inner nodes: index of the first child, the second follows it. Leaves: first primitive.
+	uint32_t first;
+	glm::vec3 max;
+	// Primitives in a leaf, 0 for inner nodes.
+	uint32_t count;
+};
+
+// A ray with its inverse direction, set up once for every box it is tested against.
+class RayBoxTest
+{
+public:
+	RayBoxTest(const Ray& ray);
+
+	// Where the ray enters the box of 'node', 0 if it starts inside.
+	// FLT_MAX if it misses or only gets there from 'distance' on.
+	inline float intersect(const BVHNode& node, float distance) const;
+
+private:
+#if BVH_SSE
+	__m128 origin;
+	__m128 inverse;
+#else
+	glm::vec3 origin;
+	glm::vec3 inverse;
+#endif
+};
+
+// Bounding volume hierarchies over boxes, built with a binned surface area heuristic.
+class BVH
+{
+public:
+	// Fills 'nodes' over the boxes of 'count' primitives, root first. Leaves refer to ranges of
+	// 'order', the primitives sorted so those of a leaf are next to each other.
+	// Leaves are costed per 'width' primitives, how many are intersected at once.
+	static void build(const glm::vec3* mins, const glm::vec3* maxs, size_t count, uint32_t width,
+		std::vector<BVHNode>& nodes, std::vector<uint32_t>& order);
+
+	// Visits the leaves 'ray' passes through, nearest first, as leaf(node, distance).
+	// Hits lower 'distance', leaves the ray only enters beyond it are skipped.
+	template<typename Leaf>
+	static void traverse(const std::vector<BVHNode>& nodes, const Ray& ray, float& distance, Leaf leaf);
+
+	// Visits the leaves whose box is within 'radius' of 'center' as leaf(node), in no particular order.
+	template<typename Leaf>
+	static void query(const std::vector<BVHNode>& nodes, const glm::vec3& center, float radius, Leaf leaf);
+
+	// Whether the box of 'node' is within the square root of 'radiusSquared' of 'center'.
+	static inline bool overlaps(const BVHNode& node, const glm::vec3& center, float radiusSquared);
+};
+
+struct RayHit
+{
+	// Only hits closer than this are taken, it is lowered to the closest one.
+	float distance = FLT_MAX;
+
+	// Index list offset of the triangle / 3.
+	uint32_t triangle = UINT32_MAX;
+
+	// Barycentric coordinates of the hit, weights of the second and third corner.
+	float u = 0.0f;
+	float v = 0.0f;
+};
+
+struct SphereHit
+{
+	// Index list offset of the triangle / 3.
+	uint32_t triangle = UINT32_MAX;
+
+	// Point of the triangle closest to the sphere's center, and how far from it that is.
+	glm::vec3 position = glm::vec3(0.0f);
+	float distance = 0.0f;
+};
+
+// Hierarchy over the triangles of one mesh. Leaves hold packets of BVH_PACKET_SIZE triangles,
+// tested against a ray together with SSE where available.
+class TriangleBVH
+{
+public:
+	TriangleBVH();
+
+	// Copies the corners, build() can then run on any thread. Triangles with an index past 'vertexCount' are left out.
+	void setTriangles(const Vertex* vertices, size_t vertexCount, const unsigned int* indices, size_t indexCount);
+	// For meshes of positions only, such as a model's collision layer.
+	void setTriangles(const glm::vec3* positions, size_t vertexCount, const unsigned int* indices, size_t indexCount);
+	void build();
+
+	bool isBuilt() const;
+
+	// Both sides of a triangle are hit, models do not wind them consistently.
+	bool intersect(const Ray& ray, RayHit& hit) const;
+
+	// Appends every triangle within 'radius' of 'center' to 'hits', false if there were none.
+	bool overlap(const glm::vec3& center, float radius, std::vector<SphereHit>& hits) const;
+
+	// Corners of triangle 'index' of the index list, false if it was left out.
+	bool getTriangle(uint32_t index, glm::vec3 corners[3]) const;
+
+	// Box around every triangle, empty (min above max) without any.
+	const glm::vec3& getMin() const;
+	const glm::vec3& getMax() const;
+
+	size_t getTriangleCount() const;
+	size_t getNodeCount() const;
+	size_t getBytes() const;
+
+private:
+	// Corners and edges of BVH_PACKET_SIZE triangles, one lane each. Unused lanes have no area and are never hit.
+	struct alignas(16) Packet
+	{
+		float v0[3][BVH_PACKET_SIZE];
+		float e1[3][BVH_PACKET_SIZE];
+		float e2[3][BVH_PACKET_SIZE];
+		uint32_t triangle[BVH_PACKET_SIZE];
+	};
+
+	// Copies the corners of either vertex type.
+	template<typename Position>
+	void copyTriangles(const Position* vertices, size_t vertexCount, const unsigned int* indices, size_t indexCount);
+
+	void intersectPacket(const Packet& packet, const Ray& ray, RayHit& hit) const;
+
+	// Three per triangle in index list order, and which of those were left out.
+	std::vector<glm::vec3> corners;
+	std::vector<bool> skipped;
+
+	glm::vec3 min;
+	glm::vec3 max;
+
+	std::vector<BVHNode> nodes;
+	std::vector<Packet> packets;
+	bool built;
+};
+
+#include "bvh.inl"
@@ -0,0 +1,161 @@
+inline float RayBoxTest::intersect(const BVHNode& node, float distance) const
+{
+#if BVH_SSE
+	// The fourth lane of a row is 'first' or 'count', it is masked to 0 along with the ray's.
+	const __m128 mask = _mm_castsi128_ps(_mm_setr_epi32(-1, -1, -1, 0));
+	const __m128 infinity = _mm_castsi128_ps(_mm_setr_epi32(0, 0, 0, 0x7F800000));
+
+	__m128 min = _mm_and_ps(_mm_loadu_ps(&node.min.x), mask);
+	__m128 max = _mm_and_ps(_mm_loadu_ps(&node.max.x), mask);
+
+	__m128 t1 = _mm_mul_ps(_mm_sub_ps(min, origin), inverse);
+	__m128 t2 = _mm_mul_ps(_mm_sub_ps(max, origin), inverse);
+
+	// A 0 in the fourth lane clamps the entry to the start of the ray, the exit ignores it.
+	__m128 entries = _mm_min_ps(t1, t2);
+	__m128 exits = _mm_or_ps(_mm_max_ps(t1, t2), infinity);
+
+	entries = _mm_max_ps(entries, _mm_shuffle_ps(entries, entries, _MM_SHUFFLE(1, 0, 3, 2)));
+	entries = _mm_max_ss(entries, _mm_shuffle_ps(entries, entries, _MM_SHUFFLE(2, 3, 0, 1)));
+	exits = _mm_min_ps(exits, _mm_shuffle_ps(exits, exits, _MM_SHUFFLE(1, 0, 3, 2)));
+	exits = _mm_min_ss(exits, _mm_shuffle_ps(exits, exits, _MM_SHUFFLE(2, 3, 0, 1)));
+
+	float entry = _mm_cvtss_f32(entries);
+	float exit = _mm_cvtss_f32(exits);
+#else
+	glm::vec3 t1 = (node.min - origin) * inverse;
+	glm::vec3 t2 = (node.max - origin) * inverse;
+
+	glm::vec3 entries = glm::min(t1, t2);
+	glm::vec3 exits = glm::max(t1, t2);
+
+	float entry = std::max(std::max(entries.x, entries.y), std::max(entries.z, 0.0f));
+	float exit = std::min(std::min(exits.x, exits.y), exits.z);
+#endif
+
+	return entry <= exit && entry < distance ? entry : FLT_MAX;
+}
+
+inline bool BVH::overlaps(const BVHNode& node, const glm::vec3& center, float radiusSquared)
+{
+	glm::vec3 closest = glm::min(glm::max(center, node.min), node.max);
+	glm::vec3 offset = closest - center;
+	return glm::dot(offset, offset) <= radiusSquared;
+}
+
+template<typename Leaf>
+void BVH::traverse(const std::vector<BVHNode>& nodes, const Ray& ray, float& distance, Leaf leaf)
+{
+	if (nodes.empty())
+		return;
+
+	RayBoxTest test(ray);
+	if (test.intersect(nodes[0], distance) == FLT_MAX)
+		return;
+
+	// Far children put aside, with where the ray enters them. One per level at most.
+	const BVHNode* stack[BVH_MAX_DEPTH];
+	float entries[BVH_MAX_DEPTH];
+	size_t depth = 0;
+
+	const BVHNode* node = &nodes[0];
+	while (true)
+	{
+		if (node->count > 0)
+		{
+			leaf(*node, distance);
+		}
+		else
+		{
+			const BVHNode* closer = &nodes[node->first];
+			const BVHNode* farther = &nodes[node->first + 1];
+
+			float closerEntry = test.intersect(*closer, distance);
+			float fartherEntry = test.intersect(*farther, distance);
+			if (fartherEntry < closerEntry)
+			{
+				std::swap(closer, farther);
+				std::swap(closerEntry, fartherEntry);
+			}
+
+			if (closerEntry != FLT_MAX)
+			{
+				if (fartherEntry != FLT_MAX)
+				{
+					stack[depth] = farther;
+					entries[depth] = fartherEntry;
+					depth++;
+				}
+
+				node = closer;
+				continue;
+			}
+		}
+
+		// Nodes put aside are skipped once a hit is closer than where they start.
+		node = nullptr;
+		while (depth > 0)
+		{
+			depth--;
+			if (entries[depth] < distance)
+			{
+				node = stack[depth];
+				break;
+			}
+		}
+
+		if (node == nullptr)
+			return;
+	}
+}
+
+template<typename Leaf>
+void BVH::query(const std::vector<BVHNode>& nodes, const glm::vec3& center, float radius, Leaf leaf)
+{
+	float radiusSquared = radius * radius;
+	if (nodes.empty() || !overlaps(nodes[0], center, radiusSquared))
+		return;
+
+	// Children are tested before they are put aside, the stack only holds nodes that overlap.
+	const BVHNode* stack[BVH_MAX_DEPTH];
+	size_t depth = 0;
+
+	const BVHNode* node = &nodes[0];
+	while (true)
+	{
+		if (node->count > 0)
+		{
+			leaf(*node);
+		}
+		else
+		{
+			const BVHNode* first = &nodes[node->first];
+			const BVHNode* second = &nodes[node->first + 1];
+
+			bool firstOverlaps = overlaps(*first, center, radiusSquared);
+			bool secondOverlaps = overlaps(*second, center, radiusSquared);
+
+			if (firstOverlaps)
+			{
+				if (secondOverlaps)
+				{
+					stack[depth++] = second;
+				}
+
+				node = first;
+				continue;
+			}
+
+			if (secondOverlaps)
+			{
+				node = second;
+				continue;
+			}
+		}
+
+		if (depth == 0)
+			return;
+
+		node = stack[--depth];
+	}
+}
@@ -0,0 +1,403 @@
+#include "picker.h"
+
+#include <atomic>
+#include <thread>
+
+#include "model.h"
+
+#include "util/trace.h"
+
+#include "debug.h"
+
+// Box around 'min' to 'max' once moved by 'transform'.
+static void transformBox(const glm::mat4& transform, const glm::vec3& min, const glm::vec3& max, glm::vec3& outMin, glm::vec3& outMax)
+{
+	outMin = glm::vec3(FLT_MAX);
+	outMax = glm::vec3(-FLT_MAX);
+	for (int corner = 0; corner < 8; corner++)
+	{
+		glm::vec3 point((corner & 1) ? max.x : min.x, (corner & 2) ? max.y : min.y, (corner & 4) ? max.z : min.z);
+		point = glm::vec3(transform * glm::vec4(point, 1.0f));
+
+		outMin = glm::min(outMin, point);
+		outMax = glm::max(outMax, point);
+	}
+}
+
+Picker::Picker()
+{}
+
+size_t Picker::addModel(const ModelData& data)
+{
+	TRACE_ZONE_DETAIL("Picker::addModel", data.name);
+
+	PickModel model;
+	model.name = data.name;
+	model.components = data.components;
+	model.ranges = data.meshes;
+	model.meshes.resize(data.meshes.size());
+
+	for (size_t i = 0; i < data.meshes.size(); i++)
+	{
+		const MeshRange& range = data.meshes[i];
+		if (range.vertexOffset + range.vertexCount > data.vertices.size() ||
+			range.indexOffset + range.indexCount > data.indices.size())
+			continue;
+
+		model.meshes[i].setTriangles(data.vertices.data() + range.vertexOffset, range.vertexCount,
+			data.indices.data() + range.indexOffset, range.indexCount);
+	}
+
+	models.push_back(std::move(model));
+	return models.size() - 1;
+}
+
+size_t Picker::addModel(const std::string& name, const Model& model)
+{
+	TRACE_ZONE_DETAIL("Picker::addModel", name);
+
+	const std::vector<Mesh*>& meshes = model.getMeshes();
+
+	PickModel pickModel;
+	pickModel.name = name;
+	pickModel.components = model.components;
+	pickModel.ranges = model.ranges;
+	pickModel.ranges.resize(meshes.size());
+	pickModel.meshes.resize(meshes.size());
+
+	for (size_t i = 0; i < meshes.size(); i++)
+	{
+		const std::vector<Vertex>& vertices = meshes[i]->getVertices();
+		const std::vector<unsigned int>& indices = meshes[i]->getIndices();
+
+		pickModel.meshes[i].setTriangles(vertices.data(), vertices.size(), indices.data(), indices.size());
+	}
+
+	models.push_back(std::move(pickModel));
+	return models.size() - 1;
+}
+
+size_t Picker::addCollision(const std::string& name, const CollisionMesh& collision)
+{
+	TRACE_ZONE_DETAIL("Picker::addCollision", name);
+
+	PickModel model;
+	model.name = name;
+	model.ranges.resize(1);
+	model.meshes.resize(1);
+
+	model.ranges[0].vertexCount = collision.positions.size();
+	model.ranges[0].indexCount = collision.indices.size();
+	model.meshes[0].setTriangles(collision.positions.data(), collision.positions.size(), collision.indices.data(), collision.indices.size());
+
+	models.push_back(std::move(model));
+	return models.size() - 1;
+}
+
+size_t Picker::addInstance(size_t model, const glm::mat4& transform)
+{
+	instances.push_back({ model, transform, glm::inverse(transform) });
+	return instances.size() - 1;
+}
+
+void Picker::clear()
+{
+	models.clear();
+	instances.clear();
+	entries.clear();
+	nodes.clear();
+}
+
+void Picker::build(unsigned int threads)
+{
+	TRACE_ZONE("Picker::build");
+
+	std::vector<TriangleBVH*> pending;
+	for (auto& model : models)
+	{
+		for (auto& mesh : model.meshes)
+		{
+			if (!mesh.isBuilt())
+				pending.push_back(&mesh);
+		}
+	}
+
+	if (threads == 0)
+		threads = std::max(1u, std::thread::hardware_concurrency());
+	threads = static_cast<unsigned int>(std::min<size_t>(threads, pending.size()));
+
+	// Meshes are independent, each worker takes the next one until none are left.
+	std::atomic<size_t> next(0);
+	auto work = [&]()
+	{
+		for (size_t i = next++; i < pending.size(); i = next++)
+		{
+			pending[i]->build();
+		}
+	};
+
+	std::vector<std::thread> workers;
+	for (unsigned int i = 1; i < threads; i++)
+	{
+		workers.emplace_back([&work]()
+		{
+			Trace::setThreadName("Picker");
+			work();
+		});
+	}
+
+	work();
+
+	for (auto& worker : workers)
+	{
+		worker.join();
+	}
+
+	// Every mesh of every instance, by its box in world space.
+	std::vector<Entry> unordered;
+	std::vector<glm::vec3> mins;
+	std::vector<glm::vec3> maxs;
+
+	for (size_t i = 0; i < instances.size(); i++)
+	{
+		const Instance& instance = instances[i];
+		if (instance.model >= models.size())
+			continue;
+
+		const PickModel& model = models[instance.model];
+		for (size_t mesh = 0; mesh < model.meshes.size(); mesh++)
+		{
+			if (model.meshes[mesh].getNodeCount() == 0)
+				continue;
+
+			glm::vec3 min;
+			glm::vec3 max;
+			transformBox(instance.transform, model.meshes[mesh].getMin(), model.meshes[mesh].getMax(), min, max);
+
+			unordered.push_back({ static_cast<uint32_t>(i), static_cast<uint32_t>(mesh) });
+			mins.push_back(min);
+			maxs.push_back(max);
+		}
+	}
+
+	std::vector<uint32_t> order;
+	BVH::build(mins.data(), maxs.data(), unordered.size(), 1, nodes, order);
+
+	entries.resize(order.size());
+	for (size_t i = 0; i < order.size(); i++)
+	{
+		entries[i] = unordered[order[i]];
+	}
+
+	LOG_DEBUG(Render, "Picker built over " + std::to_string(instances.size()) + " instances, " +
+		std::to_string(entries.size()) + " meshes and " + std::to_string(getTriangleCount()) + " triangles");
+}
+
+bool Picker::pick(const Ray& ray, PickResult& result) const
+{
+	float distance = FLT_MAX;
+	bool hit = false;
+
+	BVH::traverse(nodes, ray, distance, [&](const BVHNode& leaf, float& closest)
+	{
+		for (uint32_t i = leaf.first; i < leaf.first + leaf.count; i++)
+		{
+			const Entry& entry = entries[i];
+			const Instance& instance = instances[entry.instance];
+
+			// Distances carry over unchanged, the direction is transformed without normalizing.
+			Ray local;
+			local.origin = glm::vec3(instance.inverse * glm::vec4(ray.origin, 1.0f));
+			local.direction = glm::vec3(instance.inverse * glm::vec4(ray.direction, 0.0f));
+
+			RayHit meshHit;
+			meshHit.distance = closest;
+			if (!models[instance.model].meshes[entry.mesh].intersect(local, meshHit))
+				continue;
+
+			closest = meshHit.distance;
+			hit = true;
+
+			result.model = instance.model;
+			result.instance = entry.instance;
+			result.mesh = entry.mesh;
+			result.component = models[instance.model].ranges[entry.mesh].component;
+			result.triangle = meshHit.triangle;
+		}
+	});
+
+	if (!hit)
+		return false;
+
+	result.distance = distance;
+	result.position = ray.origin + ray.direction * distance;
+	return true;
+}
+
+bool Picker::overlap(const glm::vec3& center, float radius, std::vector<PickResult>& results) const
+{
+	size_t start = results.size();
+	std::vector<SphereHit> hits;
+
+	BVH::query(nodes, center, radius, [&](const BVHNode& leaf)
+	{
+		for (uint32_t i = leaf.first; i < leaf.first + leaf.count; i++)
+		{
+			const Entry& entry = entries[i];
+			const Instance& instance = instances[entry.instance];
+
+			// The radius grows by the inverse's largest scale, so scaled down instances are not missed.
+			glm::vec3 local = glm::vec3(instance.inverse * glm::vec4(center, 1.0f));
+			float scale = std::max(std::max(
+				glm::length(glm::vec3(instance.inverse[0])),
+				glm::length(glm::vec3(instance.inverse[1]))),
+				glm::length(glm::vec3(instance.inverse[2])));
+
+			hits.clear();
+			if (!models[instance.model].meshes[entry.mesh].overlap(local, radius * scale, hits))
+				continue;
+
+			for (auto& hit : hits)
+			{
+				PickResult result;
+				result.position = glm::vec3(instance.transform * glm::vec4(hit.position, 1.0f));
+				result.distance = glm::length(result.position - center);
+				if (result.distance > radius)
+					continue;
+
+				result.model = instance.model;
+				result.instance = entry.instance;
+				result.mesh = entry.mesh;
+				result.component = models[instance.model].ranges[entry.mesh].component;
+				result.triangle = hit.triangle;
+				results.push_back(result);
+			}
+		}
+	});
+
+	return results.size() > start;
+}
+
+Ray Picker::getRay(const glm::mat4& viewProjection, const glm::vec2& position, int width, int height)
+{
+	// Through the centre of the pixel, normalized device coordinates have y pointing up.
+	glm::vec2 device(
+		(position.x + 0.5f) / std::max(width, 1) * 2.0f - 1.0f,
+		1.0f - (position.y + 0.5f) / std::max(height, 1) * 2.0f);
+
+	glm::mat4 inverse = glm::inverse(viewProjection);
+	glm::vec4 start = inverse * glm::vec4(device.x, device.y, -1.0f, 1.0f);
+	glm::vec4 end = inverse * glm::vec4(device.x, device.y, 1.0f, 1.0f);
+
+	Ray ray;
+	ray.origin = glm::vec3(start) / start.w;
+	ray.direction = glm::normalize(glm::vec3(end) / end.w - ray.origin);
+	return ray;
+}
+
+const std::string& Picker::getModelName(size_t model) const
+{
+	static const std::string none;
+	return model < models.size() ? models[model].name : none;
+}
+
+const std::string& Picker::getComponentName(size_t model, uint32_t component) const
+{
+	static const std::string none;
+	if (model >= models.size() || component >= models[model].components.size())
+		return none;
+
+	return models[model].components[component];
+}
+
+const std::string& Picker::getTexture(size_t model, size_t mesh) const
+{
+	static const std::string none;
+	if (model >= models.size() || mesh >= models[model].ranges.size())
+		return none;
+
+	return models[model].ranges[mesh].texture;
+}
+
+bool Picker::getTriangle(const PickResult& result, glm::vec3 corners[3]) const
+{
+	if (result.instance >= instances.size())
+		return false;
+
+	const Instance& instance = instances[result.instance];
+	if (!models[instance.model].meshes[result.mesh].getTriangle(result.triangle, corners))
+		return false;
+
+	for (int corner = 0; corner < 3; corner++)
+	{
+		corners[corner] = glm::vec3(instance.transform * glm::vec4(corners[corner], 1.0f));
+	}
+	return true;
+}
+
+void Picker::getMeshBounds(const PickResult& result, glm::vec3& min, glm::vec3& max) const
+{
+	min = glm::vec3(0.0f);
+	max = glm::vec3(0.0f);
+	if (result.instance >= instances.size())
+		return;
+
+	const Instance& instance = instances[result.instance];
+	const TriangleBVH& mesh = models[instance.model].meshes[result.mesh];
+	transformBox(instance.transform, mesh.getMin(), mesh.getMax(), min, max);
+}
+
+size_t Picker::getModelCount() const
+{
+	return models.size();
+}
+
+size_t Picker::getInstanceCount() const
+{
+	return instances.size();
+}
+
+size_t Picker::getTriangleCount() const
+{
+	size_t triangles = 0;
+	for (auto& model : models)
+	{
+		for (auto& mesh : model.meshes)
+		{
+			triangles += mesh.getTriangleCount();
+		}
+	}
+	return triangles;
+}
+
+size_t Picker::getNodeCount() const
+{
+	size_t count = nodes.size();
+	for (auto& model : models)
+	{
+		for (auto& mesh : model.meshes)
+		{
+			count += mesh.getNodeCount();
+		}
+	}
+	return count;
+}
+
+size_t Picker::getBytes() const
+{
+	size_t bytes = sizeof(Picker) +
+		models.capacity() * sizeof(PickModel) +
+		instances.capacity() * sizeof(Instance) +
+		entries.capacity() * sizeof(Entry) +
+		nodes.capacity() * sizeof(BVHNode);
+
+	for (auto& model : models)
+	{
+		bytes += model.ranges.capacity() * sizeof(MeshRange) + model.components.capacity() * sizeof(std::string);
+		for (auto& mesh : model.meshes)
+		{
+			bytes += mesh.getBytes();
+		}
+	}
+	return bytes;
+}
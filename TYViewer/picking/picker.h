@@ -0,0 +1,115 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+#include <glm/glm.hpp>
+
+#include "loader/modeldata.h"
+
+#include "bvh.h"
+
+class Model;
+
+struct PickResult
+{
+	// Along the ray, in multiples of its direction. For overlap(), from the sphere's center.
+	float distance = FLT_MAX;
+	// Where the ray hit, or the point closest to the sphere's center, in world space.
+	glm::vec3 position = glm::vec3(0.0f);
+
+	// As returned by Picker::addModel and Picker::addInstance.
+	size_t model = 0;
+	size_t instance = 0;
+
+	// MeshRange::component of the mesh, see Picker::getComponentName.
+	uint32_t component = 0;
+	// Mesh of the model, and triangle of that mesh's index list.
+	size_t mesh = 0;
+	uint32_t triangle = 0;
+};
+
+// Finds what is under a ray in a scene of model instances. Every mesh gets a TriangleBVH,
+// shared by the instances of its model, and the meshes of every instance are put in one more
+// hierarchy over their world space boxes.
+class Picker
+{
+public:
+	Picker();
+
+	// Copies the triangles, 'data' can go once this returns. Returns the model's index.
+	size_t addModel(const ModelData& data);
+	// From the copies the meshes keep after upload.
+	size_t addModel(const std::string& name, const Model& model);
+	// A collision layer as a model of one mesh, without texture or components.
+	size_t addCollision(const std::string& name, const CollisionMesh& collision);
+
+	// Places 'model' in the scene. Returns the instance's index.
+	size_t addInstance(size_t model, const glm::mat4& transform);
+
+	void clear();
+
+	// Builds the meshes added since the last build, spread over 'threads' (0 uses every core),
+	// then the hierarchy over instances. Picking needs it after anything was added.
+	void build(unsigned int threads = 0);
+
+	// The closest hit, false if the ray hits nothing.
+	bool pick(const Ray& ray, PickResult& result) const;
+
+	// Appends a result for every triangle within 'radius' of 'center', false if there were none.
+	// Exact for instances that are only moved, rotated and uniformly scaled.
+	bool overlap(const glm::vec3& center, float radius, std::vector<PickResult>& results) const;
+
+	// Through 'position' in pixels from the top left of a 'width' x 'height' view, from the near plane on.
+	static Ray getRay(const glm::mat4& viewProjection, const glm::vec2& position, int width, int height);
+
+	const std::string& getModelName(size_t model) const;
+	// Empty where the model does not name its subobjects.
+	const std::string& getComponentName(size_t model, uint32_t component) const;
+	// Without extension, empty if the model does not name one.
+	const std::string& getTexture(size_t model, size_t mesh) const;
+
+	// Corners of the hit triangle in world space.
+	bool getTriangle(const PickResult& result, glm::vec3 corners[3]) const;
+	// Box around the hit mesh in world space.
+	void getMeshBounds(const PickResult& result, glm::vec3& min, glm::vec3& max) const;
+
+	size_t getModelCount() const;
+	size_t getInstanceCount() const;
+	// Over every model once, however often it is placed.
+	size_t getTriangleCount() const;
+	size_t getNodeCount() const;
+	size_t getBytes() const;
+
+private:
+	struct PickModel
+	{
+		std::string name;
+		std::vector<std::string> components;
+
+		// Texture and component of each mesh.
+		std::vector<MeshRange> ranges;
+		std::vector<TriangleBVH> meshes;
+	};
+
+	struct Instance
+	{
+		size_t model;
+		glm::mat4 transform;
+		glm::mat4 inverse;
+	};
+
+	// Leaf primitive of the hierarchy over instances, one mesh of one instance.
+	struct Entry
+	{
+		uint32_t instance;
+		uint32_t mesh;
+	};
+
+	std::vector<PickModel> models;
+	std::vector<Instance> instances;
+
+	std::vector<Entry> entries;
+	std::vector<BVHNode> nodes;
+};
@@ -0,0 +1,154 @@
+#include "search.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+
+#include "config.h"
+#include "debug.h"
+#include "util/timing.h"
+
+static const char* kindNames[] = { "substring", "subsequence", "similar" };
+
+bool NameSearch::isRequested(int argc, char* argv[])
+{
+	for (int i = 1; i < argc; i++)
+	{
+		if (std::string(argv[i]) == "--find")
+			return true;
+	}
+	return false;
+}
+
+bool NameSearch::parseArguments(int argc, char* argv[], SearchOptions& options)
+{
+	for (int i = 1; i < argc; i++)
+	{
+		std::string argument = argv[i];
+		bool hasValue = i + 1 < argc;
+
+		if (argument == "--find")
+		{
+			// The query is optional.
+			if (hasValue && std::string(argv[i + 1]).compare(0, 2, "--") != 0)
+				options.query = argv[++i];
+		}
+		else if (argument == "--trace" && hasValue)
+		{
+			i++;
+		}
+		else if (argument == "--archive" && hasValue)
+		{
+			options.archive = argv[++i];
+		}
+		else if (argument == "--extension" && hasValue)
+		{
+			options.extension = argv[++i];
+		}
+		else if (argument == "--limit" && hasValue)
+		{
+			int limit = std::atoi(argv[++i]);
+			if (limit <= 0)
+				return false;
+			options.limit = static_cast<size_t>(limit);
+		}
+		else if (argument == "--repeat" && hasValue)
+		{
+			options.repeat = std::atoi(argv[++i]);
+			if (options.repeat <= 0)
+				return false;
+		}
+		else if (argument == "--exact")
+		{
+			options.fuzzy = false;
+		}
+		else
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void NameSearch::printUsage()
+{
+	std::cout <<
+		"Usage: TYViewer --find [query] [options]" << std::endl <<
+		"  Without a query, queries are read from standard input one per line." << std::endl <<
+		"  --archive <path>     Archive to search (default: config.cfg)" << std::endl <<
+		"  --extension <ext>    Only entries with this extension, e.g. mdl" << std::endl <<
+		"  --limit <n>          Results to show (default: 20)" << std::endl <<
+		"  --exact              Substrings only, no fuzzy matches" << std::endl <<
+		"  --repeat <n>         Run each query n times and report its latency" << std::endl;
+}
+
+NameSearch::NameSearch(const SearchOptions& options) :
+	options(options)
+{}
+
+int NameSearch::run()
+{
+	std::string path = options.archive.empty() ? Config::archive : options.archive;
+	if (path.empty())
+	{
+		LOG_ERROR(General, "No archive specified, use --archive or config.cfg");
+		return -1;
+	}
+
+	auto start = std::chrono::high_resolution_clock::now();
+	if (!archive.load(path))
+		return -1;
+
+	const NameIndex& index = archive.getNameIndex();
+
+	char line[160];
+	snprintf(line, sizeof(line), "%zu entries, loaded and indexed in %.1f ms, index %.1f KB",
+		index.getCount(), millisecondsSince(start), index.getHeapBytes() / 1024.0);
+	std::cerr << line << std::endl;
+
+	if (!options.query.empty())
+	{
+		search(options.query);
+		return 0;
+	}
+
+	std::string query;
+	while (std::getline(std::cin, query))
+	{
+		search(query);
+	}
+	return 0;
+}
+
+void NameSearch::search(const std::string& text)
+{
+	const NameIndex& index = archive.getNameIndex();
+
+	NameQuery query;
+	query.text = text;
+	query.extension = options.extension;
+	query.limit = options.limit;
+	query.fuzzy = options.fuzzy;
+
+	std::vector<NameMatch> matches;
+
+	auto start = std::chrono::high_resolution_clock::now();
+	for (int i = 0; i < options.repeat; i++)
+	{
+		matches = index.search(query);
+	}
+	double milliseconds = millisecondsSince(start) / options.repeat;
+
+	for (auto& match : matches)
+	{
+		char line[64];
+		snprintf(line, sizeof(line), "%5d  %-12s ", match.score, kindNames[static_cast<int>(match.kind)]);
+		std::cout << line << index.getName(match.entry) << std::endl;
+	}
+
+	char line[128];
+	snprintf(line, sizeof(line), "%zu results for \"%s\" in %.3f ms", matches.size(), text.c_str(), milliseconds);
+	std::cerr << line << std::endl;
+}
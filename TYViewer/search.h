@@ -0,0 +1,44 @@
+#pragma once
+
+#include <string>
+
+#include "loader/archive.h"
+#include "loader/nameindex.h"
+
+struct SearchOptions
+{
+	// Read from standard input, one query per line, if empty.
+	std::string query;
+
+	std::string archive;
+
+	// Only entries with this extension, e.g. "mdl".
+	std::string extension;
+
+	size_t limit = 20;
+	bool fuzzy = true;
+
+	// Runs each query this many times to time it.
+	int repeat = 1;
+};
+
+// Finds archive entries by name with the archive's NameIndex, ranked best first.
+// Usage: TYViewer --find [query] [options]
+class NameSearch
+{
+public:
+	static bool isRequested(int argc, char* argv[]);
+	static bool parseArguments(int argc, char* argv[], SearchOptions& options);
+	static void printUsage();
+
+	NameSearch(const SearchOptions& options);
+
+	int run();
+
+private:
+	void search(const std::string& text);
+
+	SearchOptions options;
+
+	Archive archive;
+};
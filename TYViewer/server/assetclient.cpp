@@ -0,0 +1,233 @@
+#include "assetclient.h"
+
+#include <cstring>
+
+AssetClient::AssetClient()
+{}
+
+bool AssetClient::connect(const std::string& path)
+{
+	disconnect();
+
+	std::string socketPath = path.empty() ? AssetProtocol::getDefaultSocketPath() : path;
+	if (!socket.connect(socketPath))
+	{
+		error = "no server at " + socketPath;
+		return false;
+	}
+
+	error.clear();
+	return true;
+}
+
+void AssetClient::disconnect()
+{
+	socket.close();
+	shared.close();
+	buffer.clear();
+}
+
+bool AssetClient::isConnected() const
+{
+	return socket.isOpen();
+}
+
+bool AssetClient::list(const std::string& extension, std::vector<std::string>& names)
+{
+	const char* payload;
+	size_t size;
+	if (!request(AssetCommand::List, extension, payload, size))
+		return false;
+
+	names.clear();
+
+	const char* end = payload + size;
+	while (payload < end)
+	{
+		const char* line = static_cast<const char*>(std::memchr(payload, '\n', end - payload));
+		if (line == nullptr)
+			line = end;
+
+		names.emplace_back(payload, line);
+		payload = line + 1;
+	}
+	return true;
+}
+
+bool AssetClient::getEntry(const std::string& name, std::vector<char>& data)
+{
+	const char* payload;
+	size_t size;
+	if (!request(AssetCommand::Entry, name, payload, size))
+		return false;
+
+	data.assign(payload, payload + size);
+	return true;
+}
+
+bool AssetClient::getModel(const std::string& name, ModelData& model)
+{
+	const char* payload;
+	size_t size;
+	if (!request(AssetCommand::Model, name, payload, size))
+		return false;
+
+	if (!AssetProtocol::readModel(payload, size, model))
+	{
+		error = "malformed model data";
+		return false;
+	}
+	return true;
+}
+
+bool AssetClient::getBounds(const std::string& name, glm::vec3& corner, glm::vec3& size)
+{
+	const char* payload;
+	size_t payloadSize;
+	if (!request(AssetCommand::Bounds, name, payload, payloadSize))
+		return false;
+
+	float bounds[6];
+	if (payloadSize != sizeof(bounds))
+	{
+		error = "malformed bounds";
+		return false;
+	}
+	std::memcpy(bounds, payload, sizeof(bounds));
+
+	corner = glm::vec3(bounds[0], bounds[1], bounds[2]);
+	size = glm::vec3(bounds[3], bounds[4], bounds[5]);
+	return true;
+}
+
+bool AssetClient::getTexture(const std::string& name, int& width, int& height, std::vector<unsigned char>& pixels)
+{
+	const char* payload;
+	size_t size;
+	if (!request(AssetCommand::Texture, name, payload, size))
+		return false;
+
+	uint32_t dimensions[2];
+	if (size < sizeof(dimensions))
+	{
+		error = "malformed texture";
+		return false;
+	}
+	std::memcpy(dimensions, payload, sizeof(dimensions));
+
+	size_t bytes = static_cast<size_t>(dimensions[0]) * dimensions[1] * 4;
+	if (size - sizeof(dimensions) != bytes)
+	{
+		error = "malformed texture";
+		return false;
+	}
+
+	width = static_cast<int>(dimensions[0]);
+	height = static_cast<int>(dimensions[1]);
+	pixels.assign(payload + sizeof(dimensions), payload + size);
+	return true;
+}
+
+bool AssetClient::getStats(std::string& stats)
+{
+	const char* payload;
+	size_t size;
+	if (!request(AssetCommand::Stats, "", payload, size))
+		return false;
+
+	stats.assign(payload, size);
+	return true;
+}
+
+bool AssetClient::shutdownServer()
+{
+	const char* payload;
+	size_t size;
+	return request(AssetCommand::Shutdown, "", payload, size);
+}
+
+const std::string& AssetClient::getError() const
+{
+	return error;
+}
+
+bool AssetClient::request(AssetCommand command, const std::string& name, const char*& payload, size_t& size)
+{
+	if (!socket.isOpen())
+	{
+		error = "not connected";
+		return false;
+	}
+
+	if (name.size() > ASSET_PROTOCOL_MAX_NAME)
+	{
+		error = "name too long";
+		return false;
+	}
+
+	AssetRequestHeader header;
+	header.magic = ASSET_PROTOCOL_MAGIC;
+	header.version = ASSET_PROTOCOL_VERSION;
+	header.command = static_cast<uint32_t>(command);
+	header.nameLength = static_cast<uint32_t>(name.size());
+
+	AssetResponseHeader response;
+	if (!socket.send(&header, sizeof(header)) || !socket.send(name.data(), name.size()) ||
+		!socket.receive(&response, sizeof(response)) || response.magic != ASSET_PROTOCOL_MAGIC)
+	{
+		error = "connection lost";
+		disconnect();
+		return false;
+	}
+
+	size = static_cast<size_t>(response.size);
+
+	if (response.shared != 0)
+	{
+		if (response.sharedNameLength > ASSET_PROTOCOL_MAX_NAME)
+		{
+			error = "malformed response";
+			disconnect();
+			return false;
+		}
+
+		std::string sharedName(response.sharedNameLength, '\0');
+		if (!socket.receive(&sharedName[0], sharedName.size()))
+		{
+			error = "connection lost";
+			disconnect();
+			return false;
+		}
+
+		// The server only replaces its segment to grow it, so a mapping of the same name is big enough.
+		if (shared.getName() != sharedName || shared.getSize() < size)
+		{
+			if (!shared.open(sharedName, size))
+			{
+				error = "failed to map shared memory " + sharedName;
+				return false;
+			}
+		}
+		payload = shared.getData();
+	}
+	else
+	{
+		buffer.resize(size);
+		if (!socket.receive(buffer.data(), size))
+		{
+			error = "connection lost";
+			disconnect();
+			return false;
+		}
+		payload = buffer.data();
+	}
+
+	if (response.status != static_cast<uint32_t>(AssetStatus::Ok))
+	{
+		error.assign(payload, size);
+		return false;
+	}
+
+	error.clear();
+	return true;
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+#include "loader/modeldata.h"
+
+#include "server/protocol.h"
+#include "server/localsocket.h"
+#include "server/sharedmemory.h"
+
+// Talks to an AssetServer. Requests are answered in order, one at a time.
+class AssetClient
+{
+public:
+	AssetClient();
+
+	// Connects to the default socket if 'path' is empty.
+	bool connect(const std::string& path = "");
+	void disconnect();
+
+	bool isConnected() const;
+
+	// Entry names with 'extension', every entry if empty.
+	bool list(const std::string& extension, std::vector<std::string>& names);
+	bool getEntry(const std::string& name, std::vector<char>& data);
+	bool getModel(const std::string& name, ModelData& model);
+	bool getBounds(const std::string& name, glm::vec3& corner, glm::vec3& size);
+	// RGBA8, rows top to bottom.
+	bool getTexture(const std::string& name, int& width, int& height, std::vector<unsigned char>& pixels);
+	bool getStats(std::string& stats);
+	bool shutdownServer();
+
+	// Why the last request failed, from the server if it answered.
+	const std::string& getError() const;
+
+private:
+	// Points 'payload' at the response, valid until the next request.
+	bool request(AssetCommand command, const std::string& name, const char*& payload, size_t& size);
+
+	LocalSocket socket;
+
+	// The server's segment for this connection, remapped when it is replaced.
+	SharedMemory shared;
+	std::vector<char> buffer;
+
+	std::string error;
+};
@@ -0,0 +1,577 @@
+#include "assetserver.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+#include <iostream>
+#include <iterator>
+#include <algorithm>
+
+#include "loader/modelbuilder.h"
+
+#include "util/trace.h"
+
+#include "config.h"
+#include "debug.h"
+#include "util/timing.h"
+
+// How often the accept loop checks whether it was asked to stop.
+#define ASSET_SERVER_POLL_MILLISECONDS 250
+
+bool AssetServer::isRequested(int argc, char* argv[])
+{
+	for (int i = 1; i < argc; i++)
+	{
+		if (std::string(argv[i]) == "--serve")
+			return true;
+	}
+	return false;
+}
+
+bool AssetServer::parseArguments(int argc, char* argv[], AssetServerOptions& options)
+{
+	for (int i = 1; i < argc; i++)
+	{
+		std::string argument = argv[i];
+		bool hasValue = i + 1 < argc;
+
+		if (argument == "--serve")
+		{
+			// The mode itself, takes no value.
+		}
+		else if (argument == "--trace" && hasValue)
+		{
+			// Handled before the server starts.
+			i++;
+		}
+		else if (argument == "--archive" && hasValue)
+		{
+			options.archive = argv[++i];
+		}
+		else if (argument == "--socket" && hasValue)
+		{
+			options.socket = argv[++i];
+		}
+		else if (argument == "--model-cache" && hasValue)
+		{
+			int megabytes = std::atoi(argv[++i]);
+			if (megabytes <= 0)
+				return false;
+			options.modelCacheBytes = static_cast<size_t>(megabytes) * 1024 * 1024;
+		}
+		else if (argument == "--texture-cache" && hasValue)
+		{
+			int megabytes = std::atoi(argv[++i]);
+			if (megabytes <= 0)
+				return false;
+			options.textureCacheBytes = static_cast<size_t>(megabytes) * 1024 * 1024;
+		}
+		else
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void AssetServer::printUsage()
+{
+	std::cout <<
+		"Usage: TYViewer --serve [options]" << std::endl <<
+		"  --archive <path>         Archive to serve (default: config.cfg)" << std::endl <<
+		"  --socket <path>          Socket to listen on (default: " << AssetProtocol::getDefaultSocketPath() << ")" << std::endl <<
+		"  --model-cache <MB>       Parsed models kept in memory (default: 512)" << std::endl <<
+		"  --texture-cache <MB>     Decoded textures kept in memory (default: 256)" << std::endl <<
+		"  --trace <file>           Record a Chrome trace until the server stops" << std::endl;
+}
+
+AssetServer::AssetServer(const AssetServerOptions& options) :
+	options(options),
+	running(false),
+	modelBytes(0),
+	textureBytes(0),
+	useCounter(0),
+	requests(0),
+	hits(0),
+	misses(0)
+{
+	// Unique enough to keep two servers' shared memory apart.
+	unsigned long long ticks = static_cast<unsigned long long>(std::chrono::steady_clock::now().time_since_epoch().count());
+	instance = "tyviewer-" + std::to_string(ticks % 1000000007ull);
+}
+
+int AssetServer::run()
+{
+	if (options.archive.empty())
+		options.archive = Config::archive;
+
+	if (options.archive.empty())
+	{
+		LOG_ERROR(Server, "No archive specified, use --archive or config.cfg");
+		return -1;
+	}
+
+	if (options.socket.empty())
+		options.socket = AssetProtocol::getDefaultSocketPath();
+
+	auto start = std::chrono::high_resolution_clock::now();
+	if (!archive.load(options.archive))
+	{
+		LOG_ERROR(Server, "Failed to load archive: " + options.archive);
+		return -1;
+	}
+	double loadMilliseconds = millisecondsSince(start);
+
+	if (!listener.listen(options.socket))
+	{
+		LOG_ERROR(Server, "Failed to listen on " + options.socket + ", is another server running?");
+		return -1;
+	}
+
+	LOG_INFO(Server, "Serving " + options.archive + " (" + std::to_string(archive.getFileCount()) + " entries, indexed in " +
+		std::to_string(static_cast<int>(loadMilliseconds)) + " ms) on " + options.socket);
+
+	running = true;
+
+	unsigned int nextId = 0;
+	std::unique_ptr<Connection> pending;
+
+	while (running)
+	{
+		if (!pending)
+			pending.reset(new Connection());
+
+		if (listener.accept(pending->socket, ASSET_SERVER_POLL_MILLISECONDS))
+		{
+			Connection& connection = *pending;
+			unsigned int id = nextId++;
+
+			std::lock_guard<std::mutex> lock(connectionMutex);
+			connections.push_back(std::move(pending));
+
+			connection.thread = std::thread([this, &connection, id]()
+			{
+				Trace::setThreadName("Asset client");
+				serve(connection, id);
+				connection.finished = true;
+			});
+		}
+
+		reapConnections(false);
+	}
+
+	listener.close();
+	reapConnections(true);
+
+	LOG_INFO(Server, "Stopped after " + std::to_string(requests.load()) + " requests");
+	return 0;
+}
+
+void AssetServer::serve(Connection& connection, unsigned int id)
+{
+	LOG_DEBUG(Server, "Client " + std::to_string(id) + " connected");
+
+	while (running)
+	{
+		AssetRequestHeader header;
+		if (!connection.socket.receive(&header, sizeof(header)))
+			break;
+
+		if (header.magic != ASSET_PROTOCOL_MAGIC || header.version != ASSET_PROTOCOL_VERSION || header.nameLength > ASSET_PROTOCOL_MAX_NAME)
+		{
+			respond(connection, id, AssetStatus::BadRequest, "protocol version " + std::to_string(ASSET_PROTOCOL_VERSION) + " expected");
+			break;
+		}
+
+		std::string name(header.nameLength, '\0');
+		if (!connection.socket.receive(&name[0], name.size()))
+			break;
+
+		requests++;
+
+		AssetCommand command = static_cast<AssetCommand>(header.command);
+		TRACE_ZONE_DETAIL("AssetServer::serve", name);
+		LOG_DEBUG(Server, std::string(AssetProtocol::getCommandName(command)) + " " + name);
+
+		bool sent = false;
+		std::string error;
+
+		switch (command)
+		{
+		case AssetCommand::List:
+		{
+			std::string text;
+			for (auto& entry : archive.getFileNames(name))
+			{
+				text += entry;
+				text += '\n';
+			}
+			sent = respond(connection, id, AssetStatus::Ok, text);
+			break;
+		}
+		case AssetCommand::Entry:
+		{
+			std::vector<char> data;
+			if (!archive.getFileData(name, data))
+			{
+				sent = respond(connection, id, AssetStatus::NotFound, "no entry " + name);
+				break;
+			}
+			sent = respond(connection, id, AssetStatus::Ok, data.size(), [&](char* out)
+			{
+				std::memcpy(out, data.data(), data.size());
+			});
+			break;
+		}
+		case AssetCommand::Model:
+		case AssetCommand::Bounds:
+		{
+			std::shared_ptr<const ModelData> model = getModel(name, error);
+			if (model == nullptr)
+			{
+				sent = respond(connection, id, error.empty() ? AssetStatus::NotFound : AssetStatus::Failed, error.empty() ? "no model " + name : error);
+				break;
+			}
+
+			if (command == AssetCommand::Model)
+			{
+				sent = respond(connection, id, AssetStatus::Ok, AssetProtocol::getModelSize(*model), [&](char* out)
+				{
+					AssetProtocol::writeModel(*model, out);
+				});
+			}
+			else
+			{
+				float bounds[6] = { model->boundsCorner.x, model->boundsCorner.y, model->boundsCorner.z, model->boundsSize.x, model->boundsSize.y, model->boundsSize.z };
+				sent = respond(connection, id, AssetStatus::Ok, sizeof(bounds), [&](char* out)
+				{
+					std::memcpy(out, bounds, sizeof(bounds));
+				});
+			}
+			break;
+		}
+		case AssetCommand::Texture:
+		{
+			std::shared_ptr<const SoftwareTexture> texture = getTexture(name);
+			if (texture == nullptr)
+			{
+				sent = respond(connection, id, AssetStatus::NotFound, "no texture " + name);
+				break;
+			}
+
+			const SoftwareTexture::Level& image = texture->getLevel(0);
+			uint32_t size[2] = { static_cast<uint32_t>(image.width), static_cast<uint32_t>(image.height) };
+			size_t bytes = image.texels.size() * sizeof(uint32_t);
+
+			// Texels are packed R in the lowest byte, in memory that is RGBA on little endian machines.
+			sent = respond(connection, id, AssetStatus::Ok, sizeof(size) + bytes, [&](char* out)
+			{
+				std::memcpy(out, size, sizeof(size));
+				std::memcpy(out + sizeof(size), image.texels.data(), bytes);
+			});
+			break;
+		}
+		case AssetCommand::Stats:
+			sent = respond(connection, id, AssetStatus::Ok, getStats());
+			break;
+		case AssetCommand::Shutdown:
+			sent = respond(connection, id, AssetStatus::Ok, std::string());
+			running = false;
+			LOG_INFO(Server, "Shutdown requested by client " + std::to_string(id));
+			break;
+		default:
+			sent = respond(connection, id, AssetStatus::BadRequest, "unknown command " + std::to_string(header.command));
+			break;
+		}
+
+		if (!sent)
+			break;
+	}
+
+	LOG_DEBUG(Server, "Client " + std::to_string(id) + " disconnected");
+}
+
+bool AssetServer::respond(Connection& connection, unsigned int id, AssetStatus status, size_t size, const std::function<void(char*)>& write)
+{
+	AssetResponseHeader header;
+	header.magic = ASSET_PROTOCOL_MAGIC;
+	header.status = static_cast<uint32_t>(status);
+	header.size = size;
+	header.shared = 0;
+	header.sharedNameLength = 0;
+
+	if (size >= ASSET_PROTOCOL_SHARED_THRESHOLD)
+	{
+		// Doubled when it grows, a client mostly asking for similar sizes stops causing new segments.
+		if (connection.shared.getSize() < size)
+		{
+			size_t capacity = std::max(size, connection.shared.getSize() * 2);
+			std::string name = instance + "-" + std::to_string(id) + "-" + std::to_string(connection.generation++);
+
+			if (!connection.shared.create(name, capacity))
+				LOG_WARNING(Server, "Failed to create shared memory " + name + ", sending through the socket");
+		}
+
+		if (connection.shared.getSize() >= size)
+		{
+			write(connection.shared.getData());
+
+			const std::string& name = connection.shared.getName();
+			header.shared = 1;
+			header.sharedNameLength = static_cast<uint32_t>(name.size());
+
+			return connection.socket.send(&header, sizeof(header)) && connection.socket.send(name.data(), name.size());
+		}
+	}
+
+	connection.buffer.resize(size);
+	if (size > 0)
+		write(connection.buffer.data());
+
+	return connection.socket.send(&header, sizeof(header)) && connection.socket.send(connection.buffer.data(), size);
+}
+
+bool AssetServer::respond(Connection& connection, unsigned int id, AssetStatus status, const std::string& text)
+{
+	return respond(connection, id, status, text.size(), [&](char* out)
+	{
+		std::memcpy(out, text.data(), text.size());
+	});
+}
+
+std::shared_ptr<const ModelData> AssetServer::getModel(const std::string& name, std::string& error)
+{
+	std::promise<std::shared_ptr<const ModelData>> promise;
+	std::shared_future<std::shared_ptr<const ModelData>> future;
+	bool load = false;
+
+	// A model asked for by several clients at once is only parsed by the first.
+	{
+		std::lock_guard<std::mutex> lock(cacheMutex);
+
+		auto it = models.find(name);
+		if (it != models.end())
+		{
+			it->second.lastUsed = ++useCounter;
+			future = it->second.value;
+			hits++;
+		}
+		else
+		{
+			future = promise.get_future().share();
+
+			CacheEntry<ModelData>& entry = models[name];
+			entry.value = future;
+			entry.lastUsed = ++useCounter;
+
+			load = true;
+			misses++;
+		}
+	}
+
+	if (!load)
+	{
+		std::shared_ptr<const ModelData> model = future.get();
+		if (model == nullptr)
+			error = "failed to load " + name;
+		return model;
+	}
+
+	TRACE_ZONE_DETAIL("AssetServer::getModel", name);
+
+	std::shared_ptr<ModelData> model;
+	try
+	{
+		model = std::make_shared<ModelData>();
+		if (!ModelBuilder::build(archive, name, *model))
+		{
+			error = model->error.empty() ? "failed to build " + name : model->error;
+			model.reset();
+		}
+	}
+	catch (const std::exception& e)
+	{
+		error = std::string("exception: ") + e.what();
+		model.reset();
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(cacheMutex);
+
+		// Failures aren't kept, the next request tries again.
+		if (model == nullptr)
+		{
+			models.erase(name);
+		}
+		else
+		{
+			models[name].bytes = model->getHeapBytes();
+			modelBytes += models[name].bytes;
+		}
+	}
+
+	promise.set_value(model);
+
+	{
+		std::lock_guard<std::mutex> lock(cacheMutex);
+		trim(models, modelBytes, options.modelCacheBytes);
+	}
+
+	return model;
+}
+
+std::shared_ptr<const SoftwareTexture> AssetServer::getTexture(const std::string& name)
+{
+	std::promise<std::shared_ptr<const SoftwareTexture>> promise;
+	std::shared_future<std::shared_ptr<const SoftwareTexture>> future;
+	bool load = false;
+
+	{
+		std::lock_guard<std::mutex> lock(cacheMutex);
+
+		auto it = textures.find(name);
+		if (it != textures.end())
+		{
+			it->second.lastUsed = ++useCounter;
+			future = it->second.value;
+			hits++;
+		}
+		else
+		{
+			future = promise.get_future().share();
+
+			CacheEntry<SoftwareTexture>& entry = textures[name];
+			entry.value = future;
+			entry.lastUsed = ++useCounter;
+
+			load = true;
+			misses++;
+		}
+	}
+
+	if (!load)
+		return future.get();
+
+	TRACE_ZONE_DETAIL("AssetServer::getTexture", name);
+
+	std::shared_ptr<SoftwareTexture> texture;
+
+	try
+	{
+		std::vector<char> data;
+		if (archive.getFileData(name, data))
+		{
+			texture = std::make_shared<SoftwareTexture>();
+			if (!texture->load(data))
+				texture.reset();
+		}
+	}
+	catch (const std::exception& e)
+	{
+		LOG_WARNING(Server, "Failed to load texture " + name + ": " + e.what());
+		texture.reset();
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(cacheMutex);
+
+		if (texture == nullptr)
+		{
+			textures.erase(name);
+		}
+		else
+		{
+			textures[name].bytes = texture->getBytes();
+			textureBytes += textures[name].bytes;
+		}
+	}
+
+	promise.set_value(texture);
+
+	{
+		std::lock_guard<std::mutex> lock(cacheMutex);
+		trim(textures, textureBytes, options.textureCacheBytes);
+	}
+
+	return texture;
+}
+
+template<typename T>
+void AssetServer::trim(std::unordered_map<std::string, CacheEntry<T>>& cache, size_t& bytes, size_t budget)
+{
+	while (bytes > budget)
+	{
+		auto oldest = cache.end();
+		for (auto it = cache.begin(); it != cache.end(); ++it)
+		{
+			// Still loading, its size isn't counted yet.
+			if (it->second.value.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+				continue;
+
+			if (oldest == cache.end() || it->second.lastUsed < oldest->second.lastUsed)
+				oldest = it;
+		}
+
+		if (oldest == cache.end())
+			return;
+
+		// Clients being served keep their shared_ptr, only the cache lets go.
+		bytes -= oldest->second.bytes;
+		cache.erase(oldest);
+	}
+}
+
+std::string AssetServer::getStats()
+{
+	std::ostringstream stream;
+	stream << "archive=" << options.archive << "\n";
+	stream << "entries=" << archive.getFileCount() << "\n";
+	stream << "requests=" << requests.load() << "\n";
+	stream << "hits=" << hits.load() << "\n";
+	stream << "misses=" << misses.load() << "\n";
+
+	{
+		std::lock_guard<std::mutex> lock(cacheMutex);
+		stream << "models=" << models.size() << "\n";
+		stream << "modelBytes=" << modelBytes << "\n";
+		stream << "textures=" << textures.size() << "\n";
+		stream << "textureBytes=" << textureBytes << "\n";
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(connectionMutex);
+		stream << "connections=" << connections.size() << "\n";
+	}
+
+	return stream.str();
+}
+
+void AssetServer::reapConnections(bool all)
+{
+	// Taken out under the lock and joined without it, a client thread may be waiting for it in getStats().
+	std::list<std::unique_ptr<Connection>> reaped;
+	{
+		std::lock_guard<std::mutex> lock(connectionMutex);
+
+		for (auto it = connections.begin(); it != connections.end();)
+		{
+			auto next = std::next(it);
+			if (all || (*it)->finished)
+			{
+				reaped.splice(reaped.end(), connections, it);
+			}
+			it = next;
+		}
+	}
+
+	for (auto& connection : reaped)
+	{
+		// Wakes the client's thread from its receive.
+		if (all)
+			connection->socket.shutdown();
+
+		connection->thread.join();
+	}
+}
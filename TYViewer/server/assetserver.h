@@ -0,0 +1,109 @@
+#pragma once
+
+#include <list>
+#include <mutex>
+#include <atomic>
+#include <future>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include <functional>
+#include <unordered_map>
+
+#include "loader/archive.h"
+#include "loader/modeldata.h"
+
+#include "graphics/rasterizer.h"
+
+#include "server/protocol.h"
+#include "server/localsocket.h"
+#include "server/sharedmemory.h"
+
+struct AssetServerOptions
+{
+	std::string archive;
+	std::string socket;
+
+	// Least recently used entries are dropped past these.
+	size_t modelCacheBytes = 512 * 1024 * 1024;
+	size_t textureCacheBytes = 256 * 1024 * 1024;
+};
+
+// Keeps an archive open with its parsed models and decoded textures cached, and serves them
+// to other tools over a local socket, see server/protocol.h. One thread per connected client.
+// Usage: TYViewer --serve [options]
+class AssetServer
+{
+public:
+	static bool isRequested(int argc, char* argv[]);
+	static bool parseArguments(int argc, char* argv[], AssetServerOptions& options);
+	static void printUsage();
+
+	AssetServer(const AssetServerOptions& options);
+
+	int run();
+
+private:
+	struct Connection
+	{
+		LocalSocket socket;
+
+		// Grown as needed, replaced under a new name so clients notice.
+		SharedMemory shared;
+		unsigned int generation = 0;
+
+		std::vector<char> buffer;
+
+		std::thread thread;
+		std::atomic<bool> finished{ false };
+	};
+
+	template<typename T>
+	struct CacheEntry
+	{
+		std::shared_future<std::shared_ptr<const T>> value;
+		size_t bytes = 0;
+		uint64_t lastUsed = 0;
+	};
+
+	void serve(Connection& connection, unsigned int id);
+
+	// 'write' fills 'size' bytes of payload wherever they are sent from.
+	bool respond(Connection& connection, unsigned int id, AssetStatus status, size_t size, const std::function<void(char*)>& write);
+	bool respond(Connection& connection, unsigned int id, AssetStatus status, const std::string& text);
+
+	std::shared_ptr<const ModelData> getModel(const std::string& name, std::string& error);
+	std::shared_ptr<const SoftwareTexture> getTexture(const std::string& name);
+
+	// Drops least recently used entries that are no longer loading until 'cache' fits in 'budget'.
+	template<typename T>
+	void trim(std::unordered_map<std::string, CacheEntry<T>>& cache, size_t& bytes, size_t budget);
+
+	std::string getStats();
+
+	void reapConnections(bool all);
+
+	AssetServerOptions options;
+
+	Archive archive;
+	LocalSocket listener;
+	std::atomic<bool> running;
+
+	// Prefix of this server's shared memory names.
+	std::string instance;
+
+	std::mutex cacheMutex;
+	std::unordered_map<std::string, CacheEntry<ModelData>> models;
+	std::unordered_map<std::string, CacheEntry<SoftwareTexture>> textures;
+	size_t modelBytes;
+	size_t textureBytes;
+	uint64_t useCounter;
+
+	std::atomic<uint64_t> requests;
+	std::atomic<uint64_t> hits;
+	std::atomic<uint64_t> misses;
+
+	std::mutex connectionMutex;
+	std::list<std::unique_ptr<Connection>> connections;
+};
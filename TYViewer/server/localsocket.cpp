@@ -0,0 +1,217 @@
+#include "localsocket.h"
+
+#include <cstring>
+#include <filesystem>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <afunix.h>
+#pragma comment(lib, "Ws2_32.lib")
+
+typedef int socklen_t;
+#define closeSocket closesocket
+#define SHUTDOWN_BOTH SD_BOTH
+#define SEND_FLAGS 0
+#else
+#include <unistd.h>
+#include <sys/un.h>
+#include <sys/stat.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+
+#define INVALID_SOCKET -1
+#define closeSocket ::close
+#define SHUTDOWN_BOTH SHUT_RDWR
+// A peer that went away must not raise SIGPIPE and kill the server.
+#define SEND_FLAGS MSG_NOSIGNAL
+#endif
+
+#define LOCAL_SOCKET_BACKLOG 16
+
+static bool makeAddress(const std::string& path, sockaddr_un& address)
+{
+	std::memset(&address, 0, sizeof(address));
+	address.sun_family = AF_UNIX;
+
+	if (path.empty() || path.size() >= sizeof(address.sun_path))
+		return false;
+
+	std::memcpy(address.sun_path, path.c_str(), path.size());
+	return true;
+}
+
+LocalSocket::LocalSocket() :
+	handle(static_cast<intptr_t>(INVALID_SOCKET))
+{}
+
+LocalSocket::~LocalSocket()
+{
+	close();
+}
+
+bool LocalSocket::initialize()
+{
+#ifdef _WIN32
+	static bool initialized = []()
+	{
+		WSADATA data;
+		return WSAStartup(MAKEWORD(2, 2), &data) == 0;
+	}();
+	return initialized;
+#else
+	return true;
+#endif
+}
+
+bool LocalSocket::listen(const std::string& path)
+{
+	close();
+
+	sockaddr_un address;
+	if (!initialize() || !makeAddress(path, address))
+		return false;
+
+	// Another server still owns the path if it answers, otherwise the file is left over.
+	{
+		LocalSocket probe;
+		if (probe.connect(path))
+			return false;
+	}
+	std::error_code error;
+	std::filesystem::remove(path, error);
+
+	handle = static_cast<intptr_t>(::socket(AF_UNIX, SOCK_STREAM, 0));
+	if (handle == static_cast<intptr_t>(INVALID_SOCKET))
+		return false;
+
+	if (::bind(handle, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0)
+	{
+		close();
+		return false;
+	}
+
+	// Owned by path from here, so close() removes the file on failure.
+	this->path = path;
+
+#ifndef _WIN32
+	// The socket lives in the shared temp directory, keep other users off it before listening.
+	if (::chmod(path.c_str(), S_IRUSR | S_IWUSR) != 0)
+	{
+		close();
+		return false;
+	}
+#endif
+
+	if (::listen(handle, LOCAL_SOCKET_BACKLOG) != 0)
+	{
+		close();
+		return false;
+	}
+
+	return true;
+}
+
+bool LocalSocket::accept(LocalSocket& client, int timeoutMilliseconds)
+{
+	if (!isOpen())
+		return false;
+
+	fd_set set;
+	FD_ZERO(&set);
+	FD_SET(handle, &set);
+
+	timeval timeout;
+	timeout.tv_sec = timeoutMilliseconds / 1000;
+	timeout.tv_usec = (timeoutMilliseconds % 1000) * 1000;
+
+	if (::select(static_cast<int>(handle) + 1, &set, nullptr, nullptr, &timeout) <= 0)
+		return false;
+
+	intptr_t accepted = static_cast<intptr_t>(::accept(handle, nullptr, nullptr));
+	if (accepted == static_cast<intptr_t>(INVALID_SOCKET))
+		return false;
+
+	client.close();
+	client.handle = accepted;
+	return true;
+}
+
+bool LocalSocket::connect(const std::string& path)
+{
+	close();
+
+	sockaddr_un address;
+	if (!initialize() || !makeAddress(path, address))
+		return false;
+
+	handle = static_cast<intptr_t>(::socket(AF_UNIX, SOCK_STREAM, 0));
+	if (handle == static_cast<intptr_t>(INVALID_SOCKET))
+		return false;
+
+	if (::connect(handle, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0)
+	{
+		close();
+		return false;
+	}
+
+	return true;
+}
+
+bool LocalSocket::send(const void* data, size_t size)
+{
+	const char* bytes = static_cast<const char*>(data);
+	while (size > 0)
+	{
+		int chunk = static_cast<int>(size < 0x40000000 ? size : 0x40000000);
+		int sent = static_cast<int>(::send(handle, bytes, chunk, SEND_FLAGS));
+		if (sent <= 0)
+			return false;
+
+		bytes += sent;
+		size -= sent;
+	}
+	return true;
+}
+
+bool LocalSocket::receive(void* data, size_t size)
+{
+	char* bytes = static_cast<char*>(data);
+	while (size > 0)
+	{
+		int chunk = static_cast<int>(size < 0x40000000 ? size : 0x40000000);
+		int received = static_cast<int>(::recv(handle, bytes, chunk, 0));
+		if (received <= 0)
+			return false;
+
+		bytes += received;
+		size -= received;
+	}
+	return true;
+}
+
+void LocalSocket::shutdown()
+{
+	if (isOpen())
+		::shutdown(handle, SHUTDOWN_BOTH);
+}
+
+void LocalSocket::close()
+{
+	if (!isOpen())
+		return;
+
+	closeSocket(handle);
+	handle = static_cast<intptr_t>(INVALID_SOCKET);
+
+	if (!path.empty())
+	{
+		std::error_code error;
+		std::filesystem::remove(path, error);
+		path.clear();
+	}
+}
+
+bool LocalSocket::isOpen() const
+{
+	return handle != static_cast<intptr_t>(INVALID_SOCKET);
+}
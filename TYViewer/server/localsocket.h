@@ -0,0 +1,41 @@
+#pragma once
+
+#include <string>
+#include <cstdint>
+
+// Stream socket in the AF_UNIX family, on Windows 10 and later too.
+// All calls block, send and receive transfer the whole buffer or fail.
+class LocalSocket
+{
+public:
+	LocalSocket();
+	~LocalSocket();
+
+	LocalSocket(const LocalSocket&) = delete;
+	LocalSocket& operator=(const LocalSocket&) = delete;
+
+	// Binds and listens at 'path'. A socket file left behind by a server that is gone is replaced,
+	// fails if a server is still answering there.
+	bool listen(const std::string& path);
+	// Waits up to 'timeoutMilliseconds', false on timeout or error.
+	bool accept(LocalSocket& client, int timeoutMilliseconds);
+
+	bool connect(const std::string& path);
+
+	bool send(const void* data, size_t size);
+	bool receive(void* data, size_t size);
+
+	// Makes a send or receive blocked on another thread return, the socket stays open.
+	void shutdown();
+	void close();
+
+	bool isOpen() const;
+
+private:
+	static bool initialize();
+
+	intptr_t handle;
+
+	// Removed again on close() by the socket that listened.
+	std::string path;
+};
@@ -0,0 +1,247 @@
+#include "protocol.h"
+
+#include <cstring>
+#include <filesystem>
+
+#define ASSET_PROTOCOL_SOCKET_NAME "tyviewer-assets.sock"
+
+static const char* commandNames[] = { "list", "entry", "model", "bounds", "texture", "stats", "shutdown" };
+
+struct ModelHeader
+{
+	uint32_t isTY2;
+	uint32_t meshCount;
+
+	uint64_t vertexCount;
+	uint64_t indexCount;
+	uint64_t colliderCount;
+	uint64_t boundsCount;
+	uint64_t boneCount;
+	uint64_t collisionVertexCount;
+	uint64_t collisionIndexCount;
+
+	float boundsCorner[3];
+	float boundsSize[3];
+
+	uint32_t nameLength;
+	uint32_t componentCount;
+};
+
+struct MeshHeader
+{
+	uint64_t vertexOffset;
+	uint64_t vertexCount;
+	uint64_t indexOffset;
+	uint64_t indexCount;
+
+	uint32_t component;
+	uint32_t textureLength;
+};
+
+static void put(char*& out, const void* data, size_t size)
+{
+	if (size > 0)
+		std::memcpy(out, data, size);
+	out += size;
+}
+
+static bool take(const char*& data, const char* end, void* out, size_t size)
+{
+	if (static_cast<size_t>(end - data) < size)
+		return false;
+
+	if (size > 0)
+		std::memcpy(out, data, size);
+	data += size;
+	return true;
+}
+
+// Reads 'count' elements into 'items', refusing counts the remaining data can't hold.
+// 'fill' is only there for types without a default constructor, it is overwritten.
+template<typename T>
+static bool takeArray(const char*& data, const char* end, std::vector<T>& items, uint64_t count, const T& fill = T())
+{
+	if (count > static_cast<uint64_t>(end - data) / sizeof(T))
+		return false;
+
+	items.assign(static_cast<size_t>(count), fill);
+	return take(data, end, items.data(), items.size() * sizeof(T));
+}
+
+const char* AssetProtocol::getCommandName(AssetCommand command)
+{
+	if (command >= AssetCommand::Count)
+		return "unknown";
+	return commandNames[static_cast<int>(command)];
+}
+
+std::string AssetProtocol::getDefaultSocketPath()
+{
+	std::error_code error;
+	std::filesystem::path directory = std::filesystem::temp_directory_path(error);
+	if (error)
+		return ASSET_PROTOCOL_SOCKET_NAME;
+
+	return (directory / ASSET_PROTOCOL_SOCKET_NAME).string();
+}
+
+size_t AssetProtocol::getModelSize(const ModelData& model)
+{
+	size_t size = sizeof(ModelHeader) + model.name.size();
+	size += model.vertices.size() * sizeof(Vertex);
+	size += model.indices.size() * sizeof(unsigned int);
+	for (auto& mesh : model.meshes)
+	{
+		size += sizeof(MeshHeader) + mesh.texture.size();
+	}
+	for (auto& component : model.components)
+	{
+		size += sizeof(uint32_t) + component.size();
+	}
+	size += model.colliders.size() * sizeof(Collider);
+	size += model.bounds.size() * sizeof(Bounds);
+	size += model.bones.size() * sizeof(Bone);
+	size += model.collision.positions.size() * sizeof(glm::vec3);
+	size += model.collision.indices.size() * sizeof(unsigned int);
+	return size;
+}
+
+void AssetProtocol::writeModel(const ModelData& model, char* out)
+{
+	ModelHeader header;
+	header.isTY2 = model.isTY2 ? 1 : 0;
+	header.meshCount = static_cast<uint32_t>(model.meshes.size());
+	header.vertexCount = model.vertices.size();
+	header.indexCount = model.indices.size();
+	header.colliderCount = model.colliders.size();
+	header.boundsCount = model.bounds.size();
+	header.boneCount = model.bones.size();
+	header.collisionVertexCount = model.collision.positions.size();
+	header.collisionIndexCount = model.collision.indices.size();
+	for (int axis = 0; axis < 3; axis++)
+	{
+		header.boundsCorner[axis] = model.boundsCorner[axis];
+		header.boundsSize[axis] = model.boundsSize[axis];
+	}
+	header.nameLength = static_cast<uint32_t>(model.name.size());
+	header.componentCount = static_cast<uint32_t>(model.components.size());
+
+	put(out, &header, sizeof(header));
+	put(out, model.name.data(), model.name.size());
+	put(out, model.vertices.data(), model.vertices.size() * sizeof(Vertex));
+	put(out, model.indices.data(), model.indices.size() * sizeof(unsigned int));
+
+	for (auto& mesh : model.meshes)
+	{
+		MeshHeader meshHeader;
+		meshHeader.vertexOffset = mesh.vertexOffset;
+		meshHeader.vertexCount = mesh.vertexCount;
+		meshHeader.indexOffset = mesh.indexOffset;
+		meshHeader.indexCount = mesh.indexCount;
+		meshHeader.component = mesh.component;
+		meshHeader.textureLength = static_cast<uint32_t>(mesh.texture.size());
+
+		put(out, &meshHeader, sizeof(meshHeader));
+		put(out, mesh.texture.data(), mesh.texture.size());
+	}
+
+	// Length prefixed, the names MeshHeader::component refers to.
+	for (auto& component : model.components)
+	{
+		uint32_t length = static_cast<uint32_t>(component.size());
+		put(out, &length, sizeof(length));
+		put(out, component.data(), component.size());
+	}
+
+	put(out, model.colliders.data(), model.colliders.size() * sizeof(Collider));
+	put(out, model.bounds.data(), model.bounds.size() * sizeof(Bounds));
+	put(out, model.bones.data(), model.bones.size() * sizeof(Bone));
+	put(out, model.collision.positions.data(), model.collision.positions.size() * sizeof(glm::vec3));
+	put(out, model.collision.indices.data(), model.collision.indices.size() * sizeof(unsigned int));
+}
+
+bool AssetProtocol::readModel(const char* data, size_t size, ModelData& model)
+{
+	const char* end = data + size;
+
+	ModelHeader header;
+	if (!take(data, end, &header, sizeof(header)) || header.nameLength > static_cast<size_t>(end - data))
+		return false;
+
+	model = ModelData();
+	model.name.assign(data, header.nameLength);
+	data += header.nameLength;
+
+	model.isTY2 = header.isTY2 != 0;
+	for (int axis = 0; axis < 3; axis++)
+	{
+		model.boundsCorner[axis] = header.boundsCorner[axis];
+		model.boundsSize[axis] = header.boundsSize[axis];
+	}
+
+	if (!takeArray(data, end, model.vertices, header.vertexCount, Vertex(glm::vec4(0.0f))) ||
+		!takeArray(data, end, model.indices, header.indexCount))
+		return false;
+
+	// Every mesh has a header, counts the remaining bytes can't hold are refused before allocating.
+	if (header.meshCount > static_cast<size_t>(end - data) / sizeof(MeshHeader))
+		return false;
+
+	model.meshes.resize(header.meshCount);
+	for (auto& mesh : model.meshes)
+	{
+		MeshHeader meshHeader;
+		if (!take(data, end, &meshHeader, sizeof(meshHeader)) || meshHeader.textureLength > static_cast<size_t>(end - data))
+			return false;
+
+		// Ranges are drawn from straight away, they must lie inside the buffers.
+		if (meshHeader.vertexOffset > header.vertexCount || meshHeader.vertexCount > header.vertexCount - meshHeader.vertexOffset ||
+			meshHeader.indexOffset > header.indexCount || meshHeader.indexCount > header.indexCount - meshHeader.indexOffset)
+			return false;
+
+		mesh.vertexOffset = static_cast<size_t>(meshHeader.vertexOffset);
+		mesh.vertexCount = static_cast<size_t>(meshHeader.vertexCount);
+		mesh.indexOffset = static_cast<size_t>(meshHeader.indexOffset);
+		mesh.indexCount = static_cast<size_t>(meshHeader.indexCount);
+		mesh.component = meshHeader.component;
+		mesh.texture.assign(data, meshHeader.textureLength);
+		data += meshHeader.textureLength;
+
+		// Indices are relative to the mesh's own vertices.
+		for (size_t i = mesh.indexOffset; i < mesh.indexOffset + mesh.indexCount; i++)
+		{
+			if (model.indices[i] >= mesh.vertexCount)
+				return false;
+		}
+	}
+
+	if (header.componentCount > static_cast<size_t>(end - data) / sizeof(uint32_t))
+		return false;
+
+	model.components.resize(header.componentCount);
+	for (auto& component : model.components)
+	{
+		uint32_t length;
+		if (!take(data, end, &length, sizeof(length)) || length > static_cast<size_t>(end - data))
+			return false;
+
+		component.assign(data, length);
+		data += length;
+	}
+
+	if (!takeArray(data, end, model.colliders, header.colliderCount) ||
+		!takeArray(data, end, model.bounds, header.boundsCount) ||
+		!takeArray(data, end, model.bones, header.boneCount) ||
+		!takeArray(data, end, model.collision.positions, header.collisionVertexCount, glm::vec3(0.0f)) ||
+		!takeArray(data, end, model.collision.indices, header.collisionIndexCount) ||
+		data != end)
+		return false;
+
+	// Like the meshes, the collision layer is drawn from straight away.
+	for (auto index : model.collision.indices)
+	{
+		if (index >= model.collision.positions.size())
+			return false;
+	}
+	return true;
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+#include "loader/modeldata.h"
+
+#define ASSET_PROTOCOL_MAGIC 0x53415954
+// Bumped whenever a message or ModelData/Vertex changes layout, both sides must be the same build.
+#define ASSET_PROTOCOL_VERSION 3
+
+// Payloads of at least this many bytes are passed through shared memory instead of the socket.
+#define ASSET_PROTOCOL_SHARED_THRESHOLD (64 * 1024)
+
+#define ASSET_PROTOCOL_MAX_NAME 1024
+
+enum class AssetCommand : uint32_t
+{
+	// Entry names with the extension given as name, every entry if empty. Newline separated.
+	List,
+	// Raw bytes of an archive entry.
+	Entry,
+	// Decoded ModelData, see AssetProtocol::writeModel.
+	Model,
+	// Corner and size of a model, 6 floats.
+	Bounds,
+	// Width, height and RGBA8 pixels (rows top to bottom) of a decoded texture.
+	Texture,
+	// Cache statistics as "key=value" lines.
+	Stats,
+	Shutdown,
+
+	Count
+};
+
+enum class AssetStatus : uint32_t
+{
+	Ok,
+	NotFound,
+	Failed,
+	BadRequest
+};
+
+// Followed by 'nameLength' bytes of name.
+struct AssetRequestHeader
+{
+	uint32_t magic;
+	uint32_t version;
+	uint32_t command;
+	uint32_t nameLength;
+};
+
+// Followed by 'size' bytes of payload, or by 'sharedNameLength' bytes naming the shared memory
+// holding it. A shared payload stays valid until the connection's next request.
+struct AssetResponseHeader
+{
+	uint32_t magic;
+	uint32_t status;
+	uint64_t size;
+	uint32_t shared;
+	uint32_t sharedNameLength;
+};
+
+// Encodes payloads. Plain memory copies of the structures, only valid between identical builds.
+class AssetProtocol
+{
+public:
+	static const char* getCommandName(AssetCommand command);
+
+	// Socket used when none is given, in the temporary directory.
+	static std::string getDefaultSocketPath();
+
+	static size_t getModelSize(const ModelData& model);
+	// 'out' must hold getModelSize() bytes.
+	static void writeModel(const ModelData& model, char* out);
+	static bool readModel(const char* data, size_t size, ModelData& model);
+};
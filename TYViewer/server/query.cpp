@@ -0,0 +1,222 @@
+#include "query.h"
+#include "util/timing.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <algorithm>
+
+#include <SOIL2/SOIL2.h>
+
+bool AssetQuery::isRequested(int argc, char* argv[])
+{
+	for (int i = 1; i < argc; i++)
+	{
+		if (std::string(argv[i]) == "--query")
+			return true;
+	}
+	return false;
+}
+
+bool AssetQuery::parseArguments(int argc, char* argv[], QueryOptions& options)
+{
+	bool hasName = false;
+
+	for (int i = 1; i < argc; i++)
+	{
+		std::string argument = argv[i];
+		bool hasValue = i + 1 < argc;
+
+		if (argument == "--query" && hasValue)
+		{
+			std::string command = argv[++i];
+			for (int c = 0; c < static_cast<int>(AssetCommand::Count); c++)
+			{
+				if (command == AssetProtocol::getCommandName(static_cast<AssetCommand>(c)))
+					options.command = static_cast<AssetCommand>(c);
+			}
+
+			if (options.command == AssetCommand::Count)
+				return false;
+		}
+		else if (argument == "--trace" && hasValue)
+		{
+			i++;
+		}
+		else if (argument == "--socket" && hasValue)
+		{
+			options.socket = argv[++i];
+		}
+		else if (argument == "--output" && hasValue)
+		{
+			options.output = argv[++i];
+		}
+		else if (argument == "--repeat" && hasValue)
+		{
+			options.repeat = std::atoi(argv[++i]);
+			if (options.repeat <= 0)
+				return false;
+		}
+		else if (argument.compare(0, 2, "--") != 0 && !hasName)
+		{
+			options.name = argument;
+			hasName = true;
+		}
+		else
+		{
+			return false;
+		}
+	}
+
+	if (options.command == AssetCommand::Count)
+		return false;
+
+	// Everything but these names something.
+	bool needsName = options.command != AssetCommand::List && options.command != AssetCommand::Stats && options.command != AssetCommand::Shutdown;
+	return !needsName || hasName;
+}
+
+void AssetQuery::printUsage()
+{
+	std::cout <<
+		"Usage: TYViewer --query <command> [name] [options]" << std::endl <<
+		"  list [extension]         Entry names, all of them without an extension" << std::endl <<
+		"  entry <name>             Raw bytes of an archive entry" << std::endl <<
+		"  model <name.mdl>         Decoded model summary" << std::endl <<
+		"  bounds <name.mdl>        Model bounding box" << std::endl <<
+		"  texture <name.dds>       Decoded texture, saved as PNG with --output" << std::endl <<
+		"  stats                    Server cache statistics" << std::endl <<
+		"  shutdown                 Stops the server" << std::endl <<
+		"  --socket <path>          Server socket (default: " << AssetProtocol::getDefaultSocketPath() << ")" << std::endl <<
+		"  --output <file>          Write entry bytes or the texture image to a file" << std::endl <<
+		"  --repeat <n>             Send the request n times and report latency" << std::endl;
+}
+
+AssetQuery::AssetQuery(const QueryOptions& options) :
+	options(options),
+	corner(0.0f),
+	size(0.0f),
+	width(0),
+	height(0)
+{}
+
+int AssetQuery::run()
+{
+	if (!client.connect(options.socket))
+	{
+		std::cerr << client.getError() << std::endl;
+		return -1;
+	}
+
+	std::vector<double> latencies;
+	latencies.reserve(options.repeat);
+
+	for (int i = 0; i < options.repeat; i++)
+	{
+		auto start = std::chrono::high_resolution_clock::now();
+		if (!send())
+		{
+			std::cerr << AssetProtocol::getCommandName(options.command) << " " << options.name << ": " << client.getError() << std::endl;
+			return 1;
+		}
+		latencies.push_back(millisecondsSince(start));
+
+		// Nothing is left to ask after the first.
+		if (options.command == AssetCommand::Shutdown)
+			break;
+	}
+
+	print();
+
+	if (options.repeat > 1)
+	{
+		// The first is the one that misses the server's caches.
+		double first = latencies.front();
+		std::sort(latencies.begin(), latencies.end());
+
+		double total = 0.0;
+		for (double latency : latencies)
+			total += latency;
+
+		char line[160];
+		snprintf(line, sizeof(line), "%zu requests: first %.3f ms, min %.3f ms, median %.3f ms, mean %.3f ms",
+			latencies.size(), first, latencies.front(), latencies[latencies.size() / 2], total / latencies.size());
+		std::cout << line << std::endl;
+	}
+	else
+	{
+		char line[64];
+		snprintf(line, sizeof(line), "%.3f ms", latencies.front());
+		std::cout << line << std::endl;
+	}
+
+	return 0;
+}
+
+bool AssetQuery::send()
+{
+	switch (options.command)
+	{
+	case AssetCommand::List:
+		return client.list(options.name, names);
+	case AssetCommand::Entry:
+		return client.getEntry(options.name, data);
+	case AssetCommand::Model:
+		return client.getModel(options.name, model);
+	case AssetCommand::Bounds:
+		return client.getBounds(options.name, corner, size);
+	case AssetCommand::Texture:
+		return client.getTexture(options.name, width, height, pixels);
+	case AssetCommand::Stats:
+		return client.getStats(text);
+	case AssetCommand::Shutdown:
+		return client.shutdownServer();
+	default:
+		return false;
+	}
+}
+
+void AssetQuery::print()
+{
+	switch (options.command)
+	{
+	case AssetCommand::List:
+		for (auto& name : names)
+			std::cout << name << std::endl;
+		break;
+	case AssetCommand::Entry:
+		if (!options.output.empty())
+		{
+			std::ofstream file(options.output, std::ios::binary);
+			file.write(data.data(), data.size());
+			if (!file)
+				std::cerr << "Failed to write " << options.output << std::endl;
+		}
+		std::cout << options.name << ": " << data.size() << " bytes" << std::endl;
+		break;
+	case AssetCommand::Model:
+		std::cout << model.name << ": " << (model.isTY2 ? "TY2" : "TY1") << ", " <<
+			model.vertices.size() << " vertices, " << model.indices.size() << " indices, " <<
+			model.meshes.size() << " meshes, " << model.bones.size() << " bones" << std::endl;
+		break;
+	case AssetCommand::Bounds:
+		std::cout << options.name << ": corner " << corner.x << " " << corner.y << " " << corner.z <<
+			", size " << size.x << " " << size.y << " " << size.z << std::endl;
+		break;
+	case AssetCommand::Texture:
+		if (!options.output.empty() && SOIL_save_image(options.output.c_str(), SOIL_SAVE_TYPE_PNG, width, height, 4, pixels.data()) == 0)
+			std::cerr << "Failed to write " << options.output << std::endl;
+		std::cout << options.name << ": " << width << "x" << height << std::endl;
+		break;
+	case AssetCommand::Stats:
+		std::cout << text;
+		break;
+	case AssetCommand::Shutdown:
+		std::cout << "Server stopping" << std::endl;
+		break;
+	default:
+		break;
+	}
+}
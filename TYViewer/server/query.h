@@ -0,0 +1,53 @@
+#pragma once
+
+#include <string>
+
+#include "server/assetclient.h"
+
+struct QueryOptions
+{
+	AssetCommand command = AssetCommand::Count;
+	std::string name;
+
+	// The default socket if empty.
+	std::string socket;
+
+	// Where entry bytes or texture images are written, printed as a summary otherwise.
+	std::string output;
+
+	// Sends the request this many times and reports the latency.
+	int repeat = 1;
+};
+
+// Sends one request to a running asset server, for scripts and for measuring the server.
+// Usage: TYViewer --query <command> [name] [options]
+class AssetQuery
+{
+public:
+	static bool isRequested(int argc, char* argv[]);
+	static bool parseArguments(int argc, char* argv[], QueryOptions& options);
+	static void printUsage();
+
+	AssetQuery(const QueryOptions& options);
+
+	int run();
+
+private:
+	bool send();
+	void print();
+
+	QueryOptions options;
+
+	AssetClient client;
+
+	// Results of the last request.
+	std::vector<std::string> names;
+	std::vector<char> data;
+	ModelData model;
+	glm::vec3 corner;
+	glm::vec3 size;
+	int width;
+	int height;
+	std::vector<unsigned char> pixels;
+	std::string text;
+};
@@ -0,0 +1,145 @@
+#include "sharedmemory.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#endif
+
+static std::string getSystemName(const std::string& name)
+{
+#ifdef _WIN32
+	return "Local\\" + name;
+#else
+	return "/" + name;
+#endif
+}
+
+SharedMemory::SharedMemory() :
+	data(nullptr),
+	size(0),
+	owner(false),
+	mapping(nullptr)
+{}
+
+SharedMemory::~SharedMemory()
+{
+	close();
+}
+
+bool SharedMemory::create(const std::string& name, size_t size)
+{
+	close();
+
+	std::string systemName = getSystemName(name);
+
+#ifdef _WIN32
+	unsigned long long bytes = size;
+	mapping = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE,
+		static_cast<DWORD>(bytes >> 32), static_cast<DWORD>(bytes & 0xFFFFFFFF), systemName.c_str());
+	if (mapping == nullptr)
+		return false;
+
+	data = static_cast<char*>(MapViewOfFile(mapping, FILE_MAP_WRITE, 0, 0, size));
+#else
+	int descriptor = shm_open(systemName.c_str(), O_CREAT | O_RDWR | O_TRUNC, 0600);
+	if (descriptor < 0)
+		return false;
+
+	if (ftruncate(descriptor, static_cast<off_t>(size)) == 0)
+	{
+		void* view = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, descriptor, 0);
+		data = view == MAP_FAILED ? nullptr : static_cast<char*>(view);
+	}
+	::close(descriptor);
+#endif
+
+	this->name = name;
+	this->size = size;
+	owner = true;
+
+	if (data == nullptr)
+	{
+		close();
+		return false;
+	}
+	return true;
+}
+
+bool SharedMemory::open(const std::string& name, size_t size)
+{
+	close();
+
+	std::string systemName = getSystemName(name);
+
+#ifdef _WIN32
+	mapping = OpenFileMappingA(FILE_MAP_READ, FALSE, systemName.c_str());
+	if (mapping == nullptr)
+		return false;
+
+	data = static_cast<char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, size));
+#else
+	int descriptor = shm_open(systemName.c_str(), O_RDONLY, 0);
+	if (descriptor < 0)
+		return false;
+
+	void* view = mmap(nullptr, size, PROT_READ, MAP_SHARED, descriptor, 0);
+	data = view == MAP_FAILED ? nullptr : static_cast<char*>(view);
+	::close(descriptor);
+#endif
+
+	this->name = name;
+	this->size = size;
+	owner = false;
+
+	if (data == nullptr)
+	{
+		close();
+		return false;
+	}
+	return true;
+}
+
+void SharedMemory::close()
+{
+#ifdef _WIN32
+	if (data != nullptr)
+		UnmapViewOfFile(data);
+	if (mapping != nullptr)
+		CloseHandle(mapping);
+	mapping = nullptr;
+#else
+	if (data != nullptr)
+		munmap(data, size);
+	if (owner && !name.empty())
+		shm_unlink(getSystemName(name).c_str());
+#endif
+
+	data = nullptr;
+	size = 0;
+	owner = false;
+	name.clear();
+}
+
+char* SharedMemory::getData() const
+{
+	return data;
+}
+
+size_t SharedMemory::getSize() const
+{
+	return size;
+}
+
+const std::string& SharedMemory::getName() const
+{
+	return name;
+}
+
+bool SharedMemory::isOpen() const
+{
+	return data != nullptr;
+}
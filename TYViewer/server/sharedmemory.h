@@ -0,0 +1,37 @@
+#pragma once
+
+#include <string>
+
+// Named memory shared between processes, a POSIX shm object or a Windows file mapping.
+class SharedMemory
+{
+public:
+	SharedMemory();
+	~SharedMemory();
+
+	SharedMemory(const SharedMemory&) = delete;
+	SharedMemory& operator=(const SharedMemory&) = delete;
+
+	// 'name' is plain, without the platform's prefix. The creator removes the name again on close(),
+	// processes that already opened it keep their mapping.
+	bool create(const std::string& name, size_t size);
+	// Read only.
+	bool open(const std::string& name, size_t size);
+	void close();
+
+	char* getData() const;
+	size_t getSize() const;
+	const std::string& getName() const;
+
+	bool isOpen() const;
+
+private:
+	std::string name;
+
+	char* data;
+	size_t size;
+	bool owner;
+
+	// The file mapping handle on Windows.
+	void* mapping;
+};
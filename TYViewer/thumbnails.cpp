@@ -0,0 +1,330 @@
+#include "thumbnails.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <future>
+#include <iostream>
+#include <filesystem>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <SOIL2/SOIL2.h>
+
+#include "loader/modelbuilder.h"
+
+#include "graphics/camera.h"
+
+#include "util/trace.h"
+
+#include "config.h"
+#include "debug.h"
+#include "util/timing.h"
+#include "util/stringext.h"
+
+// Same view as headless images.
+#define THUMBNAIL_CAMERA_PITCH -20.0f
+#define THUMBNAIL_CAMERA_YAW 120.0f
+
+// Decoded textures are dropped once they add up to this, models in flight keep theirs.
+#define THUMBNAIL_TEXTURE_CACHE_BYTES (256 * 1024 * 1024)
+
+bool Thumbnails::isRequested(int argc, char* argv[])
+{
+	for (int i = 1; i < argc; i++)
+	{
+		if (std::string(argv[i]) == "--thumbnails")
+			return true;
+	}
+	return false;
+}
+
+bool Thumbnails::parseArguments(int argc, char* argv[], ThumbnailOptions& options)
+{
+	for (int i = 1; i < argc; i++)
+	{
+		std::string argument = argv[i];
+		bool hasValue = i + 1 < argc;
+
+		if (argument == "--thumbnails" && hasValue)
+		{
+			options.output = argv[++i];
+		}
+		else if (argument == "--trace" && hasValue)
+		{
+			// Handled before thumbnails are rendered.
+			i++;
+		}
+		else if (argument == "--models" && hasValue)
+		{
+			splitList(argv[++i], options.models);
+		}
+		else if (argument == "--archive" && hasValue)
+		{
+			options.archive = argv[++i];
+		}
+		else if (argument == "--filter" && hasValue)
+		{
+			options.filter = argv[++i];
+		}
+		else if (argument == "--size" && hasValue)
+		{
+			options.size = std::atoi(argv[++i]);
+			if (options.size <= 0)
+				return false;
+		}
+		else if (argument == "--threads" && hasValue)
+		{
+			int threads = std::atoi(argv[++i]);
+			if (threads <= 0)
+				return false;
+			options.threads = static_cast<unsigned int>(threads);
+		}
+		else if (argument == "--no-textures")
+		{
+			options.textures = false;
+		}
+		else
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void Thumbnails::printUsage()
+{
+	std::cout <<
+		"Usage: TYViewer --thumbnails <directory> [options]" << std::endl <<
+		"  --models <a,b,...>   Models to render (default: every model in the archive)" << std::endl <<
+		"  --archive <path>     Archive to load models from (default: config.cfg)" << std::endl <<
+		"  --filter <text>      Only render models whose name contains <text>" << std::endl <<
+		"  --size <n>           Width and height in pixels (default: 128)" << std::endl <<
+		"  --threads <n>        Rasterizer threads (default: one per core)" << std::endl <<
+		"  --no-textures        Shade every mesh white" << std::endl <<
+		"  --trace <file>       Record a Chrome trace of the run" << std::endl;
+}
+
+Thumbnails::Thumbnails(const ThumbnailOptions& options) :
+	options(options),
+	rasterizer(options.size, options.size, options.threads),
+	textureBytes(0)
+{}
+
+int Thumbnails::run()
+{
+	std::string path = options.archive.empty() ? Config::archive : options.archive;
+	if (path.empty())
+	{
+		LOG_ERROR(General, "No archive specified, use --archive or config.cfg");
+		return -1;
+	}
+
+	if (!archive.load(path))
+	{
+		LOG_ERROR(General, "Failed to load archive: " + path);
+		return -1;
+	}
+
+	std::vector<std::string> names;
+	for (auto& name : options.models.empty() ? archive.getFileNames("mdl") : options.models)
+	{
+		if (name.find(options.filter) != std::string::npos)
+			names.push_back(name);
+	}
+
+	if (names.empty())
+	{
+		LOG_ERROR(General, "No models to render in " + path);
+		return -1;
+	}
+
+	std::error_code error;
+	std::filesystem::create_directories(options.output, error);
+	if (error)
+	{
+		LOG_ERROR(General, "Failed to create output directory: " + options.output);
+		return -1;
+	}
+
+	// Failures are listed in the summary.
+	Debug::setLevel(Debug::Level::Error);
+
+	printf("Rendering %zu thumbnails of %dx%d from %s on %u threads\n", names.size(), options.size, options.size, path.c_str(), rasterizer.getThreads());
+	fflush(stdout);
+
+	std::vector<std::string> failures;
+	std::vector<unsigned char> pixels;
+
+	double loading = 0.0;
+	double rendering = 0.0;
+	double saving = 0.0;
+	size_t triangles = 0;
+
+	auto start = std::chrono::high_resolution_clock::now();
+
+	// While one model is rendered the next one is loaded.
+	ThumbnailModel models[2];
+	std::future<void> next = std::async(std::launch::async, [&]() { prepare(names[0], models[0]); });
+
+	for (size_t i = 0; i < names.size(); i++)
+	{
+		next.get();
+		ThumbnailModel& model = models[i % 2];
+
+		if (i + 1 < names.size())
+		{
+			ThumbnailModel& following = models[(i + 1) % 2];
+			const std::string& name = names[i + 1];
+			next = std::async(std::launch::async, [this, &following, &name]() { prepare(name, following); });
+		}
+
+		loading += model.loadMilliseconds;
+
+		if (!model.error.empty())
+		{
+			failures.push_back(model.name + ": " + model.error);
+			continue;
+		}
+
+		auto stageStart = std::chrono::high_resolution_clock::now();
+		render(model);
+		rasterizer.read(pixels);
+		rendering += millisecondsSince(stageStart);
+		triangles += rasterizer.getStats().triangles;
+
+		stageStart = std::chrono::high_resolution_clock::now();
+		std::string image = (std::filesystem::path(options.output) / (model.name.substr(0, model.name.find_last_of('.')) + ".png")).string();
+		if (SOIL_save_image(image.c_str(), SOIL_SAVE_TYPE_PNG, options.size, options.size, 4, pixels.data()) == 0)
+			failures.push_back(model.name + ": failed to save " + image);
+		saving += millisecondsSince(stageStart);
+	}
+
+	double wall = millisecondsSince(start);
+
+	if (!failures.empty())
+	{
+		printf("\nFailed:\n");
+		for (auto& failure : failures)
+		{
+			printf("  %s\n", failure.c_str());
+		}
+	}
+
+	size_t rendered = names.size() - failures.size();
+	printf("\n%zu rendered, %zu failed, %zu triangles\n", rendered, failures.size(), triangles);
+	printf("%.1f ms wall, %.1f thumbnails/s\n", wall, wall > 0.0 ? rendered * 1000.0 / wall : 0.0);
+	printf("%.1f ms loading (overlapped), %.1f ms rendering, %.1f ms saving\n", loading, rendering, saving);
+	fflush(stdout);
+
+	return failures.empty() ? 0 : 1;
+}
+
+void Thumbnails::prepare(const std::string& name, ThumbnailModel& model)
+{
+	TRACE_ZONE_DETAIL("Thumbnails::prepare", name);
+
+	auto start = std::chrono::high_resolution_clock::now();
+
+	model = ThumbnailModel();
+	model.name = name;
+
+	try
+	{
+		if (!ModelBuilder::build(archive, name, model.data))
+		{
+			model.error = model.data.error.empty() ? "build failed" : model.data.error;
+			return;
+		}
+
+		model.textures.resize(model.data.meshes.size());
+		if (options.textures)
+		{
+			for (size_t i = 0; i < model.data.meshes.size(); i++)
+			{
+				if (!model.data.meshes[i].texture.empty())
+					model.textures[i] = getTexture(model.data.meshes[i].texture + ".dds");
+			}
+		}
+	}
+	catch (const std::exception& e)
+	{
+		model.error = std::string("exception: ") + e.what();
+	}
+	catch (...)
+	{
+		model.error = "unknown exception";
+	}
+
+	model.loadMilliseconds = millisecondsSince(start);
+}
+
+std::shared_ptr<const SoftwareTexture> Thumbnails::getTexture(const std::string& name)
+{
+	auto it = textures.find(name);
+	if (it != textures.end())
+		return it->second;
+
+	if (textureBytes > THUMBNAIL_TEXTURE_CACHE_BYTES)
+	{
+		textures.clear();
+		textureBytes = 0;
+	}
+
+	TRACE_ZONE_DETAIL("Thumbnails::getTexture", name);
+
+	// Missing and broken textures are remembered too, as null.
+	std::shared_ptr<SoftwareTexture> texture;
+
+	std::vector<char> data;
+	if (archive.getFileData(name, data))
+	{
+		texture = std::make_shared<SoftwareTexture>();
+		if (texture->load(data))
+			textureBytes += texture->getBytes();
+		else
+			texture.reset();
+	}
+
+	textures[name] = texture;
+	return texture;
+}
+
+void Thumbnails::render(const ThumbnailModel& model)
+{
+	TRACE_ZONE_DETAIL("Thumbnails::render", model.name);
+
+	Camera camera(glm::vec3(0.0f), glm::vec3(90.0f, 0.0f, 0.0f), 70.0f, 1.0f, 0.2f, 30000.0f);
+
+	glm::vec3 center = model.data.boundsCorner + model.data.boundsSize / 2.0f;
+	center.z = -center.z;
+
+	float radius = glm::length(model.data.boundsSize) / 2.0f;
+	if (radius <= 0.0f)
+		radius = 100.0f;
+
+	float distance = radius / std::sin(glm::radians(camera.getFieldOfView() / 2.0f));
+	camera.orbit(center, distance, THUMBNAIL_CAMERA_YAW, THUMBNAIL_CAMERA_PITCH);
+
+	// Display as a left-handed coordinate system.
+	glm::mat4 view = glm::scale(camera.getViewMatrix(), glm::vec3(1.0f, 1.0f, -1.0f));
+	glm::mat4 matrix = camera.getProjectionMatrix() * view;
+
+	rasterizer.clear(glm::vec4(Config::backgroundR, Config::backgroundG, Config::backgroundB, 1.0f));
+
+	const glm::vec4 tint(1.0f);
+	for (size_t i = 0; i < model.data.meshes.size(); i++)
+	{
+		const MeshRange& range = model.data.meshes[i];
+		if (range.vertexOffset + range.vertexCount > model.data.vertices.size() ||
+			range.indexOffset + range.indexCount > model.data.indices.size())
+			continue;
+
+		rasterizer.draw(model.data.vertices.data() + range.vertexOffset, range.vertexCount,
+			model.data.indices.data() + range.indexOffset, range.indexCount,
+			model.textures[i].get(), matrix, tint);
+	}
+
+	rasterizer.finish();
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+#include "loader/archive.h"
+#include "loader/modeldata.h"
+
+#include "graphics/rasterizer.h"
+
+struct ThumbnailOptions
+{
+	// Every .mdl in the archive if empty.
+	std::vector<std::string> models;
+
+	std::string archive;
+	std::string output = ".";
+
+	// Only models whose name contains this.
+	std::string filter;
+
+	int size = 128;
+
+	// Rasterizer threads, 0 uses every core.
+	unsigned int threads = 0;
+
+	bool textures = true;
+};
+
+// A model decoded on the loader thread, ready to be drawn.
+struct ThumbnailModel
+{
+	std::string name;
+	std::string error;
+
+	ModelData data;
+	// One per mesh range, null where the texture is missing.
+	std::vector<std::shared_ptr<const SoftwareTexture>> textures;
+
+	double loadMilliseconds = 0.0;
+};
+
+// Renders a preview image of every model with the software rasterizer, no GPU or OpenGL needed.
+// The next model is parsed and its textures decoded while the current one is rasterized.
+// Usage: TYViewer --thumbnails <directory> [options]
+class Thumbnails
+{
+public:
+	static bool isRequested(int argc, char* argv[]);
+	static bool parseArguments(int argc, char* argv[], ThumbnailOptions& options);
+	static void printUsage();
+
+	Thumbnails(const ThumbnailOptions& options);
+
+	int run();
+
+private:
+	void prepare(const std::string& name, ThumbnailModel& model);
+	std::shared_ptr<const SoftwareTexture> getTexture(const std::string& name);
+
+	// Draws with the same camera as headless images.
+	void render(const ThumbnailModel& model);
+
+	ThumbnailOptions options;
+
+	Archive archive;
+	SoftwareRasterizer rasterizer;
+
+	// Only touched by whichever thread runs prepare(), one at a time.
+	std::unordered_map<std::string, std::shared_ptr<const SoftwareTexture>> textures;
+	size_t textureBytes;
+};
@@ -0,0 +1,187 @@
+#include "allocation.h"
+
+#include <atomic>
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+#include "debug.h"
+
+#if ALLOCATION_TRACKING
+
+// Every block starts with its size and scope, so frees are charged to the scope that allocated.
+// 16 bytes keeps the returned pointer aligned for any fundamental type.
+#define ALLOCATION_HEADER_SIZE 16
+
+struct AllocationHeader
+{
+	uint64_t size;
+	uint32_t scope;
+};
+
+static_assert(sizeof(AllocationHeader) <= ALLOCATION_HEADER_SIZE, "Allocation header does not fit!");
+
+struct AllocationCounters
+{
+	std::atomic<size_t> count;
+	std::atomic<size_t> bytes;
+	std::atomic<size_t> live;
+	std::atomic<size_t> peak;
+};
+
+// Zero initialized before any dynamic initializer can allocate.
+static AllocationCounters counters[static_cast<int>(AllocationScope::Count)];
+static AllocationCounters total;
+
+static thread_local AllocationScope currentScope = AllocationScope::Other;
+
+static void raisePeak(std::atomic<size_t>& peak, size_t live)
+{
+	size_t previous = peak.load(std::memory_order_relaxed);
+	while (live > previous && !peak.compare_exchange_weak(previous, live, std::memory_order_relaxed))
+	{
+	}
+}
+
+static void* countedAllocate(size_t size)
+{
+	char* block = static_cast<char*>(std::malloc(size + ALLOCATION_HEADER_SIZE));
+	if (block == nullptr)
+	{
+		throw std::bad_alloc();
+	}
+
+	AllocationScope scope = currentScope;
+
+	AllocationHeader* header = reinterpret_cast<AllocationHeader*>(block);
+	header->size = size;
+	header->scope = static_cast<uint32_t>(scope);
+
+	for (AllocationCounters* c : { &counters[static_cast<int>(scope)], &total })
+	{
+		c->count.fetch_add(1, std::memory_order_relaxed);
+		c->bytes.fetch_add(size, std::memory_order_relaxed);
+		raisePeak(c->peak, c->live.fetch_add(size, std::memory_order_relaxed) + size);
+	}
+
+	return block + ALLOCATION_HEADER_SIZE;
+}
+
+static void countedFree(void* p)
+{
+	if (p == nullptr)
+		return;
+
+	char* block = static_cast<char*>(p) - ALLOCATION_HEADER_SIZE;
+	AllocationHeader* header = reinterpret_cast<AllocationHeader*>(block);
+
+	size_t size = static_cast<size_t>(header->size);
+	counters[header->scope].live.fetch_sub(size, std::memory_order_relaxed);
+	total.live.fetch_sub(size, std::memory_order_relaxed);
+
+	std::free(block);
+}
+
+void* operator new(size_t size) { return countedAllocate(size); }
+void* operator new[](size_t size) { return countedAllocate(size); }
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept
+{
+	try { return countedAllocate(size); }
+	catch (...) { return nullptr; }
+}
+void* operator new[](size_t size, const std::nothrow_t&) noexcept
+{
+	try { return countedAllocate(size); }
+	catch (...) { return nullptr; }
+}
+
+void operator delete(void* p) noexcept { countedFree(p); }
+void operator delete[](void* p) noexcept { countedFree(p); }
+void operator delete(void* p, size_t) noexcept { countedFree(p); }
+void operator delete[](void* p, size_t) noexcept { countedFree(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { countedFree(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { countedFree(p); }
+
+static AllocationStats load(const AllocationCounters& c)
+{
+	AllocationStats stats;
+	stats.count = c.count.load(std::memory_order_relaxed);
+	stats.bytes = c.bytes.load(std::memory_order_relaxed);
+	stats.live = c.live.load(std::memory_order_relaxed);
+	stats.peak = c.peak.load(std::memory_order_relaxed);
+	return stats;
+}
+
+bool Allocation::isCounting() { return true; }
+size_t Allocation::getCount() { return total.count.load(std::memory_order_relaxed); }
+size_t Allocation::getBytes() { return total.bytes.load(std::memory_order_relaxed); }
+
+AllocationStats Allocation::getStats(AllocationScope scope) { return load(counters[static_cast<int>(scope)]); }
+AllocationStats Allocation::getTotal() { return load(total); }
+
+AllocationScope Allocation::setScope(AllocationScope scope)
+{
+	AllocationScope previous = currentScope;
+	currentScope = scope;
+	return previous;
+}
+
+void Allocation::resetPeaks()
+{
+	for (AllocationCounters& c : counters)
+	{
+		c.peak.store(c.live.load(std::memory_order_relaxed), std::memory_order_relaxed);
+	}
+	total.peak.store(total.live.load(std::memory_order_relaxed), std::memory_order_relaxed);
+}
+
+#else
+
+bool Allocation::isCounting() { return false; }
+size_t Allocation::getCount() { return 0; }
+size_t Allocation::getBytes() { return 0; }
+
+AllocationStats Allocation::getStats(AllocationScope) { return AllocationStats(); }
+AllocationStats Allocation::getTotal() { return AllocationStats(); }
+
+AllocationScope Allocation::setScope(AllocationScope) { return AllocationScope::Other; }
+
+void Allocation::resetPeaks() {}
+
+#endif
+
+const char* Allocation::getName(AllocationScope scope)
+{
+	switch (scope)
+	{
+	case AllocationScope::Other:	return "Other";
+	case AllocationScope::Archive:	return "Archive";
+	case AllocationScope::MDL:		return "MDL";
+	case AllocationScope::MDG:		return "MDG";
+	case AllocationScope::Content:	return "Content";
+	case AllocationScope::Frame:	return "Frame";
+	default:						return "Unknown";
+	}
+}
+
+void Allocation::report()
+{
+	if (!isCounting())
+		return;
+
+	char line[128];
+	snprintf(line, sizeof(line), "%-8s %12s %14s %14s %14s", "Scope", "Allocations", "Bytes", "Live", "Peak");
+	LOG_INFO(General, line);
+
+	for (int i = 0; i <= static_cast<int>(AllocationScope::Count); i++)
+	{
+		bool isTotal = i == static_cast<int>(AllocationScope::Count);
+		AllocationStats stats = isTotal ? getTotal() : getStats(static_cast<AllocationScope>(i));
+
+		snprintf(line, sizeof(line), "%-8s %12zu %14zu %14zu %14zu", isTotal ? "Total" : getName(static_cast<AllocationScope>(i)),
+			stats.count, stats.bytes, stats.live, stats.peak);
+		LOG_INFO(General, line);
+	}
+}
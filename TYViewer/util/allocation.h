@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstddef>
+
+// Replace the global allocation functions to count and attribute heap use.
+// On by default in debug builds, define as 1 to profile a release build.
+#ifndef ALLOCATION_TRACKING
+#ifdef _DEBUG
+#define ALLOCATION_TRACKING 1
+#else
+#define ALLOCATION_TRACKING 0
+#endif
+#endif
+
+// What the calling thread is doing, every allocation is charged to the innermost scope.
+enum class AllocationScope
+{
+	Other,
+	Archive,
+	MDL,
+	MDG,
+	Content,
+	Frame,
+
+	Count
+};
+
+struct AllocationStats
+{
+	size_t count = 0;
+	size_t bytes = 0;
+
+	// Bytes allocated in the scope and not freed yet, and the most there ever were.
+	size_t live = 0;
+	size_t peak = 0;
+};
+
+// Counts global operator new calls per scope.
+// Without ALLOCATION_TRACKING nothing is replaced and every query reports 0.
+class Allocation
+{
+public:
+	static bool isCounting();
+
+	// Totals over all scopes.
+	static size_t getCount();
+	static size_t getBytes();
+
+	static AllocationStats getStats(AllocationScope scope);
+	static AllocationStats getTotal();
+
+	static const char* getName(AllocationScope scope);
+
+	// Returns the previous scope of the calling thread.
+	static AllocationScope setScope(AllocationScope scope);
+
+	// Starts every peak over from the bytes live right now.
+	static void resetPeaks();
+
+	// Logs a table of all scopes.
+	static void report();
+};
+
+class AllocationScopeGuard
+{
+public:
+	inline AllocationScopeGuard(AllocationScope scope) :
+		previous(Allocation::setScope(scope))
+	{}
+	inline ~AllocationScopeGuard()
+	{
+		Allocation::setScope(previous);
+	}
+
+	AllocationScopeGuard(const AllocationScopeGuard&) = delete;
+	AllocationScopeGuard& operator=(const AllocationScopeGuard&) = delete;
+
+private:
+	AllocationScope previous;
+};
+
+#define ALLOCATION_CONCAT_INNER(a, b) a##b
+#define ALLOCATION_CONCAT(a, b) ALLOCATION_CONCAT_INNER(a, b)
+
+#if ALLOCATION_TRACKING
+#define ALLOCATION_SCOPE(scope) AllocationScopeGuard ALLOCATION_CONCAT(allocationScope, __LINE__)(AllocationScope::scope)
+#else
+#define ALLOCATION_SCOPE(scope) do {} while (0)
+#endif
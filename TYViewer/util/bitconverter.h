@@ -2,6 +2,7 @@
 
 #include <stdint.h>
 #include <climits>
+#include <cstring>
 #include <memory>
 
 template <typename T>
@@ -3,8 +3,15 @@
 Font::Font(const std::unordered_map<char, FontRegion>& regions, Texture* texture, float spaceWidth) :
 	spaceWidth(spaceWidth),
 	texture(texture),
-	regions(regions)
-{}
+	regions(regions),
+	lineHeight(0.0f)
+{
+	for (auto& region : regions)
+	{
+		if (region.second.height * 256 > lineHeight)
+			lineHeight = region.second.height * 256;
+	}
+}
 
 bool Font::tryGetFontRegion(char c, FontRegion& region)
 {
@@ -26,3 +33,8 @@ float Font::getSpaceWidth() const
 {
 	return spaceWidth;
 }
+
+float Font::getLineHeight() const
+{
+	return lineHeight;
+}
@@ -24,9 +24,12 @@ public:
 
 	Texture* getTexture() const;
 	float getSpaceWidth() const;
+	// Height of the tallest character, in the same units Text lays out glyphs.
+	float getLineHeight() const;
 
 private:
 	float spaceWidth;
+	float lineHeight;
 
 	Texture* texture;
 	std::unordered_map<char, FontRegion> regions;
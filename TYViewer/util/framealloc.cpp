@@ -0,0 +1,102 @@
+#include "framealloc.h"
+
+#include <cstdint>
+
+#include "debug.h"
+
+FrameAllocator::FrameAllocator(size_t capacity) :
+	current(0),
+	growCount(0)
+{
+	for (auto& arena : arenas)
+	{
+		arena.data = new char[capacity];
+		arena.capacity = capacity;
+		arena.overflow.reserve(8);
+	}
+}
+
+FrameAllocator::~FrameAllocator()
+{
+	for (auto& arena : arenas)
+	{
+		for (auto block : arena.overflow)
+		{
+			delete[] block;
+		}
+		delete[] arena.data;
+	}
+}
+
+void FrameAllocator::beginFrame()
+{
+	current ^= 1;
+	reset(arenas[current]);
+}
+
+void FrameAllocator::reset(Arena& arena)
+{
+	if (!arena.overflow.empty())
+	{
+		for (auto block : arena.overflow)
+		{
+			delete[] block;
+		}
+		arena.overflow.clear();
+
+		// Grow once so the next frame with the same workload fits.
+		size_t capacity = arena.capacity;
+		while (capacity < arena.demand)
+		{
+			capacity *= 2;
+		}
+
+		LOG_DEBUG(General, "FrameAllocator: Growing arena from " + std::to_string(arena.capacity) + " to " + std::to_string(capacity) + " bytes");
+		growCount++;
+
+		delete[] arena.data;
+		arena.data = new char[capacity];
+		arena.capacity = capacity;
+	}
+
+	arena.offset = 0;
+	arena.demand = 0;
+}
+
+void* FrameAllocator::allocate(size_t size, size_t alignment)
+{
+	Arena& arena = arenas[current];
+
+	uintptr_t base = reinterpret_cast<uintptr_t>(arena.data);
+	size_t aligned = ((base + arena.offset + alignment - 1) & ~(uintptr_t)(alignment - 1)) - base;
+
+	arena.demand += size + alignment - 1;
+
+	if (aligned + size <= arena.capacity)
+	{
+		arena.offset = aligned + size;
+		return arena.data + aligned;
+	}
+
+	// Out of space, hand out a heap block for this frame and grow on reuse.
+	// operator new[] guarantees max_align_t alignment, which covers every caller.
+	char* block = new char[size];
+	arena.overflow.push_back(block);
+	arena.offset = arena.capacity;
+	return block;
+}
+
+size_t FrameAllocator::getUsed() const
+{
+	return arenas[current].offset;
+}
+
+size_t FrameAllocator::getCapacity() const
+{
+	return arenas[current].capacity;
+}
+
+size_t FrameAllocator::getGrowCount() const
+{
+	return growCount;
+}
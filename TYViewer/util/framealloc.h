@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+#define FRAME_ALLOCATOR_DEFAULT_CAPACITY (256 * 1024)
+
+// Bump-pointer allocator for data that only lives for a frame or two.
+// Two arenas are kept and swapped every beginFrame(), so memory handed out
+// during frame N stays valid until frame N + 2 starts. Nothing is ever freed
+// individually and no destructors are run.
+class FrameAllocator
+{
+public:
+	FrameAllocator(size_t capacity = FRAME_ALLOCATOR_DEFAULT_CAPACITY);
+	~FrameAllocator();
+
+	FrameAllocator(const FrameAllocator&) = delete;
+	FrameAllocator& operator=(const FrameAllocator&) = delete;
+
+	void beginFrame();
+
+	void* allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+	template<typename T>
+	T* allocate(size_t count)
+	{
+		static_assert(std::is_trivially_destructible<T>::value, "Frame allocations are never destroyed!");
+		return static_cast<T*>(allocate(sizeof(T) * count, alignof(T)));
+	}
+
+	size_t getUsed() const;
+	size_t getCapacity() const;
+
+	// Times an arena was reallocated because a frame outgrew it.
+	size_t getGrowCount() const;
+
+private:
+	struct Arena
+	{
+		char* data = nullptr;
+		size_t capacity = 0;
+		size_t offset = 0;
+		size_t demand = 0;
+
+		// Blocks handed out after the arena ran full.
+		// Released and folded into the capacity when the arena is reused.
+		std::vector<char*> overflow;
+	};
+
+	void reset(Arena& arena);
+
+	Arena arenas[2];
+	unsigned int current;
+	size_t growCount;
+};
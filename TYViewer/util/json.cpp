@@ -0,0 +1,273 @@
+#include "json.h"
+
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+class JsonReader
+{
+public:
+	JsonReader(const std::string& text) :
+		text(text),
+		position(0)
+	{}
+
+	bool readDocument(Json& value)
+	{
+		if (!readValue(value, 0))
+			return false;
+
+		skipWhitespace();
+		return position == text.size();
+	}
+
+private:
+	// Deep enough for anything we write, shallow enough to never overflow the stack.
+	static const int MAX_DEPTH = 64;
+
+	void skipWhitespace()
+	{
+		while (position < text.size() && std::isspace(static_cast<unsigned char>(text[position])))
+		{
+			position++;
+		}
+	}
+
+	bool consume(char c)
+	{
+		skipWhitespace();
+		if (position < text.size() && text[position] == c)
+		{
+			position++;
+			return true;
+		}
+		return false;
+	}
+
+	bool consumeWord(const char* word)
+	{
+		size_t length = std::char_traits<char>::length(word);
+		if (text.compare(position, length, word) != 0)
+			return false;
+
+		position += length;
+		return true;
+	}
+
+	bool readValue(Json& value, int depth)
+	{
+		if (depth > MAX_DEPTH)
+			return false;
+
+		skipWhitespace();
+		if (position >= text.size())
+			return false;
+
+		char c = text[position];
+		if (c == '{')
+			return readObject(value, depth);
+		if (c == '[')
+			return readArray(value, depth);
+		if (c == '"')
+		{
+			value.type = Json::Type::String;
+			return readString(value.string);
+		}
+		if (consumeWord("true"))
+		{
+			value.type = Json::Type::Bool;
+			value.boolean = true;
+			return true;
+		}
+		if (consumeWord("false"))
+		{
+			value.type = Json::Type::Bool;
+			value.boolean = false;
+			return true;
+		}
+		if (consumeWord("null"))
+		{
+			value.type = Json::Type::Null;
+			return true;
+		}
+		return readNumber(value);
+	}
+
+	bool readObject(Json& value, int depth)
+	{
+		value.type = Json::Type::Object;
+		position++;
+
+		if (consume('}'))
+			return true;
+
+		do
+		{
+			skipWhitespace();
+
+			std::string key;
+			if (!readString(key) || !consume(':'))
+				return false;
+
+			value.object.emplace_back(key, Json());
+			if (!readValue(value.object.back().second, depth + 1))
+				return false;
+		} while (consume(','));
+
+		return consume('}');
+	}
+
+	bool readArray(Json& value, int depth)
+	{
+		value.type = Json::Type::Array;
+		position++;
+
+		if (consume(']'))
+			return true;
+
+		do
+		{
+			value.array.emplace_back();
+			if (!readValue(value.array.back(), depth + 1))
+				return false;
+		} while (consume(','));
+
+		return consume(']');
+	}
+
+	bool readString(std::string& s)
+	{
+		if (position >= text.size() || text[position] != '"')
+			return false;
+		position++;
+
+		while (position < text.size())
+		{
+			char c = text[position++];
+			if (c == '"')
+				return true;
+
+			if (c != '\\')
+			{
+				s += c;
+				continue;
+			}
+
+			if (position >= text.size())
+				return false;
+
+			char escaped = text[position++];
+			switch (escaped)
+			{
+			case 'n': s += '\n'; break;
+			case 't': s += '\t'; break;
+			case 'r': s += '\r'; break;
+			case 'b': s += '\b'; break;
+			case 'f': s += '\f'; break;
+			case 'u':
+				// Only ASCII is ever written, anything else becomes '?'.
+				if (position + 4 > text.size())
+					return false;
+				{
+					long code = std::strtol(text.substr(position, 4).c_str(), nullptr, 16);
+					s += code < 0x80 ? static_cast<char>(code) : '?';
+				}
+				position += 4;
+				break;
+			default: s += escaped; break;
+			}
+		}
+		return false;
+	}
+
+	bool readNumber(Json& value)
+	{
+		const char* start = text.c_str() + position;
+		char* end = nullptr;
+
+		value.number = std::strtod(start, &end);
+		if (end == start)
+			return false;
+
+		value.type = Json::Type::Number;
+		position += end - start;
+		return true;
+	}
+
+	const std::string& text;
+	size_t position;
+};
+
+bool Json::parse(const std::string& text, Json& value)
+{
+	value = Json();
+	return JsonReader(text).readDocument(value);
+}
+
+bool Json::load(const std::string& path, Json& value)
+{
+	std::ifstream stream(path, std::ios::binary);
+	if (stream.fail())
+		return false;
+
+	std::stringstream ss;
+	ss << stream.rdbuf();
+	return parse(ss.str(), value);
+}
+
+std::string Json::escape(const std::string& s)
+{
+	std::string escaped;
+	escaped.reserve(s.size());
+	for (char c : s)
+	{
+		switch (c)
+		{
+		case '"': escaped += "\\\""; break;
+		case '\\': escaped += "\\\\"; break;
+		case '\n': escaped += "\\n"; break;
+		case '\t': escaped += "\\t"; break;
+		case '\r': escaped += "\\r"; break;
+		case '\b': escaped += "\\b"; break;
+		case '\f': escaped += "\\f"; break;
+		default:
+			// Other control characters are not allowed raw in a string.
+			if (static_cast<unsigned char>(c) < 0x20)
+			{
+				char code[8];
+				snprintf(code, sizeof(code), "\\u%04x", static_cast<unsigned char>(c));
+				escaped += code;
+			}
+			else
+			{
+				escaped += c;
+			}
+			break;
+		}
+	}
+	return escaped;
+}
+
+const Json* Json::find(const std::string& key) const
+{
+	for (auto& member : object)
+	{
+		if (member.first == key)
+			return &member.second;
+	}
+	return nullptr;
+}
+
+double Json::getNumber(const std::string& key, double fallback) const
+{
+	const Json* value = find(key);
+	return value != nullptr && value->type == Type::Number ? value->number : fallback;
+}
+
+std::string Json::getString(const std::string& key, const std::string& fallback) const
+{
+	const Json* value = find(key);
+	return value != nullptr && value->type == Type::String ? value->string : fallback;
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <utility>
+
+// Minimal JSON reader for files the viewer writes itself, like benchmark baselines.
+// Numbers are doubles, objects keep their key order.
+class Json
+{
+public:
+	enum class Type
+	{
+		Null,
+		Bool,
+		Number,
+		String,
+		Array,
+		Object
+	};
+
+	static bool parse(const std::string& text, Json& value);
+	static bool load(const std::string& path, Json& value);
+
+	static std::string escape(const std::string& s);
+
+	// Null if this isn't an object or has no such key.
+	const Json* find(const std::string& key) const;
+
+	double getNumber(const std::string& key, double fallback = 0.0) const;
+	std::string getString(const std::string& key, const std::string& fallback = "") const;
+
+	Type type = Type::Null;
+
+	bool boolean = false;
+	double number = 0.0;
+	std::string string;
+
+	std::vector<Json> array;
+	std::vector<std::pair<std::string, Json>> object;
+};
@@ -6,9 +6,12 @@
 #include <algorithm>
 
 #include "util/stringext.h"
+#include "util/trace.h"
 
 std::pair<std::string, std::string> Parser::parseShader(std::ifstream& stream, const std::unordered_map<std::string, int>& properties)
 {
+	TRACE_ZONE("Parser::parseShader");
+
 	std::unordered_map<std::string, unsigned int> vertexAttribLocations =
 	{
 		{ "position",	0 },
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <string>
+#include <vector>
 
 inline std::string nts(const char* buffer, size_t offset, size_t max_length = -1)
 {
@@ -25,4 +26,28 @@ inline std::string str(const char* buffer, size_t offset, size_t length)
 		res += (char)buffer[i];
 	}
 	return res;
-}
\ No newline at end of file
+}
+
+// Appends the non-empty entries of a comma separated list.
+inline void splitList(const std::string& list, std::vector<std::string>& items)
+{
+	size_t start = 0;
+	while (start <= list.size())
+	{
+		size_t end = list.find(',', start);
+		if (end == std::string::npos)
+			end = list.size();
+
+		if (end > start)
+			items.push_back(list.substr(start, end - start));
+
+		start = end + 1;
+	}
+}
+
+// The part of a path after its last slash or backslash.
+inline std::string getFileName(const std::string& path)
+{
+	size_t slash = path.find_last_of("/\\");
+	return slash == std::string::npos ? path : path.substr(slash + 1);
+}
@@ -0,0 +1,144 @@
+#include "textwriter.h"
+
+#include <cmath>
+#include <cstring>
+#include <charconv>
+
+// Longest output of one number, shortest round-trip doubles need 24 characters.
+#define TEXT_WRITER_NUMBER_SIZE 32
+
+TextWriter::TextWriter() :
+	file(nullptr),
+	buffer(TEXT_WRITER_BUFFER_SIZE),
+	used(0),
+	written(0),
+	failed(false)
+{}
+
+TextWriter::~TextWriter()
+{
+	close();
+}
+
+bool TextWriter::open(const std::string& path)
+{
+	close();
+
+	file = std::fopen(path.c_str(), "wb");
+	used = 0;
+	written = 0;
+	failed = file == nullptr;
+
+	return !failed;
+}
+
+bool TextWriter::close()
+{
+	if (file == nullptr)
+		return false;
+
+	flush();
+	failed |= std::fclose(file) != 0;
+	file = nullptr;
+
+	return !failed;
+}
+
+void TextWriter::write(const char* data, size_t size)
+{
+	if (size > buffer.size())
+	{
+		flush();
+		if (file != nullptr)
+			failed |= std::fwrite(data, 1, size, file) != size;
+		written += size;
+		return;
+	}
+
+	std::memcpy(reserve(size), data, size);
+	used += size;
+	written += size;
+}
+
+TextWriter& TextWriter::operator<<(const char* text)
+{
+	write(text, std::strlen(text));
+	return *this;
+}
+
+TextWriter& TextWriter::operator<<(const std::string& text)
+{
+	write(text.data(), text.size());
+	return *this;
+}
+
+TextWriter& TextWriter::operator<<(char c)
+{
+	*reserve(1) = c;
+	used++;
+	written++;
+	return *this;
+}
+
+TextWriter& TextWriter::operator<<(float value)
+{
+	if (!std::isfinite(value))
+		value = 0.0f;
+
+	char* start = reserve(TEXT_WRITER_NUMBER_SIZE);
+	char* end = std::to_chars(start, start + TEXT_WRITER_NUMBER_SIZE, value).ptr;
+	used += end - start;
+	written += end - start;
+	return *this;
+}
+
+TextWriter& TextWriter::operator<<(double value)
+{
+	if (!std::isfinite(value))
+		value = 0.0;
+
+	char* start = reserve(TEXT_WRITER_NUMBER_SIZE);
+	char* end = std::to_chars(start, start + TEXT_WRITER_NUMBER_SIZE, value).ptr;
+	used += end - start;
+	written += end - start;
+	return *this;
+}
+
+size_t TextWriter::getSize() const
+{
+	return written;
+}
+
+void TextWriter::writeInteger(long long value)
+{
+	char* start = reserve(TEXT_WRITER_NUMBER_SIZE);
+	char* end = std::to_chars(start, start + TEXT_WRITER_NUMBER_SIZE, value).ptr;
+	used += end - start;
+	written += end - start;
+}
+
+void TextWriter::writeInteger(unsigned long long value)
+{
+	char* start = reserve(TEXT_WRITER_NUMBER_SIZE);
+	char* end = std::to_chars(start, start + TEXT_WRITER_NUMBER_SIZE, value).ptr;
+	used += end - start;
+	written += end - start;
+}
+
+char* TextWriter::reserve(size_t size)
+{
+	if (used + size > buffer.size())
+		flush();
+
+	return buffer.data() + used;
+}
+
+void TextWriter::flush()
+{
+	if (used == 0)
+		return;
+
+	if (file != nullptr)
+		failed |= std::fwrite(buffer.data(), 1, used, file) != used;
+	used = 0;
+}
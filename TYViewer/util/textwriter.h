@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <type_traits>
+
+#define TEXT_WRITER_BUFFER_SIZE (1024 * 1024)
+
+// Buffered file output that formats numbers with std::to_chars,
+// several times faster than iostreams for large text formats like OBJ.
+// Floats are written in their shortest round-trip form, non-finite values as 0.
+class TextWriter
+{
+public:
+	TextWriter();
+	~TextWriter();
+
+	TextWriter(const TextWriter&) = delete;
+	TextWriter& operator=(const TextWriter&) = delete;
+
+	bool open(const std::string& path);
+	// Flushes and closes, false if anything failed to write.
+	bool close();
+
+	void write(const char* data, size_t size);
+
+	TextWriter& operator<<(const char* text);
+	TextWriter& operator<<(const std::string& text);
+	TextWriter& operator<<(char c);
+	TextWriter& operator<<(float value);
+	TextWriter& operator<<(double value);
+
+	template<typename T>
+	typename std::enable_if<std::is_integral<T>::value, TextWriter&>::type operator<<(T value)
+	{
+		if (std::is_signed<T>::value)
+			writeInteger(static_cast<long long>(value));
+		else
+			writeInteger(static_cast<unsigned long long>(value));
+		return *this;
+	}
+
+	// Bytes written since open().
+	size_t getSize() const;
+
+private:
+	void writeInteger(long long value);
+	void writeInteger(unsigned long long value);
+
+	// Makes room for 'size' more bytes.
+	char* reserve(size_t size);
+	void flush();
+
+	FILE* file;
+	std::vector<char> buffer;
+	size_t used;
+	size_t written;
+	bool failed;
+};
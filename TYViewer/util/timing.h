@@ -0,0 +1,8 @@
+#pragma once
+
+#include <chrono>
+
+inline double millisecondsSince(std::chrono::high_resolution_clock::time_point start)
+{
+	return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+}
@@ -0,0 +1,272 @@
+#include "trace.h"
+
+#include <chrono>
+#include <mutex>
+#include <vector>
+#include <memory>
+#include <fstream>
+#include <cstring>
+#include <algorithm>
+
+#include "debug.h"
+
+#define TRACE_CHUNK_SIZE 4096
+
+namespace
+{
+	struct Event
+	{
+		const char* name;
+		uint64_t start;
+		uint64_t end;
+		char detail[TRACE_DETAIL_SIZE];
+	};
+
+	// Only the owning thread writes, the exporter reads up to 'count'.
+	// Chunks are only rewound by their owning thread or freed after it exits,
+	// both under the registry lock, so appending needs no lock.
+	struct Chunk
+	{
+		Event events[TRACE_CHUNK_SIZE];
+		std::atomic<size_t> count{ 0 };
+		std::atomic<Chunk*> next{ nullptr };
+	};
+
+	struct ThreadBuffer
+	{
+		unsigned int id;
+		std::atomic<const char*> name{ nullptr };
+
+		Chunk* first = nullptr;
+		Chunk* last = nullptr;
+
+		// Session the chunks were recorded in, owner only.
+		uint64_t session = 0;
+		// Set when the owning thread exits, guarded by the registry lock.
+		bool retired = false;
+
+		~ThreadBuffer()
+		{
+			Chunk* chunk = first;
+			while (chunk != nullptr)
+			{
+				Chunk* next = chunk->next.load(std::memory_order_relaxed);
+				delete chunk;
+				chunk = next;
+			}
+		}
+	};
+
+	// Buffers outlive their threads so worker zones survive until export.
+	std::mutex registryMutex;
+	std::vector<std::unique_ptr<ThreadBuffer>> registry;
+	unsigned int nextThreadId = 1;
+
+	// Counts start() calls, buffers from an earlier session are rewound before recording.
+	std::atomic<uint64_t> session{ 0 };
+
+	// Retires the thread's buffer when the thread exits, the next stop() frees it.
+	struct LocalBuffer
+	{
+		ThreadBuffer* buffer = nullptr;
+
+		~LocalBuffer()
+		{
+			if (buffer != nullptr)
+			{
+				std::lock_guard<std::mutex> lock(registryMutex);
+				buffer->retired = true;
+			}
+		}
+	};
+
+	thread_local LocalBuffer localBuffer;
+
+	const std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+
+	ThreadBuffer& getLocalBuffer()
+	{
+		if (localBuffer.buffer == nullptr)
+		{
+			std::lock_guard<std::mutex> lock(registryMutex);
+			registry.emplace_back(new ThreadBuffer());
+			localBuffer.buffer = registry.back().get();
+			localBuffer.buffer->id = nextThreadId++;
+		}
+		return *localBuffer.buffer;
+	}
+
+	// Keeps the chunks of the last session for reuse, the exporter never sees a half rewound buffer.
+	void rewind(ThreadBuffer& buffer)
+	{
+		std::lock_guard<std::mutex> lock(registryMutex);
+		for (Chunk* chunk = buffer.first; chunk != nullptr; chunk = chunk->next.load(std::memory_order_relaxed))
+		{
+			chunk->count.store(0, std::memory_order_relaxed);
+		}
+		buffer.last = buffer.first;
+	}
+
+	// Threads that exited never record again, so their chunks can go once exported.
+	void releaseRetired()
+	{
+		std::lock_guard<std::mutex> lock(registryMutex);
+		registry.erase(std::remove_if(registry.begin(), registry.end(), [](const std::unique_ptr<ThreadBuffer>& buffer) { return buffer->retired; }), registry.end());
+	}
+
+	void writeEscaped(std::ofstream& stream, const char* s)
+	{
+		for (; *s != '\0'; s++)
+		{
+			if (*s == '"' || *s == '\\')
+				stream << '\\';
+			if (static_cast<unsigned char>(*s) >= 0x20)
+				stream << *s;
+		}
+	}
+}
+
+std::atomic<bool> Trace::enabled(false);
+uint64_t Trace::sessionStart = 0;
+
+void Trace::start()
+{
+	sessionStart = now();
+	session.fetch_add(1, std::memory_order_relaxed);
+	enabled.store(true, std::memory_order_relaxed);
+
+	LOG_INFO(General, "Tracing started");
+}
+
+bool Trace::stop(const std::string& path)
+{
+	enabled.store(false, std::memory_order_relaxed);
+
+	bool saved = save(path, sessionStart);
+	releaseRetired();
+
+	if (!saved)
+	{
+		LOG_ERROR(General, "Failed to write trace: " + path);
+		return false;
+	}
+
+	LOG_INFO(General, "Trace saved: " + path);
+	return true;
+}
+
+void Trace::setThreadName(const char* name)
+{
+	getLocalBuffer().name.store(name, std::memory_order_release);
+}
+
+uint64_t Trace::now()
+{
+	// Offset by one so a timestamp is never 0, which zones use as "not recording".
+	return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - epoch).count()) + 1;
+}
+
+void Trace::record(const char* name, const char* detail, uint64_t start, uint64_t end)
+{
+	ThreadBuffer& buffer = getLocalBuffer();
+
+	uint64_t current = session.load(std::memory_order_relaxed);
+	if (buffer.session != current)
+	{
+		rewind(buffer);
+		buffer.session = current;
+	}
+
+	Chunk* chunk = buffer.last;
+	size_t index = chunk != nullptr ? chunk->count.load(std::memory_order_relaxed) : TRACE_CHUNK_SIZE;
+	if (index == TRACE_CHUNK_SIZE)
+	{
+		// Chunks left over from an earlier session are reused before allocating.
+		Chunk* next = chunk != nullptr ? chunk->next.load(std::memory_order_relaxed) : nullptr;
+		if (next == nullptr)
+		{
+			next = new Chunk();
+			if (chunk != nullptr)
+			{
+				chunk->next.store(next, std::memory_order_release);
+			}
+			else
+			{
+				std::lock_guard<std::mutex> lock(registryMutex);
+				buffer.first = next;
+			}
+		}
+		buffer.last = next;
+
+		chunk = next;
+		index = 0;
+	}
+
+	Event& event = chunk->events[index];
+	event.name = name;
+	event.start = start;
+	event.end = end;
+	strncpy(event.detail, detail, TRACE_DETAIL_SIZE - 1);
+	event.detail[TRACE_DETAIL_SIZE - 1] = '\0';
+
+	chunk->count.store(index + 1, std::memory_order_release);
+}
+
+bool Trace::save(const std::string& path, uint64_t from)
+{
+	std::ofstream stream(path, std::ios::out | std::ios::trunc);
+	if (stream.fail())
+		return false;
+
+	stream << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[" << std::endl;
+
+	bool first = true;
+	auto separate = [&]()
+	{
+		if (!first)
+			stream << "," << std::endl;
+		first = false;
+	};
+
+	std::lock_guard<std::mutex> lock(registryMutex);
+	for (auto& buffer : registry)
+	{
+		const char* threadName = buffer->name.load(std::memory_order_acquire);
+		if (threadName != nullptr)
+		{
+			separate();
+			stream << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->id << ",\"args\":{\"name\":\"";
+			writeEscaped(stream, threadName);
+			stream << "\"}}";
+		}
+
+		for (Chunk* chunk = buffer->first; chunk != nullptr; chunk = chunk->next.load(std::memory_order_acquire))
+		{
+			size_t count = chunk->count.load(std::memory_order_acquire);
+			for (size_t i = 0; i < count; i++)
+			{
+				const Event& event = chunk->events[i];
+				if (event.start < from)
+					continue;
+
+				// Microseconds, with the fraction kept for short zones.
+				separate();
+				stream << "{\"name\":\"";
+				writeEscaped(stream, event.name);
+				stream << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->id;
+				stream << ",\"ts\":" << (event.start - from) / 1000 << "." << (event.start - from) % 1000 / 100;
+				stream << ",\"dur\":" << (event.end - event.start) / 1000 << "." << (event.end - event.start) % 1000 / 100;
+				if (event.detail[0] != '\0')
+				{
+					stream << ",\"args\":{\"detail\":\"";
+					writeEscaped(stream, event.detail);
+					stream << "\"}";
+				}
+				stream << "}";
+			}
+		}
+	}
+
+	stream << std::endl << "]}" << std::endl;
+	return !stream.fail();
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <string>
+#include <atomic>
+#include <cstdint>
+
+// Remove every zone from the build by defining this as 0.
+#ifndef TRACE_COMPILED
+#define TRACE_COMPILED 1
+#endif
+
+#define TRACE_DETAIL_SIZE 48
+
+// Records timed zones into per-thread buffers and exports them in the
+// Chrome trace event format, open the file in chrome://tracing or ui.perfetto.dev.
+// Recording is off until start() is called, a disabled zone costs one atomic load.
+class Trace
+{
+public:
+	static void start();
+	// Stops recording and writes everything recorded since start().
+	static bool stop(const std::string& path);
+
+	static inline bool isEnabled()
+	{
+		return enabled.load(std::memory_order_relaxed);
+	}
+
+	// Shown as the thread's name in the trace, must be a string literal.
+	static void setThreadName(const char* name);
+
+	static uint64_t now();
+
+	// 'name' must be a string literal, 'detail' is copied and may be empty.
+	static void record(const char* name, const char* detail, uint64_t start, uint64_t end);
+
+private:
+	static bool save(const std::string& path, uint64_t from);
+
+	static std::atomic<bool> enabled;
+	static uint64_t sessionStart;
+};
+
+class TraceZone
+{
+public:
+	inline TraceZone(const char* name) :
+		name(name),
+		start(Trace::isEnabled() ? Trace::now() : 0)
+	{
+		detail[0] = '\0';
+	}
+	inline TraceZone(const char* name, const std::string& text) :
+		name(name),
+		start(Trace::isEnabled() ? Trace::now() : 0)
+	{
+		detail[0] = '\0';
+		if (start != 0)
+		{
+			text.copy(detail, TRACE_DETAIL_SIZE - 1);
+			detail[text.size() < TRACE_DETAIL_SIZE ? text.size() : TRACE_DETAIL_SIZE - 1] = '\0';
+		}
+	}
+	inline ~TraceZone()
+	{
+		if (start != 0)
+		{
+			Trace::record(name, detail, start, Trace::now());
+		}
+	}
+
+	TraceZone(const TraceZone&) = delete;
+	TraceZone& operator=(const TraceZone&) = delete;
+
+private:
+	const char* name;
+	uint64_t start;
+	char detail[TRACE_DETAIL_SIZE];
+};
+
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+
+#if TRACE_COMPILED
+#define TRACE_ZONE(name) TraceZone TRACE_CONCAT(traceZone, __LINE__)(name)
+#define TRACE_ZONE_DETAIL(name, detail) TraceZone TRACE_CONCAT(traceZone, __LINE__)(name, detail)
+#else
+#define TRACE_ZONE(name) do {} while (0)
+#define TRACE_ZONE_DETAIL(name, detail) do {} while (0)
+#endif